@@ -27,6 +27,8 @@ namespace logicalaccess
 
         static std::string getHex(const std::vector<unsigned char>& buffer);
 
+        static std::string getHex(const unsigned char* buffer, size_t buflen);
+
         static std::vector<unsigned char> fromHexString(std::string hexString);
 
         static std::string getStdString(const std::vector<unsigned char>& buffer);
@@ -55,6 +55,17 @@ class LIBLOGICALACCESS_API CardProbe
 		 */
 		virtual bool is_mifare_ultralight_c() = 0;
 
+        /**
+         * Read the Mifare Ultralight EV1 / NTAG21x version with the GET_VERSION command.
+         *
+         * The optional `*version` vector will be populated with the 8 bytes
+         * version, unless the command failed.
+         */
+        virtual bool get_mifare_ultralight_version(ByteVector * /*version*/)
+        {
+            return false;
+        }
+
         /**
          * Could the card be a Mifare Classic ?
          *
@@ -70,6 +81,17 @@ class LIBLOGICALACCESS_API CardProbe
          */
         virtual bool has_desfire_random_uid(ByteVector *uid) = 0;
 
+        /**
+         * Forget the answers cached by the probe, if any.
+         *
+         * A probe may remember the card answers for the current insertion so
+         * that the same command is not sent twice. Call this when the
+         * inserted card changed.
+         */
+        virtual void clear_cache()
+        {
+        }
+
       protected:
         ReaderUnit *reader_unit_;
 };
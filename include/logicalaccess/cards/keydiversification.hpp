@@ -1,6 +1,7 @@
 #include "logicalaccess/key.hpp"
 #include <vector>
 #include <memory>
+#include <future>
 
 #ifndef KEYDIVERSIFICATION_HPP__
 #define KEYDIVERSIFICATION_HPP__
@@ -9,14 +10,103 @@ namespace logicalaccess
 {
     class Key;
 
-    class LIBLOGICALACCESS_API KeyDiversification : public XmlSerializable
+    class LIBLOGICALACCESS_API KeyDiversification : public XmlSerializable, public std::enable_shared_from_this < KeyDiversification >
     {
     public:
+        /**
+         * \brief What a key is diversified for, as given to initDiversification.
+         */
+        struct DiversificationInput
+        {
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+            std::vector<unsigned char> identifier;
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+            int aid;
+
+            unsigned char keyno;
+        };
+
+        /**
+         * \brief Diversify a key per thread: keyed once, then used for many diversification inputs.
+         */
+        class LIBLOGICALACCESS_API BatchContext
+        {
+        public:
+            virtual ~BatchContext() {}
+
+            /**
+             * \brief Get a diversified key.
+             * \param diversify The diversification input, from initDiversification.
+             * \return The diversified key.
+             */
+            virtual std::vector<unsigned char> getDiversifiedKey(const std::vector<unsigned char>& diversify) = 0;
+        };
+
         virtual void initDiversification(std::vector<unsigned char> d_identifier, int AID, std::shared_ptr<Key> key, unsigned char keyno, std::vector<unsigned char>& diversify) = 0;
         virtual std::vector<unsigned char> getDiversifiedKey(std::shared_ptr<Key> key, std::vector<unsigned char> diversify) = 0;
         virtual std::string getType() = 0;
 
+        /**
+         * \brief Get a diversified key from the shared cache, diversifying it on a miss.
+         * \param key The key to diversify.
+         * \param diversify The diversification input.
+         * \param card The identifier of the card the key is used with, its entries are wiped on removal.
+         * \return The diversified key.
+         */
+        std::vector<unsigned char> getCachedDiversifiedKey(std::shared_ptr<Key> key, const std::vector<unsigned char>& diversify, const std::vector<unsigned char>& card);
+
+        /**
+         * \brief Diversify a key for many cards at once, spreading the work on a pool of threads.
+         * \param key The key to diversify.
+         * \param inputs The card identifier, AID and key number of each diversified key.
+         * \param threads The number of threads, 0 for one per hardware thread.
+         * \return The diversified keys, in the inputs order.
+         */
+        std::vector<std::vector<unsigned char> > getDiversifiedKeys(std::shared_ptr<Key> key, const std::vector<DiversificationInput>& inputs, unsigned int threads = 0);
+
+        /**
+         * \brief Diversify a key for many cards in the background, to prepare the next batch while cards are encoded.
+         *
+         * The diversification inputs are built before returning, the task keeps this object alive. It must be owned by a shared_ptr.
+         * \param key The key to diversify, not to be modified until done.
+         * \param inputs The card identifier, AID and key number of each diversified key.
+         * \param threads The number of threads, 0 for one per hardware thread.
+         * \return The diversified keys, in the inputs order.
+         */
+        std::future<std::vector<std::vector<unsigned char> > > getDiversifiedKeysAsync(std::shared_ptr<Key> key, const std::vector<DiversificationInput>& inputs, unsigned int threads = 0);
+
         static std::shared_ptr<KeyDiversification> getKeyDiversificationFromType(std::string kdiv);
+
+    protected:
+
+        /**
+         * \brief Diversify the key for diversification inputs already built by initDiversification.
+         * \param key The key to diversify.
+         * \param diversify The diversification inputs.
+         * \param threads The number of threads, 0 for one per hardware thread.
+         * \return The diversified keys, in the inputs order.
+         */
+        std::vector<std::vector<unsigned char> > diversifyAll(std::shared_ptr<Key> key, const std::vector<std::vector<unsigned char> >& diversify, unsigned int threads);
+
+        /**
+         * \brief Create the context used by a getDiversifiedKeys thread.
+         * \param key The key to diversify.
+         * \return The context. Calls getDiversifiedKey by default, algorithms override it to key their ciphers once per thread.
+         */
+        virtual std::unique_ptr<BatchContext> createBatchContext(std::shared_ptr<Key> key);
+
+        /**
+         * \brief Append what the diversified key depends on, besides the algorithm and the diversification input.
+         * \param key The key to diversify.
+         * \param identity The identity to append to. The key bytes by default, algorithms with settings or key attributes changing the result append them too.
+         */
+        virtual void appendCacheIdentity(std::shared_ptr<Key> key, std::vector<unsigned char>& identity);
     };
 }
 
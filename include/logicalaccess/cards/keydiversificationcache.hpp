@@ -0,0 +1,139 @@
+/**
+ * \file keydiversificationcache.hpp
+ * \brief Cache of diversified keys.
+ */
+
+#ifndef LOGICALACCESS_KEYDIVERSIFICATIONCACHE_HPP
+#define LOGICALACCESS_KEYDIVERSIFICATIONCACHE_HPP
+
+#include "logicalaccess/logicalaccess_api.hpp"
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace logicalaccess
+{
+    /**
+     * \brief A least recently used cache of diversified keys, shared by all the key diversification algorithms.
+     *
+     * An entry is identified by a digest of everything the diversified key
+     * depends on (algorithm, settings, master key and diversification input),
+     * so the master key is never held, and belongs to a card so the entries of
+     * a card can be dropped on removal. The diversified key bytes are
+     * overwritten when an entry leaves the cache.
+     */
+    class LIBLOGICALACCESS_API KeyDiversificationCache
+    {
+    public:
+
+        /**
+         * \brief Constructor.
+         * \param capacity The maximum number of entries, 0 to disable the cache.
+         */
+        explicit KeyDiversificationCache(size_t capacity = 64);
+
+        /**
+         * \brief Destructor. Wipe the entries.
+         */
+        ~KeyDiversificationCache();
+
+        /**
+         * \brief Get the cache used by the key diversifications.
+         */
+        static KeyDiversificationCache& getInstance();
+
+        /**
+         * \brief Look for a diversified key, and mark it as the most recently used.
+         * \param identity The entry identity.
+         * \param keydiv The diversified key, set when found.
+         * \return True if found, false otherwise.
+         */
+        bool get(const std::vector<unsigned char>& identity, std::vector<unsigned char>& keydiv);
+
+        /**
+         * \brief Add a diversified key, evicting the least recently used entry when full.
+         * \param identity The entry identity.
+         * \param card The identifier of the card the key is used with.
+         * \param keydiv The diversified key.
+         */
+        void put(const std::vector<unsigned char>& identity, const std::vector<unsigned char>& card, const std::vector<unsigned char>& keydiv);
+
+        /**
+         * \brief Wipe the entries of a card.
+         * \param card The card identifier.
+         */
+        void removeCard(const std::vector<unsigned char>& card);
+
+        /**
+         * \brief Wipe all the entries.
+         */
+        void clear();
+
+        /**
+         * \brief Set the maximum number of entries, evicting the extra entries.
+         * \param capacity The maximum number of entries, 0 to disable the cache.
+         */
+        void setCapacity(size_t capacity);
+
+        /**
+         * \brief Get the maximum number of entries.
+         * \return The capacity.
+         */
+        size_t getCapacity() const;
+
+        /**
+         * \brief Get the number of entries.
+         * \return The entry count.
+         */
+        size_t size() const;
+
+        /**
+         * \brief Overwrite a buffer with zeros in a way the compiler cannot optimize out, then empty it.
+         * \param buffer The buffer.
+         */
+        static void wipe(std::vector<unsigned char>& buffer);
+
+    protected:
+
+        struct Entry
+        {
+            std::vector<unsigned char> identity;
+
+            std::vector<unsigned char> card;
+
+            std::vector<unsigned char> keydiv;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        /**
+         * \brief Wipe and remove an entry. Must be called with d_mutex held.
+         * \param it The entry.
+         */
+        void erase(EntryList::iterator it);
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+        /**
+         * The entries, most recently used first.
+         */
+        EntryList d_entries;
+
+        std::map<std::vector<unsigned char>, EntryList::iterator> d_index;
+
+        mutable std::mutex d_mutex;
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+        size_t d_capacity;
+    };
+}
+
+#endif /* LOGICALACCESS_KEYDIVERSIFICATIONCACHE_HPP */
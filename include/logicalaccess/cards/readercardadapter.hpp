@@ -15,7 +15,7 @@ namespace logicalaccess
     /**
      * \brief A reader/card adapter base class. It provide an abstraction layer between the card and the reader to send chip command.
      */
-    class LIBLOGICALACCESS_API ReaderCardAdapter
+    class LIBLOGICALACCESS_API ReaderCardAdapter : public std::enable_shared_from_this < ReaderCardAdapter >
     {
     public:
 
@@ -56,6 +56,33 @@ namespace logicalaccess
 		*/
         virtual std::vector<unsigned char> sendCommand(const std::vector<unsigned char>& command, long timeout = -1);
 
+		/**
+		* \brief Send a command to the reader, writing the answer to a caller owned buffer.
+		* The default implementation copies the command to call sendCommand().
+		* \param command The command buffer.
+		* \param commandlen The command length.
+		* \param result The result buffer, replaced by the adapted answer.
+		* \param timeout The command timeout.
+		*/
+        virtual void transmit(const unsigned char* command, size_t commandlen, std::vector<unsigned char>& result, long timeout = -1);
+
+		/**
+		* \brief Send a command to the reader without waiting for the answer.
+		* \param command The command buffer.
+		* \param handler The completion handler, called with the adapted answer.
+		* \param timeout The command timeout.
+		* \remarks The adapter must be owned by a shared pointer. If it is released before the answer, the handler gets an error.
+		*/
+        void sendCommandAsync(const std::vector<unsigned char>& command, DataTransport::CommandHandler handler, long timeout = -1);
+
+		/**
+		* \brief Send a command to the reader without waiting for the answer.
+		* \param command The command buffer.
+		* \param timeout The command timeout.
+		* \return The future result of the command.
+		*/
+        std::future<std::vector<unsigned char> > sendCommandAsync(const std::vector<unsigned char>& command, long timeout = -1);
+
 		/**
 		* \brief Get the result checker.
 		* \return The result checker.
@@ -70,6 +97,36 @@ namespace logicalaccess
 
     protected:
 
+		/**
+		* \brief Adapt the answer and run the result checker on it.
+		* \param answer The answer received from the data transport.
+		* \return The adapted answer.
+		*/
+        std::vector<unsigned char> handleAnswer(const std::vector<unsigned char>& answer);
+
+		/**
+		* \brief Run the result checker on an already adapted answer.
+		* \param answer The adapted answer.
+		*/
+        void checkResult(const std::vector<unsigned char>& answer);
+
+		/**
+		* \brief Exchange a command through the data transport asynchronous API.
+		* \param command The command buffer.
+		* \param timeout The resolved command timeout.
+		* \param handler The completion handler, called exactly once.
+		*/
+        virtual void exchangeAsync(const std::vector<unsigned char>& command, long timeout, DataTransport::CommandHandler handler);
+
+		/**
+		* \brief Run sendCommand() in the calling thread and report its outcome to the handler.
+		* For adapters which command exchange cannot be split into asynchronous steps.
+		* \param command The command buffer.
+		* \param timeout The resolved command timeout.
+		* \param handler The completion handler.
+		*/
+        void exchangeInline(const std::vector<unsigned char>& command, long timeout, DataTransport::CommandHandler handler);
+
 		/**
 		* \brief The data transport.
 		*/
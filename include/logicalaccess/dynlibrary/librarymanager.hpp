@@ -3,7 +3,11 @@
 
 #include <string>
 #include <list>
+#include <memory>
 #include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
 
 #include "logicalaccess/dynlibrary/idynlibrary.hpp"
 
@@ -30,7 +34,7 @@ namespace logicalaccess
             UNIFIED_TYPE = 2
         };
     private:
-        LibraryManager() {};
+        LibraryManager() : symbols_(NULL) {};
         ~LibraryManager() {};
 
         static bool hasEnding(std::string const &fullString, std::string ending);
@@ -89,9 +93,43 @@ namespace logicalaccess
         std::vector<std::string> getAvailablePlugins(LibraryType libraryType);
         static void getAvailablePlugins(std::vector<std::string>& plugins, getobjectinfoat objectinfoptr);
 
+        /**
+         * Walk the loaded libraries of a type for a symbol. Must be called with the mutex held.
+         */
+        void* resolveFct(const std::string &fctname, LibraryType libraryType);
+
+        /**
+         * Build the symbol index with the chip and reader factories of the loaded libraries.
+         */
+        void indexFactories();
+
     private:
+        typedef std::unordered_map<std::string, void*> SymbolMap;
+
+        /**
+         * Resolved symbols by library type, NULL when not found. Never modified once published.
+         */
+        struct SymbolIndex
+        {
+            SymbolMap symbols[3];
+        };
+
+        /**
+         * Publish a new symbol index. Must be called with the mutex held.
+         */
+        void publishSymbols(SymbolIndex* symbols);
+
         mutable std::recursive_mutex mutex_;
         std::map<std::string, IDynLibrary*> libLoaded;
+
+        /**
+         * The current symbol index, read without locking. It is replaced by a new
+         * copy when a symbol is added or the plugins are scanned, the previous
+         * copies are kept in symbolIndexes_ as lookups may still be reading them.
+         */
+        std::atomic<const SymbolIndex*> symbols_;
+        std::vector<std::unique_ptr<const SymbolIndex> > symbolIndexes_;
+
         static const std::string enumType[3];
     };
 }
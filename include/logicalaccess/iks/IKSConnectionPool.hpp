@@ -0,0 +1,232 @@
+#pragma once
+
+#include "SSLTransport.hpp"
+#include "logicalaccess/iks/packet/Base.hpp"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace logicalaccess
+{
+namespace iks
+{
+/**
+ * A connection to the Islog Key Server.
+ *
+ * Commands are strict request/response: a multi-step exchange
+ * (DESFire authentication) must run on the same channel.
+ */
+class LIBLOGICALACCESS_API IKSChannel
+{
+  public:
+    IKSChannel(const IKSChannel &) = delete;
+    IKSChannel &operator=(const IKSChannel &) = delete;
+
+    /**
+     * Connect to the server, resuming `session` when set.
+     *
+     * Throw if the connection or the handshake fails.
+     */
+#ifdef ENABLE_SSLTRANSPORT
+    IKSChannel(boost::asio::ssl::context &ctx, const std::string &ip, uint16_t port,
+               std::shared_ptr<SSL_SESSION> session);
+#else
+    IKSChannel(const std::string &ip, uint16_t port);
+#endif /* ENABLE_SSLTRANSPORT */
+
+    /**
+     * Connect on a transport already set up.
+     *
+     * Throw if the connection fails.
+     */
+    explicit IKSChannel(std::unique_ptr<SSLTransport> transport);
+
+    void send_command(const BaseCommand &cmd);
+
+    /**
+     * Receive a response.
+     *
+     * Return null if no complete response came in time. The channel is then
+     * disconnected, so a late response is never read as the next one.
+     */
+    std::shared_ptr<BaseResponse> recv();
+
+    /**
+     * Check, without blocking, that the connection can still be used:
+     * connected and with no response left to read.
+     */
+    bool is_healthy();
+
+    void disconnect();
+
+#ifdef ENABLE_SSLTRANSPORT
+    /**
+     * The TLS session, to resume it on the next connections. Null until a
+     * response was read, TLS 1.3 servers send the session tickets late.
+     */
+    std::shared_ptr<SSL_SESSION> session();
+#endif /* ENABLE_SSLTRANSPORT */
+
+    static std::shared_ptr<BaseResponse> build_response(uint32_t size, uint16_t opcode,
+                                                        uint16_t status,
+                                                        const std::vector<uint8_t> &data);
+
+  private:
+    std::unique_ptr<SSLTransport> transport_;
+
+    /**
+     * A command was sent and its response not read yet.
+     */
+    bool pending_;
+};
+
+/**
+ * A pool of connections to the Islog Key Server.
+ *
+ * Each thread leases its own channel for the duration of an exchange, so
+ * several readers authenticate concurrently instead of waiting on one socket.
+ * New connections resume the TLS session of the previous ones, and a
+ * background thread checks the idle channels and replaces the broken ones
+ * before they are needed.
+ *
+ * The pool must be owned by a shared_ptr, the leases only keep a weak
+ * reference to it.
+ */
+class LIBLOGICALACCESS_API IKSConnectionPool
+    : public std::enable_shared_from_this<IKSConnectionPool>
+{
+  public:
+    /**
+     * Open a new connection, throw on failure.
+     */
+    typedef std::function<std::shared_ptr<IKSChannel>()> ChannelFactory;
+
+    IKSConnectionPool(const IKSConnectionPool &) = delete;
+    IKSConnectionPool &operator=(const IKSConnectionPool &) = delete;
+
+    /**
+     * Exclusive use of a channel, given back to the pool on destruction,
+     * or disconnected if the pool is gone.
+     */
+    class LIBLOGICALACCESS_API Lease
+    {
+      public:
+        Lease(std::weak_ptr<IKSConnectionPool> pool, std::shared_ptr<IKSChannel> channel);
+        Lease(Lease &&other);
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+        ~Lease();
+
+        IKSChannel *operator->() const
+        {
+            return channel_.get();
+        }
+
+        IKSChannel &operator*() const
+        {
+            return *channel_;
+        }
+
+      private:
+        std::weak_ptr<IKSConnectionPool> pool_;
+        std::shared_ptr<IKSChannel> channel_;
+    };
+
+    /**
+     * Create the pool, with one connection opened right away.
+     *
+     * \param max_connections The maximum number of connections.
+     * \param health_interval Milliseconds between checks of the idle
+     * connections, 0 to disable the background thread.
+     */
+#ifdef ENABLE_SSLTRANSPORT
+    IKSConnectionPool(boost::asio::ssl::context &ctx, const std::string &ip,
+                      uint16_t port, size_t max_connections = 8,
+                      long health_interval = 5000);
+#else
+    IKSConnectionPool(const std::string &ip, uint16_t port,
+                      size_t max_connections = 8, long health_interval = 5000);
+#endif /* ENABLE_SSLTRANSPORT */
+
+    /**
+     * Create the pool on another way to open the connections.
+     */
+    IKSConnectionPool(ChannelFactory open_channel, size_t max_connections = 8,
+                      long health_interval = 5000);
+
+    ~IKSConnectionPool();
+
+    /**
+     * Get an idle channel, or open a new one if below the limit, or
+     * wait for a channel to be given back.
+     */
+    Lease acquire();
+
+    /**
+     * Number of open connections, idle or leased.
+     */
+    size_t size() const;
+
+    /**
+     * Number of idle connections.
+     */
+    size_t idle_count() const;
+
+  private:
+    void start();
+
+#ifdef ENABLE_SSLTRANSPORT
+    std::shared_ptr<IKSChannel> open_ssl_channel(boost::asio::ssl::context &ctx,
+                                                 const std::string &ip,
+                                                 uint16_t port);
+#endif /* ENABLE_SSLTRANSPORT */
+
+    void release(std::shared_ptr<IKSChannel> channel);
+
+    void health_loop();
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+
+#ifdef ENABLE_SSLTRANSPORT
+    /**
+     * The session of the last released connection, resumed by the next ones.
+     */
+    std::shared_ptr<SSL_SESSION> session_;
+#endif /* ENABLE_SSLTRANSPORT */
+
+    ChannelFactory open_channel_;
+
+    size_t max_connections_;
+
+    long health_interval_;
+
+    mutable std::mutex mutex_;
+
+    std::condition_variable available_;
+
+    std::condition_variable stop_cv_;
+
+    std::vector<std::shared_ptr<IKSChannel>> idle_;
+
+    /**
+     * Idle, leased and being opened connections.
+     */
+    size_t open_count_;
+
+    bool stop_;
+
+    std::thread health_thread_;
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+};
+}
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SSLTransport.hpp"
+#include "IKSConnectionPool.hpp"
 #include "logicalaccess/iks/packet/Base.hpp"
 #include <string>
 
@@ -11,6 +12,9 @@ namespace iks
 /**
  * Main interface with the Islog Key Server.
  *
+ * The requests are spread on a pool of connections, so that it
+ * can be used from several threads at once.
+ *
  * This object is movable but not copyable.
  */
 class LIBLOGICALACCESS_API IslogKeyServer
@@ -107,20 +111,28 @@ class LIBLOGICALACCESS_API IslogKeyServer
                                          const std::array<uint8_t, 8> &iv);
 
     /**
-     * Send a command and retrieve a response.
+     * Send a command and retrieve a response, on any idle connection.
      * On network error, attempt to reconnect and try again.
      */
     std::shared_ptr<BaseResponse> transact(const BaseCommand &cmd);
 
+    /**
+     * Get a connection for a multi-step exchange, given back when
+     * the lease is destroyed.
+     */
+    IKSConnectionPool::Lease acquire();
+
+    /**
+     * Send a command on the connection shared by send_command() and recv().
+     *
+     * Not thread safe: use acquire() to run exchanges from several threads.
+     */
     void send_command(const BaseCommand &cmd);
 
     std::shared_ptr<BaseResponse> recv();
 
   private:
     void setup_transport();
-    std::shared_ptr<BaseResponse> build_response(uint32_t size, uint16_t opcode,
-                                                 uint16_t status,
-                                                 const std::vector<uint8_t> &data);
 
     std::vector<uint8_t> des_crypto(const std::vector<uint8_t> &in,
                                     const std::string &key_name,
@@ -130,7 +142,12 @@ class LIBLOGICALACCESS_API IslogKeyServer
 #ifdef ENABLE_SSLTRANSPORT
     boost::asio::ssl::context ssl_ctx_;
 #endif /* ENABLE_SSLTRANSPORT */
-    std::unique_ptr<SSLTransport> transport_;
+    std::shared_ptr<IKSConnectionPool> pool_;
+
+    /**
+     * The connection used by send_command() and recv().
+     */
+    std::unique_ptr<IKSConnectionPool::Lease> shared_channel_;
 
     /**
      * The registered pre-configuration is stored here.
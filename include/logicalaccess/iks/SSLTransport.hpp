@@ -4,6 +4,7 @@
 #include <boost/asio.hpp>
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/property_tree/ptree_fwd.hpp>
+#include <memory>
 #ifdef ENABLE_SSLTRANSPORT
 #include <boost/asio/ssl.hpp>
 #endif
@@ -52,6 +53,37 @@ class LIBLOGICALACCESS_API SSLTransport
      */
     virtual bool isConnected();
 
+    /**
+     * \brief Check, without blocking, that the peer did not close the connection,
+     * that the connection did not fail and that no unexpected application data is
+     * pending. Disconnect otherwise. TLS records carrying no application data, such
+     * as TLS 1.3 session tickets, are processed and do not count.
+     * \return True if the connection can be used, false otherwise.
+     */
+    virtual bool checkConnection();
+
+#ifdef ENABLE_SSLTRANSPORT
+    /**
+     * \brief Set the TLS session to resume on the next handshake.
+     * \param session The session of a previous connection to the same server.
+     */
+    void setSession(std::shared_ptr<SSL_SESSION> session);
+
+    /**
+     * \brief Get the TLS session of the connection, to resume it on another one.
+     * It is taken on the first application data read, TLS 1.3 servers only send
+     * the session tickets after the handshake.
+     * \return The session, null if nothing was read on the connection yet.
+     */
+    std::shared_ptr<SSL_SESSION> getSession();
+
+    /**
+     * \brief Get if the last handshake resumed the given session, skipping the full handshake.
+     * \return True if resumed, false otherwise.
+     */
+    bool isSessionReused();
+#endif /* ENABLE_SSLTRANSPORT */
+
     /**
      * \brief Get the data transport endpoint name.
      * \return The data transport endpoint name.
@@ -156,6 +188,16 @@ class LIBLOGICALACCESS_API SSLTransport
 * \brief Read Deadline timer
 */
     boost::asio::deadline_timer d_timer;
+
+    /**
+     * \brief The session to resume.
+     */
+    std::shared_ptr<SSL_SESSION> d_session;
+
+    /**
+     * \brief The session of the connection, taken on the first application data read.
+     */
+    std::shared_ptr<SSL_SESSION> d_readSession;
 #endif /* ENABLE_SSLTRANSPORT */
 
     /**
@@ -31,6 +31,16 @@
 #include <array>
 #include <cstdint>
 
+/**
+ * \brief Minimum log level compiled in the binary.
+ *
+ * Log lines under this severity are removed at compile time, their stream
+ * arguments are never evaluated. Defaults to TRACE (every level compiled in).
+ */
+#ifndef LOGICALACCESS_LOGS_MIN_LEVEL
+#define LOGICALACCESS_LOGS_MIN_LEVEL TRACE
+#endif
+
 namespace logicalaccess
 {
     enum LogLevel
@@ -84,6 +94,24 @@ namespace logicalaccess
         ~LogContext();
     };
 
+    /**
+     * \brief Get the severity rank of a log level, from TRACE (lowest) to EMERGENSYS (highest).
+     * \param level The log level.
+     * \return The severity rank.
+     */
+    inline constexpr int logLevelSeverity(LogLevel level)
+    {
+        return (level == TRACE) ? 1 :
+            (level == DEBUGS || level == COMS) ? 2 :
+            (level == INFOS || level == PLUGINS) ? 3 :
+            (level == NOTICES) ? 4 :
+            (level == WARNINGS) ? 5 :
+            (level == ERRORS || level == PLUGINS_ERROR) ? 6 :
+            (level == CRITICALS) ? 7 :
+            (level == ALERTS) ? 8 :
+            (level == EMERGENSYS) ? 9 : 0;
+    }
+
     class LIBLOGICALACCESS_API Logs
     {
       public:
@@ -91,6 +119,23 @@ namespace logicalaccess
 
         ~Logs();
 
+        /**
+         * \brief Check if a log level is compiled in, according to LOGICALACCESS_LOGS_MIN_LEVEL.
+         * \param level The log level.
+         * \return True if the level is compiled in, false otherwise.
+         */
+        static constexpr bool isCompiledIn(LogLevel level)
+        {
+            return logLevelSeverity(level) >= logLevelSeverity(LOGICALACCESS_LOGS_MIN_LEVEL);
+        }
+
+        /**
+         * \brief Check if a log level is enabled by the current settings.
+         * \param level The log level.
+         * \return True if a log line of this level would be written, false otherwise.
+         */
+        static bool isEnabled(LogLevel level);
+
         template <class T>
         Logs &operator<<(const T &arg)
         {
@@ -98,6 +143,11 @@ namespace logicalaccess
             return (*this);
         }
 
+        /**
+         * Legacy log file. When opened by the application while the log
+         * writer is closed, lines are written to it directly.
+         * Prefer the config.log settings.
+         */
         static std::ofstream logfile;
 
         /**
@@ -118,19 +168,32 @@ namespace logicalaccess
     };
 
     /**
-     * A RAII object that disable logging in its constructor, and restore
-     * the old value in its destructor.
+     * Turn a log statement into a void expression, so that the LOG macro
+     * can skip it with the conditional operator. The & operator binds
+     * looser than << and tighter than ?:.
+     */
+    struct LogVoidify
+    {
+        void operator&(const Logs &) const
+        {
+        }
+    };
+
+    /**
+     * A RAII object that disable logging in its constructor, and enable
+     * it back in its destructor.
      *
      * This is used where we need to temporarily disable logging. This is
-     * exception safe.
+     * exception safe. Logging stays disabled while any LogDisabler is alive,
+     * whatever the order they are destroyed in, and the IsLogEnabled setting
+     * is left untouched.
      */
     struct LIBLOGICALACCESS_API LogDisabler
     {
         LogDisabler();
         ~LogDisabler();
-
-      private:
-        bool old_;
+        LogDisabler(const LogDisabler &) = delete;
+        LogDisabler &operator=(const LogDisabler &) = delete;
     };
 
     /**
@@ -149,7 +212,18 @@ namespace logicalaccess
 
 #ifdef LOGICALACCESS_LOGS
 
-#define LOG(x) logicalaccess::Logs(__FILE__, __FUNCTION__, __LINE__, x)
+/**
+ * \brief Log a line at the x level.
+ *
+ * The stream arguments are only evaluated when the level is both compiled in
+ * and enabled by the settings.
+ */
+#define LOG(x)                                                                 \
+    (!logicalaccess::Logs::isCompiledIn(x) ||                                  \
+     !logicalaccess::Logs::isEnabled(x))                                       \
+        ? (void)0                                                              \
+        : logicalaccess::LogVoidify() &                                        \
+              logicalaccess::Logs(__FILE__, __FUNCTION__, __LINE__, x)
 
 	LIBLOGICALACCESS_API void trace_print_helper(std::stringstream &ss, const char *param_names, int idx);
 
@@ -198,9 +272,18 @@ namespace logicalaccess
      * parameters types and will output something like [param_name -> param_value]
      */
 #define TRACE(...)                                                 \
-  std::stringstream trace_stringstream;                            \
-  trace_print(trace_stringstream, #__VA_ARGS__, ##__VA_ARGS__);    \
-  LOG(TRACE) << trace_stringstream.str();
+  do                                                               \
+  {                                                                \
+    if (logicalaccess::Logs::isCompiledIn(logicalaccess::TRACE) && \
+        logicalaccess::Logs::isEnabled(logicalaccess::TRACE))      \
+    {                                                              \
+      std::stringstream trace_stringstream;                        \
+      trace_print(trace_stringstream, #__VA_ARGS__, ##__VA_ARGS__);\
+      logicalaccess::Logs(__FILE__, __FUNCTION__, __LINE__,        \
+                          logicalaccess::TRACE)                    \
+          << trace_stringstream.str();                             \
+    }                                                              \
+  } while (0)
 
 	LIBLOGICALACCESS_API void trace_print_helper(std::stringstream &ss, const char *param_names, int idx);
 
@@ -235,8 +318,10 @@ namespace logicalaccess
 #else
 
 #define LOG(x)                                                                 \
-    logicalaccess::Logs(__FILE__, __FUNCTION__, __LINE__,                      \
-                        logicalaccess::LogLevel::NONE)
+    true ? (void)0                                                             \
+         : logicalaccess::LogVoidify() &                                       \
+               logicalaccess::Logs(__FILE__, __FUNCTION__, __LINE__,           \
+                                   logicalaccess::LogLevel::NONE)
 
 #define THROW_EXCEPTION_WITH_LOG(type, msg)                                    \
     {                                                                          \
@@ -0,0 +1,247 @@
+/**
+ * \file logwriter.hpp
+ * \brief Background log writer.
+ */
+
+#ifndef LOGICALACCESS_LOGWRITER_HPP
+#define LOGICALACCESS_LOGWRITER_HPP
+
+#include "logicalaccess/logicalaccess_api.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace logicalaccess
+{
+    /**
+     * \brief A bounded lock-free queue of log lines, for many producers and a single consumer.
+     *
+     * Each slot holds a sequence number telling whether it is free for the
+     * producer of a given position or ready for the consumer.
+     */
+    class LIBLOGICALACCESS_API LogRingBuffer
+    {
+    public:
+
+        /**
+         * \brief Constructor.
+         * \param capacity The number of slots, rounded up to a power of two.
+         */
+        explicit LogRingBuffer(size_t capacity);
+
+        /**
+         * \brief Push a line. Can be called from any thread.
+         * \param line The line, moved on success.
+         * \return False if the buffer is full, true otherwise.
+         */
+        bool push(std::string& line);
+
+        /**
+         * \brief Pop a line. Must only be called from the consumer thread.
+         * \param line The line.
+         * \return False if the buffer is empty, true otherwise.
+         */
+        bool pop(std::string& line);
+
+        /**
+         * \brief Get the number of slots.
+         * \return The capacity.
+         */
+        size_t getCapacity() const { return d_mask + 1; }
+
+    protected:
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+        struct Slot
+        {
+            std::atomic<size_t> sequence;
+            std::string line;
+        };
+
+        std::unique_ptr<Slot[]> d_slots;
+
+        size_t d_mask;
+
+        std::atomic<size_t> d_enqueuePos;
+
+        size_t d_dequeuePos;
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+    };
+
+    /**
+     * \brief Write the log lines to the log file from a background thread.
+     *
+     * Logging threads only push their line into a ring buffer, the writer
+     * thread writes them by batch and flushes once per batch. When the buffer
+     * is full the line is dropped and counted, the drop count is written to the
+     * log file afterwards.
+     *
+     * The log file is rotated when it exceeds a maximum size or is older than
+     * a maximum age: file.log is renamed to file.log.1, file.log.1 to
+     * file.log.2, etc.
+     */
+    class LIBLOGICALACCESS_API LogWriter
+    {
+    public:
+
+        /**
+         * \brief Constructor.
+         * \param capacity The maximum number of pending lines.
+         */
+        explicit LogWriter(size_t capacity = 8192);
+
+        /**
+         * \brief Destructor. Write the pending lines and close the file.
+         */
+        ~LogWriter();
+
+        /**
+         * \brief Get the writer used by the Logs class.
+         */
+        static LogWriter& getInstance();
+
+        /**
+         * \brief Open the log file, in append mode, and start the writer thread.
+         * \param filename The log file name.
+         * \return True on success, false otherwise.
+         */
+        bool open(const std::string& filename);
+
+        /**
+         * \brief Write the pending lines, stop the writer thread and close the log file.
+         */
+        void close();
+
+        /**
+         * \brief Check if the log file is open.
+         * \return True if open, false otherwise.
+         */
+        bool isOpen() const { return d_open; }
+
+        /**
+         * \brief Get the name of the last opened log file.
+         * \return The file name.
+         */
+        const std::string& getFilename() const { return d_filename; }
+
+        /**
+         * \brief Queue a line. Never blocks.
+         * \param line The line, moved on success.
+         * \return False if the line was dropped, true otherwise.
+         */
+        bool push(std::string& line);
+
+        /**
+         * \brief Wait for the lines queued so far to be written.
+         */
+        void flush();
+
+        /**
+         * \brief Set the rotation policy. Applies on the next write.
+         * \param maxFileSize The maximum file size in bytes, 0 to disable size rotation.
+         * \param maxAge The maximum file age in seconds, 0 to disable time rotation.
+         * \param maxFiles The number of rotated files kept.
+         */
+        void setRotation(uint64_t maxFileSize, unsigned int maxAge, unsigned int maxFiles);
+
+        /**
+         * \brief Duplicate the lines to stderr.
+         * \param toStderr True to duplicate, false otherwise.
+         */
+        void setToStderr(bool toStderr) { d_toStderr = toStderr; }
+
+        /**
+         * \brief Get the number of lines dropped because the buffer was full.
+         * \return The drop count.
+         */
+        uint64_t getDroppedCount() const { return d_dropped; }
+
+    protected:
+
+        /**
+         * \brief The writer thread loop.
+         */
+        void run();
+
+        /**
+         * \brief Write the available lines.
+         * \return True if lines were written, false otherwise.
+         */
+        bool writeBatch();
+
+        /**
+         * \brief Rotate the log file if required by the policy. Must be called with d_fileMutex held.
+         */
+        void rotateIfNeeded();
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+        LogRingBuffer d_buffer;
+
+        std::ofstream d_file;
+
+        std::string d_filename;
+
+        /**
+         * Guard the file, held by the writer thread for each batch.
+         */
+        std::mutex d_fileMutex;
+
+        std::thread d_thread;
+
+        std::mutex d_mutex;
+
+        std::condition_variable d_wakeup;
+
+        std::condition_variable d_written;
+
+        std::atomic<bool> d_open;
+
+        std::atomic<bool> d_stop;
+
+        std::atomic<bool> d_sleeping;
+
+        std::atomic<bool> d_toStderr;
+
+        std::atomic<uint64_t> d_pushed;
+
+        std::atomic<uint64_t> d_writtenCount;
+
+        std::atomic<uint64_t> d_dropped;
+
+        uint64_t d_reportedDropped;
+
+        uint64_t d_fileSize;
+
+        std::chrono::steady_clock::time_point d_fileOpened;
+
+        std::atomic<uint64_t> d_maxFileSize;
+
+        std::atomic<unsigned int> d_maxAge;
+
+        std::atomic<unsigned int> d_maxFiles;
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+    };
+}
+
+#endif /* LOGICALACCESS_LOGWRITER_HPP */
@@ -10,6 +10,13 @@
 #include "logicalaccess/lla_fwd.hpp"
 #include "logicalaccess/readerproviders/readerprovider.hpp"
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace logicalaccess
@@ -21,6 +28,21 @@ namespace logicalaccess
     {
     public:
 
+        /**
+         * \brief Completion handler of an asynchronous command. On failure, the exception is set and the result is empty.
+         */
+        typedef std::function<void(std::exception_ptr, const std::vector<unsigned char>&)> CommandHandler;
+
+        /**
+         * \brief Constructor.
+         */
+        DataTransport();
+
+        /**
+         * \brief Destructor. Queued asynchronous commands fail.
+         */
+        virtual ~DataTransport();
+
         /**
          * \brief Get the reader unit.
          * \return The reader unit.
@@ -64,12 +86,57 @@ namespace logicalaccess
 
         /**
          * \brief Send a command to the reader.
+         *
+         * Waits for the queued asynchronous commands to be exchanged first.
          * \param command The command buffer.
          * \param timeout The command timeout.
          * \return the result of the command.
          */
         virtual std::vector<unsigned char> sendCommand(const std::vector<unsigned char>& command, long int timeout = -1);
 
+        /**
+         * \brief Send a command to the reader, writing the answer to a caller owned buffer.
+         *
+         * Reusing the same result buffer, transports overriding sendBuffer() and
+         * receiveInto() exchange commands without any heap allocation.
+         * \param command The command buffer.
+         * \param commandlen The command length.
+         * \param result The result buffer, replaced by the answer.
+         * \param timeout The command timeout.
+         */
+        void transmit(const unsigned char* command, size_t commandlen, std::vector<unsigned char>& result, long int timeout = -1);
+
+        /**
+         * \brief Send a command to the reader without waiting for the answer.
+         *
+         * Commands are queued and exchanged one after the other, in submission order,
+         * and never interleave with a synchronous sendCommand() or transmit().
+         * Transports without native asynchronous support run the exchange in the
+         * calling thread. Commands still queued when the transport is destroyed fail.
+         * \param command The command buffer.
+         * \param handler The completion handler.
+         * \param timeout The command timeout.
+         */
+        void sendCommandAsync(const std::vector<unsigned char>& command, CommandHandler handler, long int timeout = -1);
+
+        /**
+         * \brief Send a command to the reader without waiting for the answer.
+         * \param command The command buffer.
+         * \param timeout The command timeout.
+         * \return The future result of the command.
+         */
+        std::future<std::vector<unsigned char> > sendCommandAsync(const std::vector<unsigned char>& command, long int timeout = -1);
+
+        /**
+         * \brief Get exclusive access to the reader for a sequence of commands. Noop by default.
+         */
+        virtual void beginTransaction() {};
+
+        /**
+         * \brief Release the exclusive access got with beginTransaction(). Noop by default.
+         */
+        virtual void endTransaction() {};
+
         /**
          * \brief Get the last command.
          * \return The last command.
@@ -82,12 +149,71 @@ namespace logicalaccess
          */
         virtual std::vector<unsigned char> getLastResult() { return d_lastResult; };
 
+        /**
+         * \brief Set if the last command and result are kept. Disabled by default.
+         * \param retain True to keep a copy of the last command and result, false otherwise.
+         */
+        void setRetainLastExchange(bool retain) { d_retainLastExchange = retain; };
+
+        /**
+         * \brief Get if the last command and result are kept.
+         * \return True if a copy of the last command and result is kept, false otherwise.
+         */
+        bool getRetainLastExchange() const { return d_retainLastExchange; };
+
     protected:
 
         virtual void send(const std::vector<unsigned char>& data) = 0;
 
         virtual std::vector<unsigned char> receive(long int timeout) = 0;
 
+        /**
+         * \brief Send a raw buffer. The default implementation copies it to call send().
+         * \param data The data buffer.
+         * \param datalen The data length.
+         */
+        virtual void sendBuffer(const unsigned char* data, size_t datalen);
+
+        /**
+         * \brief Receive into a caller owned buffer. The default implementation calls receive().
+         * \param result The result buffer, replaced by the received data.
+         * \param timeout The receive timeout.
+         */
+        virtual void receiveInto(std::vector<unsigned char>& result, long int timeout);
+
+        /**
+         * \brief Exchange a command with the reader asynchronously.
+         *
+         * The default implementation connects, sends and receives synchronously
+         * and then calls the handler. Asynchronous transports override it.
+         * \param command The command buffer, empty to only receive.
+         * \param timeout The resolved command timeout.
+         * \param handler The completion handler, called exactly once.
+         */
+        virtual void exchangeAsync(const std::vector<unsigned char>& command, long int timeout, CommandHandler handler);
+
+        /**
+         * \brief Exchange the queued asynchronous commands until one completes asynchronously.
+         */
+        void processAsyncQueue();
+
+        /**
+         * \brief Fail the queued asynchronous commands and detach the pending ones from the transport.
+         *
+         * Transports completing commands on another thread call it first in their destructor.
+         */
+        void abandonAsyncCommands();
+
+        /**
+         * \brief Wait for the asynchronous commands exchange and keep the transport for a synchronous one.
+         */
+        void lockExchange();
+
+        /**
+         * \brief Release the transport kept with lockExchange() and go on with the queued commands.
+         */
+        void unlockExchange();
+
         /**
          * \brief The reader unit.
          */
@@ -102,6 +228,85 @@ namespace logicalaccess
          * \brief The last command.
          */
         std::vector<unsigned char> d_lastCommand;
+
+        /**
+         * \brief True to keep the last command and result.
+         */
+        bool d_retainLastExchange;
+
+        /**
+         * \brief A queued asynchronous command.
+         */
+        struct PendingCommand
+        {
+            std::vector<unsigned char> command;
+            long int timeout;
+            CommandHandler handler;
+        };
+
+        /**
+         * \brief The asynchronous command queue. It is shared with the completion
+         * handlers so that the transport can be destroyed from the last one.
+         */
+        struct AsyncQueue
+        {
+            AsyncQueue() : owner(NULL), busy(false), users(0) {}
+
+            std::mutex mutex;
+
+            std::condition_variable cond;
+
+            /**
+             * The transport, reset on destruction. Completion handlers only use it through this pointer.
+             */
+            DataTransport* owner;
+
+            std::deque<PendingCommand> commands;
+
+            /**
+             * True while a command is being exchanged, synchronously or not.
+             */
+            bool busy;
+
+            /**
+             * The thread running a completion handler, which may send synchronous commands.
+             */
+            std::thread::id handlerThread;
+
+            /**
+             * Completion handlers starting the next command on the transport.
+             */
+            int users;
+        };
+
+        /**
+         * \brief The state of one asynchronous exchange, to tell a completion in the starting call apart.
+         */
+        struct AsyncStep
+        {
+            AsyncStep() : returned(false), completed(false) {}
+
+            bool returned;
+
+            bool completed;
+        };
+
+        /**
+         * \brief Complete an asynchronous command and go on with the queue.
+         */
+        static void completeAsync(std::shared_ptr<AsyncQueue> queue, std::shared_ptr<AsyncStep> step, CommandHandler handler,
+                                  std::exception_ptr error, const std::vector<unsigned char>& res);
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+        std::shared_ptr<AsyncQueue> d_asyncQueue;
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
     };
 }
 
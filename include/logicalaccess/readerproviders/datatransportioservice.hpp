@@ -0,0 +1,78 @@
+/**
+ * \file datatransportioservice.hpp
+ * \brief I/O service shared by the network data transports.
+ */
+
+#ifndef LOGICALACCESS_DATATRANSPORTIOSERVICE_HPP
+#define LOGICALACCESS_DATATRANSPORTIOSERVICE_HPP
+
+#include "logicalaccess/logicalaccess_api.hpp"
+
+#include <boost/asio.hpp>
+#include <memory>
+#include <thread>
+
+namespace logicalaccess
+{
+    /**
+     * \brief A boost::asio I/O service run by a single background thread.
+     *
+     * The network data transports create their sockets on this service so that
+     * the asynchronous commands of every networked reader are driven by the same
+     * thread. Completion handlers are invoked from that thread and must not
+     * block, nor issue synchronous commands.
+     */
+    class LIBLOGICALACCESS_API DataTransportIOService
+    {
+    public:
+
+        /**
+         * \brief Constructor. Start the I/O thread.
+         */
+        DataTransportIOService();
+
+        /**
+         * \brief Destructor. Stop the I/O thread, pending operations are abandoned.
+         */
+        ~DataTransportIOService();
+
+        /**
+         * \brief Get the service shared by all data transports.
+         */
+        static std::shared_ptr<DataTransportIOService> getInstance();
+
+        /**
+         * \brief Get the underlying I/O service.
+         * \return The I/O service.
+         */
+        boost::asio::io_service& getIOService() { return ios_; }
+
+        /**
+         * \brief Check if the caller runs on the I/O thread.
+         * \return True if called from a completion handler, false otherwise.
+         */
+        bool isIOThread() const;
+
+    protected:
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+        boost::asio::io_service ios_;
+
+        /**
+         * Keep the I/O thread running while no operation is pending.
+         */
+        std::unique_ptr<boost::asio::io_service::work> work_;
+
+        std::thread thread_;
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+    };
+}
+
+#endif /* LOGICALACCESS_DATATRANSPORTIOSERVICE_HPP */
@@ -0,0 +1,198 @@
+/**
+ * \file readerpollscheduler.hpp
+ * \brief Shared poll scheduler for reader units without insertion/removal notification.
+ */
+
+#ifndef LOGICALACCESS_READERPOLLSCHEDULER_HPP
+#define LOGICALACCESS_READERPOLLSCHEDULER_HPP
+
+#include "logicalaccess/logicalaccess_api.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace logicalaccess
+{
+    /**
+     * \brief Poll intervals used by the poll scheduler, in milliseconds.
+     *
+     * A reader is first polled firstDelay after the registration, then every
+     * minInterval during the fastPeriod following the registration, when a card
+     * is the most likely to show up (or go away). The interval then doubles on
+     * each unsuccessful poll until maxInterval.
+     */
+    struct LIBLOGICALACCESS_API ReaderPollProfile
+    {
+        ReaderPollProfile(unsigned int min = 20, unsigned int max = 250, unsigned int fast = 2000, unsigned int first = 0)
+            : minInterval(min), maxInterval(max), fastPeriod(fast), firstDelay(first) {}
+
+        unsigned int minInterval;
+
+        unsigned int maxInterval;
+
+        unsigned int fastPeriod;
+
+        unsigned int firstDelay;
+    };
+
+    /**
+     * \brief Multiplex the polling of many reader units onto a shared thread pool.
+     *
+     * Reader units register a "poll once" hook returning true when the awaited
+     * condition (card inserted, card removed) is met. Hooks of a same registration
+     * are never run concurrently.
+     *
+     * Hooks usually block on the reader I/O, so the pool grows up to one thread
+     * per live registration, within the maximum thread count: a slow reader does
+     * not delay the polling of another until the cap is reached. Threads in excess
+     * of the live registrations exit once their poll completes.
+     */
+    class LIBLOGICALACCESS_API ReaderPollScheduler
+    {
+    public:
+        typedef std::function<bool()> PollHook;
+        typedef std::function<void(bool)> CompletionHandler;
+
+        /**
+         * \brief Constructor.
+         * \param threads The initial number of polling threads, the pool never shrinks below it.
+         * \param maxThreads The maximum number of polling threads.
+         */
+        explicit ReaderPollScheduler(unsigned int threads = 2, unsigned int maxThreads = 8);
+
+        /**
+         * \brief Destructor. Pending polls complete as failed.
+         */
+        ~ReaderPollScheduler();
+
+        /**
+         * \brief Get the scheduler shared by all reader units.
+         */
+        static std::shared_ptr<ReaderPollScheduler> getInstance();
+
+        /**
+         * \brief Poll a hook until it succeeds or the timeout expires.
+         * \param hook The poll hook.
+         * \param completion Called from a polling thread with true if the hook succeeded, false on timeout, error or cancellation.
+         * \param maxwait The maximum time to poll for, in milliseconds. If maxwait is zero, poll forever.
+         * \param profile The poll intervals.
+         * \return The registration identifier, to use with cancel().
+         */
+        int schedule(PollHook hook, CompletionHandler completion, unsigned int maxwait,
+                     const ReaderPollProfile& profile = ReaderPollProfile());
+
+        /**
+         * \brief Stop polling a registration. Its completion handler is called with false.
+         * \param id The registration identifier.
+         */
+        void cancel(int id);
+
+        /**
+         * \brief Get the current number of polling threads.
+         */
+        unsigned int getThreadCount();
+
+        /**
+         * \brief Poll a hook until it succeeds or the timeout expires, blocking the caller.
+         * Prefer schedule() with a completion handler, and never call it from a hook or
+         * a completion handler: it would hold a polling thread.
+         * \param hook The poll hook. An exception thrown by the hook is rethrown to the caller.
+         * \param maxwait The maximum time to poll for, in milliseconds. If maxwait is zero, poll forever.
+         * \param profile The poll intervals.
+         * \return True if the hook succeeded, false on timeout.
+         */
+        bool waitFor(PollHook hook, unsigned int maxwait, const ReaderPollProfile& profile = ReaderPollProfile());
+
+    protected:
+
+        typedef std::chrono::steady_clock Clock;
+
+        struct PollEntry
+        {
+            int id;
+            PollHook hook;
+            CompletionHandler completion;
+            ReaderPollProfile profile;
+            Clock::time_point start;
+            Clock::time_point deadline;
+            bool infinite;
+            unsigned int interval;
+            bool cancelled;
+        };
+
+        /**
+         * Polling thread main loop.
+         */
+        void run();
+
+        /**
+         * Compute the next poll time of an entry after an unsuccessful poll.
+         */
+        Clock::time_point next_poll(PollEntry& entry, Clock::time_point now);
+
+        /**
+         * Start a polling thread if there are less threads than registrations, up to the
+         * maximum thread count. Called with mutex_ held.
+         */
+        void grow();
+
+        /**
+         * Start a polling thread. Called with mutex_ held.
+         */
+        void startThread();
+
+        /**
+         * Whether there are more threads than needed, the calling thread then exits. Called with mutex_ held.
+         */
+        bool shrink();
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+        std::mutex mutex_;
+
+        std::condition_variable cond_;
+
+        /**
+         * Pending registrations, by next poll time.
+         */
+        std::multimap<Clock::time_point, std::shared_ptr<PollEntry>> queue_;
+
+        /**
+         * All live registrations, including the ones being polled.
+         */
+        std::map<int, std::shared_ptr<PollEntry>> entries_;
+
+        /**
+         * Running polling threads.
+         */
+        std::map<std::thread::id, std::thread> threads_;
+
+        /**
+         * Polling threads which exited, joined on the next growth or at destruction.
+         */
+        std::vector<std::thread> exited_;
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+        unsigned int min_threads_;
+
+        unsigned int max_threads_;
+
+        int next_id_;
+
+        bool stopping_;
+    };
+}
+
+#endif /* LOGICALACCESS_READERPOLLSCHEDULER_HPP */
@@ -9,6 +9,7 @@
 
 #include <stdint.h>
 #include <boost/property_tree/ptree_fwd.hpp>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -89,6 +90,27 @@ namespace logicalaccess
          */
         virtual bool waitRemoval(unsigned int maxwait) = 0;
 
+        /**
+         * \brief Handler of an asynchronous wait, called with true if the card was inserted (or removed), false otherwise.
+         */
+        typedef std::function<void(bool)> WaitHandler;
+
+        /**
+         * \brief Wait for a card insertion without blocking the caller.
+         * \param maxwait The maximum time to wait for, in milliseconds. If maxwait is zero, then the call never times out.
+         * \param handler Called with the result of the wait, usually from another thread.
+         * \remarks The default implementation runs waitInsertion() on a dedicated thread, polled reader units use the shared poll scheduler instead.
+         */
+        virtual void waitInsertionAsync(unsigned int maxwait, WaitHandler handler);
+
+        /**
+         * \brief Wait for a card removal without blocking the caller.
+         * \param maxwait The maximum time to wait for, in milliseconds. If maxwait is zero, then the call never times out.
+         * \param handler Called with the result of the wait, usually from another thread.
+         * \remarks The default implementation runs waitRemoval() on a dedicated thread, polled reader units use the shared poll scheduler instead.
+         */
+        virtual void waitRemovalAsync(unsigned int maxwait, WaitHandler handler);
+
         /**
          * \brief Check if the card is connected.
          * \return True if the card is connected, false otherwise.
@@ -19,6 +19,7 @@
 #include <boost/circular_buffer.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include <condition_variable>
+#include <functional>
 
 #include "logicalaccess/readerproviders/readerunit.hpp"
 #include "logicalaccess/readerproviders/circularbufferparser.hpp"
@@ -188,7 +189,25 @@ namespace logicalaccess
          */
         void dataConsumed();
 
+        typedef std::function<void(bool)> DataHandler;
+
+        /**
+         * Asynchronous counterpart of waitMoreData(): `handler` is called from
+         * the serial port thread with true once more data are available, or
+         * with false after `timeout` milliseconds or when the port is closed.
+         *
+         * Only one wait can be pending at a time.
+         */
+        void asyncWaitMoreData(long int timeout, DataHandler handler);
+
     private:
+        void do_wait_timeout(const boost::system::error_code& error);
+
+        /**
+         * Complete the pending asynchronous wait, if any.
+         */
+        void complete_wait(bool available);
+
         void do_read(const boost::system::error_code& e, std::size_t bytes_transferred);
 
         void do_close(const boost::system::error_code& error);
@@ -207,6 +226,8 @@ namespace logicalaccess
 
         boost::asio::serial_port m_serial_port;
 
+        boost::asio::deadline_timer m_wait_timer;
+
         boost::circular_buffer<unsigned char> m_circular_read_buffer;
 
         std::vector<unsigned char> m_read_buffer;
@@ -224,6 +245,11 @@ namespace logicalaccess
         std::condition_variable cond_var_;
         bool data_flag_;
         std::mutex cond_var_mutex_;
+
+        /**
+         * The pending asynchronous wait handler, guarded by cond_var_mutex_.
+         */
+        DataHandler data_handler_;
     };
 }
 
@@ -118,6 +118,21 @@ namespace logicalaccess
 
     protected:
 
+        /**
+         * \brief Exchange a command with the reader, the answer is awaited on the serial port thread.
+         * \param command The command buffer, empty to only receive.
+         * \param timeout The command timeout.
+         * \param handler The completion handler.
+         */
+        virtual void exchangeAsync(const std::vector<unsigned char>& command, long int timeout, CommandHandler handler);
+
+        /**
+         * \brief Wait for the answer without blocking the caller.
+         * \param until The time the answer is expected before.
+         * \param handler The completion handler.
+         */
+        void receiveAsync(const std::chrono::steady_clock::time_point& until, CommandHandler handler);
+
         /**
          * \brief The auto-detected status
          */
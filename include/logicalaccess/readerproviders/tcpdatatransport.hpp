@@ -8,6 +8,7 @@
 #define LOGICALACCESS_TCPDATATRANSPORT_HPP
 
 #include "logicalaccess/readerproviders/datatransport.hpp"
+#include "logicalaccess/readerproviders/datatransportioservice.hpp"
 #include <boost/asio.hpp>
 #include <boost/asio/deadline_timer.hpp>
 
@@ -123,51 +124,95 @@ namespace logicalaccess
          */
         virtual std::vector<unsigned char> receive(long int timeout);
 
-		/**
-         * \brief Connect complete
-		 * \param error Read error
+    protected:
+
+        typedef std::function<void(const boost::system::error_code&)> ConnectHandler;
+
+        typedef std::function<void(const boost::system::error_code&, const std::vector<unsigned char>&)> ReceiveHandler;
+
+        /**
+         * \brief The socket and its timer, shared with the pending operations so that
+         * the transport can be destroyed before they complete.
          */
-		void connect_complete(const boost::system::error_code& error);
+        struct AsyncSocket
+        {
+            explicit AsyncSocket(std::shared_ptr<DataTransportIOService> ios)
+                : service(ios), socket(ios->getIOService()), timer(ios->getIOService()), closed(false) {}
 
-		/**
-         * \brief Read complete
-		 * \param error Read error
-		 * \param bytes_transferred Byte transfered
+            /**
+             * \brief The I/O service the socket is bound to.
+             */
+            std::shared_ptr<DataTransportIOService> service;
+
+            /**
+             * \brief TCP Socket
+             */
+            boost::asio::ip::tcp::socket socket;
+
+            /**
+             * \brief Read Deadline timer
+             */
+            boost::asio::deadline_timer timer;
+
+            /**
+             * \brief True once the transport is destroyed, the socket is not connected again.
+             */
+            bool closed;
+        };
+
+        /**
+         * \brief Exchange a command with the reader on the I/O service thread.
+         * \param command The command buffer, empty to only receive.
+         * \param timeout The command timeout.
+         * \param handler The completion handler.
          */
-		void read_complete(const boost::system::error_code& error, size_t bytes_transferred);
+        virtual void exchangeAsync(const std::vector<unsigned char>& command, long int timeout, CommandHandler handler);
 
-		/**
-         * \brief Read timeout
-		 * \param error Read timeout or canceled
+        /**
+         * \brief Start connecting, the connection is canceled after the timeout.
+         * \param async The socket.
+         * \param ipAddress The ip address.
+         * \param port The port.
+         * \param timeout Time after the connect task will be canceled.
+         * \param handler The completion handler.
          */
-	    void time_out(const boost::system::error_code& error);
+        static void async_connect(std::shared_ptr<AsyncSocket> async, const std::string& ipAddress, int port, long int timeout, ConnectHandler handler);
 
-    protected:
+        /**
+         * \brief Start receiving a packet, the read is canceled after the timeout.
+         * \param async The socket.
+         * \param timeout Time waiting for data.
+         * \param handler The completion handler.
+         */
+        static void async_receive(std::shared_ptr<AsyncSocket> async, long int timeout, ReceiveHandler handler);
 
         /**
-         * \brief Provides core I/O functionality
+         * \brief Cancel the pending socket operation after the timeout.
+         * \param async The socket.
+         * \param timeout The timeout in milliseconds.
          */
-        boost::asio::io_service d_ios;
+        static void arm_timer(std::shared_ptr<AsyncSocket> async, long int timeout);
 
         /**
-         * \brief TCP Socket
+         * \brief Throw if a synchronous operation would block the I/O service thread.
          */
-		boost::asio::ip::tcp::socket d_socket;
+        void check_not_io_thread();
 
-		/**
-         * \brief Read Deadline timer
+        /**
+         * \brief Run a socket operation on the I/O service thread and wait for it, inline when already on it.
+         * \param operation The operation, it must not throw.
          */
-		boost::asio::deadline_timer d_timer;
+        void run_on_io_thread(std::function<void()> operation);
 
-		/**
-         * \brief Read error
+        /**
+         * \brief The I/O service the socket is bound to.
          */
-		bool d_read_error;
+        std::shared_ptr<DataTransportIOService> d_service;
 
-		/**
-         * \brief Byte Readed
+        /**
+         * \brief The socket, only used from the I/O service thread.
          */
-		size_t d_bytes_transferred;
+        std::shared_ptr<AsyncSocket> d_async;
 
         /**
          * \brief The ip address
@@ -8,6 +8,7 @@
 #define LOGICALACCESS_UDPDATATRANSPORT_HPP
 
 #include "logicalaccess/readerproviders/datatransport.hpp"
+#include "logicalaccess/readerproviders/datatransportioservice.hpp"
 #include <boost/asio.hpp>
 
 namespace logicalaccess
@@ -113,15 +114,35 @@ namespace logicalaccess
 
     protected:
 
+        /**
+         * \brief Exchange a command with the reader on the I/O service thread.
+         * \param command The command buffer, empty to only receive.
+         * \param timeout The command timeout.
+         * \param handler The completion handler.
+         */
+        virtual void exchangeAsync(const std::vector<unsigned char>& command, long int timeout, CommandHandler handler);
+
+        /**
+         * \brief Start receiving a datagram, the read is canceled after the timeout.
+         * \param timeout Time waiting for data.
+         * \param handler The completion handler.
+         */
+        void async_receive(long int timeout, CommandHandler handler);
+
+        /**
+         * \brief The I/O service the socket is bound to.
+         */
+        std::shared_ptr<DataTransportIOService> d_service;
+
         /**
          * \brief Client socket use to communicate with the reader.
          */
         std::shared_ptr<boost::asio::ip::udp::socket> d_socket;
 
         /**
-         * \brief Provides core I/O functionality
+         * \brief Asynchronous receive deadline timer.
          */
-        boost::asio::io_service ios;
+        boost::asio::deadline_timer d_timer;
 
         /**
          * \brief The ip address
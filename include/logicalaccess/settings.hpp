@@ -7,6 +7,9 @@
 #ifndef LOGICALACCESS_SETTINGS_HPP
 #define LOGICALACCESS_SETTINGS_HPP
 
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -25,12 +28,49 @@ extern HMODULE __hLibLogicalAccessModule;
 
 namespace logicalaccess
 {
+    /**
+     * \brief The library settings.
+     *
+     * The settings are read through an immutable snapshot, published atomically
+     * each time they change, so that readers from any thread never lock nor see
+     * a partially updated value. getInstance() gives the editable values, a
+     * direct modification is visible to the readers once published with
+     * publish(), update() modifies and publishes at once.
+     */
     class LIBLOGICALACCESS_API Settings
     {
     public:
 
         static Settings* getInstance();
 
+        /**
+         * \brief Get the current settings. The snapshot is never modified, a new one is published on change.
+         * \return The settings snapshot.
+         */
+        static std::shared_ptr<const Settings> getSnapshot();
+
+        /**
+         * \brief Modify the settings and publish them.
+         * \param modifier The function modifying the settings.
+         */
+        static void update(const std::function<void(Settings&)>& modifier);
+
+        /**
+         * \brief Enable or disable the logs and publish the settings. The log file is left open.
+         * \param enabled True to enable the logs, false otherwise.
+         */
+        static void setLogEnabled(bool enabled);
+
+        /**
+         * \brief Reload the settings from the configuration file and publish them, then open, reopen or close the log file to match.
+         */
+        static void reload();
+
+        /**
+         * \brief Publish the instance values as the current snapshot, after fields were modified directly.
+         */
+        void publish();
+
         void Initialize();
         static void Uninitialize();
 
@@ -45,6 +85,21 @@ namespace logicalaccess
         bool ColorizeLog;
         bool ContextLog;
 
+        /**
+         * Rotate the log file when it exceeds this size in bytes, 0 to disable.
+         */
+        long int LogMaxFileSize;
+
+        /**
+         * Rotate the log file after this number of seconds, 0 to disable.
+         */
+        long int LogRotationInterval;
+
+        /**
+         * The number of rotated log files kept.
+         */
+        int LogMaxFiles;
+
         /* Auto-Detection */
         bool IsAutoDetectEnabled;
         long int AutoDetectionTimeout;
@@ -80,6 +135,15 @@ namespace logicalaccess
     private:
 
         void reset();
+
+        /**
+         * \brief Open, reopen or close the log file according to the published settings.
+         */
+        void applyLogSettings();
+
+        static std::shared_ptr<const Settings>& snapshot();
+
+        static std::mutex& updateMutex();
     };
 }
 
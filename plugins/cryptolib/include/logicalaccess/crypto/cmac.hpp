@@ -2,6 +2,7 @@
 #include <memory>
 #include "logicalaccess/crypto/openssl.hpp"
 #include "logicalaccess/crypto/openssl_symmetric_cipher.hpp"
+#include "logicalaccess/crypto/keyed_cipher_context.hpp"
 
 #ifndef CMAC_HPP__
 #define CMAC_HPP__
@@ -46,6 +47,88 @@ namespace logicalaccess
 
         private:
         };
+
+        /**
+         * \brief A CMAC context keyed once and reused for many messages.
+         *
+         * The cipher context and the K1/K2 subkeys are computed at construction, each CMAC then only pads the
+         * message into an internal buffer and ciphers it.
+         */
+        class CMACContext
+        {
+        public:
+
+            /**
+             * \brief Constructor.
+             * \param cipherMAC The CBC cipher to use (DES or AES).
+             * \param key The key to use.
+             */
+            CMACContext(std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipherMAC, const std::vector<unsigned char>& key);
+
+            CMACContext(const CMACContext&) = delete;
+            CMACContext& operator=(const CMACContext&) = delete;
+
+            /**
+             * \brief Get the block size.
+             * \return The block size.
+             */
+            size_t blockSize() const { return d_context->blockSize(); }
+
+            /**
+             * \brief Get the key.
+             * \return The key data.
+             */
+            const std::vector<unsigned char>& getKey() const { return d_context->getKey(); }
+
+            /**
+             * \brief Get the underlying cipher context, to cipher or decipher with the same key.
+             * \return The cipher context.
+             */
+            KeyedCipherContext& getCipherContext() { return *d_context; }
+
+            /**
+             * \brief Calculate the CMAC of a message.
+             * \param data The message.
+             * \param length The message length.
+             * \param iv The initialisation vector, of blockSize() bytes.
+             * \param mac The last ciphered block, of blockSize() bytes.
+             * \param padding_size The padding size, 0 for the block size.
+             * \param forceK2Use Whether to use K2 even without padding.
+             */
+            void cmac(const unsigned char* data, size_t length, const unsigned char* iv, unsigned char* mac, unsigned int padding_size = 0, bool forceK2Use = false);
+
+            /**
+             * \brief Calculate the CMAC of a message.
+             * \param data The message.
+             * \param iv The initialisation vector.
+             * \param padding_size The padding size, 0 for the block size.
+             * \param forceK2Use Whether to use K2 even without padding.
+             * \return The last ciphered block.
+             */
+            std::vector<unsigned char> cmac(const std::vector<unsigned char>& data, const std::vector<unsigned char>& iv, unsigned int padding_size = 0, bool forceK2Use = false);
+
+        private:
+
+            /**
+             * \brief The keyed cipher context.
+             */
+            std::unique_ptr<KeyedCipherContext> d_context;
+
+            /**
+             * \brief The K1 subkey.
+             */
+            std::vector<unsigned char> d_k1;
+
+            /**
+             * \brief The K2 subkey.
+             */
+            std::vector<unsigned char> d_k2;
+
+            /**
+             * \brief The padded message, kept to reuse its storage.
+             */
+            std::vector<unsigned char> d_buffer;
+        };
     }
 }
 
@@ -0,0 +1,77 @@
+/**
+ * \file crc.hpp
+ * \brief CRC functions.
+ */
+
+#ifndef CRC_HPP
+#define CRC_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace logicalaccess
+{
+    /**
+     * \brief Table driven CRC functions, processing 8 bytes per step (slicing-by-8).
+     *
+     * Each function returns the CRC register; the two bytes of a CRC-16 are
+     * transmitted low byte first unless the protocol says otherwise.
+     */
+    namespace crc
+    {
+        /**
+         * \brief Get the ISO/IEC 14443-A CRC (CRC_A, initial value 0x6363).
+         * \param data The data.
+         * \param length The data length.
+         * \return The CRC.
+         */
+        uint16_t crc_a(const void* data, size_t length);
+
+        /**
+         * \brief Get the ISO/IEC 14443-B CRC (CRC_B, ISO 3309, initial value 0xFFFF, inverted).
+         * \param data The data.
+         * \param length The data length.
+         * \return The CRC.
+         */
+        uint16_t crc_b(const void* data, size_t length);
+
+        /**
+         * \brief Get the Kermit CRC (reflected 0x1021, initial value 0).
+         * \param data The data.
+         * \param length The data length.
+         * \return The CRC.
+         */
+        uint16_t kermit(const void* data, size_t length);
+
+        /**
+         * \brief Update a CCITT CRC (0x1021, most significant bit first).
+         * \param crc The initial value, 0xFFFF or 0x1D0F for instance.
+         * \param data The data.
+         * \param length The data length.
+         * \return The CRC.
+         */
+        uint16_t ccitt(uint16_t crc, const void* data, size_t length);
+
+        /**
+         * \brief Update an IEEE 802.3 CRC32 register, without the initial and final inversions.
+         * \param crc The register value, 0xFFFFFFFF to start.
+         * \param data The data.
+         * \param length The data length.
+         * \return The register value.
+         */
+        uint32_t crc32_update(uint32_t crc, const void* data, size_t length);
+
+        /**
+         * \brief Get the IEEE 802.3 CRC32.
+         * \param data The data.
+         * \param length The data length.
+         * \return The CRC.
+         */
+        inline uint32_t crc32(const void* data, size_t length)
+        {
+            return ~crc32_update(0xFFFFFFFF, data, length);
+        }
+    }
+}
+
+#endif /* CRC_HPP */
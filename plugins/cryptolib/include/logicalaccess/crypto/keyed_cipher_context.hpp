@@ -0,0 +1,124 @@
+/**
+ * \file keyed_cipher_context.hpp
+ * \brief Reusable keyed OpenSSL cipher context.
+ */
+
+#ifndef KEYED_CIPHER_CONTEXT_HPP
+#define KEYED_CIPHER_CONTEXT_HPP
+
+#include "logicalaccess/crypto/openssl_symmetric_cipher.hpp"
+#include <vector>
+
+#include <openssl/evp.h>
+
+namespace logicalaccess
+{
+    namespace openssl
+    {
+        /**
+         * \brief A cipher context keyed once and reused for many operations.
+         *
+         * Unlike OpenSSLSymmetricCipher::cipher(), the key schedule is computed once at construction: each operation
+         * only sets the initialization vector and processes the blocks, without padding, into a caller-provided buffer.
+         */
+        class KeyedCipherContext
+        {
+        public:
+
+            /**
+             * \brief Constructor.
+             * \param cipher The cipher, giving the algorithm and the encryption mode.
+             * \param key The key to use.
+             */
+            KeyedCipherContext(const OpenSSLSymmetricCipher& cipher, const SymmetricKey& key);
+
+            /**
+             * \brief Destructor.
+             */
+            ~KeyedCipherContext();
+
+            KeyedCipherContext(const KeyedCipherContext&) = delete;
+            KeyedCipherContext& operator=(const KeyedCipherContext&) = delete;
+
+            /**
+             * \brief Get the block size.
+             * \return The block size.
+             */
+            size_t blockSize() const { return d_blockSize; }
+
+            /**
+             * \brief Get the key.
+             * \return The key data.
+             */
+            const std::vector<unsigned char>& getKey() const { return d_key; }
+
+            /**
+             * \brief Cipher a buffer.
+             * \param src The buffer to cipher, a multiple of the block size.
+             * \param length The buffer length.
+             * \param dest The ciphered buffer, of length bytes. Can be src.
+             * \param iv The initialisation vector, of blockSize() bytes.
+             */
+            void cipher(const unsigned char* src, size_t length, unsigned char* dest, const unsigned char* iv);
+
+            /**
+             * \brief Decipher a buffer.
+             * \param src The buffer to decipher, a multiple of the block size.
+             * \param length The buffer length.
+             * \param dest The deciphered buffer, of length bytes. Can be src.
+             * \param iv The initialisation vector, of blockSize() bytes.
+             */
+            void decipher(const unsigned char* src, size_t length, unsigned char* dest, const unsigned char* iv);
+
+            /**
+             * \brief Cipher a buffer.
+             * \param src The buffer to cipher, a multiple of the block size.
+             * \param dest The ciphered buffer. Its storage is reused.
+             * \param iv The initialisation vector.
+             */
+            void cipher(const std::vector<unsigned char>& src, std::vector<unsigned char>& dest, const std::vector<unsigned char>& iv);
+
+            /**
+             * \brief Decipher a buffer.
+             * \param src The buffer to decipher, a multiple of the block size.
+             * \param dest The deciphered buffer. Its storage is reused.
+             * \param iv The initialisation vector.
+             */
+            void decipher(const std::vector<unsigned char>& src, std::vector<unsigned char>& dest, const std::vector<unsigned char>& iv);
+
+        private:
+
+            /**
+             * \brief Run an operation on one of the contexts.
+             * \param ctx The keyed context.
+             * \param src The source buffer.
+             * \param length The buffer length.
+             * \param dest The destination buffer.
+             * \param iv The initialisation vector.
+             */
+            void process(EVP_CIPHER_CTX* ctx, const unsigned char* src, size_t length, unsigned char* dest, const unsigned char* iv);
+
+            /**
+             * \brief The encryption context.
+             */
+            EVP_CIPHER_CTX* d_encrypt;
+
+            /**
+             * \brief The decryption context.
+             */
+            EVP_CIPHER_CTX* d_decrypt;
+
+            /**
+             * \brief The block size.
+             */
+            size_t d_blockSize;
+
+            /**
+             * \brief The key data.
+             */
+            std::vector<unsigned char> d_key;
+        };
+    }
+}
+
+#endif /* KEYED_CIPHER_CONTEXT_HPP */
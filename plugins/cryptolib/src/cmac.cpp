@@ -12,6 +12,8 @@
 #include "logicalaccess/crypto/des_initialization_vector.hpp"
 #include "logicalaccess/bufferhelper.hpp"
 
+#include <cstring>
+
 namespace logicalaccess
 {
     namespace openssl
@@ -194,5 +196,67 @@ namespace logicalaccess
 
             return ret;
         }
+
+        CMACContext::CMACContext(std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipherMAC, const std::vector<unsigned char>& key)
+        {
+            EXCEPTION_ASSERT_WITH_LOG(cipherMAC, std::invalid_argument, "The CMAC cipher cannot be null.");
+
+            if (std::dynamic_pointer_cast<openssl::DESCipher>(cipherMAC))
+            {
+                d_context.reset(new KeyedCipherContext(*cipherMAC, openssl::DESSymmetricKey::createFromData(key)));
+            }
+            else
+            {
+                d_context.reset(new KeyedCipherContext(*cipherMAC, openssl::AESSymmetricKey::createFromData(key)));
+            }
+
+            unsigned char Rb = (d_context->blockSize() == 8) ? 0x1b : 0x87;
+
+            std::vector<unsigned char> blankbuf(d_context->blockSize(), 0x00);
+            std::vector<unsigned char> L;
+            d_context->cipher(blankbuf, L, blankbuf);
+
+            d_k1 = CMACCrypto::shift_string(L, (L[0] & 0x80) ? Rb : 0x00);
+            d_k2 = CMACCrypto::shift_string(d_k1, (d_k1[0] & 0x80) ? Rb : 0x00);
+        }
+
+        void CMACContext::cmac(const unsigned char* data, size_t length, const unsigned char* iv, unsigned char* mac, unsigned int padding_size, bool forceK2Use)
+        {
+            size_t block_size = d_context->blockSize();
+            if (padding_size == 0)
+            {
+                padding_size = static_cast<unsigned int>(block_size);
+            }
+
+            size_t pad = (padding_size - (length % padding_size)) % padding_size;
+            if (length == 0)
+                pad = padding_size;
+
+            d_buffer.assign(data, data + length);
+            if (pad > 0)
+            {
+                d_buffer.push_back(0x80);
+                d_buffer.resize(d_buffer.size() + pad - 1, 0x00);
+            }
+
+            const std::vector<unsigned char>& K = (pad == 0 && !forceK2Use) ? d_k1 : d_k2;
+            unsigned char* last = &d_buffer[d_buffer.size() - block_size];
+            for (size_t i = 0; i < block_size; ++i)
+            {
+                last[i] = static_cast<unsigned char>(last[i] ^ K[i]);
+            }
+
+            d_context->cipher(&d_buffer[0], d_buffer.size(), &d_buffer[0], iv);
+            memcpy(mac, &d_buffer[d_buffer.size() - block_size], block_size);
+        }
+
+        std::vector<unsigned char> CMACContext::cmac(const std::vector<unsigned char>& data, const std::vector<unsigned char>& iv, unsigned int padding_size, bool forceK2Use)
+        {
+            EXCEPTION_ASSERT_WITH_LOG(iv.size() >= d_context->blockSize(), std::invalid_argument, "The initialization vector is too short.");
+
+            std::vector<unsigned char> mac(d_context->blockSize());
+            cmac(data.empty() ? NULL : &data[0], data.size(), &iv[0], &mac[0], padding_size, forceK2Use);
+            return mac;
+        }
     }
 }
\ No newline at end of file
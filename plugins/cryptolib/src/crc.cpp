@@ -0,0 +1,147 @@
+/**
+ * \file crc.cpp
+ * \brief CRC functions.
+ */
+
+#include "logicalaccess/crypto/crc.hpp"
+
+namespace logicalaccess
+{
+    namespace crc
+    {
+        namespace
+        {
+            /**
+             * \brief Slicing-by-8 tables: table[k][b] is the CRC of byte b followed by k zero bytes.
+             */
+            struct Tables
+            {
+                uint32_t table[8][256];
+            };
+
+            /**
+             * \brief Build the tables of a reflected (least significant bit first) CRC.
+             */
+            Tables reflected_tables(uint32_t poly)
+            {
+                Tables t;
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    uint32_t crc = i;
+                    for (int j = 0; j < 8; ++j)
+                    {
+                        crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+                    }
+                    t.table[0][i] = crc;
+                }
+                for (int k = 1; k < 8; ++k)
+                {
+                    for (uint32_t i = 0; i < 256; ++i)
+                    {
+                        uint32_t crc = t.table[k - 1][i];
+                        t.table[k][i] = (crc >> 8) ^ t.table[0][crc & 0xff];
+                    }
+                }
+                return t;
+            }
+
+            /**
+             * \brief Build the tables of a 16-bit CRC, most significant bit first.
+             */
+            Tables msb16_tables(uint16_t poly)
+            {
+                Tables t;
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    uint16_t crc = static_cast<uint16_t>(i << 8);
+                    for (int j = 0; j < 8; ++j)
+                    {
+                        crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ poly) : static_cast<uint16_t>(crc << 1);
+                    }
+                    t.table[0][i] = crc;
+                }
+                for (int k = 1; k < 8; ++k)
+                {
+                    for (uint32_t i = 0; i < 256; ++i)
+                    {
+                        uint32_t crc = t.table[k - 1][i];
+                        t.table[k][i] = ((crc << 8) ^ t.table[0][(crc >> 8) & 0xff]) & 0xffff;
+                    }
+                }
+                return t;
+            }
+
+            const Tables& crc16_reflected()
+            {
+                static const Tables tables = reflected_tables(0x8408);
+                return tables;
+            }
+
+            const Tables& crc16_ccitt()
+            {
+                static const Tables tables = msb16_tables(0x1021);
+                return tables;
+            }
+
+            const Tables& crc32_ieee()
+            {
+                static const Tables tables = reflected_tables(0xEDB88320);
+                return tables;
+            }
+
+            /**
+             * \brief Update a reflected CRC, of up to 32 bits.
+             */
+            uint32_t update_reflected(const Tables& t, uint32_t crc, const unsigned char* p, size_t length)
+            {
+                for (; length >= 8; length -= 8, p += 8)
+                {
+                    uint32_t one = crc ^ (p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24));
+                    crc = t.table[7][one & 0xff] ^ t.table[6][(one >> 8) & 0xff] ^ t.table[5][(one >> 16) & 0xff] ^ t.table[4][one >> 24]
+                        ^ t.table[3][p[4]] ^ t.table[2][p[5]] ^ t.table[1][p[6]] ^ t.table[0][p[7]];
+                }
+                for (; length > 0; --length, ++p)
+                {
+                    crc = (crc >> 8) ^ t.table[0][(crc ^ *p) & 0xff];
+                }
+                return crc;
+            }
+        }
+
+        uint16_t crc_a(const void* data, size_t length)
+        {
+            return static_cast<uint16_t>(update_reflected(crc16_reflected(), 0x6363, static_cast<const unsigned char*>(data), length));
+        }
+
+        uint16_t crc_b(const void* data, size_t length)
+        {
+            return static_cast<uint16_t>(~update_reflected(crc16_reflected(), 0xFFFF, static_cast<const unsigned char*>(data), length));
+        }
+
+        uint16_t kermit(const void* data, size_t length)
+        {
+            return static_cast<uint16_t>(update_reflected(crc16_reflected(), 0x0000, static_cast<const unsigned char*>(data), length));
+        }
+
+        uint16_t ccitt(uint16_t crc, const void* data, size_t length)
+        {
+            const Tables& t = crc16_ccitt();
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            for (; length >= 8; length -= 8, p += 8)
+            {
+                crc = static_cast<uint16_t>(t.table[7][p[0] ^ (crc >> 8)] ^ t.table[6][p[1] ^ (crc & 0xff)] ^ t.table[5][p[2]] ^ t.table[4][p[3]]
+                    ^ t.table[3][p[4]] ^ t.table[2][p[5]] ^ t.table[1][p[6]] ^ t.table[0][p[7]]);
+            }
+            for (; length > 0; --length, ++p)
+            {
+                crc = static_cast<uint16_t>((crc << 8) ^ t.table[0][((crc >> 8) ^ *p) & 0xff]);
+            }
+            return crc;
+        }
+
+        uint32_t crc32_update(uint32_t crc, const void* data, size_t length)
+        {
+            return update_reflected(crc32_ieee(), crc, static_cast<const unsigned char*>(data), length);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/**
+ * \file keyed_cipher_context.cpp
+ * \brief Reusable keyed OpenSSL cipher context.
+ */
+
+#include "logicalaccess/crypto/keyed_cipher_context.hpp"
+#include "logicalaccess/crypto/openssl.hpp"
+#include "logicalaccess/crypto/openssl_exception.hpp"
+#include "logicalaccess/crypto/symmetric_key.hpp"
+#include "logicalaccess/logs.hpp"
+#include "logicalaccess/myexception.hpp"
+
+#include <stdexcept>
+
+namespace logicalaccess
+{
+    namespace openssl
+    {
+        KeyedCipherContext::KeyedCipherContext(const OpenSSLSymmetricCipher& cipher, const SymmetricKey& key) :
+            d_encrypt(NULL), d_decrypt(NULL), d_blockSize(0), d_key(key.data())
+        {
+            OpenSSLInitializer::GetInstance();
+
+            const EVP_CIPHER* evpCipher = cipher.getEVPCipher(key);
+            EXCEPTION_ASSERT_WITH_LOG(evpCipher, std::invalid_argument, "No cipher found that can use the supplied key");
+
+            d_encrypt = EVP_CIPHER_CTX_new();
+            d_decrypt = EVP_CIPHER_CTX_new();
+            if (!d_encrypt || !d_decrypt
+                || EVP_EncryptInit_ex(d_encrypt, evpCipher, NULL, &d_key[0], NULL) != 1
+                || EVP_DecryptInit_ex(d_decrypt, evpCipher, NULL, &d_key[0], NULL) != 1)
+            {
+                EVP_CIPHER_CTX_free(d_encrypt);
+                EVP_CIPHER_CTX_free(d_decrypt);
+                THROW_EXCEPTION_WITH_LOG(OpenSSLException, "Cannot initialize the cipher context.");
+            }
+
+            EVP_CIPHER_CTX_set_padding(d_encrypt, 0);
+            EVP_CIPHER_CTX_set_padding(d_decrypt, 0);
+            d_blockSize = EVP_CIPHER_CTX_block_size(d_encrypt);
+        }
+
+        KeyedCipherContext::~KeyedCipherContext()
+        {
+            EVP_CIPHER_CTX_free(d_encrypt);
+            EVP_CIPHER_CTX_free(d_decrypt);
+        }
+
+        void KeyedCipherContext::cipher(const unsigned char* src, size_t length, unsigned char* dest, const unsigned char* iv)
+        {
+            process(d_encrypt, src, length, dest, iv);
+        }
+
+        void KeyedCipherContext::decipher(const unsigned char* src, size_t length, unsigned char* dest, const unsigned char* iv)
+        {
+            process(d_decrypt, src, length, dest, iv);
+        }
+
+        void KeyedCipherContext::cipher(const std::vector<unsigned char>& src, std::vector<unsigned char>& dest, const std::vector<unsigned char>& iv)
+        {
+            EXCEPTION_ASSERT_WITH_LOG(iv.size() >= static_cast<size_t>(EVP_CIPHER_CTX_iv_length(d_encrypt)), std::invalid_argument, "The initialization vector is too short.");
+
+            dest.resize(src.size());
+            if (!src.empty())
+            {
+                process(d_encrypt, &src[0], src.size(), &dest[0], iv.empty() ? NULL : &iv[0]);
+            }
+        }
+
+        void KeyedCipherContext::decipher(const std::vector<unsigned char>& src, std::vector<unsigned char>& dest, const std::vector<unsigned char>& iv)
+        {
+            EXCEPTION_ASSERT_WITH_LOG(iv.size() >= static_cast<size_t>(EVP_CIPHER_CTX_iv_length(d_decrypt)), std::invalid_argument, "The initialization vector is too short.");
+
+            dest.resize(src.size());
+            if (!src.empty())
+            {
+                process(d_decrypt, &src[0], src.size(), &dest[0], iv.empty() ? NULL : &iv[0]);
+            }
+        }
+
+        void KeyedCipherContext::process(EVP_CIPHER_CTX* ctx, const unsigned char* src, size_t length, unsigned char* dest, const unsigned char* iv)
+        {
+            EXCEPTION_ASSERT_WITH_LOG(length % d_blockSize == 0, std::invalid_argument, "The data length must be a multiple of the block size.");
+
+            int outlen = 0, finallen = 0;
+            // Only the IV is set, the key schedule is kept from the construction.
+            if (EVP_CipherInit_ex(ctx, NULL, NULL, NULL, iv, -1) != 1
+                || EVP_CipherUpdate(ctx, dest, &outlen, src, static_cast<int>(length)) != 1
+                || EVP_CipherFinal_ex(ctx, dest + outlen, &finallen) != 1)
+            {
+                THROW_EXCEPTION_WITH_LOG(OpenSSLException, "OpenSSL Error.");
+            }
+        }
+    }
+}
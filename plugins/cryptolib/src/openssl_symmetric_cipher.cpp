@@ -69,7 +69,10 @@ namespace logicalaccess
             int r = 0;
             int outlen = 0;
 
-            unsigned char* buf = new unsigned char[src.size() + context.blockSize()];
+            // Write in place at the end of the context data, no intermediate buffer.
+            size_t offset = context.data().size();
+            context.data().resize(offset + src.size() + context.blockSize());
+            unsigned char* buf = &context.data()[offset];
 
             switch (context.method())
             {
@@ -91,12 +94,11 @@ namespace logicalaccess
 
             if (r != 1)
             {
-                delete[] buf;
+                context.data().resize(offset);
                 THROW_EXCEPTION_WITH_LOG(OpenSSLException, "");
             }
 
-            context.data().insert(context.data().end(), buf, buf + outlen);
-            delete[] buf;
+            context.data().resize(offset + outlen);
         }
 
         std::vector<unsigned char> OpenSSLSymmetricCipher::stop(OpenSSLSymmetricCipherContext& context)
@@ -104,18 +106,19 @@ namespace logicalaccess
             int r = 0;
             int outlen = 0;
 
-            unsigned char* buf = new unsigned char[context.blockSize()];
+            size_t offset = context.data().size();
+            context.data().resize(offset + context.blockSize());
 
             switch (context.method())
             {
             case M_ENCRYPT:
             {
-                r = EVP_EncryptFinal_ex(context.ctx(), buf, &outlen);
+                r = EVP_EncryptFinal_ex(context.ctx(), &context.data()[offset], &outlen);
                 break;
             }
             case M_DECRYPT:
             {
-                r = EVP_DecryptFinal_ex(context.ctx(), buf, &outlen);
+                r = EVP_DecryptFinal_ex(context.ctx(), &context.data()[offset], &outlen);
                 break;
             }
             default:
@@ -126,14 +129,14 @@ namespace logicalaccess
 
             if (r != 1)
             {
-                delete[] buf;
+                context.data().resize(offset);
                 THROW_EXCEPTION_WITH_LOG(OpenSSLException, "OpenSSL Error.");
             }
 
-            context.data().insert(context.data().end(), buf, buf + outlen);
-            delete[] buf;
+            context.data().resize(offset + outlen);
 
-            std::vector<unsigned char> data = context.data();
+            std::vector<unsigned char> data;
+            data.swap(context.data());
 
             context.reset();
 
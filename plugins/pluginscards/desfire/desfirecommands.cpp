@@ -35,7 +35,7 @@ namespace logicalaccess
         DESFireCommands::FileSetting fileSetting;
         memset(&fileSetting, 0x00, sizeof(fileSetting));
 
-        getFileSettings(fileno, fileSetting);
+        getCachedFileSettings(fileno, fileSetting);
 
 		return getEncryptionMode(fileSetting, isReadMode, needLoadKey);
     }
@@ -83,7 +83,7 @@ namespace logicalaccess
 
         DESFireCommands::FileSetting fileSetting;
         memset(&fileSetting, 0x00, sizeof(fileSetting));
-        getFileSettings(fileno, fileSetting);
+        getCachedFileSettings(fileno, fileSetting);
 
         switch (fileSetting.fileType)
         {
@@ -96,4 +96,19 @@ namespace logicalaccess
 
         return fileLength;
     }
+
+    std::vector<std::vector<unsigned char> > DESFireCommands::readFiles(const std::vector<FileRead>& files)
+    {
+        std::vector<std::vector<unsigned char> > ret;
+        for (std::vector<FileRead>::const_iterator file = files.begin(); file != files.end(); ++file)
+        {
+            ret.push_back(readData(file->fileno, file->offset, file->length, file->mode));
+        }
+        return ret;
+    }
+
+    void DESFireCommands::getCachedFileSettings(unsigned char fileno, FileSetting& fileSetting)
+    {
+        getFileSettings(fileno, fileSetting);
+    }
 }
\ No newline at end of file
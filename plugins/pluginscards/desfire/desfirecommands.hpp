@@ -184,6 +184,17 @@ namespace logicalaccess
             } type; /**< \brief The file type specific information */
         };
 
+        /**
+         * \brief Describe a part of a file to read, see readFiles().
+         */
+        struct FileRead
+        {
+            unsigned char		fileno; /**< \brief The file number */
+            unsigned int		offset; /**< \brief The byte offset */
+            unsigned int		length; /**< \brief The data length to read, 0 for the whole file */
+            EncryptionMode		mode; /**< \brief The communication mode */
+        };
+
         /**
          * \brief Card information about software and hardware version.
          */
@@ -251,6 +262,13 @@ namespace logicalaccess
          */
         virtual unsigned int getFileLength(unsigned char fileno);
 
+        /**
+         * \brief Get settings of a specific file in the current application, from a cache when the command set keeps one.
+         * \param fileno The file number
+         * \param fileSetting The file setting
+         */
+        virtual void getCachedFileSettings(unsigned char fileno, FileSetting& fileSetting);
+
         /**
          * \brief Select an application.
          * \param aid The Application ID
@@ -387,6 +405,13 @@ namespace logicalaccess
          */
         virtual std::vector<unsigned char> readData(unsigned char fileno, unsigned int offset, unsigned int length, EncryptionMode mode) = 0;
 
+        /**
+         * \brief Read data from several files of the current application.
+         * \param files The parts of the files to read, in order.
+         * \return The bytes readed, one buffer per file part.
+         */
+        virtual std::vector<std::vector<unsigned char> > readFiles(const std::vector<FileRead>& files);
+
         /**
          * \brief Write data into a specific file.
          * \param fileno The file number
@@ -8,7 +8,7 @@
 #include "desfirecrypto.hpp"
 #include "desfireev1location.hpp"
 #include "logicalaccess/crypto/tomcrypt.h"
-#include <boost/crc.hpp>
+#include "logicalaccess/crypto/crc.hpp"
 #include <ctime>
 #include <cstdlib>
 
@@ -23,6 +23,7 @@
 #include "logicalaccess/crypto/des_initialization_vector.hpp"
 #include "logicalaccess/crypto/cmac.hpp"
 #include "logicalaccess/myexception.hpp"
+#include "logicalaccess/cards/keydiversificationcache.hpp"
 
 namespace logicalaccess
 {
@@ -31,6 +32,7 @@ namespace logicalaccess
         d_auth_method = CM_LEGACY;
         d_currentAid = 0;
         d_currentKeyNo = 0;
+        d_applicationSelected = false;
         d_mac_size = 4;
         d_block_size = 8;
         d_keys.clear();
@@ -41,11 +43,27 @@ namespace logicalaccess
 
     DESFireCrypto::~DESFireCrypto()
     {
+        // The chip is released on removal, wipe its diversified keys.
+        KeyDiversificationCache::getInstance().removeCard(d_identifier);
     }
 
     void DESFireCrypto::appendDecipherData(const std::vector<unsigned char>& data)
     {
         d_buf.insert(d_buf.end(), data.begin(), data.end());
+
+        if (d_auth_method != CM_LEGACY)
+        {
+            // CBC deciphering only depends on the previous block, decipher the complete blocks now.
+            size_t length = d_buf.size() - (d_buf.size() % d_block_size);
+            if (length > 0)
+            {
+                size_t offset = d_deciphered.size();
+                d_deciphered.resize(offset + length);
+                getCipherContext(d_sessionKey, d_cipher).getCipherContext().decipher(&d_buf[0], length, &d_deciphered[offset], &d_lastIV[0]);
+                d_lastIV.assign(d_buf.begin() + length - d_block_size, d_buf.begin() + length);
+                d_buf.erase(d_buf.begin(), d_buf.begin() + length);
+            }
+        }
     }
 
 	std::vector<unsigned char> DESFireCrypto::desfireDecrypt(size_t length)
@@ -58,7 +76,10 @@ namespace logicalaccess
         }
         else
         {
-            ret = desfire_iso_decrypt(d_sessionKey, d_buf, d_cipher, d_block_size, length);
+            EXCEPTION_ASSERT_WITH_LOG(d_buf.empty() && !d_deciphered.empty(), LibLogicalAccessException, "The encrypted data length must be a multiple of the block size.");
+
+            ret.swap(d_deciphered);
+            desfire_iso_check_deciphered(ret, length);
         }
 
         return ret;
@@ -67,6 +88,7 @@ namespace logicalaccess
     void DESFireCrypto::initBuf()
     {
         d_buf.clear();
+        d_deciphered.clear();
         d_last_left.clear();
         if (d_auth_method == CM_LEGACY)
         {
@@ -80,27 +102,44 @@ namespace logicalaccess
         bool ret = false;
         d_buf.insert(d_buf.end(), data.begin(), data.end());
 
-        if (end)
+        if (d_auth_method != CM_LEGACY)
         {
-            if (d_auth_method == CM_LEGACY)	// Native DESFire mode
+            // The last 8 bytes may be the MAC. The complete blocks before them are never the last CMAC block,
+            // the status byte comes after them, so chain them now.
+            if (d_buf.size() >= d_block_size + 8)
+            {
+                size_t length = ((d_buf.size() - 8) / d_block_size) * d_block_size;
+                getCipherContext(d_sessionKey, d_cipher).getCipherContext().cipher(&d_buf[0], length, &d_buf[0], &d_lastIV[0]);
+                d_lastIV.assign(d_buf.begin() + length - d_block_size, d_buf.begin() + length);
+                d_buf.erase(d_buf.begin(), d_buf.begin() + length);
+            }
+
+            if (end)
             {
-                std::vector<unsigned char> mac;
-                mac.insert(mac.end(), d_buf.end() - 4, d_buf.end());
-                std::vector<unsigned char> ourMacBuf;
-                ourMacBuf.insert(ourMacBuf.end(), d_buf.begin(), d_buf.end() - 4);
-                std::vector<unsigned char> ourMac = desfire_mac(d_sessionKey, ourMacBuf);
+                EXCEPTION_ASSERT_WITH_LOG(d_buf.size() >= 8, LibLogicalAccessException, "The MACed data is too short.");
+
+                std::vector<unsigned char> mac(d_buf.end() - 8, d_buf.end());
+                d_buf.resize(d_buf.size() - 8);
+                d_buf.push_back(0x00); // SW_OPERATION_OK
+                std::vector<unsigned char> ourMac = desfire_cmac(d_sessionKey, d_cipher, d_block_size, d_buf);
                 ret = (mac == ourMac);
+
+                d_buf.clear();
             }
             else
             {
-                std::vector<unsigned char> mac;
-                mac.insert(mac.end(), d_buf.end() - 8, d_buf.end());
-                std::vector<unsigned char> ourMacBuf;
-                ourMacBuf.insert(ourMacBuf.end(), d_buf.begin(), d_buf.end() - 8);
-                ourMacBuf.push_back(0x00); // SW_OPERATION_OK
-                std::vector<unsigned char> ourMac = desfire_cmac(d_sessionKey, d_cipher, d_block_size, ourMacBuf);
-                ret = (mac == ourMac);
+                ret = true;
             }
+        }
+        else if (end)
+        {
+            // Native DESFire mode
+            std::vector<unsigned char> mac;
+            mac.insert(mac.end(), d_buf.end() - 4, d_buf.end());
+            std::vector<unsigned char> ourMacBuf;
+            ourMacBuf.insert(ourMacBuf.end(), d_buf.begin(), d_buf.end() - 4);
+            std::vector<unsigned char> ourMac = desfire_mac(d_sessionKey, ourMacBuf);
+            ret = (mac == ourMac);
 
             d_buf.clear();
         }
@@ -148,21 +187,13 @@ namespace logicalaccess
 
     short DESFireCrypto::desfire_crc16(const void* data, size_t dataLength)
     {
-        unsigned char first, second;
-
-        ComputeCrc(CRC_A, reinterpret_cast<const unsigned char*>(data), dataLength, &first, &second);
-
-        return ((second << 8) | first);
+        return static_cast<short>(crc::crc_a(data, dataLength));
     }
 
     uint32_t DESFireCrypto::desfire_crc32(const void* data, size_t dataLength)
     {
-		boost::crc_32_type result;
-		result.process_bytes(data, dataLength);
-		uint32_t crc = result.checksum();
-		crc ^= 0xffffffff;
-		crc = (-1 * (crc ^ 0xffffffff)) - 1;
-		return crc;
+        // DESFire uses the CRC32 register without the final inversion.
+        return crc::crc32_update(0xFFFFFFFF, data, dataLength);
     }
 
     /**
@@ -590,7 +621,7 @@ namespace logicalaccess
         if (key->getKeyDiversification() && diversify.size() != 0)
         {
             LOG(LogLevel::INFOS) << "Use key diversification.";
-            keydiv = key->getKeyDiversification()->getDiversifiedKey(key, diversify);
+            keydiv = key->getKeyDiversification()->getCachedDiversifiedKey(key, diversify, d_identifier);
         }
         else
         {
@@ -630,8 +661,14 @@ namespace logicalaccess
 
         d_auth_method = CM_LEGACY;
         d_cipher.reset();
+        d_cipherContext.reset();
+        d_cipherContextCipher.reset();
         d_currentKeyNo = 0;
         d_sessionKey.clear();
+
+        d_applicationSelected = true;
+        d_authenticatedKey.reset();
+        d_authenticatedSessionKey.clear();
     }
 
     std::vector<unsigned char> DESFireCrypto::changeKey_PICC(uint8_t keyno, std::vector<unsigned char> oldKeyDiversify, std::shared_ptr<DESFireKey> newkey, std::vector<unsigned char> newKeyDiversify, unsigned char keysetno)
@@ -907,26 +944,30 @@ namespace logicalaccess
 
     std::vector<unsigned char> DESFireCrypto::desfire_cmac(const std::vector<unsigned char>& key, std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipherMAC, unsigned int block_size, const std::vector<unsigned char>& data)
     {
-        std::vector<unsigned char> ret = openssl::CMACCrypto::cmac(key, cipherMAC, block_size, data, d_lastIV, block_size);
+        std::vector<unsigned char> ret = getCipherContext(key, cipherMAC).cmac(data, d_lastIV, block_size);
 
         if (cipherMAC == d_cipher)
         {
-            d_lastIV = std::vector<unsigned char>(ret.end() - block_size, ret.end());
+            d_lastIV = ret;
         }
 
-        // DES
-        if (block_size == 8)
-        {
-            ret = std::vector<unsigned char>(ret.end() - 8, ret.end());
-        }
-        else
-        {
-            ret = std::vector<unsigned char>(ret.end() - 16, ret.end() - 8);
-        }
+        // DES uses the whole block, AES its first 8 bytes.
+        ret.resize(8);
 
         return ret;
     }
 
+    openssl::CMACContext& DESFireCrypto::getCipherContext(const std::vector<unsigned char>& key, std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipher)
+    {
+        assert(cipher);
+        if (!d_cipherContext || d_cipherContextCipher != cipher || d_cipherContext->getKey() != key)
+        {
+            d_cipherContext.reset(new openssl::CMACContext(cipher, key));
+            d_cipherContextCipher = cipher;
+        }
+        return *d_cipherContext;
+    }
+
     std::vector<unsigned char> DESFireCrypto::desfire_iso_decrypt(const std::vector<unsigned char>& data, size_t length)
     {
         return desfire_iso_decrypt(d_sessionKey, data, d_cipher, d_block_size, length);
@@ -935,27 +976,20 @@ namespace logicalaccess
     std::vector<unsigned char> DESFireCrypto::desfire_iso_decrypt(const std::vector<unsigned char>& key, const std::vector<unsigned char>& data, std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipher, unsigned int block_size, size_t datalen)
     {
         std::vector<unsigned char> decdata;
-        std::shared_ptr<openssl::SymmetricKey> isokey;
-        std::shared_ptr<openssl::InitializationVector> iv;
-
-        if (std::dynamic_pointer_cast<openssl::AESCipher>(cipher))
-        {
-            isokey.reset(new openssl::AESSymmetricKey(openssl::AESSymmetricKey::createFromData(key)));
-            iv.reset(new openssl::AESInitializationVector(openssl::AESInitializationVector::createFromData(d_lastIV)));
-        }
-        else
-        {
-            isokey.reset(new openssl::DESSymmetricKey(openssl::DESSymmetricKey::createFromData(key)));
-            iv.reset(new openssl::DESInitializationVector(openssl::DESInitializationVector::createFromData(d_lastIV)));
-        }
 
         assert(cipher);
-        cipher->decipher(data, decdata, *isokey, *iv, false);
+        getCipherContext(key, cipher).getCipherContext().decipher(data, decdata, d_lastIV);
         if (cipher == d_cipher)
         {
             d_lastIV = std::vector<unsigned char>(data.end() - block_size, data.end());
         }
 
+        desfire_iso_check_deciphered(decdata, datalen);
+        return decdata;
+    }
+
+    void DESFireCrypto::desfire_iso_check_deciphered(std::vector<unsigned char>& decdata, size_t datalen)
+    {
         size_t ll = 0;
 
         if (datalen == 0)
@@ -998,7 +1032,6 @@ namespace logicalaccess
         EXCEPTION_ASSERT_WITH_LOG(crc1 == crc2 && padding == padding1, LibLogicalAccessException, ss.str());
 
         decdata.resize(ll);
-        return decdata;
     }
 
     std::vector<unsigned char> DESFireCrypto::iso_encipherData(bool end, const std::vector<unsigned char>& data, const std::vector<unsigned char>& param)
@@ -1039,19 +1072,7 @@ namespace logicalaccess
 
         if (decdata.size() > 0)
         {
-            std::shared_ptr<openssl::SymmetricKey> isokey;
-            std::shared_ptr<openssl::InitializationVector> iv;
-            if (std::dynamic_pointer_cast<openssl::AESCipher>(d_cipher))
-            {
-                isokey.reset(new openssl::AESSymmetricKey(openssl::AESSymmetricKey::createFromData(d_sessionKey)));
-                iv.reset(new openssl::AESInitializationVector(openssl::AESInitializationVector::createFromData(d_lastIV)));
-            }
-            else
-            {
-                isokey.reset(new openssl::DESSymmetricKey(openssl::DESSymmetricKey::createFromData(d_sessionKey)));
-                iv.reset(new openssl::DESInitializationVector(openssl::DESInitializationVector::createFromData(d_lastIV)));
-            }
-            d_cipher->cipher(decdata, encdata, *isokey, *iv, false);
+            getCipherContext(d_sessionKey, d_cipher).getCipherContext().cipher(decdata, encdata, d_lastIV);
             d_lastIV = std::vector<unsigned char>(encdata.end() - d_block_size, encdata.end());
         }
 
@@ -1083,19 +1104,7 @@ namespace logicalaccess
             decdata.push_back(0x00);
         }
 
-        std::shared_ptr<openssl::SymmetricKey> isokey;
-        std::shared_ptr<openssl::InitializationVector> iv;
-        if (std::dynamic_pointer_cast<openssl::AESCipher>(cipher))
-        {
-            isokey.reset(new openssl::AESSymmetricKey(openssl::AESSymmetricKey::createFromData(key)));
-            iv.reset(new openssl::AESInitializationVector(openssl::AESInitializationVector::createFromData(d_lastIV)));
-        }
-        else
-        {
-            isokey.reset(new openssl::DESSymmetricKey(openssl::DESSymmetricKey::createFromData(key)));
-            iv.reset(new openssl::DESInitializationVector(openssl::DESInitializationVector::createFromData(d_lastIV)));
-        }
-        cipher->cipher(decdata, encdata, *isokey, *iv, false);
+        getCipherContext(key, cipher).getCipherContext().cipher(decdata, encdata, d_lastIV);
         if (cipher == d_cipher)
         {
             d_lastIV = std::vector<unsigned char>(encdata.end() - block_size, encdata.end());
@@ -1106,8 +1115,13 @@ namespace logicalaccess
 
     void DESFireCrypto::setCryptoContext(std::vector<unsigned char> identifier)
     {
+        if (d_identifier != identifier)
+        {
+            KeyDiversificationCache::getInstance().removeCard(d_identifier);
+        }
         d_identifier = identifier;
 		clearKeys();
+		invalidateSession();
     }
 
     std::shared_ptr<DESFireKey> DESFireCrypto::getKey(uint8_t keyset, uint8_t keyno) const
@@ -1192,7 +1206,7 @@ namespace logicalaccess
 		if (it == d_keys.end())
 			return false;
 
-		DESFireCrypto::getKey(it->second, diversify, keydiv);
+		getKey(it->second, diversify, keydiv);
 
 		return true;
 	}
@@ -1202,6 +1216,42 @@ namespace logicalaccess
 		d_keys[std::make_tuple(aid, keyslot, keyno)] = std::make_shared<DESFireKey>(*key);
 	}
 
+	bool DESFireCrypto::isApplicationSelected(size_t aid) const
+	{
+		return d_applicationSelected && static_cast<size_t>(d_currentAid) == aid;
+	}
+
+	bool DESFireCrypto::isAuthenticated(size_t aid, uint8_t keyno, std::shared_ptr<DESFireKey> key) const
+	{
+		// A new authentication always negotiates a new session key, whatever the command used.
+		if (!isApplicationSelected(aid) || d_currentKeyNo != keyno || !key || !d_authenticatedKey
+			|| d_sessionKey.empty() || d_sessionKey != d_authenticatedSessionKey)
+			return false;
+
+		// Stored keys are copies sharing the key storage and diversification of the original.
+		if (*d_authenticatedKey != *key || d_authenticatedKey->getKeyDiversification() != key->getKeyDiversification())
+			return false;
+
+		std::shared_ptr<KeyStorage> authenticatedStorage = d_authenticatedKey->getKeyStorage();
+		std::shared_ptr<KeyStorage> storage = key->getKeyStorage();
+		return authenticatedStorage == storage
+			|| (authenticatedStorage && storage
+				&& authenticatedStorage->getType() == KST_COMPUTER_MEMORY && storage->getType() == KST_COMPUTER_MEMORY);
+	}
+
+	void DESFireCrypto::setAuthenticatedKey(std::shared_ptr<DESFireKey> key)
+	{
+		d_authenticatedKey = key;
+		d_authenticatedSessionKey = d_sessionKey;
+	}
+
+	void DESFireCrypto::invalidateSession()
+	{
+		d_applicationSelected = false;
+		d_authenticatedKey.reset();
+		d_authenticatedSessionKey.clear();
+	}
+
 	void DESFireCrypto::setKeyInAllKeySet(size_t aid, uint8_t keySlotNb, uint8_t nbKeys, std::shared_ptr<DESFireKey> key)
 	{
 		for (auto x = 0; x < nbKeys; ++x)
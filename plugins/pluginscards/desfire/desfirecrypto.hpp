@@ -17,6 +17,11 @@
 
 namespace logicalaccess
 {
+    namespace openssl
+    {
+        class CMACContext;
+    }
+
     /**
      * \brief The cryptographic method.
      */
@@ -44,7 +49,7 @@ namespace logicalaccess
         virtual ~DESFireCrypto();
 
         /**
-         * \brief Decipher data step 2.
+         * \brief Decipher data step 2. In ISO mode, the complete blocks are deciphered right away.
          * \param data The data buffer
          */
 		void appendDecipherData(const std::vector<unsigned char>& data);
@@ -57,7 +62,8 @@ namespace logicalaccess
         virtual std::vector<unsigned char> desfireDecrypt(size_t length);
 
         /**
-         * \brief Verify MAC into the buffer.
+         * \brief Verify MAC into the buffer. In ISO mode, the CMAC is computed as the buffers come, only the
+         * bytes that can still be the last block are kept.
          * \param end True if it's the last buffer, false otherwise
          * \param data The data buffer
          * \return True on success, false otherwise.
@@ -203,6 +209,13 @@ namespace logicalaccess
          */
         std::vector<unsigned char> desfire_iso_decrypt(const std::vector<unsigned char>& data, size_t length);
 
+        /**
+         * \brief Verify the CRC and padding of deciphered data, and remove them.
+         * \param decdata The deciphered data
+         * \param datalen The excepted data length, or 0 to find it from the padding
+         */
+        void desfire_iso_check_deciphered(std::vector<unsigned char>& decdata, size_t datalen);
+
         /**
          * \brief  Return data part for the encrypted communication mode.
          * \param key The key to use, shall be the session key from the previous authentication
@@ -220,6 +233,14 @@ namespace logicalaccess
          */
         std::vector<unsigned char> desfire_cmac(const std::vector<unsigned char>& data);
 
+        /**
+         * \brief Get the cipher context for a key, reused as long as the key and the cipher do not change.
+         * \param key The key to use
+         * \param cipher The cipher to use
+         * \return The cipher context.
+         */
+        openssl::CMACContext& getCipherContext(const std::vector<unsigned char>& key, std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipher);
+
         /**
          * \brief Authenticate on the card, step 1 for mutual authentication.
          * \param keyno The key number to use
@@ -281,8 +302,9 @@ namespace logicalaccess
          * \param key The DESFire key information
          * \param diversify The diversify buffer, NULL if no diversification is needed
          * \param keydiv The key data, diversified if a diversify buffer is specified.
+         * \remarks Diversified keys are cached for the current card until it is removed.
          */
-        static void getKey(std::shared_ptr<DESFireKey> key, std::vector<unsigned char> diversify, std::vector<unsigned char>& keydiv);
+        void getKey(std::shared_ptr<DESFireKey> key, std::vector<unsigned char> diversify, std::vector<unsigned char>& keydiv);
 
         /**
          * \brief Get DES key versionned.
@@ -364,6 +386,34 @@ namespace logicalaccess
 		*/
 		std::shared_ptr<DESFireKey> getKey(uint8_t keyslot, uint8_t keyno) const;
 
+		/**
+		* \brief Check if an application is still selected on the card.
+		* \param aid The Application ID.
+		* \return True if selected, false otherwise.
+		*/
+		bool isApplicationSelected(size_t aid) const;
+
+		/**
+		* \brief Check if the current session is authenticated on an application with a key, so that
+		* the authentication can be skipped.
+		* \param aid The Application ID.
+		* \param keyno The key number.
+		* \param key The key.
+		* \return True if authenticated, false otherwise.
+		*/
+		bool isAuthenticated(size_t aid, uint8_t keyno, std::shared_ptr<DESFireKey> key) const;
+
+		/**
+		* \brief Remember the key used for the authentication just completed.
+		* \param key The key.
+		*/
+		void setAuthenticatedKey(std::shared_ptr<DESFireKey> key);
+
+		/**
+		* \brief Forget the selected application and the authentication, to be called when the card may have dropped them (error, key change).
+		*/
+		void invalidateSession();
+
 	protected:
 
 		/**
@@ -411,6 +461,13 @@ namespace logicalaccess
          */
         std::shared_ptr<openssl::OpenSSLSymmetricCipher> d_cipher;
 
+        /**
+         * \brief The last used cipher context, with its cipher.
+         */
+        std::shared_ptr<openssl::CMACContext> d_cipherContext;
+
+        std::shared_ptr<openssl::OpenSSLSymmetricCipher> d_cipherContextCipher;
+
         /**
          * \brief The MAC size.
          */
@@ -446,13 +503,33 @@ namespace logicalaccess
          */
         unsigned char d_currentKeyNo;
 
+        /**
+         * \brief True if the current Application ID is known to be selected on the card.
+         */
+        bool d_applicationSelected;
+
+        /**
+         * \brief The key used for the current authentication.
+         */
+        std::shared_ptr<DESFireKey> d_authenticatedKey;
+
+        /**
+         * \brief The session key of the authentication done with d_authenticatedKey.
+         */
+        std::vector<unsigned char> d_authenticatedSessionKey;
+
     protected:
 
         /**
-         * \brief The temporised buffer.
+         * \brief The temporised buffer. In ISO mode, only holds the bytes not processed yet.
          */
         std::vector<unsigned char> d_buf;
 
+        /**
+         * \brief The data deciphered so far (ISO mode).
+         */
+        std::vector<unsigned char> d_deciphered;
+
         /**
          * \brief The last left buffer for card command.
          */
@@ -362,6 +362,22 @@ namespace logicalaccess
     {
         EXCEPTION_ASSERT_WITH_LOG(location, std::invalid_argument, "location cannot be null.");
 
+        std::shared_ptr<DESFireLocation> dfLocation = std::dynamic_pointer_cast<DESFireLocation>(location);
+        EXCEPTION_ASSERT_WITH_LOG(dfLocation, std::invalid_argument, "location must be a DESFireLocation.");
+
+        DESFireCommands::FileRead file;
+        file.fileno = static_cast<unsigned char>(dfLocation->file);
+        file.offset = dfLocation->byte;
+        file.length = static_cast<unsigned int>(dataLength);
+        file.mode = dfLocation->securityLevel;
+
+        return readFiles(location, aiToUse, std::vector<DESFireCommands::FileRead>(1, file)).front();
+    }
+
+    std::vector<std::vector<unsigned char> > DESFireStorageCardService::readFiles(std::shared_ptr<Location> location, std::shared_ptr<AccessInfo> aiToUse, std::vector<DESFireCommands::FileRead> files)
+    {
+        EXCEPTION_ASSERT_WITH_LOG(location, std::invalid_argument, "location cannot be null.");
+
         std::shared_ptr<DESFireLocation> dfLocation = std::dynamic_pointer_cast<DESFireLocation>(location);
         std::shared_ptr<DESFireAccessInfo> dfAiToUse = std::dynamic_pointer_cast<DESFireAccessInfo>(aiToUse);
 
@@ -375,32 +391,53 @@ namespace logicalaccess
 			dfAiToUse = std::dynamic_pointer_cast<DESFireAccessInfo>(getChip()->createAccessInfo());
         }
 
-		getDESFireChip()->getCrypto()->setDefaultKeysAt(dfLocation);
+        std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
+        std::shared_ptr<DESFireCommands> cmd = getDESFireChip()->getDESFireCommands();
+        try
+        {
+            crypto->setDefaultKeysAt(dfLocation);
 
-        getDESFireChip()->getDESFireCommands()->selectApplication(dfLocation);
+            // The session of a previous call is reused when still valid.
+            if (!crypto->isApplicationSelected(dfLocation->aid))
+            {
+                cmd->selectApplication(dfLocation);
+            }
 
-        bool needLoadKey = true;
-        EncryptionMode encMode = dfLocation->securityLevel;
-		if (encMode == CM_UNKNOWN || encMode == CM_PLAIN)
-        {
-            encMode = getDESFireChip()->getDESFireCommands()->getEncryptionMode(static_cast<unsigned char>(dfLocation->file), true, &needLoadKey);
-        }
+            bool needLoadKey = false;
+            for (std::vector<DESFireCommands::FileRead>::iterator file = files.begin(); file != files.end(); ++file)
+            {
+                bool fileNeedLoadKey = true;
+                if (file->mode == CM_UNKNOWN || file->mode == CM_PLAIN)
+                {
+                    file->mode = cmd->getEncryptionMode(file->fileno, true, &fileNeedLoadKey);
+                }
+                needLoadKey = needLoadKey || fileNeedLoadKey;
+            }
 
-        if (needLoadKey)
-        {
-			if (dfAiToUse->readKey && !dfAiToUse->readKey->isEmpty())
+            if (needLoadKey)
             {
-				getDESFireChip()->getCrypto()->setKey(dfLocation->aid, 0, dfAiToUse->readKeyno, dfAiToUse->readKey);
+                if (dfAiToUse->readKey && !dfAiToUse->readKey->isEmpty())
+                {
+                    crypto->setKey(dfLocation->aid, 0, dfAiToUse->readKeyno, dfAiToUse->readKey);
+                }
+                else if (dfAiToUse->readKeyno == TaskAccessRights::AR_KEY0 && dfAiToUse->masterApplicationKey && !dfAiToUse->masterApplicationKey->isEmpty())
+                {
+                    crypto->setKey(dfLocation->aid, 0, dfAiToUse->readKeyno, dfAiToUse->masterApplicationKey);
+                }
+
+                if (!crypto->isAuthenticated(dfLocation->aid, dfAiToUse->readKeyno, crypto->getKey(0, dfAiToUse->readKeyno)))
+                {
+                    cmd->authenticate(dfAiToUse->readKeyno);
+                }
             }
-			else if (dfAiToUse->readKeyno == TaskAccessRights::AR_KEY0 && dfAiToUse->masterApplicationKey && !dfAiToUse->masterApplicationKey->isEmpty())
-			{
-				getDESFireChip()->getCrypto()->setKey(dfLocation->aid, 0, dfAiToUse->readKeyno, dfAiToUse->masterApplicationKey);
-			}
 
-            getDESFireChip()->getDESFireCommands()->authenticate(dfAiToUse->readKeyno);
+            return cmd->readFiles(files);
+        }
+        catch (std::exception&)
+        {
+            crypto->invalidateSession();
+            throw;
         }
-		
-        return getDESFireChip()->getDESFireCommands()->readData(dfLocation->file, dfLocation->byte, (int)(dataLength), encMode);
     }
 
     unsigned int DESFireStorageCardService::readDataHeader(std::shared_ptr<Location> /*location*/, std::shared_ptr<AccessInfo> /*aiToUse*/, void* /*data*/, size_t /*dataLength*/)
@@ -59,6 +59,15 @@ namespace logicalaccess
          */
         virtual std::vector<unsigned char> readData(std::shared_ptr<Location> location, std::shared_ptr<AccessInfo> aiToUse, size_t dataLength, CardBehavior behaviorFlags);
 
+        /**
+         * \brief Read several files of the location application, authenticating once.
+         * \param location The data location, giving the application.
+         * \param aiToUse The key's informations to use for read access.
+         * \param files The files to read. A plain or unknown mode is resolved from the file settings.
+         * \return The data of each file, in the same order.
+         */
+        virtual std::vector<std::vector<unsigned char> > readFiles(std::shared_ptr<Location> location, std::shared_ptr<AccessInfo> aiToUse, std::vector<DESFireCommands::FileRead> files);
+
         /**
          * \brief Read data header on a specific location, using given keys.
          * \param location The data location.
@@ -18,9 +18,71 @@
 #include "logicalaccess/crypto/des_symmetric_key.hpp"
 #include "logicalaccess/crypto/des_initialization_vector.hpp"
 #include "logicalaccess/myexception.hpp"
+#include "logicalaccess/crypto/keyed_cipher_context.hpp"
 
 namespace logicalaccess
 {
+    namespace
+    {
+        /**
+         * \brief NXP AV1 diversification with the cipher keyed once.
+         */
+        class NXPAV1BatchContext : public KeyDiversification::BatchContext
+        {
+        public:
+            NXPAV1BatchContext(NXPAV1KeyDiversification& diversification, std::shared_ptr<DESFireKey> key)
+                : d_diversification(diversification), d_key(key), d_keydata(key->getData(), key->getData() + key->getLength())
+            {
+                if (key->getKeyType() == DESFireKeyType::DF_KEY_AES)
+                {
+                    d_context.reset(new openssl::KeyedCipherContext(openssl::AESCipher(), openssl::AESSymmetricKey::createFromData(d_keydata)));
+                }
+                else
+                {
+                    d_context.reset(new openssl::KeyedCipherContext(openssl::DESCipher(), openssl::DESSymmetricKey::createFromData(d_keydata)));
+                }
+                d_iv.resize(d_context->blockSize(), 0x00);
+            }
+
+            virtual std::vector<unsigned char> getDiversifiedKey(const std::vector<unsigned char>& diversify)
+            {
+                std::vector<unsigned char> divKey;
+                size_t bs = d_context->blockSize();
+                if (diversify.size() != bs || d_keydata.size() < 16)
+                {
+                    return d_diversification.getDiversifiedKey(d_key, diversify);
+                }
+
+                std::vector<unsigned char> block(bs), enc;
+                for (size_t x = 0; x < bs; ++x)
+                    block[x] = diversify[x] ^ d_keydata[x];
+                d_context->cipher(block, enc, d_iv);
+                divKey.insert(divKey.end(), enc.begin(), enc.end());
+
+                if (bs == 8)
+                {
+                    // 3DES: the second half is the first one ciphered again, xored with the key second half.
+                    for (size_t x = 0; x < bs; ++x)
+                        block[x] = enc[x] ^ d_keydata[x + 8];
+                    d_context->cipher(block, enc, d_iv);
+                    divKey.insert(divKey.end(), enc.begin(), enc.end());
+                }
+                return divKey;
+            }
+
+        private:
+            NXPAV1KeyDiversification& d_diversification;
+
+            std::shared_ptr<DESFireKey> d_key;
+
+            std::vector<unsigned char> d_keydata;
+
+            std::vector<unsigned char> d_iv;
+
+            std::unique_ptr<openssl::KeyedCipherContext> d_context;
+        };
+    }
+
     void NXPAV1KeyDiversification::initDiversification(std::vector<unsigned char> identifier, int AID,
                                                        std::shared_ptr<Key> key, unsigned char keyno,
                                                        std::vector<unsigned char>& diversify)
@@ -83,6 +145,11 @@ namespace logicalaccess
         return divKey;
     }
 
+    std::unique_ptr<KeyDiversification::BatchContext> NXPAV1KeyDiversification::createBatchContext(std::shared_ptr<Key> key)
+    {
+        return std::unique_ptr<BatchContext>(new NXPAV1BatchContext(*this, std::dynamic_pointer_cast<DESFireKey>(key)));
+    }
+
     void NXPAV1KeyDiversification::serialize(boost::property_tree::ptree& parentNode)
     {
         boost::property_tree::ptree node;
@@ -26,6 +26,12 @@ namespace logicalaccess
         virtual void unSerialize(boost::property_tree::ptree& node) override;
         virtual std::string getDefaultXmlNodeName() const { return "NXPAV1KeyDiversification"; };
 
+    protected:
+        /**
+         * \brief Key the cipher once per thread.
+         */
+        virtual std::unique_ptr<BatchContext> createBatchContext(std::shared_ptr<Key> key) override;
+
     private:
     };
 }
@@ -14,6 +14,79 @@
 
 namespace logicalaccess
 {
+    namespace
+    {
+        /**
+         * \brief NXP AV2 diversification with the CMAC keyed once.
+         */
+        class NXPAV2BatchContext : public KeyDiversification::BatchContext
+        {
+        public:
+            NXPAV2BatchContext(NXPAV2KeyDiversification& diversification, std::shared_ptr<DESFireKey> key)
+                : d_diversification(diversification), d_key(key), d_keyType(key->getKeyType()), d_forceK2Use(diversification.getForceK2Use())
+            {
+                std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipher;
+                if (d_keyType == DESFireKeyType::DF_KEY_DES || d_keyType == DESFireKeyType::DF_KEY_3K3DES)
+                {
+                    cipher.reset(new openssl::DESCipher());
+                }
+                else if (d_keyType == DESFireKeyType::DF_KEY_AES)
+                {
+                    cipher.reset(new openssl::AESCipher());
+                }
+                else
+                    THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, "NXP Diversification don't support this security");
+
+                d_context.reset(new openssl::CMACContext(cipher, std::vector<unsigned char>(key->getData(), key->getData() + key->getLength())));
+                d_iv.resize(d_context->blockSize(), 0x00);
+            }
+
+            virtual std::vector<unsigned char> getDiversifiedKey(const std::vector<unsigned char>& diversify)
+            {
+                std::vector<unsigned char> keydiv;
+                if (d_keyType == DESFireKeyType::DF_KEY_AES)
+                {
+                    d_buffer.assign(1, 0x01);
+                    d_buffer.insert(d_buffer.end(), diversify.begin(), diversify.end());
+                    keydiv = d_context->cmac(d_buffer, d_iv, 32, d_forceK2Use);
+                }
+                else if (diversify.size() >= 16)
+                {
+                    // Longer inputs keep more than the last block of each CMAC, see getDiversifiedKey.
+                    keydiv = d_diversification.getDiversifiedKey(d_key, diversify);
+                }
+                else
+                {
+                    unsigned char first = (d_keyType == DESFireKeyType::DF_KEY_DES) ? 0x21 : 0x31;
+                    unsigned char count = (d_keyType == DESFireKeyType::DF_KEY_DES) ? 2 : 3;
+                    for (unsigned char i = 0; i < count; ++i)
+                    {
+                        d_buffer.assign(1, static_cast<unsigned char>(first + i));
+                        d_buffer.insert(d_buffer.end(), diversify.begin(), diversify.end());
+                        std::vector<unsigned char> part = d_context->cmac(d_buffer, d_iv, 16, d_forceK2Use);
+                        keydiv.insert(keydiv.end(), part.begin(), part.end());
+                    }
+                }
+                return keydiv;
+            }
+
+        private:
+            NXPAV2KeyDiversification& d_diversification;
+
+            std::shared_ptr<DESFireKey> d_key;
+
+            DESFireKeyType d_keyType;
+
+            bool d_forceK2Use;
+
+            std::vector<unsigned char> d_iv;
+
+            std::vector<unsigned char> d_buffer;
+
+            std::unique_ptr<openssl::CMACContext> d_context;
+        };
+    }
+
     void NXPAV2KeyDiversification::initDiversification(std::vector<unsigned char> identifier, int AID, std::shared_ptr<Key> key, unsigned char keyno, std::vector<unsigned char>& diversify)
     {
         if (d_divInput.size() == 0)
@@ -117,6 +190,18 @@ namespace logicalaccess
         return keydiv;
     }
 
+    void NXPAV2KeyDiversification::appendCacheIdentity(std::shared_ptr<Key> key, std::vector<unsigned char>& identity)
+    {
+        // The other settings only change the diversification input.
+        identity.push_back(d_forceK2Use ? 0x01 : 0x00);
+        NXPKeyDiversification::appendCacheIdentity(key, identity);
+    }
+
+    std::unique_ptr<KeyDiversification::BatchContext> NXPAV2KeyDiversification::createBatchContext(std::shared_ptr<Key> key)
+    {
+        return std::unique_ptr<BatchContext>(new NXPAV2BatchContext(*this, std::dynamic_pointer_cast<DESFireKey>(key)));
+    }
+
     void NXPAV2KeyDiversification::serialize(boost::property_tree::ptree& parentNode)
     {
         boost::property_tree::ptree node;
@@ -42,6 +42,14 @@ namespace logicalaccess
 
         void setSystemIdentifier(std::vector<unsigned char> systemIdentifier) { d_systemIdentifier = systemIdentifier; }
 
+    protected:
+        virtual void appendCacheIdentity(std::shared_ptr<Key> key, std::vector<unsigned char>& identity) override;
+
+        /**
+         * \brief Key the CMAC once per thread.
+         */
+        virtual std::unique_ptr<BatchContext> createBatchContext(std::shared_ptr<Key> key) override;
+
     private:
 		bool d_revertAID;
 
@@ -1,5 +1,6 @@
 #include "logicalaccess/cards/keydiversification.hpp"
 #include "logicalaccess/key.hpp"
+#include "desfirekey.hpp"
 #include <vector>
 
 #ifndef NXPKEYDIVERSIFICATION_HPP__
@@ -24,6 +25,21 @@ namespace logicalaccess
         virtual void unSerialize(boost::property_tree::ptree& node) {};
         virtual std::string getDefaultXmlNodeName() const { return "NXPKeyDiversification"; };
 
+    protected:
+        /**
+         * \brief The key type selects the cipher and the version is set in the DES keys.
+         */
+        virtual void appendCacheIdentity(std::shared_ptr<Key> key, std::vector<unsigned char>& identity) override
+        {
+            std::shared_ptr<DESFireKey> desfirekey = std::dynamic_pointer_cast<DESFireKey>(key);
+            if (desfirekey)
+            {
+                identity.push_back(static_cast<unsigned char>(desfirekey->getKeyType()));
+                identity.push_back(desfirekey->getKeyVersion());
+            }
+            KeyDiversification::appendCacheIdentity(key, identity);
+        }
+
     private:
     };
 }
@@ -64,6 +64,17 @@ namespace logicalaccess
         return keydiv;
     }
 
+    void OmnitechKeyDiversification::appendCacheIdentity(std::shared_ptr<Key> key, std::vector<unsigned char>& identity)
+    {
+        // The key version is set in the diversified key.
+        std::shared_ptr<DESFireKey> desfirekey = std::dynamic_pointer_cast<DESFireKey>(key);
+        if (desfirekey)
+        {
+            identity.push_back(desfirekey->getKeyVersion());
+        }
+        KeyDiversification::appendCacheIdentity(key, identity);
+    }
+
     void OmnitechKeyDiversification::serialize(boost::property_tree::ptree& parentNode)
     {
         boost::property_tree::ptree node;
@@ -21,6 +21,9 @@ namespace logicalaccess
         virtual void serialize(boost::property_tree::ptree& parentNode);
         virtual void unSerialize(boost::property_tree::ptree& node);
         virtual std::string getDefaultXmlNodeName() const { return "OmnitechKeyDiversification"; };
+
+    protected:
+        virtual void appendCacheIdentity(std::shared_ptr<Key> key, std::vector<unsigned char>& identity) override;
     };
 }
 
@@ -131,8 +131,10 @@ void EPassCommand::cryptoChanged()
         epass_rca->setEPassCrypto(crypto_);
 }
 
-ByteVector EPassCommand::readBinary(uint16_t offset, uint8_t length)
+ByteVector EPassCommand::readBinary(uint16_t offset, uint16_t length)
 {
+    EXCEPTION_ASSERT_WITH_LOG(offset <= 0x7FFF, LibLogicalAccessException,
+                              "Read Binary offset is too big.");
     uint8_t p1 = 0;
     uint8_t p2 = 0;
     p1         = static_cast<uint8_t>(0x7f & (offset >> 8));
@@ -141,7 +143,7 @@ ByteVector EPassCommand::readBinary(uint16_t offset, uint8_t length)
     std::shared_ptr<ISO7816ReaderCardAdapter> rca =
         std::dynamic_pointer_cast<ISO7816ReaderCardAdapter>(getReaderCardAdapter());
     if (length)
-        return rca->sendAPDUCommand(0x00, 0xB0, p1, p2, length);
+        return rca->sendExtendedAPDUCommand(0x00, 0xB0, p1, p2, {}, length);
     else
         return rca->sendAPDUCommand(0x00, 0xB0, p1, p2);
 }
@@ -182,18 +184,23 @@ ByteVector EPassCommand::readEF(uint8_t size_bytes, uint8_t size_offset)
     for (int i = 0; i < size_bytes; ++i)
         length |= data[size_offset + i] << (size_bytes - i - 1) * 8;
 
+    std::shared_ptr<ISO7816ReaderCardAdapter> rca =
+        std::dynamic_pointer_cast<ISO7816ReaderCardAdapter>(getReaderCardAdapter());
+    // With secure messaging, a short response holds up to 223 bytes of plain data.
+    // Extended length APDU allow to read big files (e.g. DG2) in a few chunks.
+    uint16_t max_read = static_cast<uint16_t>(
+        (rca && rca->isExtendedLengthSupported()) ? 0x1000 : 0xDF);
+
     uint16_t offset = initial_read_len;
     while (length)
     {
-        // somehow reading more will cause invalid checksum.
-        // todo: investigate.
-        uint8_t to_read = static_cast<uint8_t>(length > 100 ? 100 : length);
-        data            = readBinary(offset, to_read);
+        uint16_t to_read = length > max_read ? max_read : length;
+        data             = readBinary(offset, to_read);
         EXCEPTION_ASSERT_WITH_LOG(data.size() == to_read, LibLogicalAccessException,
                                   "Wrong data size");
         ef_raw.insert(ef_raw.end(), data.begin(), data.end());
-        offset += (uint8_t)(data.size());
-        length -= (uint8_t)(data.size());
+        offset = static_cast<uint16_t>(offset + data.size());
+        length = static_cast<uint16_t>(length - data.size());
     }
     return ef_raw;
 }
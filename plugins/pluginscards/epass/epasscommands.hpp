@@ -23,8 +23,10 @@ class LIBLOGICALACCESS_API EPassCommand : public Commands
 
     /**
      * Read Binary of the currently selected file.
+     *
+     * A length above 256 requires extended length APDU support.
      */
-    ByteVector readBinary(uint16_t offset, uint8_t length);
+    ByteVector readBinary(uint16_t offset, uint16_t length);
 
     /**
      * Retrieve the content of the EF.COM file.
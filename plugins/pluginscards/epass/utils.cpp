@@ -112,27 +112,84 @@ std::vector<uint8_t> EPassUtils::adjust_key_parity(const std::vector<uint8_t> &k
 }
 
 /**
- * Check whether the APDU contains an LE byte.
+ * Split a short or extended length APDU into its data and its Le field.
+ *
+ * The Le field is returned as encoded in the APDU, without the leading 0x00
+ * of an extended length APDU without data. It is empty if there is no Le.
  */
-static bool apdu_has_le(const ByteVector &apdu)
+static void split_apdu(const ByteVector &apdu, ByteVector &data, ByteVector &le)
 {
     assert(apdu.size() >= 4);
-    if (apdu.size() == 4)
-        return false;
-    auto body_size = std::distance(apdu.begin() + 4, apdu.end());
-    return body_size != apdu[4] + 1;
+    data.clear();
+    le.clear();
+    auto body_size = apdu.size() - 4;
+    if (body_size == 0)
+        return;
+
+    if (body_size == 1)
+    {
+        le.push_back(apdu[4]);
+    }
+    else if (apdu[4] != 0x00)
+    {
+        size_t lc = apdu[4];
+        EXCEPTION_ASSERT_WITH_LOG(body_size == lc + 1 || body_size == lc + 2,
+                                  LibLogicalAccessException, "Invalid APDU length.");
+        data.assign(apdu.begin() + 5, apdu.begin() + 5 + lc);
+        if (body_size == lc + 2)
+            le.push_back(apdu.back());
+    }
+    else
+    {
+        EXCEPTION_ASSERT_WITH_LOG(body_size >= 3, LibLogicalAccessException,
+                                  "Invalid extended APDU length.");
+        if (body_size == 3)
+        {
+            le.assign(apdu.begin() + 5, apdu.end());
+            return;
+        }
+        size_t lc = (apdu[5] << 8) | apdu[6];
+        EXCEPTION_ASSERT_WITH_LOG(body_size == lc + 3 || body_size == lc + 5,
+                                  LibLogicalAccessException,
+                                  "Invalid extended APDU length.");
+        data.assign(apdu.begin() + 7, apdu.begin() + 7 + lc);
+        if (body_size == lc + 5)
+            le.assign(apdu.end() - 2, apdu.end());
+    }
 }
 
 /**
- * Check whether the APDU has any data.
+ * Encode a BER-TLV length.
  */
-static bool apdu_has_data(const ByteVector &apdu)
+static ByteVector ber_length(size_t length)
 {
-    assert(apdu.size() >= 4);
-    if (apdu.size() == 4)
-        return false;
-    auto body_size = std::distance(apdu.begin() + 4, apdu.end());
-    return body_size >= apdu[4] + 1; // Maybe we also have an LE byte.
+    if (length < 0x80)
+        return {static_cast<uint8_t>(length)};
+    if (length <= 0xFF)
+        return {0x81, static_cast<uint8_t>(length)};
+    return {0x82, static_cast<uint8_t>(length >> 8), static_cast<uint8_t>(length & 0xFF)};
+}
+
+/**
+ * Decode a BER-TLV length, moving `itr` after it.
+ */
+static size_t parse_ber_length(ByteVector::const_iterator &itr,
+                               const ByteVector::const_iterator &end)
+{
+    EXCEPTION_ASSERT_WITH_LOG(itr != end, LibLogicalAccessException,
+                              "Missing BER length.");
+    uint8_t first = *itr++;
+    if (first < 0x80)
+        return first;
+
+    size_t nb_bytes = first & 0x7F;
+    EXCEPTION_ASSERT_WITH_LOG(nb_bytes >= 1 && nb_bytes <= 2 &&
+                                  std::distance(itr, end) >= static_cast<long>(nb_bytes),
+                              LibLogicalAccessException, "Invalid BER length.");
+    size_t length = 0;
+    for (size_t i = 0; i < nb_bytes; ++i)
+        length = (length << 8) | *itr++;
+    return length;
 }
 
 ByteVector EPassUtils::encrypt_apdu(const ByteVector &apdu, const ByteVector &ks_enc,
@@ -147,27 +204,26 @@ ByteVector EPassUtils::encrypt_apdu(const ByteVector &apdu, const ByteVector &ks
                             apdu.begin() + 4);
     ByteVector cmd_header = pad(cmd_header_nopad);
 
-    ByteVector do_97;
     ByteVector original_data;
-    if (apdu_has_le(apdu))
-    {
-        if (apdu_has_data(apdu))
-        {
-            original_data = ByteVector(apdu.begin() + 4, apdu.end() - 1);
-        }
-        do_97 = {0x97, 0x01, *(apdu.end() - 1)};
-    }
-    else if (apdu_has_data(apdu))
+    ByteVector le;
+    split_apdu(apdu, original_data, le);
+
+    ByteVector do_97;
+    if (le.size())
     {
-        original_data = ByteVector(apdu.begin() + 5, apdu.end());
+        do_97 = {0x97, static_cast<uint8_t>(le.size())};
+        do_97.insert(do_97.end(), le.begin(), le.end());
     }
-    ByteVector encrypted_data =
-        DESHelper::DESEncrypt(pad(original_data), ks_enc, {});
 
     ByteVector do_87;
-    if (apdu_has_data(apdu)) // LC -- do we have any data?
+    if (original_data.size()) // LC -- do we have any data?
     {
-        do_87 = {0x87, static_cast<uint8_t>(encrypted_data.size() + 1), 0x01};
+        ByteVector encrypted_data =
+            DESHelper::DESEncrypt(pad(original_data), ks_enc, {});
+        auto length = ber_length(encrypted_data.size() + 1);
+        do_87 = {0x87};
+        do_87.insert(do_87.end(), length.begin(), length.end());
+        do_87.push_back(0x01);
         do_87.insert(do_87.end(), encrypted_data.begin(), encrypted_data.end());
     }
 
@@ -181,14 +237,25 @@ ByteVector EPassUtils::encrypt_apdu(const ByteVector &apdu, const ByteVector &ks
     ByteVector do_8E = {0x8E, 0x08};
     do_8E.insert(do_8E.end(), CC.begin(), CC.end());
 
+    // The protected APDU must be extended too if the expected response
+    // or its own data does not fit in short length fields.
+    size_t lc     = do_87.size() + do_97.size() + do_8E.size();
+    bool extended = (le.size() > 1 || lc > 0xFF);
+
     ByteVector result;
     result.insert(result.end(), cmd_header_nopad.begin(), cmd_header_nopad.end());
-    result.push_back(
-        static_cast<uint8_t>(do_87.size() + do_97.size() + do_8E.size())); // LC
+    if (extended)
+    {
+        result.push_back(0x00);
+        result.push_back(static_cast<uint8_t>(lc >> 8));
+    }
+    result.push_back(static_cast<uint8_t>(lc & 0xFF)); // LC
     result.insert(result.end(), do_87.begin(), do_87.end());
     result.insert(result.end(), do_97.begin(), do_97.end());
     result.insert(result.end(), do_8E.begin(), do_8E.end());
     result.push_back(0);
+    if (extended)
+        result.push_back(0);
 
     return result;
 }
@@ -280,21 +347,27 @@ ByteVector EPassUtils::decrypt_rapdu(const ByteVector &rapdu,
     ByteVector do_87;
     ByteVector do_99;
     ByteVector do_8E;
+    size_t do_87_data_offset = 0;
 
     auto cpy = ByteVector(rapdu.begin(), rapdu.end() - 2);
-    auto itr = cpy.begin();
+    ByteVector::const_iterator itr = cpy.begin();
     if (rapdu_has_data(cpy))
     {
-        do_87.insert(do_87.end(), itr, itr + 3);
-        itr += 3;
-        do_87.insert(do_87.end(), itr, itr + cpy[1] - 1);
-        itr += cpy[1] - 1;
+        auto do_87_begin = itr++;
+        auto length      = parse_ber_length(itr, cpy.cend());
+        EXCEPTION_ASSERT_WITH_LOG(length >= 1 && std::distance(itr, cpy.cend()) >=
+                                                     static_cast<long>(length),
+                                  LibLogicalAccessException, "RAPDU is too short");
+        // Skip the padding indicator byte.
+        do_87_data_offset = static_cast<size_t>(std::distance(do_87_begin, itr)) + 1;
+        itr += length;
+        do_87.insert(do_87.end(), do_87_begin, itr);
     }
-    EXCEPTION_ASSERT_WITH_LOG(std::distance(itr, cpy.end()) >= 4,
+    EXCEPTION_ASSERT_WITH_LOG(std::distance(itr, cpy.cend()) >= 4,
                               LibLogicalAccessException, "RAPDU is too short");
     do_99.insert(do_99.end(), itr, itr + 4);
     itr += 4;
-    EXCEPTION_ASSERT_WITH_LOG(std::distance(itr, cpy.end()) >= 10,
+    EXCEPTION_ASSERT_WITH_LOG(std::distance(itr, cpy.cend()) >= 10,
                               LibLogicalAccessException, "RAPDU is too short");
     do_8E.insert(do_8E.end(), itr, itr + 10);
     itr += 10;
@@ -318,7 +391,7 @@ ByteVector EPassUtils::decrypt_rapdu(const ByteVector &rapdu,
     if (do_87.size())
     {
         decrypted_data = DESHelper::DESDecrypt(
-            ByteVector(do_87.begin() + 3, do_87.end()), ks_enc, {});
+            ByteVector(do_87.begin() + do_87_data_offset, do_87.end()), ks_enc, {});
         decrypted_data = unpad(decrypted_data);
     }
     decrypted_data.insert(decrypted_data.end(), do_99.begin() + 2, do_99.end());
@@ -8,6 +8,8 @@
 #include <logicalaccess/myexception.hpp>
 #include "felicacommands.hpp"
 
+#include <algorithm>
+
 namespace logicalaccess
 {
 	unsigned short FeliCaCommands::requestService(unsigned short code)
@@ -52,4 +54,62 @@ namespace logicalaccess
 
 		write(codes, blocks, data);
 	}
+
+	std::vector<unsigned char> FeliCaCommands::readBlocks(unsigned short code, unsigned short block, unsigned short nbBlocks)
+	{
+		std::vector<unsigned char> data;
+		unsigned short maxBlocks = getMaxReadBlocks();
+		for (unsigned short i = 0; i < nbBlocks; i += maxBlocks)
+		{
+			std::vector<unsigned short> blocks;
+			for (unsigned short b = i; b < nbBlocks && b < i + maxBlocks; ++b)
+			{
+				blocks.push_back(block + b);
+			}
+
+			std::vector<unsigned char> bdata = read(code, blocks);
+			EXCEPTION_ASSERT_WITH_LOG(bdata.size() == blocks.size() * 16, LibLogicalAccessException, "Wrong read result. Invalid length for blocks number.");
+			data.insert(data.end(), bdata.begin(), bdata.end());
+		}
+
+		return data;
+	}
+
+	void FeliCaCommands::writeBlocks(unsigned short code, unsigned short block, const std::vector<unsigned char>& data)
+	{
+		std::vector<unsigned char> padded(data);
+		if (padded.size() % 16 != 0)
+		{
+			padded.resize(padded.size() + 16 - (padded.size() % 16), 0x00);
+		}
+
+		unsigned short nbBlocks = static_cast<unsigned short>(padded.size() / 16);
+		unsigned short maxBlocks = getMaxWriteBlocks();
+		for (unsigned short i = 0; i < nbBlocks; i += maxBlocks)
+		{
+			std::vector<unsigned short> blocks;
+			for (unsigned short b = i; b < nbBlocks && b < i + maxBlocks; ++b)
+			{
+				blocks.push_back(block + b);
+			}
+
+			write(code, blocks, std::vector<unsigned char>(padded.begin() + i * 16, padded.begin() + (i + blocks.size()) * 16));
+		}
+	}
+
+	void FeliCaCommands::setMaxBlocks(unsigned char maxReadBlocks, unsigned char maxWriteBlocks)
+	{
+		d_maxReadBlocks = std::max<unsigned char>(maxReadBlocks, 1);
+		d_maxWriteBlocks = std::max<unsigned char>(maxWriteBlocks, 1);
+	}
+
+	unsigned char FeliCaCommands::getMaxReadBlocks() const
+	{
+		return std::max<unsigned char>(std::min<unsigned char>(d_maxReadBlocks, getReaderMaxReadBlocks()), 1);
+	}
+
+	unsigned char FeliCaCommands::getMaxWriteBlocks() const
+	{
+		return std::max<unsigned char>(std::min<unsigned char>(d_maxWriteBlocks, getReaderMaxWriteBlocks()), 1);
+	}
 }
\ No newline at end of file
@@ -20,7 +20,7 @@ namespace logicalaccess
     {
     public:
 
-		FeliCaCommands() {}
+		FeliCaCommands() : d_maxReadBlocks(4), d_maxWriteBlocks(1) {}
 
 		/**
 		 * \brief Get system codes.
@@ -66,6 +66,66 @@ namespace logicalaccess
 		* \param data Data to write.
 		*/
 		virtual void write(const std::vector<unsigned short>& codes, const std::vector<unsigned short>& blocks, const std::vector<unsigned char>& data) = 0;
+
+		/**
+		* \brief Read consecutive blocks of a service, with as few Read Without Encryption as the chip allows.
+		* \param code Service / Area code.
+		* \param block The first block number.
+		* \param nbBlocks The number of blocks to read.
+		* \return Data read.
+		*/
+		virtual std::vector<unsigned char> readBlocks(unsigned short code, unsigned short block, unsigned short nbBlocks);
+
+		/**
+		* \brief Write consecutive blocks of a service, with as few Write Without Encryption as the chip allows.
+		* \param code Service / Area code.
+		* \param block The first block number.
+		* \param data Data to write, the last block being padded with zeros.
+		*/
+		virtual void writeBlocks(unsigned short code, unsigned short block, const std::vector<unsigned char>& data);
+
+		/**
+		* \brief Set the maximum number of blocks the chip handles in one command (Nbr / Nbw of a NFC Type 3 tag).
+		* \param maxReadBlocks The maximum number of blocks per Read Without Encryption.
+		* \param maxWriteBlocks The maximum number of blocks per Write Without Encryption.
+		*/
+		void setMaxBlocks(unsigned char maxReadBlocks, unsigned char maxWriteBlocks);
+
+		/**
+		* \brief Get the maximum number of blocks per Read Without Encryption, for both the chip and the reader.
+		* \return The number of blocks.
+		*/
+		unsigned char getMaxReadBlocks() const;
+
+		/**
+		* \brief Get the maximum number of blocks per Write Without Encryption, for both the chip and the reader.
+		* \return The number of blocks.
+		*/
+		unsigned char getMaxWriteBlocks() const;
+
+	protected:
+
+		/**
+		* \brief Get the maximum number of blocks the reader passes in one Read Without Encryption.
+		* \return The number of blocks, no limit by default.
+		*/
+		virtual unsigned char getReaderMaxReadBlocks() const { return 0xFF; }
+
+		/**
+		* \brief Get the maximum number of blocks the reader passes in one Write Without Encryption.
+		* \return The number of blocks, no limit by default.
+		*/
+		virtual unsigned char getReaderMaxWriteBlocks() const { return 0xFF; }
+
+		/**
+		* \brief Maximum number of blocks per Read Without Encryption, 4 by default (FeliCa Lite-S).
+		*/
+		unsigned char d_maxReadBlocks;
+
+		/**
+		* \brief Maximum number of blocks per Write Without Encryption, 1 by default (FeliCa Lite-S).
+		*/
+		unsigned char d_maxWriteBlocks;
     };
 }
 
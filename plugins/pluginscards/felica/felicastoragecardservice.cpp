@@ -31,13 +31,11 @@ namespace logicalaccess
         std::shared_ptr<FeliCaCommands> cmd = getFeliCaChip()->getFeliCaCommands();
         EXCEPTION_ASSERT_WITH_LOG(cmd, CardException, "FeliCa commands not implemented on this reader.");
 
-        std::vector<unsigned short> blocks;
-        for (unsigned short i = flocation->block; i < 14; ++i)
+        if (flocation->block < 14)
         {
-            blocks.push_back(i);
+            std::vector<unsigned char> data((14 - flocation->block) * 16, 0x00);
+            cmd->writeBlocks(flocation->code, flocation->block, data);
         }
-        std::vector<unsigned char> data(blocks.size() * 16, 0x00);
-        cmd->write(flocation->code, blocks, data);
     }
 
     void FeliCaStorageCardService::writeData(std::shared_ptr<Location> location, std::shared_ptr<AccessInfo>, std::shared_ptr<AccessInfo>, const std::vector<unsigned char>& data, CardBehavior cardBehavior)
@@ -53,15 +51,7 @@ namespace logicalaccess
 
         if ((cardBehavior & CB_AUTOSWITCHAREA) == CB_AUTOSWITCHAREA)
         {
-            unsigned int i = 0;
-            while (i < data.size())
-            {
-                cmd ->write(icLocation->code,
-                    icLocation->block + (unsigned int)(i / 16),
-                    std::vector<unsigned char>(data.cbegin() + i, (i + 16 < data.size()) ? data.begin() + i + 16 : data.cend())
-                );
-                i += 16;
-            }
+            cmd->writeBlocks(icLocation->code, icLocation->block, data);
         }
         else
         {
@@ -83,15 +73,7 @@ namespace logicalaccess
         std::vector<unsigned char> data;
         if ((cardBehavior & CB_AUTOSWITCHAREA) == CB_AUTOSWITCHAREA)
         {
-            size_t i = 0;
-            while (i < length)
-            {
-				std::vector<unsigned char> bdata = cmd->read(icLocation->code, (unsigned short)(icLocation->block + (i / 16)));
-                if (bdata.size() == 0)
-                    break;
-                data.insert(data.end(), bdata.begin(), bdata.end());
-                i += bdata.size();
-            }
+            data = cmd->readBlocks(icLocation->code, icLocation->block, static_cast<unsigned short>((length + 15) / 16));
         }
         else
         {
@@ -25,6 +25,8 @@ namespace logicalaccess
             data = records->encode();
         std::vector<unsigned char> data0 = cmd->read(location->code, 0);
         EXCEPTION_ASSERT(data0.size() >= 16, CardException, "Wrong Attribute Information block length.");
+        // Nbr / Nbw, the blocks count the tag reads / writes in one command
+        cmd->setMaxBlocks(data0[1], data0[2]);
         // Attribute Information block
         data0[9] = 0x00; // WriteFlag OFF
         // Len
@@ -63,6 +65,8 @@ namespace logicalaccess
             crc += data0[i];
         }
         EXCEPTION_ASSERT(crc == rcrc, CardException, "Wrong FeliCa Attribute Information CRC.");
+        // Nbr / Nbw, the blocks count the tag reads / writes in one command
+        cmd->setMaxBlocks(data0[1], data0[2]);
 
         unsigned int ndeflen = (data0[11] << 16) | (data0[12] << 8) | data0[13];
         if (ndeflen > 0)
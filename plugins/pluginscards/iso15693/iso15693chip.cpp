@@ -46,7 +46,7 @@ namespace logicalaccess
 
         if (getCommands())
         {
-            ISO15693Commands::SystemInformation sysinfo = getISO15693Commands()->getSystemInformation();
+            ISO15693Commands::SystemInformation sysinfo = getISO15693Commands()->getCachedSystemInformation();
             if (sysinfo.hasVICCMemorySize)
             {
                 char tmpName[255];
@@ -0,0 +1,62 @@
+/**
+ * \file iso15693commands.cpp
+ * \brief ISO15693 commands.
+ */
+
+#include <logicalaccess/logs.hpp>
+#include "iso15693commands.hpp"
+#include "logicalaccess/myexception.hpp"
+
+#include <cstring>
+
+namespace logicalaccess
+{
+    ISO15693Commands::ISO15693Commands()
+        : d_hasSystemInformation(false)
+    {
+        memset(&d_systemInformation, 0x00, sizeof(d_systemInformation));
+    }
+
+    ISO15693Commands::SystemInformation ISO15693Commands::getCachedSystemInformation()
+    {
+        if (!d_hasSystemInformation)
+        {
+            d_systemInformation = getSystemInformation();
+            d_hasSystemInformation = true;
+        }
+
+        return d_systemInformation;
+    }
+
+    int ISO15693Commands::getBlockSize()
+    {
+        ISO15693Commands::SystemInformation sysinfo = getCachedSystemInformation();
+        EXCEPTION_ASSERT_WITH_LOG(sysinfo.hasVICCMemorySize && sysinfo.blockSize > 0, LibLogicalAccessException, "The chip block size is unknown.");
+
+        return sysinfo.blockSize;
+    }
+
+    std::vector<unsigned char> ISO15693Commands::readBlocks(size_t block, size_t nbBlocks)
+    {
+        std::vector<unsigned char> ret;
+
+        for (size_t i = 0; i < nbBlocks; ++i)
+        {
+            std::vector<unsigned char> data = readBlock(block + i);
+            ret.insert(ret.end(), data.begin(), data.end());
+        }
+
+        return ret;
+    }
+
+    void ISO15693Commands::writeBlocks(size_t block, const std::vector<unsigned char>& data)
+    {
+        size_t blockSize = static_cast<size_t>(getBlockSize());
+        EXCEPTION_ASSERT_WITH_LOG(data.size() % blockSize == 0, std::invalid_argument, "The data length must be a multiple of the block size.");
+
+        for (size_t i = 0; i < data.size() / blockSize; ++i)
+        {
+            writeBlock(block + i, std::vector<unsigned char>(data.begin() + i * blockSize, data.begin() + (i + 1) * blockSize));
+        }
+    }
+}
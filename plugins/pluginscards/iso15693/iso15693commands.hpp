@@ -36,6 +36,11 @@ namespace logicalaccess
             unsigned char DSFID; /**< \brief The Data Storage Format Identifier */
         };
 
+        /**
+         * \brief Constructor.
+         */
+        ISO15693Commands();
+
         virtual void stayQuiet() = 0;
 
         virtual std::vector<unsigned char> readBlock(size_t block, size_t le = 0) = 0;
@@ -55,6 +60,45 @@ namespace logicalaccess
         virtual ISO15693Commands::SystemInformation getSystemInformation() = 0;
 
         virtual unsigned char getSecurityStatus(size_t block) = 0;
+
+        /**
+         * \brief Read consecutive blocks (Read Multiple Blocks).
+         * \param block The first block number.
+         * \param nbBlocks The number of blocks to read.
+         * \return The data of the blocks.
+         */
+        virtual std::vector<unsigned char> readBlocks(size_t block, size_t nbBlocks);
+
+        /**
+         * \brief Write consecutive blocks (Write Multiple Blocks).
+         * \param block The first block number.
+         * \param data The data to write, a multiple of the block size.
+         */
+        virtual void writeBlocks(size_t block, const std::vector<unsigned char>& data);
+
+        /**
+         * \brief Get the system information, only asked to the chip the first time.
+         * \return The system information.
+         */
+        ISO15693Commands::SystemInformation getCachedSystemInformation();
+
+    protected:
+
+        /**
+         * \brief Get the block size from the system information.
+         * \return The block size in bytes.
+         */
+        int getBlockSize();
+
+        /**
+         * \brief True once the system information is cached.
+         */
+        bool d_hasSystemInformation;
+
+        /**
+         * \brief The cached system information.
+         */
+        ISO15693Commands::SystemInformation d_systemInformation;
     };
 }
 
@@ -22,7 +22,7 @@ namespace logicalaccess
 
     void ISO15693StorageCardService::erase(std::shared_ptr<Location> location, std::shared_ptr<AccessInfo> aiToUse)
     {
-        ISO15693Commands::SystemInformation sysinfo = getISO15693Chip()->getISO15693Commands()->getSystemInformation();
+        ISO15693Commands::SystemInformation sysinfo = getISO15693Chip()->getISO15693Commands()->getCachedSystemInformation();
 
         if (sysinfo.hasVICCMemorySize)
         {
@@ -41,7 +41,25 @@ namespace logicalaccess
 
         EXCEPTION_ASSERT_WITH_LOG(icLocation, std::invalid_argument, "location must be a ISO15693Location.");
 
-        getISO15693Chip()->getISO15693Commands()->writeBlock(icLocation->block, data);
+        std::shared_ptr<ISO15693Commands> cmd = getISO15693Chip()->getISO15693Commands();
+        ISO15693Commands::SystemInformation sysinfo = cmd->getCachedSystemInformation();
+        size_t blockSize = static_cast<size_t>(sysinfo.blockSize);
+        if (!sysinfo.hasVICCMemorySize || blockSize == 0 || data.size() <= blockSize)
+        {
+            cmd->writeBlock(icLocation->block, data);
+            return;
+        }
+
+        // Several blocks, the last one being completed with its current content.
+        std::vector<unsigned char> blocks(data);
+        if (blocks.size() % blockSize != 0)
+        {
+            size_t lastBlock = icLocation->block + blocks.size() / blockSize;
+            std::vector<unsigned char> last = cmd->readBlock(lastBlock);
+            EXCEPTION_ASSERT_WITH_LOG(last.size() >= blockSize, LibLogicalAccessException, "Bad block read response length.");
+            blocks.insert(blocks.end(), last.begin() + blocks.size() % blockSize, last.begin() + blockSize);
+        }
+        cmd->writeBlocks(icLocation->block, blocks);
     }
 
     std::vector<unsigned char> ISO15693StorageCardService::readData(std::shared_ptr<Location> location, std::shared_ptr<AccessInfo>, size_t length, CardBehavior)
@@ -52,7 +70,24 @@ namespace logicalaccess
 
         EXCEPTION_ASSERT_WITH_LOG(icLocation, std::invalid_argument, "location must be a ISO15693Location.");
 
-        return getISO15693Chip()->getISO15693Commands()->readBlock(icLocation->block);
+        std::shared_ptr<ISO15693Commands> cmd = getISO15693Chip()->getISO15693Commands();
+        ISO15693Commands::SystemInformation sysinfo = cmd->getCachedSystemInformation();
+        size_t blockSize = static_cast<size_t>(sysinfo.blockSize);
+        std::vector<unsigned char> data;
+        if (!sysinfo.hasVICCMemorySize || blockSize == 0 || length <= blockSize)
+        {
+            data = cmd->readBlock(icLocation->block);
+        }
+        else
+        {
+            data = cmd->readBlocks(icLocation->block, (length + blockSize - 1) / blockSize);
+        }
+
+        if (data.size() > length)
+        {
+            data.resize(length);
+        }
+        return data;
     }
 
     unsigned int ISO15693StorageCardService::readDataHeader(std::shared_ptr<Location>, std::shared_ptr<AccessInfo>, void*, size_t)
@@ -4,6 +4,7 @@
  * \brief Mifare commands.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <logicalaccess/logs.hpp>
 #include <cassert>
@@ -189,6 +190,12 @@ namespace logicalaccess
 		MifareKeyType wkt = KT_KEY_A;
 		MifareKeyType rkt = KT_KEY_A;
 
+		if (!write && block >= getNbBlocks(sector))
+		{
+			// Key A can always read the sector trailer access bits.
+			return KT_KEY_A;
+		}
+
 		int virtualblock = 0;
 		if (sector >= 32)
 		{
@@ -262,25 +269,23 @@ namespace logicalaccess
 
 	std::vector<unsigned char> MifareCommands::readSector(int sector, int start_block, std::shared_ptr<MifareKey> keyA, std::shared_ptr<MifareKey> keyB, const MifareAccessInfo::SectorAccessBits& sab, bool readtrailer)
     {
-        std::vector<unsigned char> ret;
-
         int nbblocks = getNbBlocks(sector);
         if (readtrailer)
         {
             nbblocks += 1;
         }
 
-		MifareKeyType keytype, pkeytype;
-        for (int i = start_block; i < nbblocks; i++)
+        std::vector<unsigned char> ret((start_block < nbblocks) ? (nbblocks - start_block) * 16 : 0);
+        std::vector<BlockRun> runs = getBlockRuns(sab, sector, start_block, nbblocks, false);
+        for (size_t i = 0; i < runs.size(); ++i)
         {
-			keytype = getKeyType(sab, sector, i, false);
-			if (i == start_block || keytype != pkeytype)
-			{
-				authenticate(keytype, keytype == KT_KEY_A ? keyA : keyB, sector, i, false);
-				pkeytype = keytype;
-			}
-            std::vector<unsigned char> data = readBinary(static_cast<unsigned char>(getSectorStartBlock(sector) + i), 16);
-			ret.insert(ret.end(), data.begin(), data.end());
+            if (i == 0 || runs[i].keytype != runs[i - 1].keytype)
+            {
+                authenticate(runs[i].keytype, runs[i].keytype == KT_KEY_A ? keyA : keyB, sector, runs[i].block, false);
+            }
+            std::vector<unsigned char> data = readBlocks(static_cast<unsigned char>(getSectorStartBlock(sector) + runs[i].block), static_cast<unsigned char>(runs[i].count));
+            EXCEPTION_ASSERT_WITH_LOG(data.size() == static_cast<size_t>(runs[i].count) * 16, LibLogicalAccessException, "Unexpected blocks data length.");
+            std::copy(data.begin(), data.end(), ret.begin() + (runs[i].block - start_block) * 16);
         }
 
         return ret;
@@ -293,25 +298,25 @@ namespace logicalaccess
                                      MifareAccessInfo::SectorAccessBits* newsab,
                                      std::shared_ptr<MifareKey> newkeyA, std::shared_ptr<MifareKey> newkeyB)
     {
-        size_t retlen = 0;
-
-		MifareKeyType keytype, pkeytype = KT_KEY_A;
-        for (int i = start_block; i < getNbBlocks(sector); i++)
+        bool authenticated = false;
+		MifareKeyType pkeytype = KT_KEY_A;
+        std::vector<BlockRun> runs = getBlockRuns(sab, sector, start_block, getNbBlocks(sector), true);
+        for (size_t i = 0; i < runs.size(); ++i)
         {
-			keytype = getKeyType(sab, sector, i, true);
-			if (i == start_block || keytype != pkeytype)
+			if (!authenticated || runs[i].keytype != pkeytype)
 			{
-				authenticate(keytype, keytype == KT_KEY_A ? keyA : keyB, sector, i, true);
-				pkeytype = keytype;
+				authenticate(runs[i].keytype, runs[i].keytype == KT_KEY_A ? keyA : keyB, sector, runs[i].block, true);
+				pkeytype = runs[i].keytype;
+				authenticated = true;
 			}
-            updateBinary(static_cast<unsigned char>(getSectorStartBlock(sector) + i), std::vector<unsigned char>(buf.begin() + retlen, buf.begin() + retlen + 16));
-			retlen += 16;
+            size_t offset = (runs[i].block - start_block) * 16;
+            writeBlocks(static_cast<unsigned char>(getSectorStartBlock(sector) + runs[i].block), std::vector<unsigned char>(buf.begin() + offset, buf.begin() + offset + runs[i].count * 16));
         }
 
         if (newsab != NULL)
         {
-			keytype = getKeyType(sab, sector, getNbBlocks(sector), true);
-			if (keytype != pkeytype)
+			MifareKeyType keytype = getKeyType(sab, sector, getNbBlocks(sector), true);
+			if (!authenticated || keytype != pkeytype)
 			{
 				authenticate(keytype, keytype == KT_KEY_A ? keyA : keyB, sector, getNbBlocks(sector), true);
 			}
@@ -319,6 +324,66 @@ namespace logicalaccess
         }
     }
 
+    std::vector<MifareCommands::BlockRun> MifareCommands::getBlockRuns(const MifareAccessInfo::SectorAccessBits& sab, int sector, int start_block, int stop_block, bool write)
+    {
+        std::vector<BlockRun> runs;
+        if (start_block >= stop_block)
+        {
+            return runs;
+        }
+
+        // The key type of the first block first, then the other one: at most two authentications.
+        MifareKeyType first = getKeyType(sab, sector, start_block, write);
+        MifareKeyType order[2] = { first, (first == KT_KEY_A) ? KT_KEY_B : KT_KEY_A };
+        for (int k = 0; k < 2; ++k)
+        {
+            for (int i = start_block; i < stop_block; ++i)
+            {
+                if (getKeyType(sab, sector, i, write) != order[k])
+                {
+                    continue;
+                }
+
+                if (!runs.empty() && runs.back().keytype == order[k] && runs.back().block + runs.back().count == i)
+                {
+                    ++runs.back().count;
+                }
+                else
+                {
+                    BlockRun run;
+                    run.keytype = order[k];
+                    run.block = i;
+                    run.count = 1;
+                    runs.push_back(run);
+                }
+            }
+        }
+
+        return runs;
+    }
+
+    std::vector<unsigned char> MifareCommands::readBlocks(unsigned char blockno, unsigned char count)
+    {
+        std::vector<unsigned char> ret;
+        for (unsigned char i = 0; i < count; ++i)
+        {
+            std::vector<unsigned char> data = readBinary(static_cast<unsigned char>(blockno + i), 16);
+            ret.insert(ret.end(), data.begin(), data.end());
+        }
+
+        return ret;
+    }
+
+    void MifareCommands::writeBlocks(unsigned char blockno, const std::vector<unsigned char>& buf)
+    {
+        EXCEPTION_ASSERT_WITH_LOG(buf.size() % 16 == 0, std::invalid_argument, "The buffer length must be a multiple of 16 bytes.");
+
+        for (size_t i = 0; i < buf.size() / 16; ++i)
+        {
+            updateBinary(static_cast<unsigned char>(blockno + i), std::vector<unsigned char>(buf.begin() + i * 16, buf.begin() + (i + 1) * 16));
+        }
+    }
+
 	void MifareCommands::changeKeys(MifareKeyType keytype,
                                     std::shared_ptr<MifareKey> key, std::shared_ptr<MifareKey> newkeyA,
                                     std::shared_ptr<MifareKey> newkeyB, unsigned int sector,
@@ -394,6 +459,21 @@ namespace logicalaccess
         }
     }
 
+    std::vector<unsigned char> MifareCommands::dumpCard(std::shared_ptr<MifareKey> keyA, std::shared_ptr<MifareKey> keyB, const MifareAccessInfo::SectorAccessBits& sab, bool readtrailer)
+    {
+        std::shared_ptr<MifareChip> chip = getMifareChip();
+        EXCEPTION_ASSERT_WITH_LOG(chip, LibLogicalAccessException, "The commands are not bound to a Mifare chip.");
+
+        std::vector<unsigned char> ret;
+        for (unsigned int i = 0; i < chip->getNbSectors(); ++i)
+        {
+            std::vector<unsigned char> data = readSector(static_cast<int>(i), 0, keyA, keyB, sab, readtrailer);
+            ret.insert(ret.end(), data.begin(), data.end());
+        }
+
+        return ret;
+    }
+
     unsigned char MifareCommands::getNbBlocks(int sector)
     {
         return ((sector >= 32) ? 15 : 3);
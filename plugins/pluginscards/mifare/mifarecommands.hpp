@@ -54,6 +54,19 @@ namespace logicalaccess
 								  std::shared_ptr<MifareKey> newkeyA = std::shared_ptr<MifareKey>(),
 								  std::shared_ptr<MifareKey> newkeyB = std::shared_ptr<MifareKey>()) final;
 
+        /**
+         * \brief Read the whole card, sector by sector.
+         * \param keyA The key A.
+         * \param keyB The key B.
+         * \param sab The sector access bits, for all the sectors.
+         * \param readtrailer Also read the sector trailers.
+         * \return The card data, in block order.
+         */
+        std::vector<unsigned char> dumpCard(std::shared_ptr<MifareKey> keyA,
+                                            std::shared_ptr<MifareKey> keyB,
+                                            const MifareAccessInfo::SectorAccessBits& sab,
+                                            bool readtrailer = true);
+
         /**
          * \brief Get the sector referenced by the AID from the MAD.
          * \param aid The application ID.
@@ -127,6 +140,25 @@ namespace logicalaccess
          */
         virtual void updateBinary(unsigned char blockno, const std::vector<unsigned char>& buf) = 0;
 
+        /**
+         * \brief Read consecutive blocks of an authenticated sector.
+         *
+         * The default implementation reads one block at a time.
+         * \param blockno The first block number.
+         * \param count The count of blocks.
+         * \return The blocks data.
+         */
+        virtual std::vector<unsigned char> readBlocks(unsigned char blockno, unsigned char count);
+
+        /**
+         * \brief Write consecutive blocks of an authenticated sector.
+         *
+         * The default implementation writes one block at a time.
+         * \param blockno The first block number.
+         * \param buf The blocks data, a multiple of 16 bytes.
+         */
+        virtual void writeBlocks(unsigned char blockno, const std::vector<unsigned char>& buf);
+
         /**
          * \brief Load a key to the reader.
          * \param keyno The reader key slot number. Can be anything from 0x00 to 0x1F.
@@ -211,6 +243,31 @@ namespace logicalaccess
 
     protected:
 
+        /**
+         * \brief Consecutive blocks of a sector accessed with the same key type.
+         */
+        struct BlockRun
+        {
+            MifareKeyType keytype;
+
+            int block;
+
+            int count;
+        };
+
+        /**
+         * \brief Split the blocks of a sector in runs of consecutive blocks accessed with the same key type.
+         *
+         * The runs of a key type are grouped, so each key type is authenticated once.
+         * \param sab The sector access bits.
+         * \param sector The sector.
+         * \param start_block The first block in the sector.
+         * \param stop_block The block after the last one.
+         * \param write Write access.
+         * \return The runs, in access order.
+         */
+        std::vector<BlockRun> getBlockRuns(const MifareAccessInfo::SectorAccessBits& sab, int sector, int start_block, int stop_block, bool write);
+
         std::shared_ptr<MifareChip> getMifareChip() const;
     };
 }
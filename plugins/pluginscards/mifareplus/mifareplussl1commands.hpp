@@ -132,6 +132,18 @@ namespace logicalaccess
             classic_impl.updateBinary(blockno, buf);
         }
 
+        virtual std::vector<unsigned char> readBlocks(unsigned char blockno, unsigned char count) override
+        {
+            fixup();
+            return classic_impl.readBlocks(blockno, count);
+        }
+
+        virtual void writeBlocks(unsigned char blockno, const std::vector<unsigned char> &buf) override
+        {
+            fixup();
+            classic_impl.writeBlocks(blockno, buf);
+        }
+
         virtual bool loadKey(unsigned char keyno, MifareKeyType keytype, std::shared_ptr<MifareKey> key, bool vol)override
         {
             fixup();
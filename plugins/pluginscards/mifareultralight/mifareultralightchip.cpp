@@ -29,6 +29,12 @@ namespace logicalaccess
     {
     }
 
+    bool MifareUltralightChip::hasFastRead() const
+    {
+        // NXP Ultralight EV1 (0x03) or NTAG21x (0x04)
+        return (d_version.size() == 8 && d_version[1] == 0x04 && (d_version[2] == 0x03 || d_version[2] == 0x04));
+    }
+
 	unsigned short MifareUltralightChip::getNbBlocks(bool checkOnCard)
 	{
 		if (checkOnCard)
@@ -85,6 +85,24 @@ namespace logicalaccess
          */
         std::shared_ptr<MifareUltralightCommands> getMifareUltralightCommands() { return std::dynamic_pointer_cast<MifareUltralightCommands>(getCommands()); };
 
+        /**
+         * \brief Set the GET_VERSION answer, read when the chip is detected.
+         * \param version The 8 bytes version, empty if the chip doesn't support GET_VERSION.
+         */
+        void setVersion(const std::vector<unsigned char>& version) { d_version = version; };
+
+        /**
+         * \brief Get the GET_VERSION answer.
+         * \return The 8 bytes version, empty if unknown.
+         */
+        const std::vector<unsigned char>& getVersion() const { return d_version; };
+
+        /**
+         * \brief Check if the chip supports FAST_READ, from its version.
+         * \return True for Ultralight EV1 and NTAG21x, false otherwise.
+         */
+        bool hasFastRead() const;
+
     protected:
 
 		void addBlockNode(std::shared_ptr<LocationNode> rootNode, int block);
@@ -92,6 +110,11 @@ namespace logicalaccess
         void checkRootLocationNodeName(std::shared_ptr<LocationNode> rootNode);
 
 		unsigned short d_nbblocks;
+
+        /**
+         * \brief The GET_VERSION answer, empty if unknown.
+         */
+        std::vector<unsigned char> d_version;
     };
 }
 
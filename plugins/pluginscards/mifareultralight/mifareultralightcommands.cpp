@@ -7,6 +7,9 @@
 #include <logicalaccess/logs.hpp>
 #include "mifareultralightcommands.hpp"
 #include "mifareultralightchip.hpp"
+#include "logicalaccess/myexception.hpp"
+
+#include <algorithm>
 
 namespace logicalaccess
 {
@@ -24,20 +27,36 @@ namespace logicalaccess
             THROW_EXCEPTION_WITH_LOG(std::invalid_argument, "Start page can't be greater than stop page.");
         }
 
-        for (int i = start_page; i <= stop_page; ++i)
+        if (start_page < stop_page && isFastReadSupported())
         {
-            std::vector<unsigned char> data = readPage(i);
-            // Some commands implementation returns more than one block (eg. PC/SC)
-            if (data.size() > 4)
+            for (int i = start_page; i <= stop_page; i += getMaxFastReadPages())
             {
-                i += static_cast<int>((data.size() + 3) / 4) - 1;
+                int last_page = std::min(i + getMaxFastReadPages() - 1, stop_page);
+                std::vector<unsigned char> data = fastRead(i, last_page);
+                EXCEPTION_ASSERT_WITH_LOG(data.size() == static_cast<size_t>(last_page - i + 1) * 4, CardException, "Bad FAST_READ response length.");
+                ret.insert(ret.end(), data.begin(), data.end());
             }
-			ret.insert(ret.end(), data.begin(), data.end());
+            return ret;
+        }
+
+        for (int i = start_page; i <= stop_page;)
+        {
+            std::vector<unsigned char> data = readPage(i);
+            EXCEPTION_ASSERT_WITH_LOG(data.size() >= 4, CardException, "Bad page read response length.");
+            // Some commands implementation returns more than one page (eg. PC/SC returns the 4 pages of the native READ)
+            int nbPages = std::min(static_cast<int>(data.size() / 4), stop_page - i + 1);
+            ret.insert(ret.end(), data.begin(), data.begin() + nbPages * 4);
+            i += nbPages;
         }
 
         return ret;
     }
 
+    std::vector<unsigned char> MifareUltralightCommands::fastRead(int /*start_page*/, int /*stop_page*/)
+    {
+        THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, "FAST_READ is not supported.");
+    }
+
     void MifareUltralightCommands::writePages(int start_page, int stop_page, const std::vector<unsigned char>& buf)
     {
         if (start_page > stop_page)
@@ -25,18 +25,32 @@ namespace logicalaccess
 
         /**
          * \brief Read several pages.
+         *
+         * All the pages returned by a single read command are used, and FAST_READ is used when the chip supports it.
          * \param start_page The start page number, from 0 to stop_page.
-         * \param stop_page The stop page number, from start_page to 15.
-         * \param buf The buffer to fill with the data.
-         * \param buflen The length of buf. Must be at least (stop_page - start_page + 1) * 4 bytes long.
-         * \return The number of bytes red, or a negative value on error.
+         * \param stop_page The stop page number, from start_page to the last page of the chip.
+         * \return The data of the pages, exactly (stop_page - start_page + 1) * 4 bytes long.
          */
         virtual std::vector<unsigned char> readPages(int start_page, int stop_page);
 
+        /**
+         * \brief Check if the chip and the reader support the FAST_READ command.
+         * \return True if FAST_READ is supported, false otherwise.
+         */
+        virtual bool isFastReadSupported() { return false; }
+
+        /**
+         * \brief Read a range of pages with a single FAST_READ command (Ultralight EV1 / NTAG21x).
+         * \param start_page The start page number.
+         * \param stop_page The stop page number.
+         * \return The data of the pages.
+         */
+        virtual std::vector<unsigned char> fastRead(int start_page, int stop_page);
+
         /**
          * \brief Write several pages.
          * \param start_page The start page number, from 0 to stop_page.
-         * \param stop_page The stop page number, from start_page to 15.
+         * \param stop_page The stop page number, from start_page to the last page of the chip.
          * \param buf The buffer to fill with the data.
          * \param buflen The length of buf. Must be at least (stop_page - start_page + 1) * 4 bytes long.
          * \return The number of bytes red, or a negative value on error.
@@ -69,6 +83,12 @@ namespace logicalaccess
 
     protected:
 
+        /**
+         * \brief Get the maximum number of pages read by a single FAST_READ command.
+         * \return The number of pages.
+         */
+        virtual int getMaxFastReadPages() const { return 60; }
+
         std::shared_ptr<MifareUltralightChip> getMifareUltralightChip();
     };
 }
@@ -10,6 +10,8 @@
 #include "logicalaccess/services/storage/storagecardservice.hpp"
 #include "logicalaccess/myexception.hpp"
 
+#include <algorithm>
+
 namespace logicalaccess
 {
 	void NFCTag2CardService::writeCapabilityContainer()
@@ -49,8 +51,15 @@ namespace logicalaccess
 		{
 			if (CC[2] > 0)
 			{
-				// Read all available data from data blocks
-				std::vector<unsigned char> data = mfucmd->readPages(4, 4 + (CC[2] * 2) - 1);
+				// Read all available data from data blocks, starting with the pages already returned with the CC
+				int stop_page = 4 + (CC[2] * 2) - 1;
+				int nbPages = std::min(static_cast<int>(CC.size() / 4) - 1, stop_page - 3);
+				std::vector<unsigned char> data(CC.begin() + 4, CC.begin() + 4 + nbPages * 4);
+				if (4 + nbPages <= stop_page)
+				{
+					std::vector<unsigned char> next = mfucmd->readPages(4 + nbPages, stop_page);
+					data.insert(data.end(), next.begin(), next.end());
+				}
                 ndef = NdefMessage::TLVToNdefMessage(data);
 			}
 		}
@@ -71,10 +71,10 @@ namespace logicalaccess
 
 	bool AdmittoReaderUnit::waitInsertion(unsigned int maxwait)
 	{
-		bool oldValue = Settings::getInstance()->IsLogEnabled;
-		if (oldValue && !Settings::getInstance()->SeeWaitInsertionLog)
+		std::unique_ptr<LogDisabler> logDisabler;
+		if (!Settings::getSnapshot()->SeeWaitInsertionLog)
 		{
-			Settings::getInstance()->IsLogEnabled = false;		// Disable logs for this part (otherwise too much log output in file)
+			logDisabler.reset(new LogDisabler());		// Disable logs for this part (otherwise too much log output in file)
 		}
 
 		LOG(LogLevel::INFOS) << "Waiting insertion... max wait {" << maxwait << "}";
@@ -125,22 +125,22 @@ namespace logicalaccess
 		}
 		catch (...)
 		{
-			Settings::getInstance()->IsLogEnabled = oldValue;
+			logDisabler.reset();
 			throw;
 		}
 
 		LOG(LogLevel::INFOS) << "Returns card inserted ? {" << inserted << "} function timeout expired ? {" << (std::chrono::steady_clock::now() < clock_timeout) << "}";
-		Settings::getInstance()->IsLogEnabled = oldValue;
+		logDisabler.reset();
 
 		return inserted;
 	}
 
 	bool AdmittoReaderUnit::waitRemoval(unsigned int maxwait)
 	{
-		bool oldValue = Settings::getInstance()->IsLogEnabled;
-		if (oldValue && !Settings::getInstance()->SeeWaitRemovalLog)
+		std::unique_ptr<LogDisabler> logDisabler;
+		if (!Settings::getSnapshot()->SeeWaitRemovalLog)
 		{
-			Settings::getInstance()->IsLogEnabled = false;		// Disable logs for this part (otherwise too much log output in file)
+			logDisabler.reset(new LogDisabler());		// Disable logs for this part (otherwise too much log output in file)
 		}
 
 		LOG(LogLevel::INFOS) << "Waiting removal... max wait {" << maxwait << "}";
@@ -199,13 +199,13 @@ namespace logicalaccess
 		}
 		catch (...)
 		{
-			Settings::getInstance()->IsLogEnabled = oldValue;
+			logDisabler.reset();
 			throw;
 		}
 
 		LOG(LogLevel::INFOS) << "Returns card removed ? {" << removed << "} - function timeout expired ? {" << (std::chrono::steady_clock::now() < clock_timeout) << "}";
 
-		Settings::getInstance()->IsLogEnabled = oldValue;
+		logDisabler.reset();
 
 		return removed;
 	}
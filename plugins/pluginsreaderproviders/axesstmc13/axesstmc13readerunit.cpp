@@ -18,6 +18,7 @@
 #include <boost/filesystem.hpp>
 #include "readercardadapters/axesstmc13datatransport.hpp"
 #include "logicalaccess/bufferhelper.hpp"
+#include "logicalaccess/readerproviders/readerpollscheduler.hpp"
 #include <boost/property_tree/xml_parser.hpp>
 
 namespace logicalaccess
@@ -63,28 +64,33 @@ namespace logicalaccess
 
     bool AxessTMC13ReaderUnit::waitInsertion(unsigned int maxwait)
     {
-        bool inserted = false;
-        std::chrono::steady_clock::time_point const clock_timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
+        if (d_tmcIdentifier.size() == 0)
+        {
+            retrieveReaderIdentifier();
+        }
 
+        return ReaderPollScheduler::getInstance()->waitFor(std::bind(&AxessTMC13ReaderUnit::pollInsertion, this), maxwait);
+    }
+
+    void AxessTMC13ReaderUnit::waitInsertionAsync(unsigned int maxwait, WaitHandler handler)
+    {
         if (d_tmcIdentifier.size() == 0)
         {
             retrieveReaderIdentifier();
         }
 
-        do
+        std::shared_ptr<AxessTMC13ReaderUnit> self = std::dynamic_pointer_cast<AxessTMC13ReaderUnit>(shared_from_this());
+        ReaderPollScheduler::getInstance()->schedule([self]() { return self->pollInsertion(); }, handler, maxwait);
+    }
+
+    bool AxessTMC13ReaderUnit::pollInsertion()
+    {
+        std::shared_ptr<Chip> chip = getChipInAir();
+        if (chip)
         {
-            std::shared_ptr<Chip> chip = getChipInAir();
-            if (chip)
-            {
-                d_insertedChip = chip;
-                inserted = true;
-            }
-
-            if (!inserted)
-                std::this_thread::sleep_for(std::chrono::milliseconds(250));
-        } while (!inserted && std::chrono::steady_clock::now() < clock_timeout);
-
-        return inserted;
+            d_insertedChip = chip;
+        }
+        return bool(chip);
     }
 
     bool AxessTMC13ReaderUnit::waitRemoval(unsigned int maxwait)
@@ -98,32 +104,41 @@ namespace logicalaccess
 
         if (d_insertedChip)
         {
-            std::chrono::steady_clock::time_point const clock_timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
-            do
-            {
-                std::shared_ptr<Chip> chip = getChipInAir();
-                if (chip)
-                {
-                    if (chip->getChipIdentifier() != d_insertedChip->getChipIdentifier())
-                    {
-                        d_insertedChip.reset();
-                        removed = true;
-                    }
-                }
-                else
-                {
-                    d_insertedChip.reset();
-                    removed = true;
-                }
-
-                if (!removed)
-                    std::this_thread::sleep_for(std::chrono::milliseconds(250));
-            } while (!removed && std::chrono::steady_clock::now() < clock_timeout);
+            removed = ReaderPollScheduler::getInstance()->waitFor(std::bind(&AxessTMC13ReaderUnit::pollRemoval, this), maxwait);
         }
 
         return removed;
     }
 
+    void AxessTMC13ReaderUnit::waitRemovalAsync(unsigned int maxwait, WaitHandler handler)
+    {
+        if (d_tmcIdentifier.size() == 0)
+        {
+            retrieveReaderIdentifier();
+        }
+
+        if (!d_insertedChip)
+        {
+            handler(false);
+            return;
+        }
+
+        std::shared_ptr<AxessTMC13ReaderUnit> self = std::dynamic_pointer_cast<AxessTMC13ReaderUnit>(shared_from_this());
+        ReaderPollScheduler::getInstance()->schedule([self]() { return self->pollRemoval(); }, handler, maxwait);
+    }
+
+    bool AxessTMC13ReaderUnit::pollRemoval()
+    {
+        std::shared_ptr<Chip> chip = getChipInAir();
+        if (chip && chip->getChipIdentifier() == d_insertedChip->getChipIdentifier())
+        {
+            return false;
+        }
+
+        d_insertedChip.reset();
+        return true;
+    }
+
     bool AxessTMC13ReaderUnit::connect()
     {
         return true;
@@ -67,6 +67,20 @@ namespace logicalaccess
          */
         virtual bool waitRemoval(unsigned int maxwait);
 
+        /**
+         * \brief Wait for a card insertion on the shared poll scheduler.
+         * \param maxwait The maximum time to wait for, in milliseconds. If maxwait is zero, then the call never times out.
+         * \param handler Called from a polling thread with true if a card was inserted, false otherwise.
+         */
+        virtual void waitInsertionAsync(unsigned int maxwait, WaitHandler handler);
+
+        /**
+         * \brief Wait for a card removal on the shared poll scheduler.
+         * \param maxwait The maximum time to wait for, in milliseconds. If maxwait is zero, then the call never times out.
+         * \param handler Called from a polling thread with true if the card was removed, false otherwise.
+         */
+        virtual void waitRemovalAsync(unsigned int maxwait, WaitHandler handler);
+
         /**
          * \brief Create the chip object from card type.
          * \param type The card type.
@@ -181,6 +195,18 @@ namespace logicalaccess
 
     protected:
 
+        /**
+         * \brief Poll the reader once for a card insertion.
+         * \return True if a card was inserted.
+         */
+        bool pollInsertion();
+
+        /**
+         * \brief Poll the reader once for the removal of the inserted card.
+         * \return True if the card was removed.
+         */
+        bool pollRemoval();
+
         /**
          * \brief The TMC reader identifier.
          */
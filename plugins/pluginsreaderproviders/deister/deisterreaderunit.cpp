@@ -17,6 +17,7 @@
 #include <boost/filesystem.hpp>
 #include "readercardadapters/deisterdatatransport.hpp"
 #include "logicalaccess/myexception.hpp"
+#include "logicalaccess/readerproviders/readerpollscheduler.hpp"
 #include <boost/property_tree/xml_parser.hpp>
 #include <logicalaccess/logs.hpp>
 
@@ -62,23 +63,23 @@ namespace logicalaccess
 
     bool DeisterReaderUnit::waitInsertion(unsigned int maxwait)
     {
-        bool inserted = false;
-        std::chrono::steady_clock::time_point const clock_timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
-
-        do
-        {
-            std::shared_ptr<Chip> chip = getChipInAir();
-            if (chip)
-            {
-                d_insertedChip = chip;
-                inserted = true;
-            }
+        return ReaderPollScheduler::getInstance()->waitFor(std::bind(&DeisterReaderUnit::pollInsertion, this), maxwait);
+    }
 
-            if (!inserted)
-                std::this_thread::sleep_for(std::chrono::milliseconds(250));
-        } while (!inserted && std::chrono::steady_clock::now() < clock_timeout);
+    void DeisterReaderUnit::waitInsertionAsync(unsigned int maxwait, WaitHandler handler)
+    {
+        std::shared_ptr<DeisterReaderUnit> self = std::dynamic_pointer_cast<DeisterReaderUnit>(shared_from_this());
+        ReaderPollScheduler::getInstance()->schedule([self]() { return self->pollInsertion(); }, handler, maxwait);
+    }
 
-        return inserted;
+    bool DeisterReaderUnit::pollInsertion()
+    {
+        std::shared_ptr<Chip> chip = getChipInAir();
+        if (chip)
+        {
+            d_insertedChip = chip;
+        }
+        return bool(chip);
     }
 
     bool DeisterReaderUnit::waitRemoval(unsigned int maxwait)
@@ -87,33 +88,38 @@ namespace logicalaccess
 
         if (d_insertedChip)
         {
-            std::chrono::steady_clock::time_point const clock_timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
-            do
-            {
-				std::this_thread::sleep_for(std::chrono::milliseconds(1000)); //Deister 'forget' the card...
-                std::shared_ptr<Chip> chip = getChipInAir();
-                if (chip)
-                {
-                    if (chip->getChipIdentifier() != d_insertedChip->getChipIdentifier())
-                    {
-                        d_insertedChip.reset();
-                        removed = true;
-                    }
-                }
-                else
-                {
-                    d_insertedChip.reset();
-                    removed = true;
-                }
-
-                if (!removed)
-                    std::this_thread::sleep_for(std::chrono::milliseconds(250));
-            } while (!removed && std::chrono::steady_clock::now() < clock_timeout);
+            // Deister 'forget' the card, do not poll it too often.
+            removed = ReaderPollScheduler::getInstance()->waitFor(std::bind(&DeisterReaderUnit::pollRemoval, this), maxwait, ReaderPollProfile(1250, 1250, 0, 1000));
         }
 
         return removed;
     }
 
+    void DeisterReaderUnit::waitRemovalAsync(unsigned int maxwait, WaitHandler handler)
+    {
+        if (!d_insertedChip)
+        {
+            handler(false);
+            return;
+        }
+
+        // Deister 'forget' the card, do not poll it too often.
+        std::shared_ptr<DeisterReaderUnit> self = std::dynamic_pointer_cast<DeisterReaderUnit>(shared_from_this());
+        ReaderPollScheduler::getInstance()->schedule([self]() { return self->pollRemoval(); }, handler, maxwait, ReaderPollProfile(1250, 1250, 0, 1000));
+    }
+
+    bool DeisterReaderUnit::pollRemoval()
+    {
+        std::shared_ptr<Chip> chip = getChipInAir();
+        if (chip && chip->getChipIdentifier() == d_insertedChip->getChipIdentifier())
+        {
+            return false;
+        }
+
+        d_insertedChip.reset();
+        return true;
+    }
+
     bool DeisterReaderUnit::connect()
     {
         return true;
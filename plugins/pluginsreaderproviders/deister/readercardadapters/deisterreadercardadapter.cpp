@@ -6,7 +6,7 @@
 
 #include <logicalaccess/logs.hpp>
 #include "deisterreadercardadapter.hpp"
-#include "logicalaccess/crypto/tomcrypt.h"
+#include "logicalaccess/crypto/crc.hpp"
 
 namespace logicalaccess
 {
@@ -41,10 +41,9 @@ namespace logicalaccess
         cmd.push_back(d_source);
         std::vector<unsigned char> preparedCmd = prepareDataForDevice(command);
         cmd.insert(cmd.end(), preparedCmd.begin(), preparedCmd.end());
-        unsigned char first, second;
-        ComputeCrcKermit(&cmd[2], cmd.size() - 2, &first, &second);
-        cmd.push_back(first);
-        cmd.push_back(second);
+        uint16_t checksum = crc::kermit(&cmd[2], cmd.size() - 2);
+        cmd.push_back(static_cast<unsigned char>(checksum & 0xff));
+        cmd.push_back(static_cast<unsigned char>(checksum >> 8));
         cmd.push_back(STOP);
 
         return cmd;
@@ -76,9 +75,8 @@ namespace logicalaccess
         std::vector<unsigned char> data = prepareDataFromDevice(buf);
         EXCEPTION_ASSERT_WITH_LOG(data.size() >= 2, std::invalid_argument, "The supplied buffer is not valid (no CRC)");
         data.insert(data.begin(), answer.begin() + 2, answer.begin() + 2 + 5);
-        unsigned char first, second;
-        ComputeCrcKermit(&data[0], data.size() - 2, &first, &second);
-        EXCEPTION_ASSERT_WITH_LOG(data[data.size() - 2] == first && data[data.size() - 1] == second, std::invalid_argument, "The supplied buffer is not valid (CRC missmatch)");
+        uint16_t checksum = crc::kermit(&data[0], data.size() - 2);
+        EXCEPTION_ASSERT_WITH_LOG(data[data.size() - 2] == (checksum & 0xff) && data[data.size() - 1] == (checksum >> 8), std::invalid_argument, "The supplied buffer is not valid (CRC missmatch)");
         // Remove header and CRC
         data = std::vector<unsigned char>(data.begin() + 5, data.end() - 2);
 
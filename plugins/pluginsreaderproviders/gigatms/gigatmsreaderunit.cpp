@@ -17,6 +17,7 @@
 #include <boost/filesystem.hpp>
 #include "readercardadapters/gigatmsdatatransport.hpp"
 #include "logicalaccess/bufferhelper.hpp"
+#include "logicalaccess/readerproviders/readerpollscheduler.hpp"
 #include <boost/property_tree/xml_parser.hpp>
 
 namespace logicalaccess
@@ -62,23 +63,23 @@ namespace logicalaccess
 
     bool GigaTMSReaderUnit::waitInsertion(unsigned int maxwait)
     {
-        bool inserted = false;
-        std::chrono::steady_clock::time_point const clock_timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
-
-        do
-        {
-            std::shared_ptr<Chip> chip = getChipInAir();
-            if (chip)
-            {
-                d_insertedChip = chip;
-                inserted = true;
-            }
+        return ReaderPollScheduler::getInstance()->waitFor(std::bind(&GigaTMSReaderUnit::pollInsertion, this), maxwait);
+    }
 
-            if (!inserted)
-                std::this_thread::sleep_for(std::chrono::milliseconds(250));
-        } while (!inserted && std::chrono::steady_clock::now() < clock_timeout);
+    void GigaTMSReaderUnit::waitInsertionAsync(unsigned int maxwait, WaitHandler handler)
+    {
+        std::shared_ptr<GigaTMSReaderUnit> self = std::dynamic_pointer_cast<GigaTMSReaderUnit>(shared_from_this());
+        ReaderPollScheduler::getInstance()->schedule([self]() { return self->pollInsertion(); }, handler, maxwait);
+    }
 
-        return inserted;
+    bool GigaTMSReaderUnit::pollInsertion()
+    {
+        std::shared_ptr<Chip> chip = getChipInAir();
+        if (chip)
+        {
+            d_insertedChip = chip;
+        }
+        return bool(chip);
     }
 
     bool GigaTMSReaderUnit::waitRemoval(unsigned int maxwait)
@@ -87,32 +88,36 @@ namespace logicalaccess
 
         if (d_insertedChip)
         {
-            std::chrono::steady_clock::time_point const clock_timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
-            do
-            {
-                std::shared_ptr<Chip> chip = getChipInAir();
-                if (chip)
-                {
-                    if (chip->getChipIdentifier() != d_insertedChip->getChipIdentifier())
-                    {
-                        d_insertedChip.reset();
-                        removed = true;
-                    }
-                }
-                else
-                {
-                    d_insertedChip.reset();
-                    removed = true;
-                }
-
-                if (!removed)
-                    std::this_thread::sleep_for(std::chrono::milliseconds(250));
-            } while (!removed && std::chrono::steady_clock::now() < clock_timeout);
+            removed = ReaderPollScheduler::getInstance()->waitFor(std::bind(&GigaTMSReaderUnit::pollRemoval, this), maxwait);
         }
 
         return removed;
     }
 
+    void GigaTMSReaderUnit::waitRemovalAsync(unsigned int maxwait, WaitHandler handler)
+    {
+        if (!d_insertedChip)
+        {
+            handler(false);
+            return;
+        }
+
+        std::shared_ptr<GigaTMSReaderUnit> self = std::dynamic_pointer_cast<GigaTMSReaderUnit>(shared_from_this());
+        ReaderPollScheduler::getInstance()->schedule([self]() { return self->pollRemoval(); }, handler, maxwait);
+    }
+
+    bool GigaTMSReaderUnit::pollRemoval()
+    {
+        std::shared_ptr<Chip> chip = getChipInAir();
+        if (chip && chip->getChipIdentifier() == d_insertedChip->getChipIdentifier())
+        {
+            return false;
+        }
+
+        d_insertedChip.reset();
+        return true;
+    }
+
     bool GigaTMSReaderUnit::connect()
     {
         return true;
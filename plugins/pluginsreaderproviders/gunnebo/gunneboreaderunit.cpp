@@ -20,6 +20,7 @@
 #include "logicalaccess/dynlibrary/idynlibrary.hpp"
 #include "logicalaccess/readerproviders/serialportdatatransport.hpp"
 #include "logicalaccess/settings.hpp"
+#include "logicalaccess/readerproviders/readerpollscheduler.hpp"
 #include <boost/property_tree/xml_parser.hpp>
 
 #include "readercardadapters/gunnebodatatransport.hpp"
@@ -77,10 +78,10 @@ namespace logicalaccess
     {
         std::chrono::system_clock::time_point wait_until(std::chrono::system_clock::now()
                                                          + std::chrono::milliseconds(maxwait));
-        bool oldValue = Settings::getInstance()->IsLogEnabled;
-        if (oldValue && !Settings::getInstance()->SeeWaitInsertionLog)
+        std::unique_ptr<LogDisabler> logDisabler;
+        if (!Settings::getSnapshot()->SeeWaitInsertionLog)
         {
-            Settings::getInstance()->IsLogEnabled = false;		// Disable logs for this part (otherwise too much log output in file)
+            logDisabler.reset(new LogDisabler());		// Disable logs for this part (otherwise too much log output in file)
         }
 
         LOG(LogLevel::INFOS) << "Waiting insertion... max wait {" << maxwait << "}";
@@ -92,7 +93,7 @@ namespace logicalaccess
         {
             // Gunnebo reader doesn't handle commands but we want to simulate the same behavior that for all readers
             // So we send a dummy commmand which does nothing
-            do
+            inserted = ReaderPollScheduler::getInstance()->waitFor([this, &createChipId]()
             {
                 try
                 {
@@ -117,7 +118,7 @@ namespace logicalaccess
                     {
 						d_insertedChip = ReaderUnit::createChip((d_card_type == CHIP_UNKNOWN ? CHIP_GENERICTAG : d_card_type), createChipId);
                         LOG(LogLevel::INFOS) << "Chip detected !";
-                        inserted = true;
+                        return true;
                     }
                 }
                 catch (std::exception&)
@@ -125,15 +126,12 @@ namespace logicalaccess
                     // No response received is ignored !
                 }
 
-                if (!inserted)
-                {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(250));
-                }
-            } while (!inserted && (std::chrono::system_clock::now() < wait_until || maxwait == 0));
+                return false;
+            }, maxwait);
         }
         catch (...)
         {
-            Settings::getInstance()->IsLogEnabled = oldValue;
+            logDisabler.reset();
             throw;
         }
 
@@ -141,7 +139,7 @@ namespace logicalaccess
 
         LOG(LogLevel::INFOS) << "Returns card inserted ? {" << inserted << "} function timeout expired ? {"
         << (std::chrono::system_clock::now() > wait_until && maxwait != 0) << "}";
-        Settings::getInstance()->IsLogEnabled = oldValue;
+        logDisabler.reset();
 
         return inserted;
     }
@@ -151,10 +149,10 @@ namespace logicalaccess
         std::chrono::steady_clock::time_point wait_until(std::chrono::steady_clock::now()
                                                          + std::chrono::milliseconds(maxwait));
 
-        bool oldValue = Settings::getInstance()->IsLogEnabled;
-        if (oldValue && !Settings::getInstance()->SeeWaitRemovalLog)
+        std::unique_ptr<LogDisabler> logDisabler;
+        if (!Settings::getSnapshot()->SeeWaitRemovalLog)
         {
-            Settings::getInstance()->IsLogEnabled = false;		// Disable logs for this part (otherwise too much log output in file)
+            logDisabler.reset(new LogDisabler());		// Disable logs for this part (otherwise too much log output in file)
         }
 
         LOG(LogLevel::INFOS) << "Waiting removal... max wait {" << maxwait << "}";
@@ -166,7 +164,7 @@ namespace logicalaccess
             // The inserted chip will stay inserted until a new identifier is read on the serial port.
             if (d_insertedChip)
             {
-                do
+                removed = ReaderPollScheduler::getInstance()->waitFor([this]()
                 {
                     try
                     {
@@ -182,7 +180,7 @@ namespace logicalaccess
                                 LOG(LogLevel::INFOS) << "Card found but not same chip ! The previous card has been removed !";
                                 d_insertedChip.reset();
                                 removalIdentifier = tmpId;
-                                removed = true;
+                                return true;
                             }
                         }
                     }
@@ -191,23 +189,20 @@ namespace logicalaccess
                         // No response received is ignored !
                     }
 
-                    if (!removed)
-                    {
-                        std::this_thread::sleep_for(std::chrono::milliseconds(250));
-                    }
-                } while (!removed && (std::chrono::steady_clock::now() < wait_until || maxwait == 0));
+                    return false;
+                }, maxwait);
             }
         }
         catch (...)
         {
-            Settings::getInstance()->IsLogEnabled = oldValue;
+            logDisabler.reset();
             throw;
         }
 
         LOG(LogLevel::INFOS) << "Returns card removed ? {" << removed << "} - function timeout expired ? {"
         << (std::chrono::steady_clock::now() > wait_until && maxwait != 0) << "}";
 
-        Settings::getInstance()->IsLogEnabled = oldValue;
+        logDisabler.reset();
 
         return removed;
     }
@@ -263,6 +263,10 @@ namespace logicalaccess
         data.push_back(static_cast<unsigned char>(static_cast<unsigned short>(fid & 0xff00) >> 8));
         data.push_back(static_cast<unsigned char>(fid & 0xff));
 
+        // The file identifier may be the one of an application, the cached
+        // file settings are keyed by the previous one.
+        getDESFireChip()->getCrypto()->invalidateSession();
+        d_fileSettings.clear();
         DESFireISO7816Commands::getISO7816ReaderCardAdapter()->sendAPDUCommand(DFEV1_CLA_ISO_COMPATIBLE, ISO7816_INS_SELECT_FILE, 0x00, 0x0C, static_cast<unsigned char>(data.size()), data);
     }
 
@@ -400,6 +404,7 @@ namespace logicalaccess
                 break;
             }
         }
+        crypto->setAuthenticatedKey(key);
         onAuthenticated();
     }
 
@@ -790,6 +795,8 @@ namespace logicalaccess
     {
         std::vector<unsigned char> ret, data;
 		std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
+        // The MAC and the deciphering are computed frame by frame, as the frames come.
+        bool verifyMAC = (mode == CM_MAC || (mode == CM_PLAIN && crypto->d_auth_method != CM_LEGACY));
 
         if ((err == DF_INS_ADDITIONAL_FRAME || err == 0x00))
         {
@@ -807,6 +814,11 @@ namespace logicalaccess
 
         while (err == DF_INS_ADDITIONAL_FRAME)
         {
+            if (verifyMAC)
+            {
+                crypto->verifyMAC(false, data);
+            }
+
             data = transmit_plain(DF_INS_ADDITIONAL_FRAME);
             err = data.back();
             data.resize(data.size() - 2);
@@ -826,7 +838,7 @@ namespace logicalaccess
         {
 			if (crypto->d_auth_method != CM_LEGACY)
             {
-				if (!crypto->verifyMAC(true, ret))
+				if (!crypto->verifyMAC(true, data))
                 {
                     THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, "MAC data doesn't match.");
                 }
@@ -837,7 +849,7 @@ namespace logicalaccess
 
         case CM_MAC:
         {
-			if (!crypto->verifyMAC(true, ret))
+			if (!crypto->verifyMAC(true, data))
             {
                 THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, "MAC data doesn't match.");
             }
@@ -990,6 +1002,114 @@ namespace logicalaccess
         return ret;
     }
 
+    std::vector<std::vector<unsigned char> > DESFireEV1ISO7816Commands::readFiles(const std::vector<FileRead>& files)
+    {
+        std::vector<std::vector<unsigned char> > ret;
+		std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
+        std::shared_ptr<ISO7816ReaderCardAdapter> adapter = DESFireISO7816Commands::getISO7816ReaderCardAdapter();
+
+        if (crypto->d_auth_method == CM_LEGACY)
+        {
+            // No CMAC chaining between the commands, send them all at once.
+            std::vector<std::vector<unsigned char> > commands;
+            std::vector<size_t> parts;
+            std::vector<unsigned int> lengths;
+
+            for (size_t f = 0; f < files.size(); ++f)
+            {
+                size_t i = 0;
+                do
+                {
+                    size_t trunloffset = files[f].offset + i;
+                    size_t trunklength = ((files[f].length - i) > 248) ? 248 : (files[f].length - i);
+
+                    std::vector<unsigned char> command;
+                    command.push_back(DF_CLA_ISO_WRAP);
+                    command.push_back(DF_INS_READ_DATA);
+                    command.push_back(0x00);
+                    command.push_back(0x00);
+                    command.push_back(0x07);
+                    command.push_back(files[f].fileno);
+                    command.push_back(static_cast<unsigned char>(trunloffset & 0xff));
+                    command.push_back(static_cast<unsigned char>(static_cast<unsigned short>(trunloffset & 0xff00) >> 8));
+                    command.push_back(static_cast<unsigned char>(static_cast<unsigned int>(trunloffset & 0xff0000) >> 16));
+                    command.push_back(static_cast<unsigned char>(trunklength & 0xff));
+                    command.push_back(static_cast<unsigned char>(static_cast<unsigned short>(trunklength & 0xff00) >> 8));
+                    command.push_back(static_cast<unsigned char>(static_cast<unsigned int>(trunklength & 0xff0000) >> 16));
+                    command.push_back(0x00);
+
+                    commands.push_back(command);
+                    parts.push_back(f);
+                    lengths.push_back(static_cast<unsigned int>(trunklength));
+                    i += 248;
+                } while (i < files[f].length);
+            }
+
+            std::vector<unsigned char> additionalFrame;
+            additionalFrame.push_back(DF_CLA_ISO_WRAP);
+            additionalFrame.push_back(DF_INS_ADDITIONAL_FRAME);
+            additionalFrame.push_back(0x00);
+            additionalFrame.push_back(0x00);
+            additionalFrame.push_back(0x00);
+
+            std::vector<std::vector<unsigned char> > results;
+            try
+            {
+                results = adapter->sendAPDUCommands(commands, ISO7816APDUChaining(0x91, DF_INS_ADDITIONAL_FRAME, additionalFrame));
+            }
+            catch (std::exception&)
+            {
+                crypto->invalidateSession();
+                throw;
+            }
+
+            ret.resize(files.size());
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                std::vector<unsigned char>& result = results[i];
+                unsigned char err = result.back();
+                result.resize(result.size() - 2);
+                result = handleReadData(err, result, lengths[i], files[parts[i]].mode);
+                ret[parts[i]].insert(ret[parts[i]].end(), result.begin(), result.end());
+            }
+        }
+        else
+        {
+            // Each command MAC depends on the previous response, keep the reader for the whole sequence.
+            std::shared_ptr<DataTransport> dataTransport = adapter->getDataTransport();
+            if (dataTransport)
+                dataTransport->beginTransaction();
+
+            try
+            {
+                for (std::vector<FileRead>::const_iterator file = files.begin(); file != files.end(); ++file)
+                {
+                    ret.push_back(readData(file->fileno, file->offset, file->length, file->mode));
+                }
+            }
+            catch (...)
+            {
+                if (dataTransport)
+                {
+                    try
+                    {
+                        dataTransport->endTransaction();
+                    }
+                    catch (std::exception& ex)
+                    {
+                        LOG(LogLevel::ERRORS) << "Cannot end the DESFire read transaction: " << ex.what();
+                    }
+                }
+                throw;
+            }
+
+            if (dataTransport)
+                dataTransport->endTransaction();
+        }
+
+        return ret;
+    }
+
 	std::vector<unsigned char> DESFireEV1ISO7816Commands::readRecords(unsigned char fileno, unsigned int offset, unsigned int length, EncryptionMode mode)
     {
         std::vector<unsigned char> command;
@@ -1030,6 +1150,7 @@ namespace logicalaccess
         unsigned char uf = static_cast<unsigned char>(fileno);
         command.insert(command.begin(), uf);
 
+        d_fileSettings.erase(std::make_pair(static_cast<unsigned int>(crypto->d_currentAid), fileno));
 		if (crypto->d_auth_method == CM_LEGACY || plain)
         {
             transmit_plain(DF_INS_CHANGE_FILE_SETTINGS, command);
@@ -1130,6 +1251,7 @@ namespace logicalaccess
             }
         }
 		crypto->setKey(crypto->d_currentAid, 0, keyno, newkey);
+		crypto->invalidateSession();
     }
 
     void DESFireEV1ISO7816Commands::getVersion(DESFireCommands::DESFireCardVersion& dataVersion)
@@ -1246,6 +1368,9 @@ namespace logicalaccess
 
     void DESFireEV1ISO7816Commands::iso_selectApplication(std::vector<unsigned char> isoaid)
     {
+        // The current application is unknown afterwards.
+        getDESFireChip()->getCrypto()->invalidateSession();
+        d_fileSettings.clear();
         DESFireISO7816Commands::getISO7816ReaderCardAdapter()->sendAPDUCommand(DFEV1_CLA_ISO_COMPATIBLE, ISO7816_INS_SELECT_FILE, SELECT_FILE_BY_AID, 0x00, static_cast<unsigned char>(isoaid.size()), isoaid);
     }
 
@@ -1385,7 +1510,8 @@ namespace logicalaccess
                                                          uint8_t keyno)
     {
         assert(key->getKeyType() == DF_KEY_AES && key->getKeyStorage()->getType() == KST_SERVER);
-        iks::IslogKeyServer &iks = iks::IslogKeyServer::fromGlobalSettings();
+        // Both steps run on the same connection, other threads use their own.
+        iks::IKSConnectionPool::Lease iks = iks::IslogKeyServer::fromGlobalSettings().acquire();
 
 		std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
 
@@ -1398,8 +1524,8 @@ namespace logicalaccess
         cmd.div_info_ = iks::KeyDivInfo::build(key, getChip()->getChipIdentifier(),
 			keyno, crypto->d_currentAid);
 
-        iks.send_command(cmd);
-        auto resp = std::dynamic_pointer_cast<iks::DesfireAuthResponse>(iks.recv());
+        iks->send_command(cmd);
+        auto resp = std::dynamic_pointer_cast<iks::DesfireAuthResponse>(iks->recv());
         EXCEPTION_ASSERT_WITH_LOG(resp, IKSException, "Cannot retrieve proper response from server.");
         auto cryptogram = std::vector<uint8_t>(resp->data_.begin(), resp->data_.end());
 
@@ -1413,8 +1539,8 @@ namespace logicalaccess
 			keyno, crypto->d_currentAid);
 
         std::copy(cryptogram.begin(), cryptogram.end(), cmd.data_.begin());
-        iks.send_command(cmd);
-        resp = std::dynamic_pointer_cast<iks::DesfireAuthResponse>(iks.recv());
+        iks->send_command(cmd);
+        resp = std::dynamic_pointer_cast<iks::DesfireAuthResponse>(iks->recv());
         EXCEPTION_ASSERT_WITH_LOG(resp, IKSException, "Cannot retrieve proper response from server.");
         EXCEPTION_ASSERT_WITH_LOG(resp->success_, IKSException, "Mutual authentication failure.");
 
@@ -204,6 +204,16 @@ namespace logicalaccess
          */
         virtual std::vector<unsigned char> readData(unsigned char fileno, unsigned int offset, unsigned int length, EncryptionMode mode);
 
+        /**
+         * \brief Read data from several files of the current application, within a single reader transaction.
+         *
+         * Without CMAC session, all the ReadData commands and their additional frames are sent as one batch.
+         * Otherwise each command depends on the CMAC of the previous response and is sent in turn.
+         * \param files The parts of the files to read, in order.
+         * \return The bytes readed, one buffer per file part.
+         */
+        virtual std::vector<std::vector<unsigned char> > readFiles(const std::vector<FileRead>& files);
+
         /**
          * \brief Read record from a specific record file.
          * \param fileno The file number
@@ -39,6 +39,7 @@ namespace logicalaccess
 		std::vector<unsigned char> result = transmit(DF_INS_FORMAT_PICC);
 		if (result.size() < 2 || result[result.size() - 2] != 0x91 || result[result.size() - 1] != 0x00)
 			THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, "Erase command failed.");
+        d_fileSettings.clear();
     }
 
     void DESFireISO7816Commands::getVersion(DESFireCardVersion& dataVersion)
@@ -114,6 +115,7 @@ namespace logicalaccess
         DESFireLocation::convertUIntToAid(aid, command);
 
         transmit(DF_INS_DELETE_APPLICATION, command, sizeof(command));
+        clearFileSettings(aid);
     }
 
     std::vector<unsigned int> DESFireISO7816Commands::getApplicationIDs()
@@ -311,6 +313,7 @@ namespace logicalaccess
             command.insert(command.end(), cryptogram.begin(), cryptogram.end());
             transmit(DF_INS_CHANGE_KEY, command);
 			crypto->setKey(crypto->d_currentAid, 0, keyno, newkey);
+			crypto->invalidateSession();
         }
     }
 
@@ -356,6 +359,26 @@ namespace logicalaccess
         memcpy(&fileSetting, &result[0], result.size() - 2);
     }
 
+    void DESFireISO7816Commands::getCachedFileSettings(unsigned char fileno, FileSetting& fileSetting)
+    {
+        std::pair<unsigned int, unsigned char> file(static_cast<unsigned int>(getDESFireChip()->getCrypto()->d_currentAid), fileno);
+        std::map<std::pair<unsigned int, unsigned char>, FileSetting>::const_iterator it = d_fileSettings.find(file);
+        if (it != d_fileSettings.end())
+        {
+            fileSetting = it->second;
+            return;
+        }
+
+        getFileSettings(fileno, fileSetting);
+        d_fileSettings[file] = fileSetting;
+    }
+
+    void DESFireISO7816Commands::clearFileSettings(unsigned int aid)
+    {
+        d_fileSettings.erase(d_fileSettings.lower_bound(std::make_pair(aid, static_cast<unsigned char>(0x00))),
+                             d_fileSettings.upper_bound(std::make_pair(aid, static_cast<unsigned char>(0xff))));
+    }
+
     std::vector<unsigned char> DESFireISO7816Commands::handleReadData(unsigned char err, const std::vector<unsigned char>& firstMsg, unsigned int length, EncryptionMode mode)
     {
 		std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
@@ -512,6 +535,7 @@ namespace logicalaccess
         unsigned char fc = static_cast<unsigned char>(fileno);
         command.insert(command.begin(), &fc, &fc + 1);
 
+        d_fileSettings.erase(std::make_pair(static_cast<unsigned int>(getDESFireChip()->getCrypto()->d_currentAid), fileno));
         transmit(DF_INS_CHANGE_FILE_SETTINGS, command);
     }
 
@@ -603,33 +627,72 @@ namespace logicalaccess
 
         command.push_back(fileno);
 
+        d_fileSettings.erase(std::make_pair(static_cast<unsigned int>(getDESFireChip()->getCrypto()->d_currentAid), fileno));
         transmit(DF_INS_DELETE_FILE, command);
     }
 
     std::vector<unsigned char> DESFireISO7816Commands::readData(unsigned char fileno, unsigned int offset, unsigned int length, EncryptionMode mode)
     {
-        std::vector<unsigned char> command, ret;
-
-        command.push_back(fileno);
+        std::vector<std::vector<unsigned char> > commands;
+        std::vector<unsigned int> lengths;
+        std::vector<unsigned char> ret;
 
         // Currently we have some problems to read more than 253 bytes with an Omnikey Reader.
         // So the read command is separated to some commands, 8 bytes aligned.
+        // All the commands are sent within one reader transaction.
 
         for (size_t i = 0; i < length; i += 248)
         {
             size_t trunloffset = offset + i;
             size_t trunklength = ((length - i) > 248) ? 248 : (length - i);
+
+            std::vector<unsigned char> command;
+            command.push_back(DF_CLA_ISO_WRAP);
+            command.push_back(DF_INS_READ_DATA);
+            command.push_back(0x00);
+            command.push_back(0x00);
+            command.push_back(0x07);
+            command.push_back(fileno);
             command.push_back(static_cast<unsigned char>(trunloffset & 0xff));
             command.push_back(static_cast<unsigned char>(static_cast<unsigned short>(trunloffset & 0xff00) >> 8));
             command.push_back(static_cast<unsigned char>(static_cast<unsigned int>(trunloffset & 0xff0000) >> 16));
             command.push_back(static_cast<unsigned char>(trunklength & 0xff));
             command.push_back(static_cast<unsigned char>(static_cast<unsigned short>(trunklength & 0xff00) >> 8));
             command.push_back(static_cast<unsigned char>(static_cast<unsigned int>(trunklength & 0xff0000) >> 16));
+            command.push_back(0x00);
 
-            std::vector<unsigned char> result = transmit(DF_INS_READ_DATA, command);
+            commands.push_back(command);
+            lengths.push_back(static_cast<unsigned int>(trunklength));
+        }
+
+        // The additional frames of each command are fetched before the next one, the card would abort it otherwise.
+        // In MAC mode, the MAC of the chained frames is then verified as a whole.
+        std::vector<unsigned char> additionalFrame;
+        additionalFrame.push_back(DF_CLA_ISO_WRAP);
+        additionalFrame.push_back(DF_INS_ADDITIONAL_FRAME);
+        additionalFrame.push_back(0x00);
+        additionalFrame.push_back(0x00);
+        additionalFrame.push_back(0x00);
+
+        std::vector<std::vector<unsigned char> > results;
+        try
+        {
+            results = getISO7816ReaderCardAdapter()->sendAPDUCommands(commands, ISO7816APDUChaining(0x91, DF_INS_ADDITIONAL_FRAME, additionalFrame));
+        }
+        catch (std::exception&)
+        {
+            // The card drops the authentication on error.
+            if (getDESFireChip())
+                getDESFireChip()->getCrypto()->invalidateSession();
+            throw;
+        }
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            std::vector<unsigned char>& result = results[i];
             unsigned char err = result.back();
             result.resize(result.size() - 2);
-            result = handleReadData(err, result, static_cast<unsigned int>(trunklength), mode);
+            result = handleReadData(err, result, lengths[i], mode);
             ret.insert(ret.end(), result.begin(), result.end());
         }
 
@@ -889,6 +952,8 @@ namespace logicalaccess
 		}
 		else
 			THROW_EXCEPTION_WITH_LOG(CardException, "DESFire authentication P1 failed.");
+
+		crypto->setAuthenticatedKey(currentKey);
 	}
 
     std::vector<unsigned char> DESFireISO7816Commands::transmit(unsigned char cmd, unsigned char lc)
@@ -898,22 +963,33 @@ namespace logicalaccess
 
     std::vector<unsigned char> DESFireISO7816Commands::transmit(unsigned char cmd, const std::vector<unsigned char>& data, unsigned char lc, bool forceLc)
     {
-        if (data.size())
+        try
         {
-            return getISO7816ReaderCardAdapter()->sendAPDUCommand(DF_CLA_ISO_WRAP, cmd, 0x00, 0x00, static_cast<unsigned char>(data.size()), data, 0x00);
+            if (data.size())
+            {
+                return getISO7816ReaderCardAdapter()->sendAPDUCommand(DF_CLA_ISO_WRAP, cmd, 0x00, 0x00, static_cast<unsigned char>(data.size()), data, 0x00);
+            }
+            else if (forceLc)
+            {
+                return getISO7816ReaderCardAdapter()->sendAPDUCommand(DF_CLA_ISO_WRAP, cmd, 0x00, 0x00, lc, 0x00);
+            }
+
+            return getISO7816ReaderCardAdapter()->sendAPDUCommand(DF_CLA_ISO_WRAP, cmd, 0x00, 0x00, 0x00);
         }
-        else if (forceLc)
+        catch (std::exception&)
         {
-            return getISO7816ReaderCardAdapter()->sendAPDUCommand(DF_CLA_ISO_WRAP, cmd, 0x00, 0x00, lc, 0x00);
+            // The card drops the authentication on error.
+            if (getDESFireChip())
+                getDESFireChip()->getCrypto()->invalidateSession();
+            throw;
         }
-
-        return getISO7816ReaderCardAdapter()->sendAPDUCommand(DF_CLA_ISO_WRAP, cmd, 0x00, 0x00, 0x00);
     }
 
     void DESFireISO7816Commands::setChip(std::shared_ptr<Chip> chip)
     {
         DESFireCommands::setChip(chip);
 		getDESFireChip()->getCrypto()->setCryptoContext(chip->getChipIdentifier());
+        d_fileSettings.clear();
     }
 
     void DESFireISO7816Commands::iks_des_authenticate(unsigned char keyno,
@@ -945,7 +1021,8 @@ namespace logicalaccess
         {
             result.resize(8);
             std::vector<unsigned char> rndAB;
-            iks::IslogKeyServer &iks = iks::IslogKeyServer::fromGlobalSettings();
+            // Both steps run on the same connection, other threads use their own.
+            iks::IKSConnectionPool::Lease iks = iks::IslogKeyServer::fromGlobalSettings().acquire();
 
             iks::DesfireAuthCommand cmd;
             cmd.key_idt_ = std::static_pointer_cast<IKSStorage>(key->getKeyStorage())->getKeyIdentity();
@@ -953,8 +1030,8 @@ namespace logicalaccess
             cmd.algo_ = iks::DESFIRE_AUTH_ALGO_DES;
             memcpy(&cmd.data_[0], &result[0], result.size());
 
-            iks.send_command(cmd);
-            auto resp = std::dynamic_pointer_cast<iks::DesfireAuthResponse>(iks.recv());
+            iks->send_command(cmd);
+            auto resp = std::dynamic_pointer_cast<iks::DesfireAuthResponse>(iks->recv());
             EXCEPTION_ASSERT_WITH_LOG(resp, IKSException, "Cannot retrieve proper response from server.");
             rndAB = std::vector<uint8_t>(resp->data_.begin(), resp->data_.begin() + 16);
 
@@ -966,8 +1043,8 @@ namespace logicalaccess
                 assert(result.size() == 8);
                 assert(result.size() <= cmd.data_.max_size());
                 memcpy(&cmd.data_[0], &result[0], result.size());
-                iks.send_command(cmd);
-                resp = std::dynamic_pointer_cast<iks::DesfireAuthResponse>(iks.recv());
+                iks->send_command(cmd);
+                resp = std::dynamic_pointer_cast<iks::DesfireAuthResponse>(iks->recv());
                 EXCEPTION_ASSERT_WITH_LOG(resp, IKSException, "Cannot retrieve proper response from server.");
                 EXCEPTION_ASSERT_WITH_LOG(resp->success_, IKSException, "Mutual Authentication failed.");
 
@@ -988,7 +1065,7 @@ namespace logicalaccess
         auto storage = std::dynamic_pointer_cast<IKSStorage>(key->getKeyStorage());
         assert(storage);
 
-        iks::IslogKeyServer &key_server = iks::IslogKeyServer::fromGlobalSettings();
+        iks::IKSConnectionPool::Lease key_server = iks::IslogKeyServer::fromGlobalSettings().acquire();
         iks::DesfireChangeKeyCommand cmd;
 		std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
 
@@ -1009,10 +1086,10 @@ namespace logicalaccess
        cmd.newkey_divinfo_ = iks::KeyDivInfo::build(key, getChip()->getChipIdentifier(),
 		   keyno, crypto->d_currentAid);
 
-        key_server.send_command(cmd);
+        key_server->send_command(cmd);
 
 
-        auto resp = std::dynamic_pointer_cast<iks::DesfireChangeKeyResponse>(key_server.recv());
+        auto resp = std::dynamic_pointer_cast<iks::DesfireChangeKeyResponse>(key_server->recv());
         EXCEPTION_ASSERT_WITH_LOG(resp, IKSException, "Cannot retrieve a proper response from IKS.");
         EXCEPTION_ASSERT_WITH_LOG(resp->status_ == iks::SMSG_STATUS_SUCCESS,
                                   IKSException, "Cannot retrieve a proper response from IKS.");
@@ -13,6 +13,7 @@
 #include "../iso7816readerunit.hpp"
 #include "samav2/samchip.hpp"
 
+#include <map>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -114,6 +115,13 @@ namespace logicalaccess
          */
         virtual void getFileSettings(unsigned char fileno, FileSetting& fileSetting);
 
+        /**
+         * \brief Get settings of a specific file in the current application, read from the card only once.
+         * \param fileno The file number
+         * \param fileSetting The file setting
+         */
+        virtual void getCachedFileSettings(unsigned char fileno, FileSetting& fileSetting);
+
         /**
          * \brief Change file settings of a specific file in the current application.
          * \param fileno The file number
@@ -361,10 +369,21 @@ namespace logicalaccess
          */
         virtual std::vector<unsigned char> transmit(unsigned char cmd, const std::vector<unsigned char>& data = std::vector<unsigned char>(), unsigned char lc = 0, bool forceLc = false);
 
+        /**
+         * \brief Forget the cached settings of the files of an application.
+         * \param aid The Application ID
+         */
+        void clearFileSettings(unsigned int aid);
+
         /**
          * \brief The SAMChip used for the SAM Commands.
          */
         std::shared_ptr<SAMChip> d_SAM_chip;
+
+        /**
+         * \brief The file settings read from the card, by Application ID and file number.
+         */
+        std::map<std::pair<unsigned int, unsigned char>, FileSetting> d_fileSettings;
     };
 }
 
@@ -45,4 +45,9 @@ namespace logicalaccess
 
 		return result;
 	}
+
+	void ISO7816FuzzingReaderCardAdapter::exchangeAsync(const std::vector<unsigned char>& command, long timeout, DataTransport::CommandHandler handler)
+	{
+		exchangeInline(command, timeout, handler);
+	}
 }
\ No newline at end of file
@@ -31,6 +31,10 @@ namespace logicalaccess
 
 		virtual std::vector<unsigned char> sendCommand(const std::vector<unsigned char>& command, long timeout = -1);
 
+	protected:
+
+		virtual void exchangeAsync(const std::vector<unsigned char>& command, long timeout, DataTransport::CommandHandler handler);
+
 	private:
 		static int index;
 		int currentIndex;
@@ -6,7 +6,10 @@
 
 #include "iso7816readercardadapter.hpp"
 
+#include "logicalaccess/myexception.hpp"
+
 #include <cstring>
+#include <stdexcept>
 
 namespace logicalaccess
 {
@@ -24,78 +27,178 @@ namespace logicalaccess
         }
     }
 
+    ISO7816APDU::ISO7816APDU(unsigned char cla, unsigned char ins, unsigned char p1, unsigned char p2)
+        : d_size(4)
+    {
+        d_inline[0] = cla;
+        d_inline[1] = ins;
+        d_inline[2] = p1;
+        d_inline[3] = p2;
+    }
+
+    void ISO7816APDU::append(const unsigned char* buf, size_t buflen)
+    {
+        if (d_heap.empty() && d_size + buflen <= INLINE_SIZE)
+        {
+            memcpy(d_inline + d_size, buf, buflen);
+        }
+        else
+        {
+            if (d_heap.empty())
+                d_heap.assign(d_inline, d_inline + d_size);
+            d_heap.insert(d_heap.end(), buf, buf + buflen);
+        }
+        d_size += buflen;
+    }
+
+    std::vector<unsigned char> ISO7816ReaderCardAdapter::sendAPDUCommand(const ISO7816APDU& apdu)
+    {
+        std::vector<unsigned char> result;
+        sendAPDUCommand(apdu, result);
+        return result;
+    }
+
+    void ISO7816ReaderCardAdapter::sendAPDUCommand(const ISO7816APDU& apdu, std::vector<unsigned char>& result)
+    {
+        transmit(apdu.data(), apdu.size(), result);
+    }
+
     std::vector<unsigned char> ISO7816ReaderCardAdapter::sendAPDUCommand(unsigned char cla, unsigned char ins, unsigned char p1, unsigned char p2, unsigned char lc, const std::vector<unsigned char>& data, unsigned char le)
     {
-        std::vector<unsigned char> command;
-        command.push_back(cla);
-        command.push_back(ins);
-        command.push_back(p1);
-        command.push_back(p2);
-        command.push_back(lc);
-        command.insert(command.end(), data.begin(), data.end());
-        command.push_back(le);
-
-        return sendCommand(command);
+        ISO7816APDU apdu(cla, ins, p1, p2);
+        apdu.push_back(lc);
+        apdu.append(data);
+        apdu.push_back(le);
+
+        return sendAPDUCommand(apdu);
     }
 
     std::vector<unsigned char> ISO7816ReaderCardAdapter::sendAPDUCommand(unsigned char cla, unsigned char ins, unsigned char p1, unsigned char p2, unsigned char lc, const std::vector<unsigned char>& data)
     {
-        std::vector<unsigned char> command;
-        command.push_back(cla);
-        command.push_back(ins);
-        command.push_back(p1);
-        command.push_back(p2);
-        command.push_back(lc);
-        command.insert(command.end(), data.begin(), data.end());
-
-        return sendCommand(command);
+        ISO7816APDU apdu(cla, ins, p1, p2);
+        apdu.push_back(lc);
+        apdu.append(data);
+
+        return sendAPDUCommand(apdu);
     }
 
     std::vector<unsigned char> ISO7816ReaderCardAdapter::sendAPDUCommand(unsigned char cla, unsigned char ins, unsigned char p1, unsigned char p2, const std::vector<unsigned char>& data)
     {
-        std::vector<unsigned char> command;
-        command.push_back(cla);
-        command.push_back(ins);
-        command.push_back(p1);
-        command.push_back(p2);
-        command.insert(command.end(), data.begin(), data.end());
-
-        return sendCommand(command);
+        ISO7816APDU apdu(cla, ins, p1, p2);
+        apdu.append(data);
+
+        return sendAPDUCommand(apdu);
     }
 
     std::vector<unsigned char> ISO7816ReaderCardAdapter::sendAPDUCommand(unsigned char cla, unsigned char ins, unsigned char p1, unsigned char p2, unsigned char le)
     {
-        std::vector<unsigned char> command;
-        command.push_back(cla);
-        command.push_back(ins);
-        command.push_back(p1);
-        command.push_back(p2);
-        command.push_back(le);
-
-        return sendCommand(command);
+        ISO7816APDU apdu(cla, ins, p1, p2);
+        apdu.push_back(le);
+
+        return sendAPDUCommand(apdu);
     }
 
     std::vector<unsigned char> ISO7816ReaderCardAdapter::sendAPDUCommand(unsigned char cla, unsigned char ins, unsigned char p1, unsigned char p2, unsigned char lc, unsigned char le)
     {
-        std::vector<unsigned char> command;
-        command.push_back(cla);
-        command.push_back(ins);
-        command.push_back(p1);
-        command.push_back(p2);
-        command.push_back(lc);
-        command.push_back(le);
-
-        return sendCommand(command);
+        ISO7816APDU apdu(cla, ins, p1, p2);
+        apdu.push_back(lc);
+        apdu.push_back(le);
+
+        return sendAPDUCommand(apdu);
     }
 
     std::vector<unsigned char> ISO7816ReaderCardAdapter::sendAPDUCommand(unsigned char cla, unsigned char ins, unsigned char p1, unsigned char p2)
     {
-        std::vector<unsigned char> command;
-        command.push_back(cla);
-        command.push_back(ins);
-        command.push_back(p1);
-        command.push_back(p2);
+        ISO7816APDU apdu(cla, ins, p1, p2);
+
+        return sendAPDUCommand(apdu);
+    }
+
+    std::vector<unsigned char> ISO7816ReaderCardAdapter::sendExtendedAPDUCommand(unsigned char cla, unsigned char ins, unsigned char p1, unsigned char p2, const std::vector<unsigned char>& data, unsigned int le)
+    {
+        EXCEPTION_ASSERT_WITH_LOG(data.size() <= 65535, std::invalid_argument, "The APDU command data cannot exceed 65535 bytes.");
+        EXCEPTION_ASSERT_WITH_LOG(le <= 65536, std::invalid_argument, "The APDU expected response length cannot exceed 65536 bytes.");
+
+        bool extended = (data.size() > 255 || le > 256);
+        if (extended && !d_extendedLength)
+        {
+            THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, "Extended length APDU are not supported by the reader or the card.");
+        }
+
+        ISO7816APDU command(cla, ins, p1, p2);
+        if (data.size() > 0)
+        {
+            if (extended)
+            {
+                command.push_back(0x00);
+                command.push_back(static_cast<unsigned char>((data.size() >> 8) & 0xff));
+            }
+            command.push_back(static_cast<unsigned char>(data.size() & 0xff));
+            command.append(data);
+        }
+        if (le > 0)
+        {
+            // With extended length, Le is only preceded by 0x00 when there is no Lc.
+            if (extended)
+            {
+                if (data.size() == 0)
+                    command.push_back(0x00);
+                command.push_back(static_cast<unsigned char>((le >> 8) & 0xff));
+            }
+            command.push_back(static_cast<unsigned char>(le & 0xff));
+        }
+
+        return sendAPDUCommand(command);
+    }
+
+    std::vector<std::vector<unsigned char> > ISO7816ReaderCardAdapter::sendAPDUCommands(const std::vector<std::vector<unsigned char> >& commands, const ISO7816APDUChaining& chaining)
+    {
+        std::vector<std::vector<unsigned char> > responses;
+        std::shared_ptr<DataTransport> dataTransport = getDataTransport();
+
+        if (dataTransport)
+            dataTransport->beginTransaction();
+
+        try
+        {
+            for (std::vector<std::vector<unsigned char> >::const_iterator it = commands.begin(); it != commands.end(); ++it)
+            {
+                std::vector<unsigned char> res = sendCommand(*it);
+
+                if (chaining.enabled)
+                {
+                    std::vector<unsigned char> data;
+                    while (res.size() >= 2 && res[res.size() - 2] == chaining.sw1 && res[res.size() - 1] == chaining.sw2)
+                    {
+                        data.insert(data.end(), res.begin(), res.end() - 2);
+                        res = sendCommand(chaining.continuation);
+                    }
+                    data.insert(data.end(), res.begin(), res.end());
+                    res.swap(data);
+                }
+
+                responses.push_back(res);
+            }
+        }
+        catch (...)
+        {
+            if (dataTransport)
+            {
+                try
+                {
+                    dataTransport->endTransaction();
+                }
+                catch (std::exception& ex)
+                {
+                    LOG(LogLevel::ERRORS) << "Cannot end the APDU batch transaction: " << ex.what();
+                }
+            }
+            throw;
+        }
+
+        if (dataTransport)
+            dataTransport->endTransaction();
 
-        return sendCommand(command);
+        return responses;
     }
 }
\ No newline at end of file
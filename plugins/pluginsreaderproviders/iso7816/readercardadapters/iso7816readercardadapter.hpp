@@ -16,6 +16,97 @@
 
 namespace logicalaccess
 {
+    /**
+     * \brief Response chaining rule for APDU batches.
+     *
+     * While a response ends with the status word sw1 sw2, the continuation APDU
+     * is sent and its response appended, without the intermediate status words.
+     * E.g. DESFire native commands continue with 90 AF 00 00 00 on SW=91AF.
+     */
+    struct LIBLOGICALACCESS_API ISO7816APDUChaining
+    {
+        /**
+         * \brief No chaining.
+         */
+        ISO7816APDUChaining() : enabled(false), sw1(0x00), sw2(0x00) {}
+
+        /**
+         * \brief Chain on the given status word.
+         */
+        ISO7816APDUChaining(unsigned char csw1, unsigned char csw2, const std::vector<unsigned char>& ccontinuation)
+            : enabled(true), sw1(csw1), sw2(csw2), continuation(ccontinuation) {}
+
+        bool enabled;
+
+        unsigned char sw1;
+
+        unsigned char sw2;
+
+        std::vector<unsigned char> continuation;
+    };
+
+    /**
+     * \brief An APDU command built in place.
+     *
+     * Short APDU commands fit in the inline storage, bigger ones are moved to the heap.
+     */
+    class LIBLOGICALACCESS_API ISO7816APDU
+    {
+    public:
+
+        /**
+         * \brief Inline storage size: CLA INS P1 P2 Lc, 255 bytes of data and Le.
+         */
+        static const size_t INLINE_SIZE = 261;
+
+        /**
+         * \brief Constructor.
+         */
+        ISO7816APDU(unsigned char cla, unsigned char ins, unsigned char p1, unsigned char p2);
+
+        /**
+         * \brief Append a byte.
+         */
+        void push_back(unsigned char c) { append(&c, 1); };
+
+        /**
+         * \brief Append a buffer.
+         */
+        void append(const unsigned char* buf, size_t buflen);
+
+        /**
+         * \brief Append a buffer.
+         */
+        void append(const std::vector<unsigned char>& buf) { append(buf.data(), buf.size()); };
+
+        /**
+         * \brief Get the command buffer.
+         */
+        const unsigned char* data() const { return d_heap.empty() ? d_inline : d_heap.data(); };
+
+        /**
+         * \brief Get the command length.
+         */
+        size_t size() const { return d_size; };
+
+    protected:
+
+        unsigned char d_inline[INLINE_SIZE];
+
+        size_t d_size;
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+        std::vector<unsigned char> d_heap;
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+    };
+
     /**
      * \brief A default ISO7816 reader/card adapter class.
      */
@@ -23,6 +114,11 @@ namespace logicalaccess
     {
     public:
 
+        /**
+         * \brief Constructor.
+         */
+        ISO7816ReaderCardAdapter() : d_extendedLength(false) {};
+
         /**
         * \brief Send an APDU command to the reader.
         */
@@ -58,7 +154,60 @@ namespace logicalaccess
          */
         virtual std::vector<unsigned char> sendAPDUCommand(unsigned char cla, unsigned char ins, unsigned char p1, unsigned char p2);
 
+        /**
+         * \brief Send an APDU command to the reader.
+         * \param apdu The APDU command.
+         * \return The response.
+         */
+        std::vector<unsigned char> sendAPDUCommand(const ISO7816APDU& apdu);
+
+        /**
+         * \brief Send an APDU command to the reader, writing the response to a caller owned buffer.
+         * \param apdu The APDU command.
+         * \param result The result buffer, replaced by the response.
+         */
+        void sendAPDUCommand(const ISO7816APDU& apdu, std::vector<unsigned char>& result);
+
+        /**
+         * \brief Send an APDU command to the reader, using extended length Lc/Le fields when the short ones are not enough.
+         * \param data The command data, up to 65535 bytes.
+         * \param le The expected response length, up to 65536 bytes. 0 if no response data is expected.
+         * \return The response.
+         */
+        virtual std::vector<unsigned char> sendExtendedAPDUCommand(unsigned char cla, unsigned char ins, unsigned char p1, unsigned char p2, const std::vector<unsigned char>& data, unsigned int le);
+
+        /**
+         * \brief Set if both the reader and the card support extended length APDU.
+         * \param extendedLength True if extended length APDU are supported, false otherwise.
+         */
+        void setExtendedLengthSupported(bool extendedLength) { d_extendedLength = extendedLength; };
+
+        /**
+         * \brief Get if both the reader and the card support extended length APDU.
+         * \return True if extended length APDU are supported, false otherwise.
+         */
+        bool isExtendedLengthSupported() const { return d_extendedLength; };
+
+        /**
+         * \brief Get the maximum response data length for a single APDU command.
+         * \return The maximum length, 65536 with extended length APDU, 256 otherwise.
+         */
+        unsigned int getMaxResponseLength() const { return d_extendedLength ? 65536 : 256; };
+
+        /**
+         * \brief Send a batch of APDU commands to the reader, within a single reader transaction.
+         * \param commands The APDU commands, sent in order.
+         * \param chaining The response chaining rule.
+         * \return The responses, one per command, each ending with its last status word.
+         */
+        virtual std::vector<std::vector<unsigned char> > sendAPDUCommands(const std::vector<std::vector<unsigned char> >& commands, const ISO7816APDUChaining& chaining = ISO7816APDUChaining());
+
     protected:
+
+        /**
+         * \brief True if extended length APDU are supported.
+         */
+        bool d_extendedLength;
     };
 }
 
@@ -24,6 +24,7 @@
 #include "iso7816/commands/desfireiso7816resultchecker.hpp"
 
 #include "osdpcommands.hpp"
+#include "logicalaccess/readerproviders/readerpollscheduler.hpp"
 
 namespace logicalaccess
 {
@@ -107,10 +108,8 @@ namespace logicalaccess
 
 	bool OSDPReaderUnit::waitInsertion(unsigned int maxwait)
 	{
-		unsigned int currentWait = 0;
-        bool inserted = false;
-
-        do
+        // Keep the OSDP line from being flooded with polls.
+        bool inserted = ReaderPollScheduler::getInstance()->waitFor([this]()
         {
             std::shared_ptr<OSDPChannel> poll = m_commands->poll();
 
@@ -120,18 +119,14 @@ namespace logicalaccess
             {
                 std::vector<unsigned char>& data = poll->getData();
                 if (data.size() > 2 && data[0x01] == 0x01) //osdp_PRES
-                    inserted = true;
+                    return true;
             }
-            else
-            {
-                if (poll->getCommandsType() == OSDPCommandsType::LSTATR && poll->getData().size() > 1) {
-                    LOG(LogLevel::INFOS) << "Tamper status changed to: " << static_cast<bool>(poll->getData()[0x00] != 0);
-					m_tamperStatus = static_cast<bool>(poll->getData()[0x00] != 0);
-                }
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                currentWait += 100;
+            else if (poll->getCommandsType() == OSDPCommandsType::LSTATR && poll->getData().size() > 1) {
+                LOG(LogLevel::INFOS) << "Tamper status changed to: " << static_cast<bool>(poll->getData()[0x00] != 0);
+				m_tamperStatus = static_cast<bool>(poll->getData()[0x00] != 0);
             }
-        } while (!inserted && (maxwait == 0 || currentWait < maxwait));
+            return false;
+        }, maxwait, ReaderPollProfile(50, 200));
 
 		if (inserted)
 		{
@@ -150,11 +145,9 @@ namespace logicalaccess
 
 	bool OSDPReaderUnit::waitRemoval(unsigned int maxwait)
 	{
-		unsigned int currentWait = 0;
-		bool removed = false;
         bool disconnected = false;
 
-		do
+		bool removed = ReaderPollScheduler::getInstance()->waitFor([this, &disconnected]()
 		{
 			std::shared_ptr<OSDPChannel> poll = m_commands->poll();
 
@@ -167,7 +160,7 @@ namespace logicalaccess
                 disconnected = true;
             }
             else if (!disconnected) {
-                removed = true;
+                return true;
             } else {
                 if (poll->getCommandsType() == OSDPCommandsType::LSTATR && poll->getData().size() > 1) {
 					LOG(LogLevel::INFOS) << "Tamper status changed to: " << static_cast<bool>(poll->getData()[0x00] != 0);
@@ -176,11 +169,8 @@ namespace logicalaccess
                 else
                     disconnected = false;
             }
-
-            if (!removed)
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            currentWait += 100;
-		} while (!removed && (maxwait == 0 || currentWait < maxwait));
+            return false;
+		}, maxwait, ReaderPollProfile(50, 200));
 
 		return removed;
 	}
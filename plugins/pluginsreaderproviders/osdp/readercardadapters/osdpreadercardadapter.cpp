@@ -59,6 +59,11 @@ namespace logicalaccess
 		return res;
 	}
 
+	void OSDPReaderCardAdapter::exchangeAsync(const std::vector<unsigned char>& command, long timeout, DataTransport::CommandHandler handler)
+	{
+		exchangeInline(command, timeout, handler);
+	}
+
 	OSDPReaderCardAdapter::~OSDPReaderCardAdapter()
 	{
 		//Restore Profile 0x00 command
@@ -32,6 +32,11 @@ namespace logicalaccess
 			virtual std::vector<unsigned char> sendCommand(const std::vector<unsigned char>& command, long timeout = -1);
 
 		protected:
+
+			/**
+			* \brief OSDP secure channel exchanges are synchronous, run sendCommand() in the calling thread.
+			*/
+			virtual void exchangeAsync(const std::vector<unsigned char>& command, long timeout, DataTransport::CommandHandler handler);
 			
 			std::shared_ptr<DataTransport> d_dataTransport;
 
@@ -1,49 +1,381 @@
 #include "atrparser.hpp"
 #include "logicalaccess/bufferhelper.hpp"
 #include "logicalaccess/logs.hpp"
+#include "logicalaccess/settings.hpp"
 #include <algorithm>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <map>
 #include <logicalaccess/myexception.hpp>
+#include <memory>
+#include <mutex>
+#include <sstream>
 
 namespace logicalaccess
 {
+namespace
+{
+/**
+ * An hardcoded ATR. The reader type is -1 for an ATR acceptable for any
+ * reader. An 'x' nibble matches any value.
+ */
+struct HardcodedATR
+{
+    const char *atr;
+    const char *card_type;
+    int reader_type;
+};
+
+const HardcodedATR hardcoded_atrs[] = {
+    {"3B8F8001804F0CA0000003064000000000000028", "Prox", PCSC_RUT_OMNIKEY_XX27},
+    {"3B878001C1052F2F0035C730", "MifarePlusS", -1},
+    {"3B878001C1052F2F01BCD6A9", "MifarePlusX", -1},
+    {"3B8F8001804F0CA000000306030036000000005D", "MifarePlus_SL1_2K", -1},
+    {"3B8F8001804F0CA000000306030037000000005C", "MifarePlus_SL1_4K", -1},
+    // {"3B8F8001804F0CA0000003060300020000000069", "MifarePlus_SL1_4K", -1},
+    {"3B8F8001804F0CA000000306030001000000006A", "MifarePlus_SL1_2K",
+     PCSC_RUT_ACS_ACR_1222L},
+    {"3B8F8001804F0CA00000030603FFA00000000034", "MifarePlus_SL1_4K",
+     PCSC_RUT_SPRINGCARD},
+    {"3B878001C1052F2F0035C730", "MifarePlus_SL3_2K", -1},
+    {"3BF59100FF918171FE400041080000000D", "Mifare1K", -1},
+    {"3BF59100FF918171FE400041180000001D", "Mifare4K", -1},
+    {"3BF59100FF918171FE400041880000008D", "Mifare1K", -1},
+    {"3B09410411DD822F000088", "Mifare1K", -1},
+    {"3B8F8001804F0CA000000306030000000000006B", "Mifare1K", PCSC_RUT_ID3_CL1356},
+    {"3B8180018080", "DESFire", -1},
+    {"3B86800106757781028000", "DESFire", -1},
+    {"3BF79100FF918171FE40004120001177818040", "DESFire", -1},
+    {"3BF59100FF918171FE4000410x0000000005", "MifareUltralight", -1},
+    {"3B8C80010443FD", "FeliCa", -1},
+    {"3B8F80010031B86404B0ECC1739401808290000E", "CPS3", -1},
+    {"3B8F8001804F0CA0000003060B00120000000071", "TagIt", -1},
+    {"3B8F8001804F0CA00000030603F004000000009F", "Topaz", -1},
+    {"3BDF18FF81F1FE43003F03834D494641524520506C75732053414D3B", "SAM_AV2", -1},
+    {"3BDF18FF81F1FE43001F034D494641524520506C75732053414D98", "SAM_AV2", -1},
+    // SEOS or Electronic Passport / Spanish passport (2012)
+    {"3B80800101", "SEOS", -1}};
+
+/**
+ * A byte trie of the known ATRs. Each edge matches the bits of its mask,
+ * so that nibbles can be wildcards.
+ */
+class ATRTrie
+{
+  public:
+    ATRTrie()
+        : nodes_(1)
+    {
+    }
+
+    void insert(const std::string &atr, const std::string &card_type, bool any_reader,
+                PCSCReaderUnitType reader_type)
+    {
+        std::string pattern = atr;
+        pattern.erase(std::remove(pattern.begin(), pattern.end(), ' '), pattern.end());
+        EXCEPTION_ASSERT_WITH_LOG(!pattern.empty() && pattern.size() % 2 == 0,
+                                  LibLogicalAccessException,
+                                  "Bad ATR pattern " + atr + ".");
+
+        size_t node = 0;
+        for (size_t i = 0; i < pattern.size(); i += 2)
+        {
+            uint8_t value = 0, mask = 0;
+            for (size_t j = i; j < i + 2; ++j)
+            {
+                int nibble = nibble_value(pattern[j]);
+                EXCEPTION_ASSERT_WITH_LOG(nibble != -2, LibLogicalAccessException,
+                                          "Bad ATR pattern " + atr + ".");
+                value = static_cast<uint8_t>(value << 4);
+                mask  = static_cast<uint8_t>(mask << 4);
+                if (nibble >= 0)
+                {
+                    value |= static_cast<uint8_t>(nibble);
+                    mask |= 0x0F;
+                }
+            }
+            node = child(node, value, mask);
+        }
+
+        Node &terminal = nodes_[node];
+        if (any_reader)
+        {
+            terminal.has_any_reader = true;
+            terminal.any_reader     = card_type;
+        }
+        else
+        {
+            terminal.readers[reader_type] = card_type;
+        }
+    }
+
+    const std::string *match(const uint8_t *atr, size_t atrlen, bool ignore_reader_type,
+                             PCSCReaderUnitType reader_type) const
+    {
+        return match(0, atr, atrlen, 0, ignore_reader_type, reader_type);
+    }
+
+  private:
+    struct Edge
+    {
+        uint8_t value;
+        uint8_t mask;
+        size_t node;
+    };
+
+    struct Node
+    {
+        Node()
+            : has_any_reader(false)
+        {
+        }
+
+        /**
+         * Exact edges first, then wildcard ones.
+         */
+        std::vector<Edge> edges;
+        bool has_any_reader;
+        std::string any_reader;
+        std::map<PCSCReaderUnitType, std::string> readers;
+    };
+
+    static int nibble_value(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        if (c == 'x' || c == 'X' || c == '?')
+            return -1;
+        return -2;
+    }
+
+    size_t child(size_t node, uint8_t value, uint8_t mask)
+    {
+        std::vector<Edge> &edges = nodes_[node].edges;
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            if (edges[i].value == value && edges[i].mask == mask)
+                return edges[i].node;
+        }
+
+        Edge edge;
+        edge.value = value;
+        edge.mask  = mask;
+        edge.node  = nodes_.size();
+        nodes_.push_back(Node());
+
+        // nodes_ may have been reallocated.
+        std::vector<Edge> &new_edges = nodes_[node].edges;
+        if (mask == 0xFF)
+            new_edges.insert(new_edges.begin(), edge);
+        else
+            new_edges.push_back(edge);
+        return edge.node;
+    }
+
+    const std::string *match(size_t node, const uint8_t *atr, size_t atrlen, size_t pos,
+                             bool ignore_reader_type,
+                             PCSCReaderUnitType reader_type) const
+    {
+        const Node &current = nodes_[node];
+        if (pos == atrlen)
+        {
+            if (!ignore_reader_type)
+            {
+                auto it = current.readers.find(reader_type);
+                if (it != current.readers.end())
+                    return &it->second;
+            }
+            return current.has_any_reader ? &current.any_reader : nullptr;
+        }
+
+        for (const auto &edge : current.edges)
+        {
+            if ((atr[pos] & edge.mask) == edge.value)
+            {
+                const std::string *ret =
+                    match(edge.node, atr, atrlen, pos + 1, ignore_reader_type, reader_type);
+                if (ret)
+                    return ret;
+            }
+        }
+        return nullptr;
+    }
+
+    std::vector<Node> nodes_;
+};
+
+std::mutex &atr_database_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+/**
+ * The current ATR database, loaded and replaced atomically. A replaced
+ * database is freed once the last lookup holding it is done.
+ */
+std::shared_ptr<const ATRTrie> &atr_database_instance()
+{
+    static std::shared_ptr<const ATRTrie> database;
+    return database;
+}
+
+/**
+ * The database built from the hardcoded ATRs and the file, without the ATRs
+ * registered at runtime.
+ */
+std::shared_ptr<const ATRTrie> &atr_database_base()
+{
+    static std::shared_ptr<const ATRTrie> base;
+    return base;
+}
+
+/**
+ * Insert the ATRs of a file into a trie, see ATRParser::loadATRFile().
+ */
+size_t load_atr_file(ATRTrie &database, const std::string &filename)
+{
+    std::ifstream file(filename);
+    EXCEPTION_ASSERT_WITH_LOG(file, LibLogicalAccessException,
+                              "Cannot open the ATR file " + filename + ".");
+
+    size_t count = 0, line_number = 0;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        ++line_number;
+        line = line.substr(0, line.find('#'));
+        std::istringstream iss(line);
+        std::string atr, card_type, reader_type;
+        if (!(iss >> atr))
+            continue;
+        EXCEPTION_ASSERT_WITH_LOG(iss >> card_type, LibLogicalAccessException,
+                                  "Missing card type for ATR " + atr + " line " +
+                                      std::to_string(line_number) + ".");
+        if (iss >> reader_type)
+        {
+            unsigned long value = 0;
+            try
+            {
+                value = std::stoul(reader_type, nullptr, 0);
+            }
+            catch (const std::logic_error &)
+            {
+                THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
+                                         "Bad reader type " + reader_type + " line " +
+                                             std::to_string(line_number) + ".");
+            }
+            database.insert(atr, card_type, false, static_cast<PCSCReaderUnitType>(value));
+        }
+        else
+        {
+            database.insert(atr, card_type, true, PCSC_RUT_DEFAULT);
+        }
+        ++count;
+    }
+
+    LOG(INFOS) << count << " ATR loaded from " << filename << ".";
+    return count;
+}
+
+/**
+ * The ATR database, built once from the hardcoded ATRs and the optional
+ * liblogicalaccess.atr file next to the library. A lookup is a single
+ * atomic load once built.
+ */
+std::shared_ptr<const ATRTrie> atr_database()
+{
+    std::shared_ptr<const ATRTrie> current = std::atomic_load(&atr_database_instance());
+    if (current)
+        return current;
+
+    static std::once_flag built;
+    std::call_once(built, []() {
+        std::unique_ptr<ATRTrie> database(new ATRTrie());
+        for (const auto &hardcoded : hardcoded_atrs)
+        {
+            database->insert(hardcoded.atr, hardcoded.card_type,
+                             hardcoded.reader_type < 0,
+                             static_cast<PCSCReaderUnitType>(hardcoded.reader_type));
+        }
+
+        std::string filename = Settings::getDllPath() + "/liblogicalaccess.atr";
+        if (boost::filesystem::exists(filename))
+        {
+            // Load into a copy, a bad file must not drop the hardcoded ATRs.
+            std::unique_ptr<ATRTrie> loaded(new ATRTrie(*database));
+            try
+            {
+                load_atr_file(*loaded, filename);
+                database = std::move(loaded);
+            }
+            catch (std::exception &e)
+            {
+                LOG(ERRORS) << "Cannot load the ATR file " << filename << ": "
+                            << e.what();
+            }
+        }
+        atr_database_base() = std::shared_ptr<const ATRTrie>(database.release());
+        std::atomic_store(&atr_database_instance(), atr_database_base());
+    });
+    return std::atomic_load(&atr_database_instance());
+}
+
+/**
+ * Apply a change to a copy of the ATR database then publish it, so that
+ * lookups never wait for a registration.
+ */
+template <typename F>
+void update_atr_database(F change)
+{
+    atr_database();
+
+    std::lock_guard<std::mutex> lock(atr_database_mutex());
+    std::shared_ptr<ATRTrie> database(
+        new ATRTrie(*std::atomic_load(&atr_database_instance())));
+    change(*database);
+    std::atomic_store(&atr_database_instance(), std::shared_ptr<const ATRTrie>(database));
+}
+}
+
 ATRParser::ATRParser(const std::vector<uint8_t> &atr)
     : atr_(atr)
 {
-    // Populated the hardcoded atr table
-    register_hardcoded_atr("3B8F8001804F0CA0000003064000000000000028", "Prox",
-                           PCSC_RUT_OMNIKEY_XX27);
-    register_hardcoded_atr("3B878001C1052F2F0035C730", "MifarePlusS");
-    register_hardcoded_atr("3B878001C1052F2F01BCD6A9", "MifarePlusX");
-    register_hardcoded_atr("3B8F8001804F0CA000000306030036000000005D",
-                           "MifarePlus_SL1_2K");
-    register_hardcoded_atr("3B8F8001804F0CA000000306030037000000005C",
-                           "MifarePlus_SL1_4K");
-    // register_hardcoded_atr("3B8F8001804F0CA0000003060300020000000069",
-    //"MifarePlus_SL1_4K");
-    register_hardcoded_atr("3B8F8001804F0CA000000306030001000000006A",
-                           "MifarePlus_SL1_2K", PCSC_RUT_ACS_ACR_1222L);
-    register_hardcoded_atr("3B8F8001804F0CA00000030603FFA00000000034",
-                           "MifarePlus_SL1_4K", PCSC_RUT_SPRINGCARD);
-    register_hardcoded_atr("3B878001C1052F2F0035C730", "MifarePlus_SL3_2K");
-	register_hardcoded_atr("3BF59100FF918171FE400041080000000D", "Mifare1K");
-	register_hardcoded_atr("3BF59100FF918171FE400041180000001D", "Mifare4K");
-	register_hardcoded_atr("3BF59100FF918171FE400041880000008D", "Mifare1K");
-	register_hardcoded_atr("3B09410411DD822F000088", "Mifare1K");
-    register_hardcoded_atr("3B8F8001804F0CA000000306030000000000006B", "Mifare1K",
-                           PCSC_RUT_ID3_CL1356);
-	register_hardcoded_atr("3B8180018080", "DESFire");
-	register_hardcoded_atr("3B86800106757781028000", "DESFire");
-	register_hardcoded_atr("3BF79100FF918171FE40004120001177818040", "DESFire");
-	register_hardcoded_atr("3BF59100FF918171FE4000410x0000000005", "MifareUltralight");
-	register_hardcoded_atr("3B8C80010443FD", "FeliCa");
-	register_hardcoded_atr("3B8F80010031B86404B0ECC1739401808290000E", "CPS3");
-	register_hardcoded_atr("3B8F8001804F0CA0000003060B00120000000071", "TagIt");
-	register_hardcoded_atr("3B8F8001804F0CA00000030603F004000000009F", "Topaz");
-	register_hardcoded_atr("3BDF18FF81F1FE43003F03834D494641524520506C75732053414D3B", "SAM_AV2");
-	register_hardcoded_atr("3BDF18FF81F1FE43001F034D494641524520506C75732053414D98", "SAM_AV2");
-	
-	// SEOS or Electronic Passport / Spanish passport (2012)
-	register_hardcoded_atr("3B80800101", "SEOS");
+}
+
+void ATRParser::registerATR(const std::string &atr, const std::string &card_type)
+{
+    update_atr_database([&](ATRTrie &database) {
+        database.insert(atr, card_type, true, PCSC_RUT_DEFAULT);
+    });
+}
+
+void ATRParser::registerATR(const std::string &atr, const std::string &card_type,
+                            PCSCReaderUnitType reader_type)
+{
+    update_atr_database([&](ATRTrie &database) {
+        database.insert(atr, card_type, false, reader_type);
+    });
+}
+
+size_t ATRParser::loadATRFile(const std::string &filename)
+{
+    size_t count = 0;
+    update_atr_database(
+        [&](ATRTrie &database) { count = load_atr_file(database, filename); });
+    return count;
+}
+
+void ATRParser::clearRegisteredATR()
+{
+    atr_database();
+
+    std::lock_guard<std::mutex> lock(atr_database_mutex());
+    std::atomic_store(&atr_database_instance(), atr_database_base());
 }
 
 ///
@@ -52,14 +384,13 @@ ATRParser::ATRParser(const std::vector<uint8_t> &atr)
 
 std::string ATRParser::guessCardType(const std::vector<uint8_t> &atr)
 {
-    ATRParser parser(atr);
     // Type will be ignored.
-    return parser.parse(true, PCSCReaderUnitType::PCSC_RUT_ACS_ACR);
+    return guess(atr.data(), atr.size(), true, PCSCReaderUnitType::PCSC_RUT_ACS_ACR);
 }
 
 std::string ATRParser::guessCardType(uint8_t *atr, size_t atrlen)
 {
-    return guessCardType(std::vector<uint8_t>(atr, atr + atrlen));
+    return guess(atr, atrlen, true, PCSCReaderUnitType::PCSC_RUT_ACS_ACR);
 }
 
 std::string ATRParser::guessCardType(const std::string &atr_str)
@@ -70,7 +401,7 @@ std::string ATRParser::guessCardType(const std::string &atr_str)
 std::string ATRParser::guessCardType(uint8_t *atr, size_t atrlen,
                                      PCSCReaderUnitType reader_type)
 {
-    return guessCardType(std::vector<uint8_t>(atr, atr + atrlen), reader_type);
+    return guess(atr, atrlen, false, reader_type);
 }
 
 std::string ATRParser::guessCardType(const std::string &atr_str,
@@ -82,23 +413,91 @@ std::string ATRParser::guessCardType(const std::string &atr_str,
 std::string ATRParser::guessCardType(const std::vector<uint8_t> &atr,
                                      PCSCReaderUnitType reader_type)
 {
-    ATRParser parser(atr);
-    return parser.parse(false, reader_type);
+    return guess(atr.data(), atr.size(), false, reader_type);
+}
+
+std::string ATRParser::guess(const uint8_t *atr, size_t atrlen, bool ignore_reader_type,
+                             PCSCReaderUnitType reader_type)
+{
+    // Known ATRs are matched in place, the parser only handles the others.
+    std::shared_ptr<const ATRTrie> database = atr_database();
+    const std::string *card_type =
+        database->match(atr, atrlen, ignore_reader_type, reader_type);
+    if (card_type)
+    {
+        LOG(INFOS) << "ATR " << BufferHelper::getHex(std::vector<uint8_t>(atr, atr + atrlen))
+                   << " matched to " << *card_type << ".";
+        return *card_type;
+    }
+
+    ATRParser parser(std::vector<uint8_t>(atr, atr + atrlen));
+    return parser.parse();
+}
+
+bool ATRParser::supportsExtendedLength(const std::vector<uint8_t> &atr)
+{
+    if (atr.size() < 2)
+        return false;
+
+    // Skip the interface bytes to reach the historical bytes.
+    size_t historical_len = atr[1] & 0x0F;
+    size_t pos            = 1;
+    uint8_t td            = atr[1];
+    while (true)
+    {
+        size_t count = 0;
+        for (int i = 4; i < 8; ++i)
+            count += (td >> i) & 0x01;
+        if (pos + count >= atr.size())
+            return false;
+        bool has_td = (td & 0x80) != 0;
+        pos += count;
+        if (!has_td)
+            break;
+        td = atr[pos];
+    }
+    ++pos;
+    if (pos + historical_len > atr.size() || historical_len < 1)
+        return false;
+
+    auto begin = atr.begin() + pos;
+    auto end   = begin + historical_len;
+    // Category indicator: compact-TLV objects follow, with a 3 bytes
+    // status indicator at the end for 0x00.
+    if (*begin == 0x00)
+    {
+        if (historical_len < 4)
+            return false;
+        end -= 3;
+    }
+    else if (*begin != 0x80)
+        return false;
+    ++begin;
+
+    while (begin < end)
+    {
+        uint8_t tag = static_cast<uint8_t>(*begin >> 4);
+        size_t len  = *begin & 0x0F;
+        ++begin;
+        if (static_cast<size_t>(std::distance(begin, end)) < len)
+            return false;
+        // Card capabilities, third software function table.
+        if (tag == 0x07 && len >= 3)
+            return (begin[2] & 0x40) != 0;
+        begin += len;
+    }
+    return false;
 }
 
 ///
 /// ATR Parsing code
 ///
 
-std::string ATRParser::parse(bool ignore_reader_type,
-                             const PCSCReaderUnitType &reader_type) const
+std::string ATRParser::parse() const
 {
     LOG(INFOS) << "Trying to match ATR " << atr_ << " ("
                << BufferHelper::getHex(atr_) << ") to a card type.";
-    auto atr = check_hardcoded(ignore_reader_type, reader_type);
-    if (atr != "UNKNOWN")
-        return atr;
-    atr = check_from_atr();
+    auto atr = check_from_atr();
     if (atr != "UNKNOWN")
         return atr;
     return check_generic_from_atr();
@@ -158,55 +557,6 @@ std::string ATRParser::atr_x_to_type(uint8_t code) const
 	return "UNKNOWN";
 }
 
-///
-/// Hardcoded ATR related code
-///
-
-void ATRParser::register_hardcoded_atr(const std::string &atr,
-                                       const std::string &card_type)
-{
-    ATRParser::ATRInfo atr_info;
-    atr_info.card_type = card_type;
-
-    hardcoded_atr_to_type_[BufferHelper::fromHexString(atr)] = atr_info;
-}
-
-void ATRParser::register_hardcoded_atr(const std::string &atr,
-                                       const std::string &card_type,
-                                       PCSCReaderUnitType reader_type)
-{
-    ATRParser::ATRInfo atr_info;
-    atr_info.card_type = card_type;
-    atr_info.reader_type.push_back(reader_type);
-
-    hardcoded_atr_to_type_[BufferHelper::fromHexString(atr)] = atr_info;
-}
-
-std::string ATRParser::check_hardcoded(bool ignore_reader_type,
-                                       const PCSCReaderUnitType &reader_type) const
-{
-    for (const auto &atr_info : hardcoded_atr_to_type_)
-    {
-        if (atr_info.first == atr_)
-        {
-            const auto &readers = atr_info.second.reader_type;
-
-            // We only want entry that target all readers (meaning readers.empty() ==
-            // true)
-            if (ignore_reader_type && readers.empty())
-                return atr_info.second.card_type;
-            // Try to match the reader type.
-            if (readers.empty() ||
-                std::find(readers.begin(), readers.end(), reader_type) !=
-                    readers.end())
-            {
-                return atr_info.second.card_type;
-            }
-        }
-    }
-    return "UNKNOWN";
-}
-
 std::string ATRParser::check_from_atr() const
 {
     size_t atrlen      = atr_.size();
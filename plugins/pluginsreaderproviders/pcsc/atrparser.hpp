@@ -5,7 +5,6 @@
 #include "pcscreaderunitconfiguration.hpp"
 #include <cstddef>
 #include <cstdint>
-#include <map>
 #include <string>
 #include <vector>
 
@@ -47,51 +46,66 @@ class LIBLOGICALACCESS_API ATRParser
      */
     static std::string guessCardType(const std::string &atr_str);
 
-  private:
-    std::string parse(bool ignore_reader_type,
-                      const PCSCReaderUnitType &reader_type) const;
-    std::string check_hardcoded(bool ignore_reader_type,
-                                const PCSCReaderUnitType &reader_type) const;
+    /**
+     * Check whether the card advertises extended length Lc/Le fields
+     * in the card capabilities of its historical bytes (ISO7816-4 8.1.1.2.7).
+     */
+    static bool supportsExtendedLength(const std::vector<uint8_t> &atr);
 
-    std::string check_from_atr() const;
-    std::string check_generic_from_atr() const;
+    /**
+     * Register an ATR acceptable for any reader, overriding a previous
+     * registration of the same ATR.
+     *
+     * An 'x' nibble in the ATR matches any value.
+     */
+    static void registerATR(const std::string &atr, const std::string &card_type);
 
     /**
-     * Deduce the card type from one byte of the ATR.
+     * Register an ATR for a unique type of PCSC Reader. It takes precedence
+     * over the ATR registered for any reader.
      */
-    std::string atr_x_to_type(uint8_t code) const;
+    static void registerATR(const std::string &atr, const std::string &card_type,
+                            PCSCReaderUnitType reader_type);
 
     /**
-     * Register an hardcoded ATR.
+     * Register the ATRs listed in a file, one per line: the ATR, the card type
+     * and optionally the PCSC reader unit type value. Text after a '#' is ignored.
      *
-     * The ATR will be register for a unique type of PCSC Reader.
+     * The liblogicalaccess.atr file next to the library is loaded on first use.
+     *
+     * The file is loaded as a whole: on error no ATR is registered.
+     *
+     * Returns the number of ATR registered.
      */
-    void register_hardcoded_atr(const std::string &atr, const std::string &card_type,
-                                PCSCReaderUnitType reader_type);
+    static size_t loadATRFile(const std::string &filename);
 
     /**
-     * Register an harcoded ATR acceptable for any reader.
+     * Forget the ATRs registered or loaded at runtime. The hardcoded ATRs and
+     * the liblogicalaccess.atr file next to the library are kept.
      */
-    void register_hardcoded_atr(const std::string &atr,
-                                const std::string &card_type);
-
-    struct ATRInfo
-    {
-        std::string card_type;
-        /**
-         * If the reader is empty, works for all type
-         * of reader.
-         */
-        std::vector<PCSCReaderUnitType> reader_type;
-    };
+    static void clearRegisteredATR();
 
-    std::vector<uint8_t> atr_;
+  private:
+    /**
+     * Match the known ATRs without copying the ATR, then fall back to parsing it.
+     */
+    static std::string guess(const uint8_t *atr, size_t atrlen, bool ignore_reader_type,
+                             PCSCReaderUnitType reader_type);
 
     /**
-     * A map mapping ATR hexadecimal representation to the type of
-     * card they represent.
+     * Deduce the card type from the ATR bytes, for the ATRs not in the database.
      */
-    std::map<std::vector<uint8_t>, ATRInfo> hardcoded_atr_to_type_;
+    std::string parse() const;
+
+    std::string check_from_atr() const;
+    std::string check_generic_from_atr() const;
+
+    /**
+     * Deduce the card type from one byte of the ATR.
+     */
+    std::string atr_x_to_type(uint8_t code) const;
+
+    std::vector<uint8_t> atr_;
 };
 }
 
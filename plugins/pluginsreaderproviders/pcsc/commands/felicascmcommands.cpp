@@ -115,7 +115,7 @@ namespace logicalaccess
 		}
 		cdata.insert(cdata.end(), data.begin(), data.end());
 
-		std::vector<unsigned char> result = getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0x48, static_cast<unsigned char>(codes.size()), static_cast<unsigned char>(blocks.size()), data);
+		std::vector<unsigned char> result = getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0x48, static_cast<unsigned char>(codes.size()), static_cast<unsigned char>(blocks.size()), cdata);
 		// First 8 bytes = IDm, then Status Flag 1 + Status Flag 2
 		EXCEPTION_ASSERT_WITH_LOG(result.size() >= 10, LibLogicalAccessException, "Wrong write result.");
 	}
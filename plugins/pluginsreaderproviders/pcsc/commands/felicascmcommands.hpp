@@ -73,6 +73,18 @@ namespace logicalaccess
 		* \param data Data to write.
 		*/
 		virtual void write(const std::vector<unsigned short>& codes, const std::vector<unsigned short>& blocks, const std::vector<unsigned char>& data);
+
+	protected:
+
+		/**
+		* \brief The reader passes up to 15 blocks per read.
+		*/
+		virtual unsigned char getReaderMaxReadBlocks() const override { return 15; }
+
+		/**
+		* \brief The reader passes up to 13 blocks per write, with their block list in the same command.
+		*/
+		virtual unsigned char getReaderMaxWriteBlocks() const override { return 13; }
 	};
 }
 
@@ -9,6 +9,7 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
 
 #include <logicalaccess/logs.hpp>
 #include <logicalaccess/myexception.hpp>
@@ -17,7 +18,7 @@
 namespace logicalaccess
 {
     FeliCaSpringCardCommands::FeliCaSpringCardCommands()
-        : FeliCaCommands()
+        : FeliCaCommands(), d_singleBlockTransfer(false)
     {
     }
 
@@ -51,10 +52,34 @@ namespace logicalaccess
             cmd.push_back(static_cast<unsigned char>(codes[i] & 0xff));
             getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xFB, 0xFC, 0x01, static_cast<unsigned char>(cmd.size()), cmd);
 
-            for (unsigned int b = 0; b < blocks.size(); ++b)
+            for (unsigned int b = 0; b < blocks.size();)
             {
+                unsigned int nb = getBlocksRun(blocks, b, d_singleBlockTransfer ? 1 : getMaxReadBlocks());
+                if (nb > 1)
+                {
+                    try
+                    {
+                        std::vector<unsigned char> result = getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xB0, 0x00, static_cast<unsigned char>(blocks[b] & 0xff), static_cast<unsigned char>(nb * 16));
+                        if (result.size() == nb * 16 + 2)
+                        {
+                            data.insert(data.end(), result.begin(), result.end() - 2);
+                            b += nb;
+                            continue;
+                        }
+
+                        // The reader cut the answer to what it supports.
+                        LOG(LogLevel::WARNINGS) << "Multiple blocks read returned " << (result.size() - 2) << " bytes, reading one block at a time.";
+                        d_singleBlockTransfer = true;
+                    }
+                    catch (const CardException& e)
+                    {
+                        PCSCReaderCardAdapter::switchToSingleBlock(e, false, d_singleBlockTransfer);
+                    }
+                }
+
                 std::vector<unsigned char> result = getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xB0, 0x00, static_cast<unsigned char>(blocks[b] & 0xff), 16);
                 data.insert(data.end(), result.begin(), result.end() - 2);
+                ++b;
             }
         }
         return data;
@@ -76,6 +101,25 @@ namespace logicalaccess
                 if (offset >= data.size())
                     break;
 
+                unsigned int nb = getBlocksRun(blocks, b, d_singleBlockTransfer ? 1 : getMaxWriteBlocks());
+                nb = std::min<unsigned int>(nb, static_cast<unsigned int>((data.size() - offset + 15) / 16));
+                if (nb > 1)
+                {
+                    cmd = std::vector<unsigned char>(data.begin() + offset, data.begin() + std::min<size_t>(offset + nb * 16, data.size()));
+                    cmd.resize(nb * 16, 0x00);
+                    try
+                    {
+                        getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xD6, 0x00, static_cast<unsigned char>(blocks[b] & 0xff), static_cast<unsigned char>(cmd.size()), cmd);
+                        offset += nb * 16;
+                        b += nb - 1;
+                        continue;
+                    }
+                    catch (const CardException& e)
+                    {
+                        PCSCReaderCardAdapter::switchToSingleBlock(e, true, d_singleBlockTransfer);
+                    }
+                }
+
                 unsigned char len = static_cast<unsigned char>((offset + 16 <= data.size()) ? 16 : data.size() - offset);
                 cmd = std::vector<unsigned char>(data.begin() + offset, data.begin() + offset + len);
                 if (len != 16)
@@ -87,4 +131,14 @@ namespace logicalaccess
             }
         }
     }
+
+    unsigned int FeliCaSpringCardCommands::getBlocksRun(const std::vector<unsigned short>& blocks, unsigned int pos, unsigned char maxBlocks)
+    {
+        unsigned int nb = 1;
+        while (pos + nb < blocks.size() && nb < maxBlocks && blocks[pos + nb] == blocks[pos] + nb)
+        {
+            ++nb;
+        }
+        return nb;
+    }
 }
\ No newline at end of file
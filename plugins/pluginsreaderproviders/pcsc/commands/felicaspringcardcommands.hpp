@@ -73,6 +73,32 @@ namespace logicalaccess
         * \param data Data to write.
         */
         virtual void write(const std::vector<unsigned short>& codes, const std::vector<unsigned short>& blocks, const std::vector<unsigned char>& data);
+
+    protected:
+
+        /**
+        * \brief The length of a read, in a single byte, holds up to 15 blocks.
+        */
+        virtual unsigned char getReaderMaxReadBlocks() const override { return 15; }
+
+        /**
+        * \brief The length of a write, in a single byte, holds up to 15 blocks.
+        */
+        virtual unsigned char getReaderMaxWriteBlocks() const override { return 15; }
+
+        /**
+        * \brief Count the consecutive blocks, up to the chip limit, starting at a position of the blocks list.
+        * \param blocks Blocks list.
+        * \param pos The position in the list.
+        * \param maxBlocks The maximum number of blocks.
+        * \return The number of consecutive blocks.
+        */
+        static unsigned int getBlocksRun(const std::vector<unsigned short>& blocks, unsigned int pos, unsigned char maxBlocks);
+
+        /**
+        * \brief The reader refused a multiple blocks command, use one block per command.
+        */
+        bool d_singleBlockTransfer;
     };
 }
 
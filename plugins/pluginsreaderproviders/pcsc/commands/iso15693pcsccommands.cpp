@@ -12,11 +12,14 @@
 
 #include "iso15693/iso15693chip.hpp"
 #include "logicalaccess/myexception.hpp"
+#include "logicalaccess/logs.hpp"
+
+#include <algorithm>
 
 namespace logicalaccess
 {
     ISO15693PCSCCommands::ISO15693PCSCCommands()
-        : ISO15693Commands()
+        : ISO15693Commands(), d_singleBlockTransfer(false)
     {
     }
 
@@ -178,4 +181,81 @@ namespace logicalaccess
 
         return result[0];
     }
+
+    size_t ISO15693PCSCCommands::getMaxTransferLength() const
+    {
+        // Short APDU, leaving room for the reader frame overhead.
+        return 0xF0;
+    }
+
+    std::vector<unsigned char> ISO15693PCSCCommands::readBlocks(size_t block, size_t nbBlocks)
+    {
+        ISO15693Commands::SystemInformation sysinfo = getCachedSystemInformation();
+        if (!sysinfo.hasVICCMemorySize || sysinfo.blockSize <= 0)
+        {
+            return ISO15693Commands::readBlocks(block, nbBlocks);
+        }
+
+        std::vector<unsigned char> ret;
+        size_t blockSize = static_cast<size_t>(sysinfo.blockSize);
+        size_t maxblocks = std::max<size_t>(getMaxTransferLength() / blockSize, 1);
+        for (size_t i = 0; i < nbBlocks; i += maxblocks)
+        {
+            size_t nb = std::min(maxblocks, nbBlocks - i);
+            std::vector<unsigned char> data;
+            if (nb > 1 && !d_singleBlockTransfer)
+            {
+                try
+                {
+                    data = readBlock(block + i, nb * blockSize);
+                    if (data.size() != nb * blockSize)
+                    {
+                        // The reader cut the answer to what it supports.
+                        LOG(LogLevel::WARNINGS) << "Multiple blocks read returned " << data.size() << " bytes, reading one block at a time.";
+                        d_singleBlockTransfer = true;
+                    }
+                }
+                catch (const CardException& e)
+                {
+                    PCSCReaderCardAdapter::switchToSingleBlock(e, false, d_singleBlockTransfer);
+                }
+            }
+
+            if (nb == 1 || d_singleBlockTransfer)
+            {
+                data = ISO15693Commands::readBlocks(block + i, nb);
+            }
+            ret.insert(ret.end(), data.begin(), data.end());
+        }
+
+        return ret;
+    }
+
+    void ISO15693PCSCCommands::writeBlocks(size_t block, const std::vector<unsigned char>& data)
+    {
+        size_t blockSize = static_cast<size_t>(getBlockSize());
+        EXCEPTION_ASSERT_WITH_LOG(data.size() % blockSize == 0, std::invalid_argument, "The data length must be a multiple of the block size.");
+
+        size_t nbBlocks = data.size() / blockSize;
+        size_t maxblocks = std::max<size_t>(getMaxTransferLength() / blockSize, 1);
+        for (size_t i = 0; i < nbBlocks; i += maxblocks)
+        {
+            size_t nb = std::min(maxblocks, nbBlocks - i);
+            std::vector<unsigned char> blocks(data.begin() + i * blockSize, data.begin() + (i + nb) * blockSize);
+            if (nb > 1 && !d_singleBlockTransfer)
+            {
+                try
+                {
+                    writeBlock(block + i, blocks);
+                    continue;
+                }
+                catch (const CardException& e)
+                {
+                    PCSCReaderCardAdapter::switchToSingleBlock(e, true, d_singleBlockTransfer);
+                }
+            }
+
+            ISO15693Commands::writeBlocks(block + i, blocks);
+        }
+    }
 }
\ No newline at end of file
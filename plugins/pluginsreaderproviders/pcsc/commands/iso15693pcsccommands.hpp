@@ -43,11 +43,39 @@ namespace logicalaccess
         virtual ISO15693PCSCCommands::SystemInformation getSystemInformation();
         virtual unsigned char getSecurityStatus(size_t block);
 
+        /**
+         * \brief Read consecutive blocks, with a single READ BINARY for as many blocks as the reader handles.
+         * \param block The first block number.
+         * \param nbBlocks The number of blocks to read.
+         * \return The data of the blocks.
+         */
+        virtual std::vector<unsigned char> readBlocks(size_t block, size_t nbBlocks);
+
+        /**
+         * \brief Write consecutive blocks, with a single UPDATE BINARY for as many blocks as the reader handles.
+         * \param block The first block number.
+         * \param data The data to write, a multiple of the block size.
+         */
+        virtual void writeBlocks(size_t block, const std::vector<unsigned char>& data);
+
         /**
          * \brief Get the PC/SC reader/card adapter.
          * \return The PC/SC reader/card adapter.
          */
         virtual std::shared_ptr<PCSCReaderCardAdapter> getPCSCReaderCardAdapter() { return std::dynamic_pointer_cast<PCSCReaderCardAdapter>(getReaderCardAdapter()); };
+
+    protected:
+
+        /**
+         * \brief Get the maximum count of data bytes the reader reads or writes in one command.
+         * \return The count of bytes.
+         */
+        virtual size_t getMaxTransferLength() const;
+
+        /**
+         * \brief The reader refused a multiple blocks command, use one block per command.
+         */
+        bool d_singleBlockTransfer;
     };
 }
 
@@ -2,6 +2,11 @@
 
 namespace logicalaccess
 {
+    unsigned char MifareCL1356Commands::getMaxBlocksPerTransfer() const
+    {
+        return 3;
+    }
+
     void MifareCL1356Commands::increment(uint8_t blockno, uint32_t value)
     {
         std::vector<unsigned char> buf;
@@ -18,6 +18,13 @@ namespace logicalaccess
 
         virtual void decrement(uint8_t blockno, uint32_t value) override;
 
+    protected:
+
+        /**
+         * \brief Get the maximum count of blocks the reader reads or writes in one command.
+         * \return 3 blocks, 48 bytes.
+         */
+        virtual unsigned char getMaxBlocksPerTransfer() const override;
     };
 
 }
@@ -24,10 +24,11 @@ namespace logicalaccess
     {
     }
 
-    bool MifareCherryCommands::loadKey(unsigned char keyno, MifareKeyType /*keytype*/, std::shared_ptr<MifareKey> key, bool /*vol*/)
+    bool MifareCherryCommands::loadKey(unsigned char keyno, MifareKeyType keytype, std::shared_ptr<MifareKey> key, bool /*vol*/)
     {
         bool r = false;
 
+        invalidateKeySlot(keyno, keytype, true);
         // To check on Cherry documentation why key #0 failed.
         if (keyno == 0)
         {
@@ -36,10 +37,21 @@ namespace logicalaccess
 		std::vector<unsigned char> vector_key((unsigned char*)key->getData(), (unsigned char*)key->getData() + key->getLength());
 		getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0x82, 0x00, keyno, static_cast<unsigned char>(key->getLength()), vector_key);
         r = true;
+        setKeySlotLoaded(keyno, keytype, true, vector_key);
 
         return r;
     }
 
+    unsigned short MifareCherryCommands::getKeySlotIndex(unsigned char keyno, MifareKeyType /*keytype*/) const
+    {
+        return (keyno == 0) ? 1 : keyno;
+    }
+
+    bool MifareCherryCommands::isVolatileLoad(bool /*vol*/)
+    {
+        return true;
+    }
+
     void MifareCherryCommands::authenticate(unsigned char blockno, unsigned char keyno, MifareKeyType keytype)
     {
         std::vector<unsigned char> command;
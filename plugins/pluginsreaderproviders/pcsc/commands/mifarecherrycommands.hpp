@@ -45,6 +45,21 @@ namespace logicalaccess
          */
         bool loadKey(unsigned char keyno, MifareKeyType keytype, std::shared_ptr<MifareKey> key, bool vol = false) override;
 
+        /**
+         * \brief Get the reader slot a key number and type are loaded in.
+         * \param keyno The key number.
+         * \param keytype The mifare key type.
+         * \return The slot, as addressed by the reader.
+         */
+        unsigned short getKeySlotIndex(unsigned char keyno, MifareKeyType keytype) const override;
+
+        /**
+         * \brief Get the key memory a LOAD KEY actually uses.
+         * \param vol True if the volatile memory is asked.
+         * \return Always true, the keys are loaded in volatile memory.
+         */
+        bool isVolatileLoad(bool vol) override;
+
         /**
          * \brief Authenticate a block, given a key number.
          * \param blockno The block number.
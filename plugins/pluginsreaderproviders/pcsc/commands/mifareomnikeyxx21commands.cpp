@@ -15,6 +15,11 @@ namespace logicalaccess
     {
     }
 
+    unsigned char MifareOmnikeyXX21Commands::getMaxBlocksPerTransfer() const
+    {
+        return 3;
+    }
+
     void MifareOmnikeyXX21Commands::increment(uint8_t blockno, uint32_t value)
     {
         std::vector<uint8_t> buf(4);
@@ -16,7 +16,7 @@ namespace logicalaccess
 
         AddCheck(0x65, 0x81, "Illegal block number (out of memory space)");
 
-        AddCheck(0x67, 0x00, "Wrong length (Lc or Le)");
+        AddCheck(0x67, 0x00, "Wrong length (Lc or Le)", CardException::WRONG_LENGTH);
 
         AddCheck(0x69, 0x81, "Incompatible command");
         AddCheck(0x69, 0x82, "Security status not satisfied (not authenticated)");
@@ -25,10 +25,10 @@ namespace logicalaccess
         AddCheck(0x69, 0x88, "KeyNumber not valid");
         AddCheck(0x69, 0x89, "KeyLength incorrect");
 
-        AddCheck(0x6A, 0x81, "Function not supported");
+        AddCheck(0x6A, 0x81, "Function not supported", CardException::FUNCTION_NOT_SUPPORTED);
         AddCheck(0x6A, 0x82, "Illegal block number (File not found)");
 
-        AddCheck(0x6B, 0x00, "Wrong parameter (P1 or P2)");
+        AddCheck(0x6B, 0x00, "Wrong parameter (P1 or P2)", CardException::WRONG_P1_P2);
     }
 
     MifareOmnikeyXX27ResultChecker::~MifareOmnikeyXX27ResultChecker() {}
@@ -5,10 +5,13 @@
  */
 
 #include "../commands/mifarepcsccommands.hpp"
+#include "../commands/mifarepcsckeyslots.hpp"
+#include "../pcscdatatransport.hpp"
 
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
 
 #include "../pcscreaderprovider.hpp"
 #include "mifare/mifarechip.hpp"
@@ -21,7 +24,7 @@
 namespace logicalaccess
 {
     MifarePCSCCommands::MifarePCSCCommands()
-        : MifareCommands()
+        : MifareCommands(), d_singleBlockTransfer(false), d_authKeyType(KT_KEY_A)
     {
     }
 
@@ -35,13 +38,22 @@ namespace logicalaccess
         std::vector<unsigned char> result,
 			vector_key((unsigned char *)key->getData(), (unsigned char *)key->getData() + key->getLength());
 
+        std::shared_ptr<PCSCReaderUnit> readerUnit = getPCSCReaderUnit();
+        if (!vol && readerUnit && MifarePCSCKeySlots::isVolatileOnly(readerUnit->getPCSCType()))
+        {
+            // Already known to fail on this reader type, don't pay for it again.
+            vol = true;
+        }
+
+        // The slot content is unknown until the reader accepts the key.
+        invalidateKeySlot(keyno, keytype, vol);
         try
         {
             result = getPCSCReaderCardAdapter()->sendAPDUCommand(
                 0xFF, 0x82, (vol ? 0x00 : 0x20), static_cast<char>(keyno),
                 static_cast<unsigned char>(vector_key.size()), vector_key);
         }
-        catch (CardException e)
+        catch (const CardException& e)
         {
             if (!vol && (e.error_code() == CardException::WRONG_P1_P2 ||
                          e.error_code() == CardException::UNKOWN_ERROR))
@@ -49,7 +61,12 @@ namespace logicalaccess
                 // With the Sony RC-S380, non-volatile memory doesn't work,
                 // so we try again. Same with ACR1222L.
                 // Apparently the issue is also hit with ACS122U.
-                return loadKey(keyno, keytype, key, true);
+                r = loadKey(keyno, keytype, key, true);
+                if (r && readerUnit)
+                {
+                    MifarePCSCKeySlots::setVolatileOnly(readerUnit->getPCSCType());
+                }
+                return r;
             }
             else
                 throw;
@@ -60,11 +77,16 @@ namespace logicalaccess
             if (keyno == 0)
             {
                 r = loadKey(keyno, keytype, key, true);
+                if (r && readerUnit)
+                {
+                    MifarePCSCKeySlots::setVolatileOnly(readerUnit->getPCSCType());
+                }
             }
         }
         else
         {
             r = true;
+            setKeySlotLoaded(keyno, keytype, vol, vector_key);
         }
 
         return r;
@@ -85,7 +107,7 @@ namespace logicalaccess
 
         if (std::dynamic_pointer_cast<ComputerMemoryKeyStorage>(key_storage))
         {
-            loadKey(0, keytype, key);
+            loadResidentKey(0, keytype, key, false);
         }
         else if (std::dynamic_pointer_cast<ReaderMemoryKeyStorage>(key_storage))
         {
@@ -93,7 +115,7 @@ namespace logicalaccess
             if (!key->isEmpty())
             {
                 std::shared_ptr<ReaderMemoryKeyStorage> rmKs = std::dynamic_pointer_cast<ReaderMemoryKeyStorage>(key_storage);
-                loadKey(rmKs->getKeySlot(), keytype, key, rmKs->getVolatile());
+                loadResidentKey(rmKs->getKeySlot(), keytype, key, rmKs->getVolatile());
             }
         }
         else
@@ -102,6 +124,72 @@ namespace logicalaccess
         }
     }
 
+    void MifarePCSCCommands::loadResidentKey(unsigned char keyno, MifareKeyType keytype, std::shared_ptr<MifareKey> key, bool vol)
+    {
+        std::shared_ptr<MifarePCSCKeySlots> slots = getKeySlots();
+        std::vector<unsigned char> vector_key((unsigned char *)key->getData(), (unsigned char *)key->getData() + key->getLength());
+        if (slots && slots->isLoaded(getKeySlotIndex(keyno, keytype), isVolatileLoad(vol), vector_key))
+        {
+            return;
+        }
+
+        // loadKey() tracks the slot content.
+        loadKey(keyno, keytype, key, vol);
+    }
+
+    unsigned short MifarePCSCCommands::getKeySlotIndex(unsigned char keyno, MifareKeyType /*keytype*/) const
+    {
+        return keyno;
+    }
+
+    bool MifarePCSCCommands::isVolatileLoad(bool vol)
+    {
+        std::shared_ptr<PCSCReaderUnit> readerUnit = getPCSCReaderUnit();
+        return vol || (readerUnit && MifarePCSCKeySlots::isVolatileOnly(readerUnit->getPCSCType()));
+    }
+
+    void MifarePCSCCommands::invalidateKeySlot(unsigned char keyno, MifareKeyType keytype, bool vol)
+    {
+        std::shared_ptr<MifarePCSCKeySlots> slots = getKeySlots();
+        if (slots)
+        {
+            slots->invalidate(getKeySlotIndex(keyno, keytype), vol);
+        }
+    }
+
+    void MifarePCSCCommands::setKeySlotLoaded(unsigned char keyno, MifareKeyType keytype, bool vol, const std::vector<unsigned char>& key)
+    {
+        std::shared_ptr<MifarePCSCKeySlots> slots = getKeySlots();
+        if (slots)
+        {
+            slots->setLoaded(getKeySlotIndex(keyno, keytype), vol, key);
+        }
+    }
+
+    std::shared_ptr<PCSCReaderUnit> MifarePCSCCommands::getPCSCReaderUnit()
+    {
+        std::shared_ptr<PCSCReaderCardAdapter> rca = getPCSCReaderCardAdapter();
+        if (rca)
+        {
+            std::shared_ptr<PCSCDataTransport> dt = std::dynamic_pointer_cast<PCSCDataTransport>(rca->getDataTransport());
+            if (dt)
+            {
+                return dt->getPCSCReaderUnit();
+            }
+        }
+        return std::shared_ptr<PCSCReaderUnit>();
+    }
+
+    std::shared_ptr<MifarePCSCKeySlots> MifarePCSCCommands::getKeySlots()
+    {
+        std::shared_ptr<PCSCReaderUnit> readerUnit = getPCSCReaderUnit();
+        if (readerUnit)
+        {
+            return readerUnit->getMifareKeySlots();
+        }
+        return std::shared_ptr<MifarePCSCKeySlots>();
+    }
+
     void MifarePCSCCommands::authenticate(unsigned char blockno, unsigned char keyno, MifareKeyType keytype)
     {
         TRACE(blockno, keyno, keytype);
@@ -119,19 +207,38 @@ namespace logicalaccess
     void MifarePCSCCommands::authenticate(unsigned char blockno, std::shared_ptr<KeyStorage> key_storage, MifareKeyType keytype)
     {
         TRACE(blockno, key_storage, keytype);
+        unsigned char keyno = 0;
         if (std::dynamic_pointer_cast<ComputerMemoryKeyStorage>(key_storage))
         {
-            authenticate(blockno, 0, keytype);
+            keyno = 0;
         }
         else if (std::dynamic_pointer_cast<ReaderMemoryKeyStorage>(key_storage))
         {
             std::shared_ptr<ReaderMemoryKeyStorage> rmKs = std::dynamic_pointer_cast<ReaderMemoryKeyStorage>(key_storage);
-            authenticate(blockno, rmKs->getKeySlot(), keytype);
+            keyno = rmKs->getKeySlot();
         }
         else
         {
             THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, "The key storage type is not supported for this card/reader.");
         }
+
+        try
+        {
+            authenticate(blockno, keyno, keytype);
+            d_authKeyStorage = key_storage;
+            d_authKeyType = keytype;
+        }
+        catch (...)
+        {
+            d_authKeyStorage.reset();
+            // The slot may not hold the key we think, whatever the memory, load it again next time.
+            std::shared_ptr<MifarePCSCKeySlots> slots = getKeySlots();
+            if (slots)
+            {
+                slots->invalidate(getKeySlotIndex(keyno, keytype));
+            }
+            throw;
+        }
     }
 
     std::vector<unsigned char> MifarePCSCCommands::readBinary(unsigned char blockno, size_t len)
@@ -159,6 +266,89 @@ namespace logicalaccess
         getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xD6, 0x00, blockno, static_cast<unsigned char>(buf.size()), buf);
     }
 
+    unsigned char MifarePCSCCommands::getMaxBlocksPerTransfer() const
+    {
+        return 1;
+    }
+
+    std::vector<unsigned char> MifarePCSCCommands::readBlocks(unsigned char blockno, unsigned char count)
+    {
+        TRACE(blockno, count);
+        std::vector<unsigned char> ret;
+        unsigned char maxblocks = std::max<unsigned char>(getMaxBlocksPerTransfer(), 1);
+        for (unsigned char i = 0; i < count; i += maxblocks)
+        {
+            unsigned char nb = std::min<unsigned char>(maxblocks, count - i);
+            unsigned char block = static_cast<unsigned char>(blockno + i);
+            std::vector<unsigned char> data;
+            if (nb > 1 && !d_singleBlockTransfer)
+            {
+                try
+                {
+                    data = readBinary(block, nb * 16);
+                    if (data.size() != static_cast<size_t>(nb) * 16)
+                    {
+                        // The reader cut the answer to what it supports.
+                        LOG(LogLevel::WARNINGS) << "Multiple blocks read returned " << data.size() << " bytes, reading one block at a time.";
+                        d_singleBlockTransfer = true;
+                    }
+                }
+                catch (const CardException& e)
+                {
+                    PCSCReaderCardAdapter::switchToSingleBlock(e, false, d_singleBlockTransfer);
+                    reauthenticate(block);
+                }
+            }
+
+            if (nb == 1 || d_singleBlockTransfer)
+            {
+                data = MifareCommands::readBlocks(block, nb);
+            }
+            ret.insert(ret.end(), data.begin(), data.end());
+        }
+
+        return ret;
+    }
+
+    void MifarePCSCCommands::writeBlocks(unsigned char blockno, const std::vector<unsigned char>& buf)
+    {
+        TRACE(blockno, buf);
+        EXCEPTION_ASSERT_WITH_LOG(buf.size() % 16 == 0, std::invalid_argument, "The buffer length must be a multiple of 16 bytes.");
+
+        size_t count = buf.size() / 16;
+        size_t maxblocks = std::max<unsigned char>(getMaxBlocksPerTransfer(), 1);
+        for (size_t i = 0; i < count; i += maxblocks)
+        {
+            size_t nb = std::min<size_t>(maxblocks, count - i);
+            unsigned char block = static_cast<unsigned char>(blockno + i);
+            std::vector<unsigned char> data(buf.begin() + i * 16, buf.begin() + (i + nb) * 16);
+            if (nb > 1 && !d_singleBlockTransfer)
+            {
+                try
+                {
+                    updateBinary(block, data);
+                    continue;
+                }
+                catch (const CardException& e)
+                {
+                    PCSCReaderCardAdapter::switchToSingleBlock(e, true, d_singleBlockTransfer);
+                    reauthenticate(block);
+                }
+            }
+
+            MifareCommands::writeBlocks(block, data);
+        }
+    }
+
+    void MifarePCSCCommands::reauthenticate(unsigned char blockno)
+    {
+        // A failed command leaves the card unauthenticated, the sector key is still in the reader.
+        if (d_authKeyStorage)
+        {
+            authenticate(blockno, d_authKeyStorage, d_authKeyType);
+        }
+    }
+
     void MifarePCSCCommands::increment(uint8_t blockno, uint32_t value)
     {
         std::vector<uint8_t> buf;
@@ -19,8 +19,13 @@ namespace logicalaccess
     template<typename T, typename T2>
     class MifarePlusSL1Policy;
 
+    class MifarePCSCKeySlots;
+
     /**
      * \brief The Mifare card provider class for PCSC reader.
+     *
+     * The keys loaded in the reader are tracked per reader unit, so a key already
+     * residing in its slot is not loaded again before each sector authentication.
      */
     class LIBLOGICALACCESS_API MifarePCSCCommands : public virtual MifareCommands
     {
@@ -61,12 +66,33 @@ namespace logicalaccess
          */
         virtual void updateBinary(unsigned char blockno, const std::vector<unsigned char>& buf);
 
+        /**
+         * \brief Read consecutive blocks of an authenticated sector, several blocks per Read Binary when the reader supports it.
+         * \param blockno The first block number.
+         * \param count The count of blocks.
+         * \return The blocks data.
+         */
+        virtual std::vector<unsigned char> readBlocks(unsigned char blockno, unsigned char count) override;
+
+        /**
+         * \brief Write consecutive blocks of an authenticated sector, several blocks per Update Binary when the reader supports it.
+         * \param blockno The first block number.
+         * \param buf The blocks data, a multiple of 16 bytes.
+         */
+        virtual void writeBlocks(unsigned char blockno, const std::vector<unsigned char>& buf) override;
+
         virtual void increment(uint8_t blockno, uint32_t value) override;
 
         virtual void decrement(uint8_t blockno, uint32_t value) override;
 
     protected:
 
+        /**
+         * \brief Get the maximum count of blocks the reader reads or writes in one command.
+         * \return The count of blocks, 1 by default.
+         */
+        virtual unsigned char getMaxBlocksPerTransfer() const;
+
         /**
          * \brief Load a key to the reader.
          * \param keyno The key number.
@@ -85,6 +111,59 @@ namespace logicalaccess
          */
 		virtual void loadKey(std::shared_ptr<Location> location, MifareKeyType keytype, std::shared_ptr<MifareKey> key);
 
+        /**
+         * \brief Load a key in a reader slot, unless the slot already holds it.
+         * \param keyno The key number.
+         * \param keytype The mifare key type.
+         * \param key The key.
+         * \param vol Use volatile memory.
+         */
+        void loadResidentKey(unsigned char keyno, MifareKeyType keytype, std::shared_ptr<MifareKey> key, bool vol);
+
+        /**
+         * \brief Get the reader slot a key number and type are loaded in.
+         * \param keyno The key number.
+         * \param keytype The mifare key type.
+         * \return The slot, as addressed by the reader.
+         */
+        virtual unsigned short getKeySlotIndex(unsigned char keyno, MifareKeyType keytype) const;
+
+        /**
+         * \brief Get the key memory a LOAD KEY actually uses.
+         * \param vol True if the volatile memory is asked.
+         * \return True if the key goes to the volatile memory.
+         */
+        virtual bool isVolatileLoad(bool vol);
+
+        /**
+         * \brief Forget the tracked content of a key slot.
+         * \param keyno The key number.
+         * \param keytype The mifare key type.
+         * \param vol True for the volatile key memory.
+         */
+        void invalidateKeySlot(unsigned char keyno, MifareKeyType keytype, bool vol);
+
+        /**
+         * \brief Track a key loaded in a key slot.
+         * \param keyno The key number.
+         * \param keytype The mifare key type.
+         * \param vol True for the volatile key memory.
+         * \param key The key.
+         */
+        void setKeySlotLoaded(unsigned char keyno, MifareKeyType keytype, bool vol, const std::vector<unsigned char>& key);
+
+        /**
+         * \brief Get the PC/SC reader unit the commands are sent to.
+         * \return The reader unit, null if not sent through a PC/SC data transport.
+         */
+        std::shared_ptr<PCSCReaderUnit> getPCSCReaderUnit();
+
+        /**
+         * \brief Get the tracking of the keys loaded in the reader.
+         * \return The key slots tracking, null if unavailable.
+         */
+        std::shared_ptr<MifarePCSCKeySlots> getKeySlots();
+
         /**
          * \brief Authenticate a block, given a key number.
          * \param blockno The block number.
@@ -101,8 +180,29 @@ namespace logicalaccess
          */
         virtual void authenticate(unsigned char blockno, unsigned char keyno, MifareKeyType keytype) override;
 
+        /**
+         * \brief Authenticate a block again with the last key used, if any.
+         * \param blockno The block number.
+         */
+        void reauthenticate(unsigned char blockno);
+
         template<typename T, typename T2>
         friend class MifarePlusSL1Policy;
+
+        /**
+         * \brief The reader refused a multiple blocks command, use one block per command.
+         */
+        bool d_singleBlockTransfer;
+
+        /**
+         * \brief The key storage of the last successful authentication, null if none.
+         */
+        std::shared_ptr<KeyStorage> d_authKeyStorage;
+
+        /**
+         * \brief The key type of the last successful authentication.
+         */
+        MifareKeyType d_authKeyType;
     };
 }
 
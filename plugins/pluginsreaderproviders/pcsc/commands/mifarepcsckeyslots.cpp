@@ -0,0 +1,91 @@
+/**
+ * \file mifarepcsckeyslots.cpp
+ * \brief Mifare keys loaded in the PC/SC reader key slots.
+ */
+
+#include "../commands/mifarepcsckeyslots.hpp"
+
+#include <set>
+
+#include "logicalaccess/cards/keydiversificationcache.hpp"
+
+namespace logicalaccess
+{
+    namespace
+    {
+        std::mutex& volatileOnlyMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::set<PCSCReaderUnitType>& volatileOnlyTypes()
+        {
+            static std::set<PCSCReaderUnitType> types;
+            return types;
+        }
+    }
+
+    MifarePCSCKeySlots::MifarePCSCKeySlots()
+    {
+    }
+
+    MifarePCSCKeySlots::~MifarePCSCKeySlots()
+    {
+        clear();
+    }
+
+    bool MifarePCSCKeySlots::isLoaded(unsigned short slot, bool vol, const std::vector<unsigned char>& key) const
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        std::map<std::pair<unsigned short, bool>, std::vector<unsigned char> >::const_iterator it = d_slots.find(std::make_pair(slot, vol));
+        return (it != d_slots.end() && it->second == key);
+    }
+
+    void MifarePCSCKeySlots::setLoaded(unsigned short slot, bool vol, const std::vector<unsigned char>& key)
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        std::vector<unsigned char>& loaded = d_slots[std::make_pair(slot, vol)];
+        KeyDiversificationCache::wipe(loaded);
+        loaded = key;
+    }
+
+    void MifarePCSCKeySlots::invalidate(unsigned short slot, bool vol)
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        std::map<std::pair<unsigned short, bool>, std::vector<unsigned char> >::iterator it = d_slots.find(std::make_pair(slot, vol));
+        if (it != d_slots.end())
+        {
+            KeyDiversificationCache::wipe(it->second);
+            d_slots.erase(it);
+        }
+    }
+
+    void MifarePCSCKeySlots::invalidate(unsigned short slot)
+    {
+        invalidate(slot, false);
+        invalidate(slot, true);
+    }
+
+    void MifarePCSCKeySlots::clear()
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        for (std::map<std::pair<unsigned short, bool>, std::vector<unsigned char> >::iterator it = d_slots.begin(); it != d_slots.end(); ++it)
+        {
+            KeyDiversificationCache::wipe(it->second);
+        }
+        d_slots.clear();
+    }
+
+    bool MifarePCSCKeySlots::isVolatileOnly(PCSCReaderUnitType type)
+    {
+        std::lock_guard<std::mutex> lock(volatileOnlyMutex());
+        return volatileOnlyTypes().count(type) > 0;
+    }
+
+    void MifarePCSCKeySlots::setVolatileOnly(PCSCReaderUnitType type)
+    {
+        std::lock_guard<std::mutex> lock(volatileOnlyMutex());
+        volatileOnlyTypes().insert(type);
+    }
+}
@@ -0,0 +1,108 @@
+/**
+ * \file mifarepcsckeyslots.hpp
+ * \brief Mifare keys loaded in the PC/SC reader key slots.
+ */
+
+#ifndef LOGICALACCESS_MIFAREPCSCKEYSLOTS_HPP
+#define LOGICALACCESS_MIFAREPCSCKEYSLOTS_HPP
+
+#include "../pcscreaderunitconfiguration.hpp"
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace logicalaccess
+{
+    /**
+     * \brief Track the Mifare keys currently loaded in the key slots of a PC/SC reader.
+     *
+     * A LOAD KEY command is only needed when the slot does not already hold the key,
+     * so authenticating many sectors with the same key only costs the authentication APDUs.
+     * The volatile and non-volatile key memories are tracked apart.
+     * The tracking belongs to a reader unit and is cleared each time the card connection
+     * is set up or torn down, as another application may use the reader in between.
+     */
+    class LIBLOGICALACCESS_API MifarePCSCKeySlots
+    {
+    public:
+
+        /**
+         * \brief Constructor.
+         */
+        MifarePCSCKeySlots();
+
+        /**
+         * \brief Destructor. Wipe the tracked keys.
+         */
+        ~MifarePCSCKeySlots();
+
+        /**
+         * \brief Check if a key is loaded in a slot.
+         * \param slot The reader key slot.
+         * \param vol True for the volatile key memory.
+         * \param key The key.
+         * \return True if the slot holds the key, false otherwise.
+         */
+        bool isLoaded(unsigned short slot, bool vol, const std::vector<unsigned char>& key) const;
+
+        /**
+         * \brief Mark a key as loaded in a slot.
+         * \param slot The reader key slot.
+         * \param vol True for the volatile key memory.
+         * \param key The key.
+         */
+        void setLoaded(unsigned short slot, bool vol, const std::vector<unsigned char>& key);
+
+        /**
+         * \brief Forget the content of a slot, before loading it or after a failure.
+         * \param slot The reader key slot.
+         * \param vol True for the volatile key memory.
+         */
+        void invalidate(unsigned short slot, bool vol);
+
+        /**
+         * \brief Forget the content of a slot in both key memories.
+         * \param slot The reader key slot.
+         */
+        void invalidate(unsigned short slot);
+
+        /**
+         * \brief Forget the content of all the slots.
+         */
+        void clear();
+
+        /**
+         * \brief Check if the non-volatile key memory is known not to work on a reader type.
+         * \param type The reader type.
+         * \return True if the keys must be loaded in volatile memory, false otherwise.
+         */
+        static bool isVolatileOnly(PCSCReaderUnitType type);
+
+        /**
+         * \brief Remember the non-volatile key memory does not work on a reader type.
+         * \param type The reader type.
+         */
+        static void setVolatileOnly(PCSCReaderUnitType type);
+
+    protected:
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+        /**
+         * The key loaded in each slot, by slot and volatile memory.
+         */
+        std::map<std::pair<unsigned short, bool>, std::vector<unsigned char> > d_slots;
+
+        mutable std::mutex d_mutex;
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+    };
+}
+
+#endif /* LOGICALACCESS_MIFAREPCSCKEYSLOTS_HPP */
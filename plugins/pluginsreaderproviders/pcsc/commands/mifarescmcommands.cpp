@@ -30,6 +30,7 @@ namespace logicalaccess
 
 		std::vector<unsigned char> result, vector_key((unsigned char*)key->getData(), (unsigned char*)key->getData() + key->getLength());
 
+        invalidateKeySlot(keyno, keytype, true);
         result = getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0x82, 0x00, static_cast<unsigned char>(keytype), static_cast<unsigned char>(vector_key.size()), vector_key);
 
         if (!vol && (result[result.size() - 2] == 0x63) && (result[result.size() - 1] == 0x86))
@@ -42,11 +43,23 @@ namespace logicalaccess
         else
         {
             r = true;
+            setKeySlotLoaded(keyno, keytype, true, vector_key);
         }
 
         return r;
     }
 
+    unsigned short MifareSCMCommands::getKeySlotIndex(unsigned char /*keyno*/, MifareKeyType keytype) const
+    {
+        // The key is loaded by type, whatever the key number.
+        return static_cast<unsigned short>(keytype);
+    }
+
+    bool MifareSCMCommands::isVolatileLoad(bool /*vol*/)
+    {
+        return true;
+    }
+
 	void MifareSCMCommands::increment(unsigned char blockno, uint32_t value)
 	{
         // Somehow the documentation is invalid, and increment and decrement
@@ -39,6 +39,7 @@ bool MifareSpringCardCommands::loadKey(unsigned char keyno,
         keyindex = 0x10 + keyno;
     }
 
+    invalidateKeySlot(keyno, keytype, true);
     result = getPCSCReaderCardAdapter()->sendAPDUCommand(
         0xFF, 0x82, 0x00, keyindex,
         static_cast<unsigned char>(vector_key.size()), vector_key);
@@ -54,11 +55,24 @@ bool MifareSpringCardCommands::loadKey(unsigned char keyno,
     else
     {
         r = true;
+        setKeySlotLoaded(keyno, keytype, true, vector_key);
     }
 
     return r;
 }
 
+unsigned short MifareSpringCardCommands::getKeySlotIndex(unsigned char keyno,
+                                                        MifareKeyType keytype) const
+{
+    // Same key index as loadKey().
+    return (keytype == KT_KEY_B) ? static_cast<unsigned short>(0x10 + keyno) : 0x00;
+}
+
+bool MifareSpringCardCommands::isVolatileLoad(bool /*vol*/)
+{
+    return true;
+}
+
 void MifareSpringCardCommands::authenticate(unsigned char blockno,
                                             unsigned char keyno,
                                             MifareKeyType keytype)
@@ -82,6 +96,11 @@ void MifareSpringCardCommands::authenticate(unsigned char blockno,
         command);
 }
 
+unsigned char MifareSpringCardCommands::getMaxBlocksPerTransfer() const
+{
+    return 3;
+}
+
 void MifareSpringCardCommands::restore(unsigned char blockno)
 {
     std::vector<unsigned char> buf;
@@ -47,6 +47,21 @@ namespace logicalaccess
          */
         bool loadKey(unsigned char keyno, MifareKeyType keytype, std::shared_ptr<MifareKey> key, bool vol = false);
 
+        /**
+         * \brief Get the reader slot a key number and type are loaded in.
+         * \param keyno The key number.
+         * \param keytype The mifare key type.
+         * \return The slot, as addressed by the reader.
+         */
+        unsigned short getKeySlotIndex(unsigned char keyno, MifareKeyType keytype) const override;
+
+        /**
+         * \brief Get the key memory a LOAD KEY actually uses.
+         * \param vol True if the volatile memory is asked.
+         * \return Always true, the keys are loaded in volatile memory.
+         */
+        bool isVolatileLoad(bool vol) override;
+
         /**
          * \brief Authenticate a block, given a key number.
          * \param blockno The block number.
@@ -74,6 +89,14 @@ namespace logicalaccess
 		* \param value The decrement value.
 		*/
 		virtual void decrement(unsigned char blockno, uint32_t value) override;
+
+    protected:
+
+        /**
+         * \brief Get the maximum count of blocks the reader reads or writes in one command.
+         * \return 3 blocks, 48 bytes.
+         */
+        virtual unsigned char getMaxBlocksPerTransfer() const override;
     };
 }
 
@@ -0,0 +1,33 @@
+/**
+ * \file mifareultralightacsacrcommands.cpp
+ * \author Maxime C. <maxime-dev@islog.com>
+ * \brief Mifare Ultralight - ACS ACR.
+ */
+
+#include "../commands/mifareultralightacsacrcommands.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+#include "../pcscreaderprovider.hpp"
+#include "logicalaccess/cards/computermemorykeystorage.hpp"
+#include "logicalaccess/cards/readermemorykeystorage.hpp"
+#include "logicalaccess/cards/samkeystorage.hpp"
+
+namespace logicalaccess
+{
+    MifareUltralightACSACRCommands::MifareUltralightACSACRCommands()
+        : MifareUltralightPCSCCommands()
+    {
+    }
+
+    MifareUltralightACSACRCommands::~MifareUltralightACSACRCommands()
+    {
+    }
+
+    std::vector<unsigned char> MifareUltralightACSACRCommands::sendGenericCommand(const std::vector<unsigned char>& data)
+    {
+        return getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0x00, 0x00, 0x00, static_cast<unsigned char>(data.size()), data);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+/**
+ * \file mifareultralightacsacrcommands.hpp
+ * \author Maxime C. <maxime-dev@islog.com>
+ * \brief Mifare Ultralight - ACS ACR.
+ */
+
+#ifndef LOGICALACCESS_MIFAREULTRALIGHTACSACRCOMMANDS_HPP
+#define LOGICALACCESS_MIFAREULTRALIGHTACSACRCOMMANDS_HPP
+
+#include "mifareultralightpcsccommands.hpp"
+
+namespace logicalaccess
+{
+    /**
+     * \brief The Mifare Ultralight commands class for ACS ACR reader.
+     */
+    class LIBLOGICALACCESS_API MifareUltralightACSACRCommands : public virtual MifareUltralightPCSCCommands
+    {
+    public:
+
+        /**
+         * \brief Constructor.
+         */
+        MifareUltralightACSACRCommands();
+
+        /**
+         * \brief Destructor.
+         */
+        virtual ~MifareUltralightACSACRCommands();
+
+    protected:
+
+        virtual bool hasGenericCommand() const { return true; }
+
+        virtual std::vector<unsigned char> sendGenericCommand(const std::vector<unsigned char>& data);
+    };
+}
+
+#endif /* LOGICALACCESS_MIFAREULTRALIGHTACSACRCOMMANDS_HPP */
\ No newline at end of file
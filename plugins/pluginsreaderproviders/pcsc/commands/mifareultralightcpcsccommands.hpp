@@ -15,7 +15,7 @@ namespace logicalaccess
     /**
      * \brief The Mifare Ultralight C commands class for PCSC reader.
      */
-    class LIBLOGICALACCESS_API MifareUltralightCPCSCCommands : public MifareUltralightPCSCCommands, public MifareUltralightCCommands
+    class LIBLOGICALACCESS_API MifareUltralightCPCSCCommands : public virtual MifareUltralightPCSCCommands, public MifareUltralightCCommands
     {
     public:
 
@@ -35,13 +35,13 @@ namespace logicalaccess
          */
         virtual void authenticate(std::shared_ptr<TripleDESKey> authkey);
 
-    protected:
-
-		virtual void startGenericSession();
-
-		virtual void stopGenericSession();
+        /**
+         * \brief Ultralight C doesn't support FAST_READ, and a GET_VERSION would halt it.
+         * \return False.
+         */
+        virtual bool isFastReadSupported() { return false; }
 
-        virtual std::vector<unsigned char> sendGenericCommand(const std::vector<unsigned char>& data);
+    protected:
 
         virtual std::vector<unsigned char> authenticate_PICC1();
 
@@ -18,28 +18,11 @@
 namespace logicalaccess
 {
     MifareUltralightCSpringCardCommands::MifareUltralightCSpringCardCommands()
-        : MifareUltralightCPCSCCommands()
+        : MifareUltralightPCSCCommands(), MifareUltralightCPCSCCommands(), MifareUltralightSpringCardCommands()
     {
     }
 
     MifareUltralightCSpringCardCommands::~MifareUltralightCSpringCardCommands()
     {
     }
-
-	void MifareUltralightCSpringCardCommands::startGenericSession()
-	{
-		// Suspend card tracking
-		getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xFB, 0x01, 0x00);
-	}
-
-	void MifareUltralightCSpringCardCommands::stopGenericSession()
-	{
-		// Resume card tracking
-		getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xFB, 0x00, 0x00);
-	}
-
-    std::vector<unsigned char> MifareUltralightCSpringCardCommands::sendGenericCommand(const std::vector<unsigned char>& data)
-    {
-        return getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xFE, 0x01, 0x08, static_cast<unsigned char>(data.size()), data);
-    }
 }
\ No newline at end of file
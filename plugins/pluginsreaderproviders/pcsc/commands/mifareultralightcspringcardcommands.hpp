@@ -8,13 +8,14 @@
 #define LOGICALACCESS_MIFAREULTRALIGHTCSPRINGCARDCOMMANDS_HPP
 
 #include "mifareultralightcpcsccommands.hpp"
+#include "mifareultralightspringcardcommands.hpp"
 
 namespace logicalaccess
 {
     /**
      * \brief The Mifare Ultralight C commands class for SpringCard reader.
      */
-    class LIBLOGICALACCESS_API MifareUltralightCSpringCardCommands : public MifareUltralightCPCSCCommands
+    class LIBLOGICALACCESS_API MifareUltralightCSpringCardCommands : public MifareUltralightCPCSCCommands, public MifareUltralightSpringCardCommands
     {
     public:
 
@@ -27,14 +28,6 @@ namespace logicalaccess
          * \brief Destructor.
          */
         virtual ~MifareUltralightCSpringCardCommands();
-
-    protected:
-
-		virtual void startGenericSession();
-
-		virtual void stopGenericSession();
-
-        virtual std::vector<unsigned char> sendGenericCommand(const std::vector<unsigned char>& data);
     };
 }
 
@@ -0,0 +1,68 @@
+/**
+ * \file mifareultralightomnikeyxx21commands.cpp
+ * \author Maxime C. <maxime-dev@islog.com>
+ * \brief Mifare Ultralight - Omnikey xx21.
+ */
+
+#include "../commands/mifareultralightomnikeyxx21commands.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+#include "../pcscreaderprovider.hpp"
+#include "logicalaccess/cards/computermemorykeystorage.hpp"
+#include "logicalaccess/cards/readermemorykeystorage.hpp"
+#include "logicalaccess/cards/samkeystorage.hpp"
+
+namespace logicalaccess
+{
+    MifareUltralightOmnikeyXX21Commands::MifareUltralightOmnikeyXX21Commands()
+        : MifareUltralightPCSCCommands()
+    {
+    }
+
+    MifareUltralightOmnikeyXX21Commands::~MifareUltralightOmnikeyXX21Commands()
+    {
+    }
+
+	void MifareUltralightOmnikeyXX21Commands::startGenericSession()
+	{
+		std::vector<unsigned char> data;
+		data.push_back(0x01);
+		data.push_back(0x00);
+		data.push_back(0x01);
+		getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xA0, 0x00, 0x07, static_cast<unsigned char>(data.size()), data);
+	}
+
+	void MifareUltralightOmnikeyXX21Commands::stopGenericSession()
+	{
+		std::vector<unsigned char> data;
+		data.push_back(0x01);
+		data.push_back(0x00);
+		data.push_back(0x02);
+		getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xA0, 0x00, 0x07, static_cast<unsigned char>(data.size()), data);
+	}
+
+    std::vector<unsigned char> MifareUltralightOmnikeyXX21Commands::sendGenericCommand(const std::vector<unsigned char>& data)
+    {
+        std::vector<unsigned char> wdata;
+        wdata.push_back(0x01);
+        wdata.push_back(0x00);
+        wdata.push_back(0xF3);
+        wdata.push_back(0x00);
+        wdata.push_back(0x00);
+        wdata.push_back(0x64);
+        wdata.insert(wdata.end(), data.begin(), data.end());
+
+        std::vector<unsigned char> ret = getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xA0, 0x00, 0x05, static_cast<unsigned char>(wdata.size()), wdata, 0x00);
+		// Should return 00 00 [data] 90 00, otherwise we return the raw received buffer
+		if (ret.size() < 4)
+		{
+			return ret;
+		}
+
+		// Remove 00 00 starting bytes
+		return std::vector<unsigned char>(ret.begin() + 2, ret.end());
+    }
+}
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include <sstream>
 
 #include "../pcscreaderprovider.hpp"
+#include "logicalaccess/myexception.hpp"
+#include "logicalaccess/logs.hpp"
 #include "mifareultralight/mifareultralightchip.hpp"
 #include "logicalaccess/cards/computermemorykeystorage.hpp"
 #include "logicalaccess/cards/readermemorykeystorage.hpp"
@@ -19,7 +21,7 @@
 namespace logicalaccess
 {
     MifareUltralightPCSCCommands::MifareUltralightPCSCCommands()
-        : MifareUltralightCommands()
+        : MifareUltralightCommands(), d_fastReadRejected(false)
     {
     }
 
@@ -43,4 +45,89 @@ namespace logicalaccess
 
         getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xD6, 0x00, static_cast<unsigned char>(page), static_cast<unsigned char>(buf.size()), buf);
     }
-}
\ No newline at end of file
+
+    void MifareUltralightPCSCCommands::startGenericSession()
+    {
+    }
+
+    void MifareUltralightPCSCCommands::stopGenericSession()
+    {
+    }
+
+    std::vector<unsigned char> MifareUltralightPCSCCommands::sendGenericCommand(const std::vector<unsigned char>& /*data*/)
+    {
+        THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, "Not implemented function call.");
+    }
+
+    std::vector<unsigned char> MifareUltralightPCSCCommands::transmitGenericCommand(const std::vector<unsigned char>& data)
+    {
+        std::vector<unsigned char> result;
+
+        startGenericSession();
+        try
+        {
+            result = sendGenericCommand(data);
+        }
+        catch (std::exception&)
+        {
+            stopGenericSession();
+            throw;
+        }
+        stopGenericSession();
+
+        EXCEPTION_ASSERT_WITH_LOG(result.size() >= 2, CardException, "The PICC return a bad buffer.");
+        return std::vector<unsigned char>(result.begin(), result.end() - 2);
+    }
+
+    std::vector<unsigned char> MifareUltralightPCSCCommands::getVersion()
+    {
+        std::vector<unsigned char> data;
+        data.push_back(0x60);
+
+        std::vector<unsigned char> result = transmitGenericCommand(data);
+        EXCEPTION_ASSERT_WITH_LOG(result.size() == 8, CardException, "Bad GET_VERSION response length.");
+        return result;
+    }
+
+    bool MifareUltralightPCSCCommands::isFastReadSupported()
+    {
+        if (d_fastReadRejected || !hasGenericCommand())
+        {
+            return false;
+        }
+
+        // The version is read when the chip is detected, sending GET_VERSION now would halt an older chip.
+        std::shared_ptr<MifareUltralightChip> chip = std::dynamic_pointer_cast<MifareUltralightChip>(getChip());
+        return (chip && chip->hasFastRead());
+    }
+
+    std::vector<unsigned char> MifareUltralightPCSCCommands::fastRead(int start_page, int stop_page)
+    {
+        if (start_page > stop_page)
+        {
+            THROW_EXCEPTION_WITH_LOG(std::invalid_argument, "Start page can't be greater than stop page.");
+        }
+
+        std::vector<unsigned char> data;
+        data.push_back(0x3A);
+        data.push_back(static_cast<unsigned char>(start_page));
+        data.push_back(static_cast<unsigned char>(stop_page));
+
+        try
+        {
+            return transmitGenericCommand(data);
+        }
+        catch (const CardException& e)
+        {
+            // The chip never got the command, READ still works.
+            if (!PCSCReaderCardAdapter::isCommandRejected(e))
+            {
+                throw;
+            }
+            LOG(LogLevel::WARNINGS) << "FAST_READ refused by the reader (" << e.what() << "), reading the pages with READ.";
+            d_fastReadRejected = true;
+        }
+
+        return readPages(start_page, stop_page);
+    }
+}
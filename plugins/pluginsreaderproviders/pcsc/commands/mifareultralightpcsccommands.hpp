@@ -57,7 +57,58 @@ namespace logicalaccess
          */
         virtual void writePage(int page, const std::vector<unsigned char>& buf);
 
+        /**
+         * \brief Get the chip version (GET_VERSION command, Ultralight EV1 / NTAG21x).
+         * \return The 8 bytes version.
+         */
+        virtual std::vector<unsigned char> getVersion();
+
+        /**
+         * \brief Check if the chip and the reader support the FAST_READ command.
+         *
+         * The chip version is read with GET_VERSION when the chip is detected.
+         * \return True if FAST_READ is supported, false otherwise.
+         */
+        virtual bool isFastReadSupported();
+
+        /**
+         * \brief Read a range of pages with a single FAST_READ command, or with READ if the reader refuses it.
+         * \param start_page The start page number.
+         * \param stop_page The stop page number.
+         * \return The data of the pages.
+         */
+        virtual std::vector<unsigned char> fastRead(int start_page, int stop_page);
+
+        /**
+         * \brief Check if the reader can send native commands to the chip, through sendGenericCommand().
+         * \return True if the native commands are supported, false otherwise.
+         */
+        virtual bool hasGenericCommand() const { return false; }
+
     protected:
+
+        virtual void startGenericSession();
+
+        virtual void stopGenericSession();
+
+        /**
+         * \brief Send a native command to the chip.
+         * \param data The native command.
+         * \return The chip response, followed by the status word.
+         */
+        virtual std::vector<unsigned char> sendGenericCommand(const std::vector<unsigned char>& data);
+
+        /**
+         * \brief Send a native command to the chip, within a generic session.
+         * \param data The native command.
+         * \return The chip response, without the status word.
+         */
+        std::vector<unsigned char> transmitGenericCommand(const std::vector<unsigned char>& data);
+
+        /**
+         * True once the reader refused FAST_READ.
+         */
+        bool d_fastReadRejected;
     };
 }
 
@@ -0,0 +1,45 @@
+/**
+ * \file mifareultralightspringcardcommands.cpp
+ * \author Maxime C. <maxime-dev@islog.com>
+ * \brief Mifare Ultralight - SpringCard.
+ */
+
+#include "../commands/mifareultralightspringcardcommands.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+#include "../pcscreaderprovider.hpp"
+#include "logicalaccess/cards/computermemorykeystorage.hpp"
+#include "logicalaccess/cards/readermemorykeystorage.hpp"
+#include "logicalaccess/cards/samkeystorage.hpp"
+
+namespace logicalaccess
+{
+    MifareUltralightSpringCardCommands::MifareUltralightSpringCardCommands()
+        : MifareUltralightPCSCCommands()
+    {
+    }
+
+    MifareUltralightSpringCardCommands::~MifareUltralightSpringCardCommands()
+    {
+    }
+
+	void MifareUltralightSpringCardCommands::startGenericSession()
+	{
+		// Suspend card tracking
+		getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xFB, 0x01, 0x00);
+	}
+
+	void MifareUltralightSpringCardCommands::stopGenericSession()
+	{
+		// Resume card tracking
+		getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xFB, 0x00, 0x00);
+	}
+
+    std::vector<unsigned char> MifareUltralightSpringCardCommands::sendGenericCommand(const std::vector<unsigned char>& data)
+    {
+        return getPCSCReaderCardAdapter()->sendAPDUCommand(0xFF, 0xFE, 0x01, 0x08, static_cast<unsigned char>(data.size()), data);
+    }
+}
\ No newline at end of file
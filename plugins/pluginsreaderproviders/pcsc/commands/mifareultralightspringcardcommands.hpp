@@ -0,0 +1,43 @@
+/**
+ * \file mifareultralightspringcardcommands.hpp
+ * \author Maxime C. <maxime-dev@islog.com>
+ * \brief Mifare Ultralight - SpringCard.
+ */
+
+#ifndef LOGICALACCESS_MIFAREULTRALIGHTSPRINGCARDCOMMANDS_HPP
+#define LOGICALACCESS_MIFAREULTRALIGHTSPRINGCARDCOMMANDS_HPP
+
+#include "mifareultralightpcsccommands.hpp"
+
+namespace logicalaccess
+{
+    /**
+     * \brief The Mifare Ultralight commands class for SpringCard reader.
+     */
+    class LIBLOGICALACCESS_API MifareUltralightSpringCardCommands : public virtual MifareUltralightPCSCCommands
+    {
+    public:
+
+        /**
+         * \brief Constructor.
+         */
+        MifareUltralightSpringCardCommands();
+
+        /**
+         * \brief Destructor.
+         */
+        virtual ~MifareUltralightSpringCardCommands();
+
+    protected:
+
+        virtual bool hasGenericCommand() const { return true; }
+
+		virtual void startGenericSession();
+
+		virtual void stopGenericSession();
+
+        virtual std::vector<unsigned char> sendGenericCommand(const std::vector<unsigned char>& data);
+    };
+}
+
+#endif /* LOGICALACCESS_MIFAREULTRALIGHTSPRINGCARDCOMMANDS_HPP */
\ No newline at end of file
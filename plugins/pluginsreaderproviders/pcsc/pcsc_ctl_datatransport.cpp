@@ -17,7 +17,7 @@
 #define IOCTL_CCID_ESCAPE SCARD_CTL_CODE(3500)
 #endif
 
-void logicalaccess::PCSCControlDataTransport::send(const std::vector<unsigned char> &data)
+void logicalaccess::PCSCControlDataTransport::sendBuffer(const unsigned char *data, size_t datalen)
 {
     LLA_LOG_CTX("PCSC Control DataTransport");
 
@@ -26,15 +26,15 @@ void logicalaccess::PCSCControlDataTransport::send(const std::vector<unsigned ch
     EXCEPTION_ASSERT_WITH_LOG(getPCSCReaderUnit(), LibLogicalAccessException,
                               "The PCSC reader unit object"
                                       "is null. We cannot send.");
-    if (data.size() > 0) {
+    if (datalen > 0) {
         std::array<uint8_t, 255> returnedData;
         ULONG ulNoOfDataReceived;
 
-        LOG(LogLevel::COMS) << "APDU (control) command: " << BufferHelper::getHex(data);
+        LOG(LogLevel::COMS) << "APDU (control) command: " << BufferHelper::getHex(data, datalen);
 
         unsigned int errorFlag = SCardControl(getPCSCReaderUnit()->getHandle(),
                                               IOCTL_CCID_ESCAPE,
-                                              &data[0], data.size(),
+                                              data, datalen,
                                               &returnedData[0], returnedData.size(),
                                               &ulNoOfDataReceived);
         CheckCardError(errorFlag);
@@ -20,8 +20,8 @@ namespace logicalaccess
     class PCSCControlDataTransport : public PCSCDataTransport
     {
 
-    public:
-        virtual void send(const std::vector<unsigned char> &data) override;
+    protected:
+        virtual void sendBuffer(const unsigned char *data, size_t datalen) override;
     };
 
 }
@@ -42,17 +42,39 @@ namespace logicalaccess
         return d_isConnected;
     }
 
+    void PCSCDataTransport::beginTransaction()
+    {
+        EXCEPTION_ASSERT_WITH_LOG(getPCSCReaderUnit(), LibLogicalAccessException, "The PCSC reader unit object"
+                "is null. We cannot begin a transaction.");
+        getPCSCReaderUnit()->beginTransaction();
+    }
+
+    void PCSCDataTransport::endTransaction()
+    {
+        EXCEPTION_ASSERT_WITH_LOG(getPCSCReaderUnit(), LibLogicalAccessException, "The PCSC reader unit object"
+                "is null. We cannot end a transaction.");
+        getPCSCReaderUnit()->endTransaction();
+    }
+
     void PCSCDataTransport::send(const std::vector<unsigned char>& data)
+    {
+        sendBuffer(data.data(), data.size());
+    }
+
+    void PCSCDataTransport::sendBuffer(const unsigned char* data, size_t datalen)
     {
         LLA_LOG_CTX("PCSCDataTransport");
         d_response.clear();
 
         EXCEPTION_ASSERT_WITH_LOG(getPCSCReaderUnit(), LibLogicalAccessException, "The PCSC reader unit object"
                 "is null. We cannot send.");
-        if (data.size() > 0)
+        if (datalen > 0)
         {
-            unsigned char returnedData[255];
-            ULONG ulNoOfDataReceived = sizeof(returnedData);
+            // Room for 256 bytes of data and the status word, or 65536 bytes
+            // for an extended length APDU (Lc or Le field starting with 0x00).
+            // The response buffer keeps its capacity from one command to the other.
+            d_response.resize((datalen > 5 && data[4] == 0x00) ? 65538 : 258);
+            ULONG ulNoOfDataReceived = static_cast<ULONG>(d_response.size());
             LPCSCARD_IO_REQUEST ior = NULL;
             switch (getPCSCReaderUnit()->getActiveProtocol())
             {
@@ -69,22 +91,30 @@ namespace logicalaccess
                 break;
             }
 
-            LOG(LogLevel::COMS) << "APDU command: " << BufferHelper::getHex(data);
+            LOG(LogLevel::COMS) << "APDU command: " << BufferHelper::getHex(data, datalen);
 
-            unsigned int errorFlag = SCardTransmit(getPCSCReaderUnit()->getHandle(), ior, &data[0], static_cast<DWORD>(data.size()), NULL, returnedData, &ulNoOfDataReceived);
+            unsigned int errorFlag = SCardTransmit(getPCSCReaderUnit()->getHandle(), ior, data, static_cast<DWORD>(datalen), NULL, &d_response[0], &ulNoOfDataReceived);
 
+            if (errorFlag != SCARD_S_SUCCESS)
+                d_response.clear();
             CheckCardError(errorFlag);
-            d_response = std::vector<unsigned char>(returnedData, returnedData + ulNoOfDataReceived);
+            d_response.resize(ulNoOfDataReceived);
         }
     }
 
     std::vector<unsigned char> PCSCDataTransport::receive(long int /*timeout*/)
     {
-        std::vector<unsigned char> r = d_response;
-        LOG(LogLevel::COMS) << "APDU response: " << BufferHelper::getHex(r);
+        std::vector<unsigned char> r;
+        receiveInto(r, 0);
+        return r;
+    }
+
+    void PCSCDataTransport::receiveInto(std::vector<unsigned char>& result, long int /*timeout*/)
+    {
+        LOG(LogLevel::COMS) << "APDU response: " << BufferHelper::getHex(d_response);
 
+        result.assign(d_response.begin(), d_response.end());
         d_response.clear();
-        return r;
     }
 
     std::string PCSCDataTransport::getName() const
@@ -91,12 +91,26 @@ namespace logicalaccess
          */
         static void CheckCardError(unsigned int errorFlag);
 
+        /**
+         * \brief Begin a PC/SC transaction on the card handle.
+         */
+        virtual void beginTransaction();
+
+        /**
+         * \brief End the PC/SC transaction, leaving the card as is.
+         */
+        virtual void endTransaction();
+
         virtual void send(const std::vector<unsigned char>& data);
 
         virtual std::vector<unsigned char> receive(long int timeout);
 
     protected:
 
+        virtual void sendBuffer(const unsigned char* data, size_t datalen);
+
+        virtual void receiveInto(std::vector<unsigned char>& result, long int timeout);
+
         bool d_isConnected;
 
         std::vector<unsigned char> d_response;
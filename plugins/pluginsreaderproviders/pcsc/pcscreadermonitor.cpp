@@ -0,0 +1,324 @@
+/**
+ * \file pcscreadermonitor.cpp
+ * \brief PC/SC multi-reader insertion/removal monitor.
+ */
+
+#include "pcscreadermonitor.hpp"
+#include "pcsc_connection.hpp"
+#include "logicalaccess/logs.hpp"
+#include "logicalaccess/myexception.hpp"
+
+#include <chrono>
+#include <cstring>
+
+/**
+ * The PnP notification pseudo-reader, reporting reader plug/unplug.
+ */
+#define PCSC_PNP_NOTIFICATION "\\\\?PnP?\\Notification"
+
+/**
+ * The status change wait, in milliseconds. Bounds how long stop() waits if
+ * its cancel is lost.
+ */
+#define PCSC_MONITOR_TIMEOUT 500
+
+namespace logicalaccess
+{
+    PCSCReaderMonitor::PCSCReaderMonitor()
+        : context_(0), running_(false), next_handler_id_(0)
+    {
+    }
+
+    PCSCReaderMonitor::~PCSCReaderMonitor()
+    {
+        stop();
+        if (thread_.joinable())
+        {
+            // Destroyed from an event handler.
+            thread_.detach();
+        }
+    }
+
+    int PCSCReaderMonitor::addEventHandler(EventHandler handler)
+    {
+        std::lock_guard<std::mutex> lock(handlers_mutex_);
+        handlers_[next_handler_id_] = handler;
+        return next_handler_id_++;
+    }
+
+    void PCSCReaderMonitor::removeEventHandler(int id)
+    {
+        std::lock_guard<std::mutex> lock(handlers_mutex_);
+        handlers_.erase(id);
+    }
+
+    void PCSCReaderMonitor::start()
+    {
+        if (running_)
+            return;
+
+        // Join a thread stopped from one of its handlers.
+        stop();
+        EXCEPTION_ASSERT_WITH_LOG(!thread_.joinable(), LibLogicalAccessException,
+            "The PC/SC reader monitor cannot be restarted from its own thread.");
+
+        // Report the readers and cards present again.
+        readers_names_.clear();
+        readers_states_.clear();
+
+        establish_context();
+        running_ = true;
+        thread_ = std::thread(&PCSCReaderMonitor::run, this);
+    }
+
+    void PCSCReaderMonitor::stop()
+    {
+        running_ = false;
+        {
+            std::lock_guard<std::mutex> lock(context_mutex_);
+            if (context_ != 0)
+                SCardCancel(context_);
+        }
+
+        if (thread_.joinable())
+        {
+            if (thread_.get_id() == std::this_thread::get_id())
+                return;
+
+            // The cancel is lost if the thread was not waiting yet, the status
+            // change timeout bounds the wait in that case.
+            thread_.join();
+        }
+
+        std::lock_guard<std::mutex> lock(context_mutex_);
+        if (context_ != 0)
+        {
+            SCardReleaseContext(context_);
+            context_ = 0;
+        }
+    }
+
+    void PCSCReaderMonitor::establish_context()
+    {
+        SCARDCONTEXT context = 0;
+        LONG r = SCardEstablishContext(SCARD_SCOPE_USER, NULL, NULL, &context);
+
+        SCARDCONTEXT previous;
+        {
+            std::lock_guard<std::mutex> lock(context_mutex_);
+            previous = context_;
+            context_ = (r == SCARD_S_SUCCESS) ? context : 0;
+        }
+
+        if (previous != 0)
+        {
+            SCardReleaseContext(previous);
+        }
+
+        if (r != SCARD_S_SUCCESS)
+        {
+            THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
+                "Can't establish the context for PC/SC reader monitor: " + PCSCConnection::strerror(r));
+        }
+    }
+
+    SCARDCONTEXT PCSCReaderMonitor::get_context()
+    {
+        std::lock_guard<std::mutex> lock(context_mutex_);
+        return context_;
+    }
+
+    void PCSCReaderMonitor::run()
+    {
+        refresh_readers();
+
+        while (running_)
+        {
+            LONG r = SCardGetStatusChange(get_context(), PCSC_MONITOR_TIMEOUT, &readers_states_[0],
+                                          static_cast<DWORD>(readers_states_.size()));
+            if (!running_)
+                break;
+
+            if (r == SCARD_S_SUCCESS)
+            {
+                if (process_states())
+                    refresh_readers();
+            }
+            else if (r == SCARD_E_UNKNOWN_READER || r == SCARD_E_READER_UNAVAILABLE)
+            {
+                refresh_readers();
+            }
+            else if (r != SCARD_E_TIMEOUT && r != SCARD_E_CANCELLED)
+            {
+                LOG(LogLevel::ERRORS) << "Reader monitor cannot get status change: "
+                    << PCSCConnection::strerror(r);
+                // Do not spin if the resource manager is gone, and try to get a fresh context.
+                std::this_thread::sleep_for(std::chrono::milliseconds(250));
+                if (r == SCARD_E_NO_SERVICE || r == SCARD_E_SERVICE_STOPPED || r == SCARD_E_INVALID_HANDLE)
+                {
+                    try
+                    {
+                        establish_context();
+                    }
+                    catch (std::exception&)
+                    {
+                        continue;
+                    }
+                }
+                refresh_readers();
+            }
+        }
+    }
+
+    void PCSCReaderMonitor::refresh_readers()
+    {
+        std::map<std::string, SCARD_READERSTATE> previous;
+        for (size_t i = 1; i < readers_states_.size(); ++i)
+        {
+            previous[readers_names_[i]] = readers_states_[i];
+        }
+
+        std::vector<std::string> names;
+        SCARDCONTEXT context = get_context();
+        DWORD rdlen = 0;
+        if (SCARD_S_SUCCESS == SCardListReaders(context, NULL, (char*)NULL, &rdlen) && rdlen > 0)
+        {
+            std::vector<char> rdnames(rdlen);
+            if (SCARD_S_SUCCESS == SCardListReaders(context, NULL, &rdnames[0], &rdlen))
+            {
+                const char* rdname = &rdnames[0];
+                while (rdname[0] != '\0')
+                {
+                    names.push_back(rdname);
+                    rdname += strlen(rdname) + 1;
+                }
+            }
+        }
+
+        DWORD pnp_state = SCARD_STATE_UNAWARE;
+        if (readers_states_.size() > 0)
+        {
+            pnp_state = readers_states_[0].dwCurrentState;
+        }
+
+        readers_names_.clear();
+        readers_names_.push_back(PCSC_PNP_NOTIFICATION);
+        readers_names_.insert(readers_names_.end(), names.begin(), names.end());
+
+        readers_states_.resize(readers_names_.size());
+        std::memset(&readers_states_[0], 0, readers_states_.size() * sizeof(SCARD_READERSTATE));
+        readers_states_[0].dwCurrentState = pnp_state;
+        for (size_t i = 1; i < readers_names_.size(); ++i)
+        {
+            std::map<std::string, SCARD_READERSTATE>::iterator it = previous.find(readers_names_[i]);
+            if (it != previous.end())
+            {
+                readers_states_[i].dwCurrentState = it->second.dwCurrentState;
+                previous.erase(it);
+            }
+            else
+            {
+                readers_states_[i].dwCurrentState = SCARD_STATE_UNAWARE;
+
+                PCSCReaderMonitorEvent event;
+                event.type = PCSC_RME_READER_ADDED;
+                event.readerName = readers_names_[i];
+                dispatch(event);
+            }
+        }
+
+        // Names are final now, the states can safely reference them.
+        for (size_t i = 0; i < readers_names_.size(); ++i)
+        {
+            readers_states_[i].szReader = readers_names_[i].c_str();
+        }
+
+        for (std::map<std::string, SCARD_READERSTATE>::const_iterator it = previous.begin(); it != previous.end(); ++it)
+        {
+            PCSCReaderMonitorEvent event;
+            event.readerName = it->first;
+            if ((it->second.dwCurrentState & SCARD_STATE_PRESENT) != 0)
+            {
+                event.type = PCSC_RME_CARD_REMOVED;
+                dispatch(event);
+            }
+            event.type = PCSC_RME_READER_REMOVED;
+            dispatch(event);
+        }
+    }
+
+    bool PCSCReaderMonitor::process_states()
+    {
+        bool refresh = false;
+
+        if ((readers_states_[0].dwEventState & SCARD_STATE_CHANGED) != 0)
+        {
+            readers_states_[0].dwCurrentState = readers_states_[0].dwEventState & ~SCARD_STATE_CHANGED;
+            refresh = true;
+        }
+
+        for (size_t i = 1; i < readers_states_.size(); ++i)
+        {
+            SCARD_READERSTATE& state = readers_states_[i];
+            if ((state.dwEventState & SCARD_STATE_CHANGED) == 0)
+                continue;
+
+            bool was_present = (state.dwCurrentState & SCARD_STATE_PRESENT) != 0;
+            bool is_present = (state.dwEventState & SCARD_STATE_PRESENT) != 0;
+            state.dwEventState &= ~SCARD_STATE_CHANGED;
+            state.dwCurrentState = state.dwEventState;
+
+            if ((state.dwEventState & (SCARD_STATE_UNKNOWN | SCARD_STATE_UNAVAILABLE)) != 0)
+            {
+                // The reader is going away, the card with it. The removal is reported
+                // here, not again when the reader is dropped from the list.
+                refresh = true;
+                is_present = false;
+                state.dwCurrentState &= ~SCARD_STATE_PRESENT;
+            }
+
+            if (!was_present && is_present)
+            {
+                PCSCReaderMonitorEvent event;
+                event.type = PCSC_RME_CARD_INSERTED;
+                event.readerName = readers_names_[i];
+                event.atr.assign(state.rgbAtr, state.rgbAtr + state.cbAtr);
+                dispatch(event);
+            }
+            else if (was_present && !is_present)
+            {
+                PCSCReaderMonitorEvent event;
+                event.type = PCSC_RME_CARD_REMOVED;
+                event.readerName = readers_names_[i];
+                dispatch(event);
+            }
+        }
+
+        return refresh;
+    }
+
+    void PCSCReaderMonitor::dispatch(const PCSCReaderMonitorEvent &event)
+    {
+        std::map<int, EventHandler> handlers;
+        {
+            std::lock_guard<std::mutex> lock(handlers_mutex_);
+            handlers = handlers_;
+        }
+
+        for (std::map<int, EventHandler>::const_iterator it = handlers.begin(); it != handlers.end(); ++it)
+        {
+            try
+            {
+                it->second(event);
+            }
+            catch (std::exception& ex)
+            {
+                LOG(LogLevel::ERRORS) << "Reader monitor event handler failed: " << ex.what();
+            }
+            catch (...)
+            {
+                LOG(LogLevel::ERRORS) << "Reader monitor event handler failed.";
+            }
+        }
+    }
+}
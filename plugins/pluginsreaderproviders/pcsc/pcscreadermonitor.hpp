@@ -0,0 +1,178 @@
+/**
+ * \file pcscreadermonitor.hpp
+ * \brief PC/SC multi-reader insertion/removal monitor.
+ */
+
+#ifndef LOGICALACCESS_PCSCREADERMONITOR_HPP
+#define LOGICALACCESS_PCSCREADERMONITOR_HPP
+
+#include "pcscreaderunitconfiguration.hpp"
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace logicalaccess
+{
+    /**
+     * \brief The kind of event reported by the PC/SC reader monitor.
+     */
+    typedef enum {
+        PCSC_RME_CARD_INSERTED = 0x00,
+        PCSC_RME_CARD_REMOVED = 0x01,
+        PCSC_RME_READER_ADDED = 0x02,
+        PCSC_RME_READER_REMOVED = 0x03
+    } PCSCReaderMonitorEventType;
+
+    /**
+     * \brief An event reported by the PC/SC reader monitor.
+     */
+    struct LIBLOGICALACCESS_API PCSCReaderMonitorEvent
+    {
+        PCSCReaderMonitorEventType type;
+
+        /**
+         * \brief The name of the reader the event occurred on.
+         */
+        std::string readerName;
+
+        /**
+         * \brief The card ATR, only set on PCSC_RME_CARD_INSERTED.
+         */
+        std::vector<unsigned char> atr;
+    };
+
+    /**
+     * Watch every PC/SC reader of the system from a single thread.
+     *
+     * One SCardGetStatusChange() loop is run over all the readers, plus the
+     * PnP notification pseudo-reader so that readers plugged or unplugged
+     * while monitoring are picked up without restarting the monitor.
+     *
+     * Handlers are invoked from the monitor thread and must not block.
+     * When the monitor starts, an insertion event is reported for each card
+     * already present on a reader.
+     */
+    class LIBLOGICALACCESS_API PCSCReaderMonitor
+    {
+    public:
+        typedef std::function<void(const PCSCReaderMonitorEvent&)> EventHandler;
+
+        /**
+         * \brief Constructor.
+         */
+        PCSCReaderMonitor();
+
+        /**
+         * \brief Destructor. Stop the monitor thread.
+         */
+        ~PCSCReaderMonitor();
+
+        /**
+         * \brief Register an event handler.
+         * \param handler The handler to call on each event.
+         * \return An identifier to use with removeEventHandler().
+         */
+        int addEventHandler(EventHandler handler);
+
+        /**
+         * \brief Unregister an event handler.
+         * \param id The identifier returned by addEventHandler().
+         */
+        void removeEventHandler(int id);
+
+        /**
+         * \brief Start the monitor thread. Noop if already running.
+         */
+        void start();
+
+        /**
+         * \brief Stop the monitor thread and wait for it to terminate.
+         *
+         * When called from an event handler, the monitor thread terminates once
+         * the handler returns and is joined on the next stop() or start() call.
+         */
+        void stop();
+
+        /**
+         * \brief Check if the monitor thread is running.
+         * \return True if running, false otherwise.
+         */
+        bool isRunning() const { return running_; }
+
+    protected:
+
+        /**
+         * Monitor thread main loop.
+         */
+        void run();
+
+        /**
+         * List the system readers again and rebuild the reader states,
+         * keeping the known state of readers still connected.
+         */
+        void refresh_readers();
+
+        /**
+         * Process the reader states returned by SCardGetStatusChange().
+         * Return true if the reader list has to be refreshed.
+         */
+        bool process_states();
+
+        /**
+         * Invoke every registered handler.
+         */
+        void dispatch(const PCSCReaderMonitorEvent &event);
+
+        /**
+         * Establish the monitor own context, releasing the previous one.
+         */
+        void establish_context();
+
+        /**
+         * Get the monitor own context.
+         */
+        SCARDCONTEXT get_context();
+
+        /**
+         * The monitor own context, SCardCancel() is used on it to
+         * wake the thread up. Guarded by context_mutex_.
+         */
+        SCARDCONTEXT context_;
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+        std::mutex context_mutex_;
+
+        std::atomic<bool> running_;
+
+        std::thread thread_;
+
+        std::mutex handlers_mutex_;
+
+        std::map<int, EventHandler> handlers_;
+
+        int next_handler_id_;
+
+        /**
+         * Reader names, referenced by the states szReader pointers. Index 0 is
+         * the PnP notification pseudo-reader.
+         */
+        std::vector<std::string> readers_names_;
+
+        std::vector<SCARD_READERSTATE> readers_states_;
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+    };
+}
+
+#endif /* LOGICALACCESS_PCSCREADERMONITOR_HPP */
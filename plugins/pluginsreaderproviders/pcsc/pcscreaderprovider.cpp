@@ -41,6 +41,12 @@ namespace logicalaccess
 
     void PCSCReaderProvider::release()
     {
+        if (d_monitor)
+        {
+            d_monitor->stop();
+            d_monitor.reset();
+        }
+
         if (d_scc != 0)
         {
             SCardReleaseContext(d_scc);
@@ -103,6 +109,16 @@ namespace logicalaccess
         return ret;
     }
 
+    std::shared_ptr<PCSCReaderMonitor> PCSCReaderProvider::getReaderMonitor()
+    {
+        if (!d_monitor)
+        {
+            d_monitor.reset(new PCSCReaderMonitor());
+        }
+
+        return d_monitor;
+    }
+
     std::vector<std::string> PCSCReaderProvider::getReaderGroupList()
     {
         std::vector<std::string> groupList;
@@ -9,6 +9,7 @@
 
 #include "../iso7816/iso7816readerprovider.hpp"
 #include "pcscreaderunit.hpp"
+#include "pcscreadermonitor.hpp"
 
 #include <string>
 #include <vector>
@@ -97,6 +98,12 @@ namespace logicalaccess
          */
         SCARDCONTEXT getContext() { return d_scc; };
 
+        /**
+         * \brief Get the reader monitor watching all the readers of this provider from a single thread.
+         * \return The reader monitor. Register the event handlers then start() it.
+         */
+        std::shared_ptr<PCSCReaderMonitor> getReaderMonitor();
+
     protected:
 
 #ifdef _MSC_VER
@@ -109,6 +116,11 @@ namespace logicalaccess
          */
         ReaderList d_system_readers;
 
+        /**
+         * \brief The reader monitor, created on first use.
+         */
+        std::shared_ptr<PCSCReaderMonitor> d_monitor;
+
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
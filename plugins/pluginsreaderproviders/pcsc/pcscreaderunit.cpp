@@ -25,12 +25,16 @@
 #include "commands/iso15693pcsccommands.hpp"
 #include "iso7816/commands/twiciso7816commands.hpp"
 #include "commands/mifareultralightpcsccommands.hpp"
+#include "commands/mifareultralightacsacrcommands.hpp"
+#include "commands/mifareultralightspringcardcommands.hpp"
+#include "commands/mifareultralightomnikeyxx21commands.hpp"
 #include "commands/mifareultralightcpcsccommands.hpp"
 #include "commands/mifareultralightcomnikeyxx21commands.hpp"
 #include "commands/mifareultralightcomnikeyxx22commands.hpp"
 #include "commands/mifareultralightcacsacrcommands.hpp"
 #include "commands/mifareultralightcspringcardcommands.hpp"
 #include "commands/mifareomnikeyxx21commands.hpp"
+#include "commands/mifarepcsckeyslots.hpp"
 #include "commands/mifareplus_omnikeyxx21_sl1.hpp"
 #include "commands/mifareplus_sprincard_sl1.hpp"
 #include "commands/topazpcsccommands.hpp"
@@ -122,6 +126,7 @@ namespace logicalaccess
         catch (...) {}
 
         d_proxyReaderUnit.reset();
+        d_mifareKeySlots.reset(new MifarePCSCKeySlots());
         d_readerUnitConfig.reset(new PCSCReaderUnitConfiguration());
         setDefaultReaderCardAdapter(std::shared_ptr<PCSCReaderCardAdapter>(new PCSCReaderCardAdapter()));
     }
@@ -262,7 +267,7 @@ namespace logicalaccess
             disconnect();
         }
 
-        if (Settings::getInstance()->SeeWaitInsertionLog)
+        if (Settings::getSnapshot()->SeeWaitInsertionLog)
         {
             LOG(LogLevel::INFOS) << "Waiting card insertion...";
         }
@@ -307,7 +312,7 @@ namespace logicalaccess
             }
             else if (r != SCARD_E_TIMEOUT)
             {
-                if (Settings::getInstance()->SeeWaitInsertionLog)
+                if (Settings::getSnapshot()->SeeWaitInsertionLog)
                 {
                     LOG(LogLevel::ERRORS) << "Cannot get status change: " << r << ".";
                 }
@@ -342,7 +347,7 @@ namespace logicalaccess
             THROW_EXCEPTION_WITH_LOG(CardException, EXCEPTION_MSG_CONNECTED);
         }
 
-        if (Settings::getInstance()->SeeWaitRemovalLog)
+        if (Settings::getSnapshot()->SeeWaitRemovalLog)
         {
             LOG(LogLevel::INFOS) << "Waiting card removal...";
         }
@@ -361,38 +366,32 @@ namespace logicalaccess
             THROW_EXCEPTION_WITH_LOG(CardException, EXCEPTION_MSG_NOREADER);
         }
 
-        char** readers_names = new char*[readers_count];
-
-        for (int i = 0; i < readers_count; ++i)
-        {
-            readers_names[i] = NULL;
-        }
-
-        SCARD_READERSTATE* readers = new SCARD_READERSTATE[readers_count];
-
-        memset(readers, 0x00, sizeof(SCARD_READERSTATE) * readers_count);
+        std::vector<std::string> readers_names(readers_count);
+        ReaderStateVector readers(readers_count);
+        std::memset(&readers[0], 0x00, sizeof(SCARD_READERSTATE) * readers_count);
 
         if (reader != "")
         {
-            readers_names[0] = strdup(reader.c_str());
-            readers[0].dwCurrentState = SCARD_STATE_UNAWARE;
-            readers[0].dwEventState = SCARD_STATE_UNAWARE;
-            readers[0].szReader = reinterpret_cast<const char*>(readers_names[0]);
+            readers_names[0] = reader;
         }
         else
         {
             for (int i = 0; i < readers_count; ++i)
             {
-                readers_names[i] = strdup(getReaderProvider()->getReaderList().at(i)->getName().c_str());
-                readers[i].dwCurrentState = SCARD_STATE_UNAWARE;
-                readers[i].dwEventState = SCARD_STATE_UNAWARE;
-                readers[i].szReader = reinterpret_cast<const char*>(readers_names[i]);
+                readers_names[i] = getReaderProvider()->getReaderList().at(i)->getName();
             }
         }
 
+        for (int i = 0; i < readers_count; ++i)
+        {
+            readers[i].dwCurrentState = SCARD_STATE_UNAWARE;
+            readers[i].dwEventState = SCARD_STATE_UNAWARE;
+            readers[i].szReader = readers_names[i].c_str();
+        }
+
         reader.clear();
 
-        LONG r = SCardGetStatusChange(getPCSCReaderProvider()->getContext(), ((maxwait == 0) ? INFINITE : maxwait), readers, readers_count);
+        LONG r = SCardGetStatusChange(getPCSCReaderProvider()->getContext(), ((maxwait == 0) ? INFINITE : maxwait), &readers[0], readers_count);
 
         if (SCARD_S_SUCCESS == r)
         {
@@ -417,7 +416,7 @@ namespace logicalaccess
                 do
                 {
                     loop = false;
-                    r = SCardGetStatusChange(getPCSCReaderProvider()->getContext(), ((maxwait == 0) ? INFINITE : maxwait), readers, readers_count);
+                    r = SCardGetStatusChange(getPCSCReaderProvider()->getContext(), ((maxwait == 0) ? INFINITE : maxwait), &readers[0], readers_count);
 
                     if (SCARD_S_SUCCESS == r)
                     {
@@ -440,7 +439,7 @@ namespace logicalaccess
                     {
                         if (r != SCARD_E_TIMEOUT)
                         {
-                            if (Settings::getInstance()->SeeWaitRemovalLog)
+                            if (Settings::getSnapshot()->SeeWaitRemovalLog)
                             {
                                 LOG(LogLevel::ERRORS) << "Cannot get status change: " << r << ".";
                             }
@@ -451,21 +450,6 @@ namespace logicalaccess
             }
         }
 
-        for (int i = 0; i < readers_count; ++i)
-        {
-            if (readers_names[i])
-            {
-                free(readers_names[i]);
-                readers_names[i] = NULL;
-            }
-        }
-
-        delete[] readers;
-        readers = NULL;
-
-        delete[] readers_names;
-        readers_names = NULL;
-
         if (!reader.empty())
         {
             if (d_name == "")
@@ -571,6 +555,7 @@ namespace logicalaccess
         }
 
 		connection_->reconnect();
+        d_mifareKeySlots->clear();
 
 		if (!ISO7816ReaderUnit::reconnect(action))
 			return false;
@@ -757,7 +742,22 @@ namespace logicalaccess
             }
 			else if (type == CHIP_MIFAREULTRALIGHT)
             {
-                commands.reset(new MifareUltralightPCSCCommands());
+                if (getPCSCType() == PCSC_RUT_ACS_ACR || getPCSCType() == PCSC_RUT_ACS_ACR_1222L)
+                {
+                    commands.reset(new MifareUltralightACSACRCommands());
+                }
+                else if (getPCSCType() == PCSC_RUT_SPRINGCARD)
+                {
+                    commands.reset(new MifareUltralightSpringCardCommands());
+                }
+                else if (getPCSCType() == PCSC_RUT_OMNIKEY_XX21)
+                {
+                    commands.reset(new MifareUltralightOmnikeyXX21Commands());
+                }
+                else
+                {
+                    commands.reset(new MifareUltralightPCSCCommands());
+                }
             }
 			else if (type == CHIP_MIFAREULTRALIGHTC)
             {
@@ -861,6 +861,11 @@ namespace logicalaccess
             if (rca)
             {
 				rca->setResultChecker(resultChecker);
+                std::shared_ptr<ISO7816ReaderCardAdapter> isorca = std::dynamic_pointer_cast<ISO7816ReaderCardAdapter>(rca);
+                if (isorca)
+                {
+                    isorca->setExtendedLengthSupported(ATRParser::supportsExtendedLength(getATR()));
+                }
                 std::shared_ptr<DataTransport> dt = getDataTransport();
                 if (dt)
                 {
@@ -1174,6 +1179,7 @@ namespace logicalaccess
             return d_proxyReaderUnit->setup_pcsc_connection(share_mode);
         }
         assert(connection_ == nullptr);
+        d_mifareKeySlots->clear();
         if (share_mode == SC_DIRECT)
         {
             assert(getPCSCReaderProvider());
@@ -1207,6 +1213,16 @@ namespace logicalaccess
             d_proxyReaderUnit->teardown_pcsc_connection();
         }
         connection_ = nullptr;
+        d_mifareKeySlots->clear();
+    }
+
+    std::shared_ptr<MifarePCSCKeySlots> PCSCReaderUnit::getMifareKeySlots() const
+    {
+        if (d_proxyReaderUnit)
+        {
+            return d_proxyReaderUnit->getMifareKeySlots();
+        }
+        return d_mifareKeySlots;
     }
 
     void PCSCReaderUnit::configure_mifareplus_chip(std::shared_ptr<Chip> chip,
@@ -1321,7 +1337,7 @@ namespace logicalaccess
         if (!getName().empty())
         {
             // use dedicated reader
-            if (Settings::getInstance()->SeeWaitInsertionLog)
+            if (Settings::getSnapshot()->SeeWaitInsertionLog)
             {
                 LOG(LogLevel::INFOS) << "Use specific reader: " << getName() << ".";
             }
@@ -1412,13 +1428,14 @@ bool PCSCReaderUnit::process_insertion(const std::string &cardType,
 
 std::shared_ptr<Chip> PCSCReaderUnit::adjustChip(std::shared_ptr<Chip> c)
 {
+    // One probe for the whole adjustment, GetVersion is sent at most once.
+    std::shared_ptr<CardProbe> probe = createCardProbe();
+
     // DESFire adjustment. Check maybe it's DESFireEV1 or EV2. Check random uid.
     // Adjust cryptographic context.
 	if (c->getCardType() == CHIP_DESFIRE && d_card_type == CHIP_UNKNOWN)
     {
-        if (createCardProbe()->is_desfire_ev1())
-			c = createChip(CHIP_DESFIRE_EV1);
-		else if (createCardProbe()->is_desfire_ev2())
+        if (probe->is_desfire_ev1() || probe->is_desfire_ev2())
 			c = createChip(CHIP_DESFIRE_EV1);
     }
 	if (c->getCardType() == CHIP_DESFIRE
@@ -1426,7 +1443,7 @@ std::shared_ptr<Chip> PCSCReaderUnit::adjustChip(std::shared_ptr<Chip> c)
 		|| c->getCardType() == CHIP_DESFIRE_EV2)
     {
         ByteVector uid;
-        if (createCardProbe()->has_desfire_random_uid(&uid))
+        if (probe->has_desfire_random_uid(&uid))
         {
             c->setChipIdentifier(getCardSerialNumber()); // Has random, cannot rely on get_version
             std::dynamic_pointer_cast<DESFireChip>(c)->setHasRealUID(false);
@@ -1443,8 +1460,11 @@ std::shared_ptr<Chip> PCSCReaderUnit::adjustChip(std::shared_ptr<Chip> c)
 	// Mifare Ultralight adjustement.
 	if (c->getCardType() == "MifareUltralight" && d_card_type == CHIP_UNKNOWN)
 	{
-		if (createCardProbe()->is_mifare_ultralight_c())
+		ByteVector version;
+		if (probe->is_mifare_ultralight_c())
 			c = createChip("MifareUltralightC");
+		else if (probe->get_mifare_ultralight_version(&version))
+			std::dynamic_pointer_cast<MifareUltralightChip>(c)->setVersion(version);
 	}
 
     if (c->getChipIdentifier().size() == 0)
@@ -16,6 +16,8 @@
 
 namespace logicalaccess
 {
+    class MifarePCSCKeySlots;
+
     /**
      * \brief The PC/SC reader unit class.
      */
@@ -392,6 +394,12 @@ namespace logicalaccess
          */
         void teardown_pcsc_connection();
 
+        /**
+         * \brief Get the Mifare keys loaded in the reader key slots.
+         * \return The key slots tracking, cleared with the card connection.
+         */
+        std::shared_ptr<MifarePCSCKeySlots> getMifareKeySlots() const;
+
       protected:
 		/**
 		 * A PCSC connection object.
@@ -407,6 +415,11 @@ namespace logicalaccess
          * \brief The proxy reader unit.
          */
         std::shared_ptr<PCSCReaderUnit> d_proxyReaderUnit;
+
+        /**
+         * \brief The Mifare keys loaded in the reader key slots.
+         */
+        std::shared_ptr<MifarePCSCKeySlots> d_mifareKeySlots;
     };
 
 }
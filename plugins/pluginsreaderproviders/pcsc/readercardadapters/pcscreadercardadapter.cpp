@@ -29,4 +29,43 @@ namespace logicalaccess
     {
         return answer;
     }
-}
\ No newline at end of file
+
+    void PCSCReaderCardAdapter::transmit(const unsigned char* command, size_t commandlen, std::vector<unsigned char>& result, long timeout)
+    {
+        if (!d_dataTransport)
+        {
+            ReaderCardAdapter::transmit(command, commandlen, result, timeout);
+            return;
+        }
+
+        d_dataTransport->transmit(command, commandlen, result, timeout);
+        checkResult(result);
+    }
+
+    bool PCSCReaderCardAdapter::isCommandRejected(const CardException& e)
+    {
+        switch (e.error_code())
+        {
+        case CardException::WRONG_LENGTH:
+        case CardException::FUNCTION_NOT_SUPPORTED:
+        case CardException::WRONG_P1_P2:
+        case CardException::WRONG_INSTRUCTION:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void PCSCReaderCardAdapter::switchToSingleBlock(const CardException& e, bool write, bool& singleBlockTransfer)
+    {
+        // Only the reader refusing the command is worth a retry, chip errors are reported.
+        if (!isCommandRejected(e))
+        {
+            throw;
+        }
+
+        LOG(LogLevel::WARNINGS) << "Multiple blocks " << (write ? "write" : "read") << " refused (" << e.what() << "), "
+            << (write ? "writing" : "reading") << " one block at a time.";
+        singleBlockTransfer = true;
+    }
+}
@@ -48,6 +48,37 @@ namespace logicalaccess
          */
         virtual std::vector<unsigned char> adaptAnswer(const std::vector<unsigned char>& answer);
 
+        /**
+         * \brief Send a command to the reader, writing the answer to a caller owned buffer.
+         *
+         * Commands and answers are not adapted, so they are exchanged without any copy.
+         * \param command The command buffer.
+         * \param commandlen The command length.
+         * \param result The result buffer, replaced by the answer.
+         * \param timeout The command timeout.
+         */
+        virtual void transmit(const unsigned char* command, size_t commandlen, std::vector<unsigned char>& result, long timeout = -1);
+
+        /**
+         * \brief Tell if an error is the reader refusing the command itself, rather than a card failure.
+         *
+         * Wrong length (6700), function not supported (6A81), wrong parameters (6B00) or wrong instruction (6D00).
+         * \param e The error.
+         * \return True if the reader doesn't support the command as sent.
+         */
+        static bool isCommandRejected(const CardException& e);
+
+        /**
+         * \brief Switch to one block at a time when the reader refused a multiple blocks command.
+         *
+         * To call from the catch block of the multiple blocks command: the error is rethrown
+         * unless the reader refused the command itself (see isCommandRejected()).
+         * \param e The error of the multiple blocks command.
+         * \param write True for a write command, false for a read.
+         * \param singleBlockTransfer Set to true when switching.
+         */
+        static void switchToSingleBlock(const CardException& e, bool write, bool& singleBlockTransfer);
+
     protected:
     };
 }
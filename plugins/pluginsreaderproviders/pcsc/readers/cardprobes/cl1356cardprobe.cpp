@@ -11,7 +11,7 @@ CL1356CardProbe::CL1356CardProbe(ReaderUnit *ru)
 {
 }
 
-bool CL1356CardProbe::maybe_mifare_classic()
+bool CL1356CardProbe::probe_mifare_classic()
 {
     try
     {
@@ -10,7 +10,7 @@ class LIBLOGICALACCESS_API CL1356CardProbe : public PCSCCardProbe
     CL1356CardProbe(ReaderUnit *ru);
 
 
-  public:
-    virtual bool maybe_mifare_classic() override;
+  protected:
+    virtual bool probe_mifare_classic() override;
 };
 }
@@ -6,15 +6,39 @@
 #include <assert.h>
 #include <desfire/desfirecommands.hpp>
 #include <mifareultralight/mifareultralightccommands.hpp>
+#include "../../commands/mifareultralightpcsccommands.hpp"
 
 using namespace logicalaccess;
 
 PCSCCardProbe::PCSCCardProbe(ReaderUnit *ru)
     : CardProbe(ru)
+    , desfire_version_probed_(false)
+    , desfire_version_(-1)
+    , mifare_classic_(PROBE_UNKNOWN)
+    , mifare_ultralight_c_(PROBE_UNKNOWN)
+    , mifare_ultralight_ev1_(PROBE_UNKNOWN)
 {
 }
 
+void PCSCCardProbe::clear_cache()
+{
+    desfire_version_probed_ = false;
+    desfire_version_        = -1;
+    desfire_uid_.clear();
+    mifare_classic_        = PROBE_UNKNOWN;
+    mifare_ultralight_c_   = PROBE_UNKNOWN;
+    mifare_ultralight_ev1_ = PROBE_UNKNOWN;
+    mifare_ultralight_version_.clear();
+}
+
 bool PCSCCardProbe::maybe_mifare_classic()
+{
+    if (mifare_classic_ == PROBE_UNKNOWN)
+        mifare_classic_ = probe_mifare_classic() ? PROBE_TRUE : PROBE_FALSE;
+    return mifare_classic_ == PROBE_TRUE;
+}
+
+bool PCSCCardProbe::probe_mifare_classic()
 {
     try
     {
@@ -47,31 +71,21 @@ bool PCSCCardProbe::maybe_mifare_classic()
 
 bool PCSCCardProbe::is_desfire(std::vector<uint8_t> *uid)
 {
-    try
-    {
-        LLA_LOG_CTX("Probe::is_desfire");
-        reset();
-        auto chip = reader_unit_->createChip("DESFire");
-        DESFireCommands::DESFireCardVersion cardversion;
-        auto desfire_command =
-            std::dynamic_pointer_cast<DESFireCommands>(chip->getCommands());
-        desfire_command->selectApplication(0x00);
-        desfire_command->getVersion(cardversion);
-
-        if (uid)
-            *uid =
-                ByteVector(std::begin(cardversion.uid), std::end(cardversion.uid));
-        return true;
-    }
-    catch (const std::exception &)
-    {
-        // If an error occurred, the card probably isn't desfire.
+    LLA_LOG_CTX("Probe::is_desfire");
+    if (get_desfire_version() < 0)
         return false;
-    }
+
+    if (uid)
+        *uid = desfire_uid_;
+    return true;
 }
 
-unsigned char PCSCCardProbe::get_desfire_version(std::vector<uint8_t> *uid)
+int PCSCCardProbe::get_desfire_version()
 {
+    if (desfire_version_probed_)
+        return desfire_version_;
+
+    desfire_version_probed_ = true;
 	try
 	{
 		LLA_LOG_CTX("Probe::get_desfire_version");
@@ -84,32 +98,46 @@ unsigned char PCSCCardProbe::get_desfire_version(std::vector<uint8_t> *uid)
 		desfire_command->selectApplication(0x00);
 		desfire_command->getVersion(cardversion);
 
-		if (uid)
-			*uid =
+		desfire_uid_ =
 			ByteVector(std::begin(cardversion.uid), std::end(cardversion.uid));
-		return cardversion.softwareMjVersion;
+		desfire_version_ = cardversion.softwareMjVersion;
 	}
 	catch (const std::exception&)
 	{
 		// If an error occurred, the card probably isn't desfire.
-		return -1;
+		desfire_version_ = -1;
 	}
+	return desfire_version_;
 }
 
 bool PCSCCardProbe::is_desfire_ev1(std::vector<uint8_t> *uid)
 {
 	LLA_LOG_CTX("Probe::is_desfire_ev1");
-	return get_desfire_version(uid) == 1;
+	if (get_desfire_version() != 1)
+		return false;
+
+	if (uid)
+		*uid = desfire_uid_;
+	return true;
 }
 
 bool PCSCCardProbe::is_desfire_ev2(std::vector<uint8_t> *uid)
 {
 	LLA_LOG_CTX("Probe::is_desfire_ev2");
-	return get_desfire_version(uid) >= 2;
+	if (get_desfire_version() < 2)
+		return false;
+
+	if (uid)
+		*uid = desfire_uid_;
+	return true;
 }
 
 bool PCSCCardProbe::is_mifare_ultralight_c()
 {
+	if (mifare_ultralight_c_ != PROBE_UNKNOWN)
+		return mifare_ultralight_c_ == PROBE_TRUE;
+
+	mifare_ultralight_c_ = PROBE_FALSE;
 	try
 	{
 		LLA_LOG_CTX("Probe::is_mifare_ultralight_c");
@@ -126,9 +154,49 @@ bool PCSCCardProbe::is_mifare_ultralight_c()
 		return false;
 	}
 
+	mifare_ultralight_c_ = PROBE_TRUE;
 	return true;
 }
 
+bool PCSCCardProbe::get_mifare_ultralight_version(ByteVector *version)
+{
+    if (mifare_ultralight_ev1_ == PROBE_UNKNOWN)
+    {
+        mifare_ultralight_ev1_ = PROBE_FALSE;
+        LLA_LOG_CTX("Probe::get_mifare_ultralight_version");
+        auto chip = reader_unit_->createChip("MifareUltralight");
+        auto mfu_command =
+            std::dynamic_pointer_cast<MifareUltralightPCSCCommands>(chip->getCommands());
+        // Without a transparent exchange, the reader cannot send GET_VERSION.
+        if (mfu_command && mfu_command->hasGenericCommand())
+        {
+            try
+            {
+                reset();
+                mifare_ultralight_version_ = mfu_command->getVersion();
+                mifare_ultralight_ev1_     = PROBE_TRUE;
+            }
+            catch (const std::exception &)
+            {
+                // The chip is halted by the NAK, wake it up for the next commands.
+                try
+                {
+                    reset();
+                }
+                catch (const std::exception &)
+                {
+                }
+            }
+        }
+    }
+
+    if (mifare_ultralight_ev1_ != PROBE_TRUE)
+        return false;
+
+    if (version)
+        *version = mifare_ultralight_version_;
+    return true;
+}
 
 void PCSCCardProbe::reset()
 {
@@ -150,28 +218,14 @@ void PCSCCardProbe::reset()
 
 bool PCSCCardProbe::has_desfire_random_uid(ByteVector *uid)
 {
-    try
-    {
-        DESFireCommands::DESFireCardVersion cardversion;
-        auto chip = reader_unit_->createChip("DESFireEV1");
-        auto desfire_command =
-            std::dynamic_pointer_cast<DESFireCommands>(chip->getCommands());
-        assert(desfire_command);
-
-        desfire_command->selectApplication(0x00);
-        desfire_command->getVersion(cardversion);
-
-        if (BufferHelper::allZeroes(cardversion.uid))
-        {
-            return true;
-        }
-        if (uid)
-            *uid =
-                ByteVector(std::begin(cardversion.uid), std::end(cardversion.uid));
+    if (get_desfire_version() < 0)
         return false;
-    }
-    catch (const std::exception &)
+
+    if (BufferHelper::allZeroes(desfire_uid_))
     {
-        return false;
+        return true;
     }
-}
\ No newline at end of file
+    if (uid)
+        *uid = desfire_uid_;
+    return false;
+}
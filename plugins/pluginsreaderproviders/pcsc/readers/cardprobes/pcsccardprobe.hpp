@@ -1,9 +1,19 @@
 #pragma once
 
 #include "logicalaccess/cardprobe.hpp"
+#include <vector>
 
 namespace logicalaccess
 {
+/**
+ * A probe for PC/SC readers.
+ *
+ * The probe remembers the card answers: GetVersion is sent once and the
+ * DESFire generation, random UID and serial number are all derived from it.
+ * The Mifare Classic, Ultralight C and Ultralight version probes are also
+ * sent once. Create a
+ * new probe, or call clear_cache(), for each card insertion.
+ */
 class LIBLOGICALACCESS_API PCSCCardProbe : public CardProbe
 {
   public:
@@ -18,14 +28,55 @@ class LIBLOGICALACCESS_API PCSCCardProbe : public CardProbe
 
 	virtual bool is_mifare_ultralight_c() override;
 
+    virtual bool get_mifare_ultralight_version(ByteVector *version) override;
+
     virtual bool maybe_mifare_classic() override;
 
     virtual bool has_desfire_random_uid(ByteVector *uid) override;
 
+    virtual void clear_cache() override;
+
   protected:
     void reset();
 
-	private:
-		unsigned char get_desfire_version(std::vector<uint8_t> *uid = nullptr);
+    /**
+     * Send the Mifare Classic probe, maybe_mifare_classic() caches the answer.
+     */
+    virtual bool probe_mifare_classic();
+
+    /**
+     * Send the DESFire GetVersion command, once per insertion.
+     * @return The DESFire software major version, -1 if the card is not a DESFire.
+     */
+    int get_desfire_version();
+
+  private:
+    enum ProbeResult
+    {
+        PROBE_UNKNOWN,
+        PROBE_TRUE,
+        PROBE_FALSE
+    };
+
+    bool desfire_version_probed_;
+
+    int desfire_version_;
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+    ByteVector desfire_uid_;
+
+    ByteVector mifare_ultralight_version_;
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+    ProbeResult mifare_classic_;
+
+    ProbeResult mifare_ultralight_c_;
+
+    ProbeResult mifare_ultralight_ev1_;
 };
 }
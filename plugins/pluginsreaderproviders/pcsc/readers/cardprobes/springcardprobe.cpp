@@ -10,7 +10,7 @@ SpringCardProbe::SpringCardProbe(ReaderUnit *ru)
 {
 }
 
-bool SpringCardProbe::maybe_mifare_classic()
+bool SpringCardProbe::probe_mifare_classic()
 {
     try
     {
@@ -10,7 +10,7 @@ class LIBLOGICALACCESS_API SpringCardProbe : public PCSCCardProbe
     SpringCardProbe(ReaderUnit *ru);
 
 
-  public:
-    virtual bool maybe_mifare_classic() override;
+  protected:
+    virtual bool probe_mifare_classic() override;
 };
 }
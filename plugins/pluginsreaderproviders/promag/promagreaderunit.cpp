@@ -17,6 +17,7 @@
 #include <boost/filesystem.hpp>
 #include "readercardadapters/promagdatatransport.hpp"
 #include "logicalaccess/bufferhelper.hpp"
+#include "logicalaccess/readerproviders/readerpollscheduler.hpp"
 #include <boost/property_tree/xml_parser.hpp>
 
 namespace logicalaccess
@@ -61,28 +62,33 @@ namespace logicalaccess
 
     bool PromagReaderUnit::waitInsertion(unsigned int maxwait)
     {
-        bool inserted = false;
-        std::chrono::steady_clock::time_point const clock_timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
+        if (d_promagIdentifier.size() == 0)
+        {
+            retrieveReaderIdentifier();
+        }
 
+        return ReaderPollScheduler::getInstance()->waitFor(std::bind(&PromagReaderUnit::pollInsertion, this), maxwait);
+    }
+
+    void PromagReaderUnit::waitInsertionAsync(unsigned int maxwait, WaitHandler handler)
+    {
         if (d_promagIdentifier.size() == 0)
         {
             retrieveReaderIdentifier();
         }
 
-        do
+        std::shared_ptr<PromagReaderUnit> self = std::dynamic_pointer_cast<PromagReaderUnit>(shared_from_this());
+        ReaderPollScheduler::getInstance()->schedule([self]() { return self->pollInsertion(); }, handler, maxwait);
+    }
+
+    bool PromagReaderUnit::pollInsertion()
+    {
+        std::shared_ptr<Chip> chip = getChipInAir();
+        if (chip)
         {
-            std::shared_ptr<Chip> chip = getChipInAir();
-            if (chip)
-            {
-                d_insertedChip = chip;
-                inserted = true;
-            }
-
-            if (!inserted)
-                std::this_thread::sleep_for(std::chrono::milliseconds(250));
-        } while (!inserted && std::chrono::steady_clock::now() < clock_timeout);
-
-        return inserted;
+            d_insertedChip = chip;
+        }
+        return bool(chip);
     }
 
     bool PromagReaderUnit::waitRemoval(unsigned int maxwait)
@@ -96,32 +102,41 @@ namespace logicalaccess
 
         if (d_insertedChip)
         {
-            std::chrono::steady_clock::time_point const clock_timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
-            do
-            {
-                std::shared_ptr<Chip> chip = getChipInAir();
-                if (chip)
-                {
-                    if (chip->getChipIdentifier() != d_insertedChip->getChipIdentifier())
-                    {
-                        d_insertedChip.reset();
-                        removed = true;
-                    }
-                }
-                else
-                {
-                    d_insertedChip.reset();
-                    removed = true;
-                }
-
-                if (!removed)
-                    std::this_thread::sleep_for(std::chrono::milliseconds(250));
-            } while (!removed && std::chrono::steady_clock::now() < clock_timeout);
+            removed = ReaderPollScheduler::getInstance()->waitFor(std::bind(&PromagReaderUnit::pollRemoval, this), maxwait);
         }
 
         return removed;
     }
 
+    void PromagReaderUnit::waitRemovalAsync(unsigned int maxwait, WaitHandler handler)
+    {
+        if (d_promagIdentifier.size() == 0)
+        {
+            retrieveReaderIdentifier();
+        }
+
+        if (!d_insertedChip)
+        {
+            handler(false);
+            return;
+        }
+
+        std::shared_ptr<PromagReaderUnit> self = std::dynamic_pointer_cast<PromagReaderUnit>(shared_from_this());
+        ReaderPollScheduler::getInstance()->schedule([self]() { return self->pollRemoval(); }, handler, maxwait);
+    }
+
+    bool PromagReaderUnit::pollRemoval()
+    {
+        std::shared_ptr<Chip> chip = getChipInAir();
+        if (chip && chip->getChipIdentifier() == d_insertedChip->getChipIdentifier())
+        {
+            return false;
+        }
+
+        d_insertedChip.reset();
+        return true;
+    }
+
     bool PromagReaderUnit::connect()
     {
         return true;
@@ -23,6 +23,7 @@
 #include "logicalaccess/dynlibrary/idynlibrary.hpp"
 #include "logicalaccess/logs.hpp"
 #include "logicalaccess/myexception.hpp"
+#include "logicalaccess/readerproviders/readerpollscheduler.hpp"
 
 namespace logicalaccess
 {
@@ -163,26 +164,27 @@ namespace logicalaccess
 
     bool RFIDeasReaderUnit::waitInsertion(unsigned int maxwait)
     {
-        bool inserted = false;
-        unsigned int currentWait = 0;
+        return ReaderPollScheduler::getInstance()->waitFor(std::bind(&RFIDeasReaderUnit::pollInsertion, this), maxwait);
+    }
+
+    void RFIDeasReaderUnit::waitInsertionAsync(unsigned int maxwait, WaitHandler handler)
+    {
+        std::shared_ptr<RFIDeasReaderUnit> self = std::dynamic_pointer_cast<RFIDeasReaderUnit>(shared_from_this());
+        ReaderPollScheduler::getInstance()->schedule([self]() { return self->pollInsertion(); }, handler, maxwait);
+    }
 
-        do
+    bool RFIDeasReaderUnit::pollInsertion()
+    {
+        std::vector<unsigned char> tagid = getTagId();
+        if (tagid.size() > 0)
         {
-            std::vector<unsigned char> tagid = getTagId();
-            if (tagid.size() > 0)
-            {
-                d_insertedChip = ReaderUnit::createChip(
+            d_insertedChip = ReaderUnit::createChip(
 					(d_card_type == CHIP_UNKNOWN) ? CHIP_GENERICTAG : d_card_type,
-                    tagid
-                    );
-                inserted = true;
-            }
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(250));
-            currentWait += 250;
-        } while (!inserted && (maxwait == 0 || currentWait < maxwait));
-
-        return inserted;
+                tagid
+                );
+            return true;
+        }
+        return false;
     }
 
     bool RFIDeasReaderUnit::waitRemoval(unsigned int maxwait)
@@ -191,35 +193,36 @@ namespace logicalaccess
 
         if (d_insertedChip)
         {
-            unsigned int currentWait = 0;
-            do
-            {
-                std::vector<unsigned char> tagid = getTagId();
-                if (tagid.size() > 0)
-                {
-                    if (tagid != d_insertedChip->getChipIdentifier())
-                    {
-                        d_insertedChip.reset();
-                        removed = true;
-                    }
-                }
-                else
-                {
-                    d_insertedChip.reset();
-                    removed = true;
-                }
-
-                if (!removed)
-                {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(250));
-                    currentWait += 250;
-                }
-            } while (!removed && (maxwait == 0 || currentWait < maxwait));
+            removed = ReaderPollScheduler::getInstance()->waitFor(std::bind(&RFIDeasReaderUnit::pollRemoval, this), maxwait);
         }
 
         return removed;
     }
 
+    void RFIDeasReaderUnit::waitRemovalAsync(unsigned int maxwait, WaitHandler handler)
+    {
+        if (!d_insertedChip)
+        {
+            handler(false);
+            return;
+        }
+
+        std::shared_ptr<RFIDeasReaderUnit> self = std::dynamic_pointer_cast<RFIDeasReaderUnit>(shared_from_this());
+        ReaderPollScheduler::getInstance()->schedule([self]() { return self->pollRemoval(); }, handler, maxwait);
+    }
+
+    bool RFIDeasReaderUnit::pollRemoval()
+    {
+        std::vector<unsigned char> tagid = getTagId();
+        if (tagid.size() > 0 && tagid == d_insertedChip->getChipIdentifier())
+        {
+            return false;
+        }
+
+        d_insertedChip.reset();
+        return true;
+    }
+
     bool RFIDeasReaderUnit::connect()
     {
         return true;
@@ -35,7 +35,7 @@ namespace logicalaccess
                                                                           bool waitanswer, long timeout)
     {
         if (timeout == -1)
-            timeout = Settings::getInstance()->DataTransportTimeout;
+            timeout = Settings::getSnapshot()->DataTransportTimeout;
 
         LOG(LogLevel::COMS) << "Send Rpleth Command : " << BufferHelper::getHex(data);
         std::vector<unsigned char> res;
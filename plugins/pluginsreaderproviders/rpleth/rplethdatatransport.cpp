@@ -78,7 +78,7 @@ namespace logicalaccess
     {
         std::vector<unsigned char> ret, buf;
         if (timeout == -1)
-            timeout = Settings::getInstance()->DataTransportTimeout;
+            timeout = Settings::getSnapshot()->DataTransportTimeout;
 		std::chrono::steady_clock::time_point const clock_timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
 
 		do
@@ -144,19 +144,42 @@ namespace logicalaccess
         LOG(LogLevel::COMS) << "Sending command " << BufferHelper::getHex(command) << " command size {" << command.size() << "} timeout {" << timeout << "}...";
 
         if (timeout == -1)
-            timeout = Settings::getInstance()->DataTransportTimeout;
+            timeout = Settings::getSnapshot()->DataTransportTimeout;
 
         std::vector<unsigned char> res;
-        d_lastCommand = command;
-        d_lastResult.clear();
+        if (d_retainLastExchange)
+        {
+            d_lastCommand = command;
+            d_lastResult.clear();
+        }
 
         if (command.size() > 0)
             send(command);
 
         res = receive(timeout);
-        d_lastResult = res;
+        if (d_retainLastExchange)
+            d_lastResult = res;
         LOG(LogLevel::COMS) << "Response received successfully ! Reponse: " << BufferHelper::getHex(res) << " size {" << res.size() << "}";
 
         return res;
     }
+
+    void RplethDataTransport::exchangeAsync(const std::vector<unsigned char>& command, long int timeout, CommandHandler handler)
+    {
+        std::vector<unsigned char> res;
+        try
+        {
+            if (command.size() > 0)
+                send(command);
+
+            res = receive(timeout);
+        }
+        catch (...)
+        {
+            handler(std::current_exception(), std::vector<unsigned char>());
+            return;
+        }
+
+        handler(std::exception_ptr(), res);
+    }
 }
\ No newline at end of file
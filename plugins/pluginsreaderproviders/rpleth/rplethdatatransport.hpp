@@ -92,6 +92,15 @@ namespace logicalaccess
 
     protected:
 
+        /**
+         * \brief Exchange a command with the reader. The Rpleth framing is handled
+         * synchronously, in the calling thread, and the connection is left to the reader unit.
+         * \param command The command buffer.
+         * \param timeout The command timeout.
+         * \param handler The completion handler.
+         */
+        virtual void exchangeAsync(const std::vector<unsigned char>& command, long int timeout, CommandHandler handler);
+
         /**
          * \brief Calculate command checksum.
          * \param data The data to calculate checksum
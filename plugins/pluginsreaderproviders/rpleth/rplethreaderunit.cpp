@@ -30,6 +30,7 @@
 #include "rplethreaderunitconfiguration.hpp"
 #include "logicalaccess/myexception.hpp"
 #include "logicalaccess/settings.hpp"
+#include "logicalaccess/readerproviders/readerpollscheduler.hpp"
 #include <boost/property_tree/xml_parser.hpp>
 #include "pcsc/pcscreaderunit.hpp"
 
@@ -107,7 +108,7 @@ namespace logicalaccess
             std::vector<unsigned char> answer;
             try
             {
-                auto rpleth_maxwait = maxwait + Settings::getInstance()->DataTransportTimeout;
+                auto rpleth_maxwait = maxwait + Settings::getSnapshot()->DataTransportTimeout;
                 answer = getDefaultRplethReaderCardAdapter()->sendRplethCommand(command, true, rpleth_maxwait);
             }
             catch (LibLogicalAccessException&)
@@ -200,7 +201,7 @@ namespace logicalaccess
                 BufferHelper::setUInt32(command, maxwait);
                 try
                 {
-                    auto rpleth_maxwait = maxwait + Settings::getInstance()->DataTransportTimeout;
+                    auto rpleth_maxwait = maxwait + Settings::getSnapshot()->DataTransportTimeout;
                     getDefaultRplethReaderCardAdapter()->sendRplethCommand(command, true, rpleth_maxwait);
                     d_insertedChip.reset();
                     LOG(LogLevel::INFOS) << "Card removed";
@@ -212,10 +213,10 @@ namespace logicalaccess
             }
             else
             {
-                unsigned int currentWait = 0;
                 removalIdentifier.clear();
 
-                while (!removed && ((currentWait < maxwait) || maxwait == 0))
+                // Each poll listens for the badge up to 250ms, the card is gone once no badge comes in.
+                removed = ReaderPollScheduler::getInstance()->waitFor([this]()
                 {
                     std::shared_ptr<Chip> chip;
                     try
@@ -228,24 +229,16 @@ namespace logicalaccess
                     if (chip)
                     {
                         std::vector<unsigned char> tmpId = chip->getChipIdentifier();
-                        if (tmpId != d_insertedChip->getChipIdentifier())
+                        if (tmpId == d_insertedChip->getChipIdentifier())
                         {
-                            d_insertedChip.reset();
-                            removalIdentifier = tmpId;
-                            removed = true;
+                            return false;
                         }
-                        else
-                        {
-                            std::this_thread::sleep_for(std::chrono::milliseconds(250));
-                            currentWait += 250;
-                        }
-                    }
-                    else
-                    {
-                        d_insertedChip.reset();
-                        removed = true;
+                        removalIdentifier = tmpId;
                     }
-                }
+
+                    d_insertedChip.reset();
+                    return true;
+                }, maxwait);
             }
         }
 
@@ -64,10 +64,10 @@ namespace logicalaccess
 
     bool SCIELReaderUnit::waitInsertion(unsigned int maxwait)
     {
-        bool oldValue = Settings::getInstance()->IsLogEnabled;
-        if (oldValue && !Settings::getInstance()->SeeWaitInsertionLog)
+        std::unique_ptr<LogDisabler> logDisabler;
+        if (!Settings::getSnapshot()->SeeWaitInsertionLog)
         {
-            Settings::getInstance()->IsLogEnabled = false;		// Disable logs for this part (otherwise too much log output in file)
+            logDisabler.reset(new LogDisabler());		// Disable logs for this part (otherwise too much log output in file)
         }
 
         LOG(LogLevel::INFOS) << "Waiting insertion... max wait {" << maxwait << "}";
@@ -91,17 +91,17 @@ namespace logicalaccess
         } while (!inserted && std::chrono::steady_clock::now() < clock_timeout);
 
         LOG(LogLevel::INFOS) << "Returns card inserted ? {" << inserted << "} function timeout expired ? {" << (std::chrono::steady_clock::now() < clock_timeout) << "}";
-        Settings::getInstance()->IsLogEnabled = oldValue;
+        logDisabler.reset();
 
         return inserted;
     }
 
     bool SCIELReaderUnit::waitRemoval(unsigned int maxwait)
     {
-        bool oldValue = Settings::getInstance()->IsLogEnabled;
-        if (oldValue && !Settings::getInstance()->SeeWaitRemovalLog)
+        std::unique_ptr<LogDisabler> logDisabler;
+        if (!Settings::getSnapshot()->SeeWaitRemovalLog)
         {
-            Settings::getInstance()->IsLogEnabled = false;		// Disable logs for this part (otherwise too much log output in file)
+            logDisabler.reset(new LogDisabler());		// Disable logs for this part (otherwise too much log output in file)
         }
 
         LOG(LogLevel::INFOS) << "Waiting removal... max wait {" << maxwait << "}";
@@ -129,7 +129,7 @@ namespace logicalaccess
 
         LOG(LogLevel::INFOS) << "Returns card removed ? {" << removed << "} - function timeout expired ? {" << (std::chrono::steady_clock::now() < clock_timeout) << "}";
 
-        Settings::getInstance()->IsLogEnabled = oldValue;
+        logDisabler.reset();
 
         return removed;
     }
@@ -16,6 +16,12 @@ std::vector<unsigned char> STidPRGDataTransport::receive(long int timeout)
     return SerialPortDataTransport::receive(receiveTimeout_);
 }
 
+void STidPRGDataTransport::exchangeAsync(const std::vector<unsigned char>& command, long int timeout,
+                                         CommandHandler handler)
+{
+    SerialPortDataTransport::exchangeAsync(command, receiveTimeout_, handler);
+}
+
 STidPRGDataTransport::STidPRGDataTransport()
     : receiveTimeout_(3000)
 {
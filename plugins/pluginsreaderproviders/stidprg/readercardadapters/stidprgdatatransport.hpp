@@ -43,5 +43,13 @@ class STidPRGDataTransport : public SerialPortDataTransport
     virtual std::string getTransportType() const override { return "STidPRGSerialPort"; };
 
     long int receiveTimeout_;
+
+  protected:
+    /**
+     * Same as receive(), the timeout parameter is IGNORED in favor
+     * of the receiveTimeout_ attribute.
+     */
+    virtual void exchangeAsync(const std::vector<unsigned char>& command, long int timeout,
+                               CommandHandler handler) override;
 };
 }
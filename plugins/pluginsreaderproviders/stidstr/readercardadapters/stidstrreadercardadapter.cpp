@@ -5,7 +5,7 @@
  */
 
 #include "stidstrreadercardadapter.hpp"
-#include "logicalaccess/crypto/tomcrypt.h"
+#include "logicalaccess/crypto/crc.hpp"
 #include <openssl/evp.h>
 #include <openssl/hmac.h>
 #include <openssl/sha.h>
@@ -61,10 +61,9 @@ namespace logicalaccess
         cmd.push_back(static_cast<unsigned char>(readerConfig->getCommunicationMode()));
 
         cmd.insert(cmd.end(), commandEncapsuled.begin(), commandEncapsuled.end());
-        unsigned char first, second;
-        ComputeCrcCCITT(0xFFFF, &cmd[1], cmd.size() - 1, &first, &second);
-        cmd.push_back(second);
-        cmd.push_back(first);
+        uint16_t checksum = crc::ccitt(0xFFFF, &cmd[1], cmd.size() - 1);
+        cmd.push_back(static_cast<unsigned char>(checksum >> 8));
+        cmd.push_back(static_cast<unsigned char>(checksum & 0xff));
 
         return cmd;
     }
@@ -193,6 +192,11 @@ namespace logicalaccess
         return ReaderCardAdapter::sendCommand(command, timeout);
     }
 
+    void STidSTRReaderCardAdapter::exchangeAsync(const std::vector<unsigned char>& command, long timeout, DataTransport::CommandHandler handler)
+    {
+        exchangeInline(command, timeout, handler);
+    }
+
     std::vector<unsigned char> STidSTRReaderCardAdapter::adaptAnswer(const std::vector<unsigned char>& answer)
     {
         LOG(LogLevel::COMS) << "Processing the received buffer " << BufferHelper::getHex(answer) << " size {" << answer.size() << "}...";
@@ -229,9 +233,8 @@ namespace logicalaccess
         std::vector<unsigned char> data = std::vector<unsigned char>(answer.begin() + 5, answer.begin() + 5 + messageSize);
         LOG(LogLevel::COMS) << "Communication response data " << BufferHelper::getHex(data);
 
-        unsigned char first, second;
-        ComputeCrcCCITT(0xFFFF, &answer[1], 4 + messageSize, &first, &second);
-        EXCEPTION_ASSERT_WITH_LOG(answer[5 + messageSize] == second && answer[5 + messageSize + 1] == first, std::invalid_argument, "The supplied buffer is not valid (CRC mismatch)");
+        uint16_t checksum = crc::ccitt(0xFFFF, &answer[1], 4 + messageSize);
+        EXCEPTION_ASSERT_WITH_LOG(answer[5 + messageSize] == (checksum >> 8) && answer[5 + messageSize + 1] == (checksum & 0xff), std::invalid_argument, "The supplied buffer is not valid (CRC mismatch)");
 
         return receiveMessage(data, statusCode);
     }
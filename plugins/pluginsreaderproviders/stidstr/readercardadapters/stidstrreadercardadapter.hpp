@@ -92,6 +92,11 @@ namespace logicalaccess
 
     protected:
 
+        /**
+         * \brief The ISO7816 wrapping is synchronous, run sendCommand() in the calling thread.
+         */
+        virtual void exchangeAsync(const std::vector<unsigned char>& command, long timeout, DataTransport::CommandHandler handler);
+
         std::shared_ptr<STidSTRReaderUnit> getSTidSTRReaderUnit() const;
 
         /**
@@ -84,10 +84,10 @@ namespace logicalaccess
 
     bool STidSTRReaderUnit::waitInsertion(unsigned int maxwait)
     {
-        bool oldValue = Settings::getInstance()->IsLogEnabled;
-        if (oldValue && !Settings::getInstance()->SeeWaitInsertionLog)
+        std::unique_ptr<LogDisabler> logDisabler;
+        if (!Settings::getSnapshot()->SeeWaitInsertionLog)
         {
-            Settings::getInstance()->IsLogEnabled = false;		// Disable logs for this part (otherwise too much log output in file)
+            logDisabler.reset(new LogDisabler());		// Disable logs for this part (otherwise too much log output in file)
         }
 
         auto stidprgdt =
@@ -130,22 +130,22 @@ namespace logicalaccess
         }
         catch (...)
         {
-            Settings::getInstance()->IsLogEnabled = oldValue;
+            logDisabler.reset();
             throw;
         }
 
         LOG(LogLevel::INFOS) << "Returns card inserted ? {" << inserted << "} function timeout expired ? {" << (std::chrono::steady_clock::now() < clock_timeout) << "}";
-        Settings::getInstance()->IsLogEnabled = oldValue;
+        logDisabler.reset();
 
         return inserted;
     }
 
     bool STidSTRReaderUnit::waitRemoval(unsigned int maxwait)
     {
-        bool oldValue = Settings::getInstance()->IsLogEnabled;
-        if (oldValue && !Settings::getInstance()->SeeWaitRemovalLog)
+        std::unique_ptr<LogDisabler> logDisabler;
+        if (!Settings::getSnapshot()->SeeWaitRemovalLog)
         {
-            Settings::getInstance()->IsLogEnabled = false;		// Disable logs for this part (otherwise too much log output in file)
+            logDisabler.reset(new LogDisabler());		// Disable logs for this part (otherwise too much log output in file)
         }
 
         LOG(LogLevel::INFOS) << "Waiting removal... max wait {" << maxwait << "}";
@@ -186,13 +186,13 @@ namespace logicalaccess
         }
         catch (...)
         {
-            Settings::getInstance()->IsLogEnabled = oldValue;
+            logDisabler.reset();
             throw;
         }
 
         LOG(LogLevel::INFOS) << "Returns card removed ? {" << removed << "} - function timeout expired ? {" << (std::chrono::steady_clock::now() < clock_timeout) << "}";
 
-        Settings::getInstance()->IsLogEnabled = oldValue;
+        logDisabler.reset();
 
         return removed;
     }
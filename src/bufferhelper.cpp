@@ -116,11 +116,16 @@ namespace logicalaccess
     }
 
     std::string BufferHelper::getHex(const std::vector<unsigned char>& buffer)
+    {
+        return getHex(buffer.data(), buffer.size());
+    }
+
+    std::string BufferHelper::getHex(const unsigned char* buffer, size_t buflen)
     {
         std::ostringstream ss;
 
         ss << std::hex << std::uppercase << std::setfill('0');
-        std::for_each(buffer.cbegin(), buffer.cend(), [&](int c) { ss << std::setw(2) << c; });
+        std::for_each(buffer, buffer + buflen, [&](int c) { ss << std::setw(2) << c; });
 
         std::string result = ss.str();
         return result;
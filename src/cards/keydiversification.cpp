@@ -7,10 +7,43 @@
 #include <logicalaccess/logs.hpp>
 #include "logicalaccess/myexception.hpp"
 #include "logicalaccess/cards/keydiversification.hpp"
+#include "logicalaccess/cards/keydiversificationcache.hpp"
 #include "logicalaccess/dynlibrary/librarymanager.hpp"
+#include "logicalaccess/crypto/sha.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 namespace logicalaccess
 {
+    namespace
+    {
+        /**
+         * \brief Batch context of the algorithms without one of their own.
+         */
+        class DefaultBatchContext : public KeyDiversification::BatchContext
+        {
+        public:
+            DefaultBatchContext(KeyDiversification& diversification, std::shared_ptr<Key> key)
+                : d_diversification(diversification), d_key(key)
+            {
+            }
+
+            virtual std::vector<unsigned char> getDiversifiedKey(const std::vector<unsigned char>& diversify)
+            {
+                return d_diversification.getDiversifiedKey(d_key, diversify);
+            }
+
+        private:
+            KeyDiversification& d_diversification;
+
+            std::shared_ptr<Key> d_key;
+        };
+    }
+
     std::shared_ptr<KeyDiversification> KeyDiversification::getKeyDiversificationFromType(std::string kdiv)
     {
         std::shared_ptr<KeyDiversification> ret = LibraryManager::getInstance()->getKeyDiversification(kdiv);
@@ -21,4 +54,136 @@ namespace logicalaccess
         }
         return ret;
     }
-}
\ No newline at end of file
+
+    std::vector<unsigned char> KeyDiversification::getCachedDiversifiedKey(std::shared_ptr<Key> key, const std::vector<unsigned char>& diversify, const std::vector<unsigned char>& card)
+    {
+        KeyDiversificationCache& cache = KeyDiversificationCache::getInstance();
+        if (cache.getCapacity() == 0)
+        {
+            return getDiversifiedKey(key, diversify);
+        }
+
+        // Each part is followed by its length so that no two inputs give the same material.
+        std::string type = getType();
+        std::vector<unsigned char> material(type.begin(), type.end());
+        material.push_back(static_cast<unsigned char>(type.size()));
+        size_t start = material.size();
+        appendCacheIdentity(key, material);
+        material.push_back(static_cast<unsigned char>(material.size() - start));
+        material.insert(material.end(), diversify.begin(), diversify.end());
+        material.push_back(static_cast<unsigned char>(diversify.size()));
+
+        std::vector<unsigned char> identity = openssl::SHA256Hash(material);
+        KeyDiversificationCache::wipe(material);
+
+        std::vector<unsigned char> keydiv;
+        if (!cache.get(identity, keydiv))
+        {
+            keydiv = getDiversifiedKey(key, diversify);
+            cache.put(identity, card, keydiv);
+        }
+        return keydiv;
+    }
+
+    void KeyDiversification::appendCacheIdentity(std::shared_ptr<Key> key, std::vector<unsigned char>& identity)
+    {
+        identity.push_back(key->isEmpty() ? 0x00 : 0x01);
+        identity.push_back(static_cast<unsigned char>(key->getLength()));
+        if (!key->isEmpty())
+        {
+            identity.insert(identity.end(), key->getData(), key->getData() + key->getLength());
+        }
+    }
+
+    std::vector<std::vector<unsigned char> > KeyDiversification::getDiversifiedKeys(std::shared_ptr<Key> key, const std::vector<DiversificationInput>& inputs, unsigned int threads)
+    {
+        // The inputs are built first: initDiversification may update the settings and is cheap.
+        std::vector<std::vector<unsigned char> > diversify(inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            initDiversification(inputs[i].identifier, inputs[i].aid, key, inputs[i].keyno, diversify[i]);
+        }
+
+        return diversifyAll(key, diversify, threads);
+    }
+
+    std::vector<std::vector<unsigned char> > KeyDiversification::diversifyAll(std::shared_ptr<Key> key, const std::vector<std::vector<unsigned char> >& diversify, unsigned int threads)
+    {
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = static_cast<unsigned int>(std::min<size_t>(threads, diversify.size()));
+        LOG(LogLevel::INFOS) << "Diversifying " << diversify.size() << " keys with " << getType() << " on " << threads << " threads.";
+
+        std::vector<std::vector<unsigned char> > keys(diversify.size());
+        std::atomic<size_t> next(0);
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        auto worker = [&]()
+        {
+            try
+            {
+                std::unique_ptr<BatchContext> context = createBatchContext(key);
+                for (size_t i = next++; i < diversify.size(); i = next++)
+                {
+                    keys[i] = context->getDiversifiedKey(diversify[i]);
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+                next = diversify.size();
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned int t = 1; t < threads; ++t)
+        {
+            pool.push_back(std::thread(worker));
+        }
+        if (threads > 0)
+        {
+            worker();
+        }
+        for (std::vector<std::thread>::iterator it = pool.begin(); it != pool.end(); ++it)
+        {
+            it->join();
+        }
+
+        if (error)
+        {
+            for (std::vector<std::vector<unsigned char> >::iterator it = keys.begin(); it != keys.end(); ++it)
+            {
+                KeyDiversificationCache::wipe(*it);
+            }
+            std::rethrow_exception(error);
+        }
+        return keys;
+    }
+
+    std::future<std::vector<std::vector<unsigned char> > > KeyDiversification::getDiversifiedKeysAsync(std::shared_ptr<Key> key, const std::vector<DiversificationInput>& inputs, unsigned int threads)
+    {
+        // initDiversification may update the settings, it is not run on the task thread.
+        std::vector<std::vector<unsigned char> > diversify(inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            initDiversification(inputs[i].identifier, inputs[i].aid, key, inputs[i].keyno, diversify[i]);
+        }
+
+        std::shared_ptr<KeyDiversification> self = shared_from_this();
+        return std::async(std::launch::async, [self, key, diversify, threads]()
+        {
+            return self->diversifyAll(key, diversify, threads);
+        });
+    }
+
+    std::unique_ptr<KeyDiversification::BatchContext> KeyDiversification::createBatchContext(std::shared_ptr<Key> key)
+    {
+        return std::unique_ptr<BatchContext>(new DefaultBatchContext(*this, key));
+    }
+}
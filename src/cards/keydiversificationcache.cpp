@@ -0,0 +1,129 @@
+/**
+ * \file keydiversificationcache.cpp
+ * \brief Cache of diversified keys.
+ */
+
+#include "logicalaccess/cards/keydiversificationcache.hpp"
+
+#include <iterator>
+
+namespace logicalaccess
+{
+    KeyDiversificationCache::KeyDiversificationCache(size_t capacity)
+        : d_capacity(capacity)
+    {
+    }
+
+    KeyDiversificationCache::~KeyDiversificationCache()
+    {
+        clear();
+    }
+
+    KeyDiversificationCache& KeyDiversificationCache::getInstance()
+    {
+        // Never destroyed, chips released from static destructors still remove their entries.
+        static KeyDiversificationCache* instance = new KeyDiversificationCache();
+        return *instance;
+    }
+
+    bool KeyDiversificationCache::get(const std::vector<unsigned char>& identity, std::vector<unsigned char>& keydiv)
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        std::map<std::vector<unsigned char>, EntryList::iterator>::iterator found = d_index.find(identity);
+        if (found == d_index.end())
+        {
+            return false;
+        }
+
+        d_entries.splice(d_entries.begin(), d_entries, found->second);
+        keydiv = found->second->keydiv;
+        return true;
+    }
+
+    void KeyDiversificationCache::put(const std::vector<unsigned char>& identity, const std::vector<unsigned char>& card, const std::vector<unsigned char>& keydiv)
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        if (d_capacity == 0)
+        {
+            return;
+        }
+
+        std::map<std::vector<unsigned char>, EntryList::iterator>::iterator found = d_index.find(identity);
+        if (found != d_index.end())
+        {
+            erase(found->second);
+        }
+        while (d_entries.size() >= d_capacity)
+        {
+            erase(std::prev(d_entries.end()));
+        }
+
+        d_entries.push_front(Entry());
+        d_entries.front().identity = identity;
+        d_entries.front().card = card;
+        d_entries.front().keydiv = keydiv;
+        d_index[identity] = d_entries.begin();
+    }
+
+    void KeyDiversificationCache::removeCard(const std::vector<unsigned char>& card)
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        for (EntryList::iterator it = d_entries.begin(); it != d_entries.end();)
+        {
+            EntryList::iterator current = it++;
+            if (current->card == card)
+            {
+                erase(current);
+            }
+        }
+    }
+
+    void KeyDiversificationCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        while (!d_entries.empty())
+        {
+            erase(d_entries.begin());
+        }
+    }
+
+    void KeyDiversificationCache::setCapacity(size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_capacity = capacity;
+        while (d_entries.size() > d_capacity)
+        {
+            erase(std::prev(d_entries.end()));
+        }
+    }
+
+    size_t KeyDiversificationCache::getCapacity() const
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        return d_capacity;
+    }
+
+    size_t KeyDiversificationCache::size() const
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        return d_entries.size();
+    }
+
+    void KeyDiversificationCache::wipe(std::vector<unsigned char>& buffer)
+    {
+        volatile unsigned char* p = buffer.data();
+        for (size_t i = 0; i < buffer.size(); ++i)
+        {
+            p[i] = 0x00;
+        }
+        buffer.clear();
+    }
+
+    void KeyDiversificationCache::erase(EntryList::iterator it)
+    {
+        d_index.erase(it->identity);
+        wipe(it->card);
+        wipe(it->keydiv);
+        d_entries.erase(it);
+    }
+}
@@ -27,21 +27,11 @@ namespace logicalaccess
         std::vector<unsigned char> res;
 
         if (timeout == -1)
-            timeout = Settings::getInstance()->DataTransportTimeout;
+            timeout = Settings::getSnapshot()->DataTransportTimeout;
 
         if (d_dataTransport)
         {
-            res = adaptAnswer(d_dataTransport->sendCommand(adaptCommand(command), timeout));
-
-			if (res.size() > 0 && getResultChecker())
-			{
-				LOG(LogLevel::DEBUGS) << "Call ResultChecker..." << BufferHelper::getHex(res);
-				getResultChecker()->CheckResult(&res[0], res.size());
-			}
-			else if (getResultChecker() && !getResultChecker()->AllowEmptyResult())
-			{
-				THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, "ResultChecker is set but no data has been received !!!")
-			}
+            res = handleAnswer(d_dataTransport->sendCommand(adaptCommand(command), timeout));
         }
         else
         {
@@ -51,6 +41,119 @@ namespace logicalaccess
         return res;
     }
 
+    void ReaderCardAdapter::transmit(const unsigned char* command, size_t commandlen, std::vector<unsigned char>& result, long timeout)
+    {
+        result = sendCommand(std::vector<unsigned char>(command, command + commandlen), timeout);
+    }
+
+    std::vector<unsigned char> ReaderCardAdapter::handleAnswer(const std::vector<unsigned char>& answer)
+    {
+        std::vector<unsigned char> res = adaptAnswer(answer);
+        checkResult(res);
+        return res;
+    }
+
+    void ReaderCardAdapter::checkResult(const std::vector<unsigned char>& answer)
+    {
+        std::shared_ptr<ResultChecker> checker = getResultChecker();
+        if (answer.size() > 0 && checker)
+        {
+            LOG(LogLevel::DEBUGS) << "Call ResultChecker..." << BufferHelper::getHex(answer);
+            checker->CheckResult(&answer[0], answer.size());
+        }
+        else if (checker && !checker->AllowEmptyResult())
+        {
+            THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, "ResultChecker is set but no data has been received !!!")
+        }
+    }
+
+    void ReaderCardAdapter::sendCommandAsync(const std::vector<unsigned char>& command, DataTransport::CommandHandler handler, long timeout)
+    {
+        if (timeout == -1)
+            timeout = Settings::getSnapshot()->DataTransportTimeout;
+
+        exchangeAsync(command, timeout, handler);
+    }
+
+    std::future<std::vector<unsigned char> > ReaderCardAdapter::sendCommandAsync(const std::vector<unsigned char>& command, long timeout)
+    {
+        std::shared_ptr<std::promise<std::vector<unsigned char> > > promise(new std::promise<std::vector<unsigned char> >());
+        std::future<std::vector<unsigned char> > result = promise->get_future();
+
+        sendCommandAsync(command, [promise](std::exception_ptr error, const std::vector<unsigned char>& res)
+        {
+            if (error)
+                promise->set_exception(error);
+            else
+                promise->set_value(res);
+        }, timeout);
+
+        return result;
+    }
+
+    void ReaderCardAdapter::exchangeAsync(const std::vector<unsigned char>& command, long timeout, DataTransport::CommandHandler handler)
+    {
+        if (!d_dataTransport)
+        {
+            LOG(LogLevel::ERRORS) << "Cannot transmit the command, data transport is not set!";
+            handler(std::exception_ptr(), std::vector<unsigned char>());
+            return;
+        }
+
+        std::vector<unsigned char> adapted;
+        std::weak_ptr<ReaderCardAdapter> weak;
+        try
+        {
+            // The adapter may be released before the answer comes in.
+            weak = shared_from_this();
+            adapted = adaptCommand(command);
+        }
+        catch (...)
+        {
+            handler(std::current_exception(), std::vector<unsigned char>());
+            return;
+        }
+
+        d_dataTransport->sendCommandAsync(adapted, [weak, handler](std::exception_ptr error, const std::vector<unsigned char>& answer)
+        {
+            std::vector<unsigned char> res;
+            std::shared_ptr<ReaderCardAdapter> self = weak.lock();
+            if (!error && !self)
+            {
+                error = std::make_exception_ptr(LibLogicalAccessException("The reader card adapter was released before the answer."));
+            }
+            else if (!error)
+            {
+                try
+                {
+                    res = self->handleAnswer(answer);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+            }
+
+            handler(error, res);
+        }, timeout);
+    }
+
+    void ReaderCardAdapter::exchangeInline(const std::vector<unsigned char>& command, long timeout, DataTransport::CommandHandler handler)
+    {
+        std::vector<unsigned char> res;
+        try
+        {
+            res = sendCommand(command, timeout);
+        }
+        catch (...)
+        {
+            handler(std::current_exception(), std::vector<unsigned char>());
+            return;
+        }
+
+        handler(std::exception_ptr(), res);
+    }
+
 ReaderCardAdapter::ReaderCardAdapter()
 {
 
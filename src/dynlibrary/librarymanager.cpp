@@ -31,16 +31,50 @@ namespace logicalaccess
 
     void* LibraryManager::getFctFromName(const std::string &fctname, LibraryType libraryType)
     {
-        std::lock_guard<std::recursive_mutex> lg(mutex_);
-        void *fct;
-        boost::filesystem::directory_iterator end_iter;
-        std::string extension = EXTENSION_LIB;
+        const SymbolIndex* symbols = symbols_.load(std::memory_order_acquire);
+        if (symbols != NULL)
+        {
+            SymbolMap::const_iterator it = symbols->symbols[libraryType].find(fctname);
+            if (it != symbols->symbols[libraryType].end())
+                return it->second;
+        }
 
+        std::lock_guard<std::recursive_mutex> lg(mutex_);
         if (libLoaded.empty())
         {
             scanPlugins();
+            // Nothing to cache, scan again on the next lookup.
+            if (libLoaded.empty())
+                return NULL;
+        }
+
+        // Resolved by another thread meanwhile.
+        symbols = symbols_.load(std::memory_order_acquire);
+        if (symbols != NULL)
+        {
+            SymbolMap::const_iterator it = symbols->symbols[libraryType].find(fctname);
+            if (it != symbols->symbols[libraryType].end())
+                return it->second;
         }
 
+        void* fct = resolveFct(fctname, libraryType);
+        SymbolIndex* newSymbols = (symbols != NULL) ? new SymbolIndex(*symbols) : new SymbolIndex();
+        newSymbols->symbols[libraryType][fctname] = fct;
+        publishSymbols(newSymbols);
+        return fct;
+    }
+
+    void LibraryManager::publishSymbols(SymbolIndex* symbols)
+    {
+        symbolIndexes_.push_back(std::unique_ptr<const SymbolIndex>(symbols));
+        symbols_.store(symbols, std::memory_order_release);
+    }
+
+    void* LibraryManager::resolveFct(const std::string &fctname, LibraryType libraryType)
+    {
+        void *fct;
+        std::string extension = EXTENSION_LIB;
+
         for (std::map<std::string, IDynLibrary*>::iterator it = libLoaded.begin(); it != libLoaded.end(); ++it)
         {
             try
@@ -55,9 +89,33 @@ namespace logicalaccess
         return NULL;
     }
 
+    void LibraryManager::indexFactories()
+    {
+        SymbolIndex* symbols = new SymbolIndex();
+        if (!libLoaded.empty())
+        {
+            std::vector<std::string> cards = getAvailablePlugins(LibraryManager::CARDS_TYPE);
+            for (std::vector<std::string>::const_iterator it = cards.begin(); it != cards.end(); ++it)
+            {
+                std::string fctname = "get" + *it + "Chip";
+                symbols->symbols[LibraryManager::CARDS_TYPE][fctname] = resolveFct(fctname, LibraryManager::CARDS_TYPE);
+            }
+
+            std::vector<std::string> readers = getAvailablePlugins(LibraryManager::READERS_TYPE);
+            for (std::vector<std::string>::const_iterator it = readers.begin(); it != readers.end(); ++it)
+            {
+                std::string fctname = "get" + *it + "Reader";
+                symbols->symbols[LibraryManager::READERS_TYPE][fctname] = resolveFct(fctname, LibraryManager::READERS_TYPE);
+            }
+
+            LOG(LogLevel::PLUGINS) << "Indexed " << (symbols->symbols[LibraryManager::CARDS_TYPE].size() + symbols->symbols[LibraryManager::READERS_TYPE].size()) << " factories.";
+        }
+
+        publishSymbols(symbols);
+    }
+
     std::shared_ptr<ReaderProvider> LibraryManager::getReaderProvider(const std::string& readertype)
     {
-        std::lock_guard<std::recursive_mutex> lg(mutex_);
         std::shared_ptr<ReaderProvider> ret;
         std::string fctname = "get" + readertype + "Reader";
 
@@ -74,7 +132,6 @@ namespace logicalaccess
 
     std::shared_ptr<Chip> LibraryManager::getCard(const std::string& cardtype)
     {
-        std::lock_guard<std::recursive_mutex> lg(mutex_);
         std::shared_ptr<Chip> ret;
         std::string fctname = "get" + cardtype + "Chip";
 
@@ -91,7 +148,6 @@ namespace logicalaccess
 
     std::shared_ptr<KeyDiversification> LibraryManager::getKeyDiversification(const std::string& keydivtype)
     {
-        std::lock_guard<std::recursive_mutex> lg(mutex_);
         std::shared_ptr<KeyDiversification> ret;
         std::string fctname = "get" + keydivtype + "Diversification";
 
@@ -108,7 +164,6 @@ namespace logicalaccess
 
     std::shared_ptr<Commands> LibraryManager::getCommands(const std::string& extendedtype)
     {
-        std::lock_guard<std::recursive_mutex> lg(mutex_);
         std::shared_ptr<Commands> ret;
         std::string fctname = "get" + extendedtype + "Commands";
 
@@ -249,11 +304,11 @@ namespace logicalaccess
         void* fct = NULL;
         boost::filesystem::directory_iterator end_iter;
         std::string extension = EXTENSION_LIB;
-        Settings* setting = Settings::getInstance();
+        std::shared_ptr<const Settings> setting = Settings::getSnapshot();
         std::string fctname = "getLibraryName";
 
         LOG(LogLevel::PLUGINS) << "Will scan " << setting->PluginFolders.size() << " folders.";
-        for (std::vector<std::string>::iterator it = setting->PluginFolders.begin(); it != setting->PluginFolders.end(); ++it)
+        for (std::vector<std::string>::const_iterator it = setting->PluginFolders.begin(); it != setting->PluginFolders.end(); ++it)
         {
             boost::filesystem::path pluginDir(*it);
             if (boost::filesystem::exists(pluginDir) && boost::filesystem::is_directory(pluginDir))
@@ -307,6 +362,9 @@ namespace logicalaccess
                 LOG(LogLevel::WARNINGS) << "Cannot found plug-in folder " << (*it);
             }
         }
+
+        // Loaded libraries changed, previous lookups (including misses) are stale.
+        indexFactories();
     }
 
 std::shared_ptr<CardService> LibraryManager::getCardService(std::shared_ptr<Chip> chip,
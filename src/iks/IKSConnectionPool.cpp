@@ -0,0 +1,396 @@
+#include "logicalaccess/iks/IKSConnectionPool.hpp"
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstring>
+#include <logicalaccess/iks/packet/AesEncrypt.hpp>
+#include <logicalaccess/iks/packet/DesEncrypt.hpp>
+#include <logicalaccess/iks/packet/DesfireAuth.hpp>
+#include <logicalaccess/iks/packet/DesfireChangeKey.hpp>
+#include <logicalaccess/iks/packet/GenRandom.hpp>
+#include <logicalaccess/logs.hpp>
+#include <logicalaccess/myexception.hpp>
+
+using namespace logicalaccess;
+using namespace logicalaccess::iks;
+
+#ifdef ENABLE_SSLTRANSPORT
+IKSChannel::IKSChannel(boost::asio::ssl::context &ctx, const std::string &ip,
+                       uint16_t port, std::shared_ptr<SSL_SESSION> session)
+    : transport_(new SSLTransport(ctx))
+    , pending_(false)
+{
+    transport_->setSession(session);
+#else
+IKSChannel::IKSChannel(const std::string &ip, uint16_t port)
+    : transport_(new SSLTransport())
+    , pending_(false)
+{
+#endif /* ENABLE_SSLTRANSPORT */
+    transport_->setIpAddress(ip);
+    transport_->setPort(port);
+
+    if (!transport_->connect(2500))
+    {
+        THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
+                                 "Failed to connect to Islog Key Server.");
+    }
+}
+
+IKSChannel::IKSChannel(std::unique_ptr<SSLTransport> transport)
+    : transport_(std::move(transport))
+    , pending_(false)
+{
+    if (!transport_->connect(2500))
+    {
+        THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
+                                 "Failed to connect to Islog Key Server.");
+    }
+}
+
+void IKSChannel::send_command(const BaseCommand &cmd)
+{
+    pending_ = true;
+    transport_->send(cmd.serialize());
+}
+
+std::shared_ptr<BaseResponse> IKSChannel::recv()
+{
+    uint32_t packet_size;
+    uint16_t opcode;
+    uint16_t status;
+
+    bool has_size   = false;
+    bool has_opcode = false;
+    bool has_status = false;
+    size_t needle   = 0;
+    std::vector<uint8_t> buffer;
+    // 3 attempts of 1sec
+    for (int i = 0; i < 3; ++i)
+    {
+        try
+        {
+            auto tmpbuf = transport_->receive(3000);
+            buffer.insert(buffer.end(), tmpbuf.begin(), tmpbuf.end());
+        }
+        catch (LibLogicalAccessException &)
+        {
+            // probably timeout error;
+            continue;
+        }
+
+        // size
+        if (!has_size && buffer.size() - needle >= sizeof(packet_size))
+        {
+            memcpy(&packet_size, &buffer[needle], sizeof(packet_size));
+            packet_size = ntohl(packet_size);
+            needle += sizeof(packet_size);
+            has_size = true;
+        }
+
+        // opcode
+        if (!has_opcode && buffer.size() - needle >= sizeof(opcode))
+        {
+            memcpy(&opcode, &buffer[needle], sizeof(opcode));
+            opcode = ntohs(opcode);
+            needle += sizeof(opcode);
+            has_opcode = true;
+        }
+
+        // status code
+        if (!has_status && buffer.size() - needle >= sizeof(status))
+        {
+            memcpy(&status, &buffer[needle], sizeof(status));
+            status = ntohs(status);
+            needle += sizeof(status);
+            has_status = true;
+        }
+
+        if (has_size && has_opcode && has_status &&
+            buffer.size() - needle >= packet_size - 8) // total size of header
+        {
+            pending_ = false;
+            LOG(INFOS) << "Size: " << packet_size << ". Op: " << opcode
+                       << ". St: " << status << ". Bufsize: " << buffer.size()
+                       << ". Needle: " << needle;
+
+            return build_response(
+                packet_size, opcode, status,
+                std::vector<uint8_t>(buffer.begin() + needle, buffer.end()));
+        }
+    }
+
+    // The rest of the response may still come: never reuse this connection.
+    transport_->disconnect();
+    return nullptr;
+}
+
+bool IKSChannel::is_healthy()
+{
+    return !pending_ && transport_->checkConnection();
+}
+
+void IKSChannel::disconnect()
+{
+    transport_->disconnect();
+}
+
+#ifdef ENABLE_SSLTRANSPORT
+std::shared_ptr<SSL_SESSION> IKSChannel::session()
+{
+    return transport_->getSession();
+}
+#endif /* ENABLE_SSLTRANSPORT */
+
+std::shared_ptr<BaseResponse>
+IKSChannel::build_response(uint32_t size, uint16_t opcode, uint16_t status,
+                           const std::vector<uint8_t> &data)
+{
+    std::shared_ptr<BaseResponse> resp;
+    switch (opcode)
+    {
+    case SMSG_OP_GENRANDOM:
+        resp = std::make_shared<GenRandomResponse>(status, data);
+        break;
+
+    case SMSG_OP_AES_ENCRYPT:
+        resp = std::make_shared<AesEncryptResponse>(status, data);
+        break;
+
+    case SMSG_OP_DESFIRE_AUTH:
+        resp = std::make_shared<DesfireAuthResponse>(status, data);
+        break;
+
+    case SMSG_OP_DES_ENCRYPT:
+        resp = std::make_shared<DesEncryptResponse>(status, data);
+        break;
+
+    case SMSG_OP_DESFIRE_CHANGEKEY:
+        resp = std::make_shared<DesfireChangeKeyResponse>(status, data);
+        break;
+    default:
+        LOG(WARNINGS) << "Unkown opcode " << opcode << " from server.";
+    }
+
+    return resp;
+}
+
+IKSConnectionPool::Lease::Lease(std::weak_ptr<IKSConnectionPool> pool,
+                                std::shared_ptr<IKSChannel> channel)
+    : pool_(pool)
+    , channel_(channel)
+{
+}
+
+IKSConnectionPool::Lease::Lease(Lease &&other)
+    : pool_(std::move(other.pool_))
+    , channel_(std::move(other.channel_))
+{
+}
+
+IKSConnectionPool::Lease::~Lease()
+{
+    if (!channel_)
+        return;
+
+    std::shared_ptr<IKSConnectionPool> pool = pool_.lock();
+    if (pool)
+        pool->release(channel_);
+    else
+        channel_->disconnect();
+}
+
+#ifdef ENABLE_SSLTRANSPORT
+IKSConnectionPool::IKSConnectionPool(boost::asio::ssl::context &ctx,
+                                     const std::string &ip, uint16_t port,
+                                     size_t max_connections, long health_interval)
+    : max_connections_(max_connections > 0 ? max_connections : 1)
+    , health_interval_(health_interval)
+    , open_count_(0)
+    , stop_(false)
+{
+    boost::asio::ssl::context *ssl_ctx = &ctx;
+    open_channel_ = [this, ssl_ctx, ip, port]() {
+        return open_ssl_channel(*ssl_ctx, ip, port);
+    };
+    start();
+}
+#else
+IKSConnectionPool::IKSConnectionPool(const std::string &ip, uint16_t port,
+                                     size_t max_connections, long health_interval)
+    : max_connections_(max_connections > 0 ? max_connections : 1)
+    , health_interval_(health_interval)
+    , open_count_(0)
+    , stop_(false)
+{
+    open_channel_ = [ip, port]() { return std::make_shared<IKSChannel>(ip, port); };
+    start();
+}
+#endif /* ENABLE_SSLTRANSPORT */
+
+IKSConnectionPool::IKSConnectionPool(ChannelFactory open_channel,
+                                     size_t max_connections, long health_interval)
+    : open_channel_(open_channel)
+    , max_connections_(max_connections > 0 ? max_connections : 1)
+    , health_interval_(health_interval)
+    , open_count_(0)
+    , stop_(false)
+{
+    start();
+}
+
+void IKSConnectionPool::start()
+{
+    // Fail early, as a single connection did.
+    idle_.push_back(open_channel_());
+    open_count_ = 1;
+
+    if (health_interval_ > 0)
+        health_thread_ = std::thread(&IKSConnectionPool::health_loop, this);
+}
+
+IKSConnectionPool::~IKSConnectionPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    stop_cv_.notify_all();
+    if (health_thread_.joinable())
+        health_thread_.join();
+
+    for (auto &channel : idle_)
+        channel->disconnect();
+}
+
+IKSConnectionPool::Lease IKSConnectionPool::acquire()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        while (!idle_.empty())
+        {
+            std::shared_ptr<IKSChannel> channel = idle_.back();
+            idle_.pop_back();
+            if (channel->is_healthy())
+                return Lease(shared_from_this(), channel);
+            --open_count_;
+        }
+
+        if (open_count_ < max_connections_)
+        {
+            ++open_count_;
+            lock.unlock();
+            try
+            {
+                return Lease(shared_from_this(), open_channel_());
+            }
+            catch (...)
+            {
+                lock.lock();
+                --open_count_;
+                available_.notify_one();
+                throw;
+            }
+        }
+
+        available_.wait(lock);
+    }
+}
+
+size_t IKSConnectionPool::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return open_count_;
+}
+
+size_t IKSConnectionPool::idle_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idle_.size();
+}
+
+#ifdef ENABLE_SSLTRANSPORT
+std::shared_ptr<IKSChannel>
+IKSConnectionPool::open_ssl_channel(boost::asio::ssl::context &ctx,
+                                    const std::string &ip, uint16_t port)
+{
+    std::shared_ptr<SSL_SESSION> session;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        session = session_;
+    }
+    return std::make_shared<IKSChannel>(ctx, ip, port, session);
+}
+#endif /* ENABLE_SSLTRANSPORT */
+
+void IKSConnectionPool::release(std::shared_ptr<IKSChannel> channel)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+#ifdef ENABLE_SSLTRANSPORT
+        // The session is only resumable once a response was read.
+        std::shared_ptr<SSL_SESSION> session = channel->session();
+        if (session)
+            session_ = session;
+#endif /* ENABLE_SSLTRANSPORT */
+        if (!stop_ && channel->is_healthy())
+            idle_.push_back(channel);
+        else
+            --open_count_;
+    }
+    available_.notify_one();
+}
+
+void IKSConnectionPool::health_loop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_)
+    {
+        stop_cv_.wait_for(lock, std::chrono::milliseconds(health_interval_));
+        if (stop_)
+            break;
+
+        // The check does not block, the reconnections run unlocked.
+        size_t broken = 0;
+        for (auto it = idle_.begin(); it != idle_.end();)
+        {
+            if ((*it)->is_healthy())
+            {
+                ++it;
+            }
+            else
+            {
+                it = idle_.erase(it);
+                ++broken;
+            }
+        }
+
+        for (; broken > 0 && !stop_; --broken)
+        {
+            lock.unlock();
+            std::shared_ptr<IKSChannel> channel;
+            try
+            {
+                channel = open_channel_();
+            }
+            catch (const std::exception &e)
+            {
+                LOG(WARNINGS) << "Cannot reconnect to the Islog Key Server: "
+                              << e.what();
+            }
+            lock.lock();
+
+            if (channel && !stop_)
+            {
+                idle_.push_back(channel);
+                available_.notify_one();
+            }
+            else
+            {
+                --open_count_;
+                available_.notify_one();
+            }
+        }
+        open_count_ -= broken;
+    }
+}
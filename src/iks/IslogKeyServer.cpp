@@ -168,20 +168,16 @@ std::vector<uint8_t> IslogKeyServer::des_crypto(const std::vector<uint8_t> &in,
 
 void IslogKeyServer::setup_transport()
 {
-    transport_ = nullptr;
+    shared_channel_ = nullptr;
+    pool_           = nullptr;
 
 #ifdef ENABLE_SSLTRANSPORT
-    transport_ = std::unique_ptr<SSLTransport>(new SSLTransport(ssl_ctx_));
+    // The client session cache lets the new connections resume the TLS session.
+    SSL_CTX_set_session_cache_mode(ssl_ctx_.native_handle(), SSL_SESS_CACHE_CLIENT);
+    pool_ = std::make_shared<IKSConnectionPool>(ssl_ctx_, config_.ip, config_.port);
+#else
+    pool_ = std::make_shared<IKSConnectionPool>(config_.ip, config_.port);
 #endif
-
-    transport_->setIpAddress(config_.ip);
-    transport_->setPort(config_.port);
-
-    if (!transport_->connect(2500))
-    {
-        THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
-                                 "Failed to connect to Islog Key Server.");
-    }
 }
 
 std::shared_ptr<BaseResponse> IslogKeyServer::transact(const BaseCommand &cmd)
@@ -192,121 +188,47 @@ std::shared_ptr<BaseResponse> IslogKeyServer::transact(const BaseCommand &cmd)
     {
         try
         {
-            transport_->send(cmd.serialize());
-            return recv();
+            IKSConnectionPool::Lease channel = pool_->acquire();
+            try
+            {
+                channel->send_command(cmd);
+                return channel->recv();
+            }
+            catch (const std::exception &)
+            {
+                channel->disconnect();
+                throw;
+            }
         }
         catch (const std::exception &)
         {
             LOG(ERRORS) << "Network error in IKS. Attempting to reconnect.";
-            setup_transport();
         }
     } while (--max_try);
     return nullptr;
 }
 
-void IslogKeyServer::send_command(const BaseCommand &cmd)
+IKSConnectionPool::Lease IslogKeyServer::acquire()
 {
-    transport_->send(cmd.serialize());
+    return pool_->acquire();
 }
 
-std::shared_ptr<BaseResponse> IslogKeyServer::recv()
+void IslogKeyServer::send_command(const BaseCommand &cmd)
 {
-    uint32_t packet_size;
-    uint16_t opcode;
-    uint16_t status;
-
-    bool has_size   = false;
-    bool has_opcode = false;
-    bool has_status = false;
-    size_t needle   = 0;
-    std::vector<uint8_t> buffer;
-    // 3 attempts of 1sec
-    for (int i = 0; i < 3; ++i)
+    if (!shared_channel_ || !(*shared_channel_)->is_healthy())
     {
-        try
-        {
-            auto tmpbuf = transport_->receive(3000);
-            buffer.insert(buffer.end(), tmpbuf.begin(), tmpbuf.end());
-        }
-        catch (LibLogicalAccessException &)
-        {
-            // probably timeout error;
-            continue;
-        }
-
-        // size
-        if (!has_size && buffer.size() - needle >= sizeof(packet_size))
-        {
-            memcpy(&packet_size, &buffer[needle], sizeof(packet_size));
-            packet_size = ntohl(packet_size);
-            needle += sizeof(packet_size);
-            has_size = true;
-        }
-
-        // opcode
-        if (!has_opcode && buffer.size() - needle >= sizeof(opcode))
-        {
-            memcpy(&opcode, &buffer[needle], sizeof(opcode));
-            opcode = ntohs(opcode);
-            needle += sizeof(opcode);
-            has_opcode = true;
-        }
-
-        // status code
-        if (!has_status && buffer.size() - needle >= sizeof(status))
-        {
-            memcpy(&status, &buffer[needle], sizeof(status));
-            status = ntohs(status);
-            needle += sizeof(status);
-            has_status = true;
-        }
-
-        if (has_size && has_opcode && has_status &&
-            buffer.size() - needle >= packet_size - 8) // total size of header
-        {
-            LOG(INFOS) << "Size: " << packet_size << ". Op: " << opcode
-                       << ". St: " << status << ". Bufsize: " << buffer.size()
-                       << ". Needle: " << needle;
-
-            return build_response(
-                packet_size, opcode, status,
-                std::vector<uint8_t>(buffer.begin() + needle, buffer.end()));
-        }
+        shared_channel_ = nullptr;
+        shared_channel_ = std::unique_ptr<IKSConnectionPool::Lease>(
+            new IKSConnectionPool::Lease(pool_->acquire()));
     }
-    return nullptr;
+    (*shared_channel_)->send_command(cmd);
 }
 
-std::shared_ptr<BaseResponse>
-IslogKeyServer::build_response(uint32_t size, uint16_t opcode, uint16_t status,
-                               const std::vector<uint8_t> &data)
+std::shared_ptr<BaseResponse> IslogKeyServer::recv()
 {
-    std::shared_ptr<BaseResponse> resp;
-    switch (opcode)
-    {
-    case SMSG_OP_GENRANDOM:
-        resp = std::make_shared<GenRandomResponse>(status, data);
-        break;
-
-    case SMSG_OP_AES_ENCRYPT:
-        resp = std::make_shared<AesEncryptResponse>(status, data);
-        break;
-
-    case SMSG_OP_DESFIRE_AUTH:
-        resp = std::make_shared<DesfireAuthResponse>(status, data);
-        break;
-
-    case SMSG_OP_DES_ENCRYPT:
-        resp = std::make_shared<DesEncryptResponse>(status, data);
-        break;
-
-    case SMSG_OP_DESFIRE_CHANGEKEY:
-        resp = std::make_shared<DesfireChangeKeyResponse>(status, data);
-        break;
-    default:
-        LOG(WARNINGS) << "Unkown opcode " << opcode << " from server.";
-    }
-
-    return resp;
+    EXCEPTION_ASSERT_WITH_LOG(shared_channel_, IKSException,
+                              "No command was sent to the Islog Key Server.");
+    return (*shared_channel_)->recv();
 }
 
 IslogKeyServer::IKSConfig IslogKeyServer::pre_configuration_;
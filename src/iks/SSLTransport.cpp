@@ -61,6 +61,7 @@ bool SSLTransport::connect(long int timeout)
 #else
     if (d_socket.lowest_layer().is_open())
         d_socket.lowest_layer().close();
+    d_readSession.reset();
 
     try
     {
@@ -70,7 +71,7 @@ bool SSLTransport::connect(long int timeout)
                                        boost::asio::placeholders::error));
 
         boost::asio::ip::tcp::endpoint endpoint(
-            boost::asio::ip::address::from_string(getIpAddress()), getPort());
+            boost::asio::ip::make_address(getIpAddress()), getPort());
         d_socket.lowest_layer().async_connect(
             endpoint, boost::bind(&SSLTransport::connect_complete, this,
                                   boost::asio::placeholders::error));
@@ -111,6 +112,61 @@ bool SSLTransport::isConnected()
 #endif /* ENABLE_SSLTRANSPORT */
 }
 
+bool SSLTransport::checkConnection()
+{
+#ifndef ENABLE_SSLTRANSPORT
+    // No socket to check, errors show on use.
+    return true;
+#else
+    if (!d_socket.lowest_layer().is_open())
+        return false;
+
+    // Decrypted application data is a late response nobody waits for anymore.
+    size_t n = SSL_pending(d_socket.native_handle());
+    boost::system::error_code ec;
+    if (n == 0)
+    {
+        // Let the SSL layer process what came in without blocking: records
+        // without application data (session tickets, key updates) are consumed,
+        // a close_notify or a closed socket shows as an error.
+        unsigned char byte;
+        d_socket.lowest_layer().non_blocking(true, ec);
+        if (!ec)
+            n = d_socket.read_some(boost::asio::buffer(&byte, 1), ec);
+        boost::system::error_code ignored;
+        d_socket.lowest_layer().non_blocking(false, ignored);
+
+        if (n == 0 && (ec == boost::asio::error::would_block ||
+                       ec == boost::asio::error::try_again))
+            return true;
+    }
+
+    LOG(LogLevel::INFOS) << "Connection to " << getIpAddress() << ":" << getPort()
+                         << " is not usable anymore (" << n
+                         << " bytes of application data pending, " << ec.message()
+                         << ").";
+    disconnect();
+    return false;
+#endif /* ENABLE_SSLTRANSPORT */
+}
+
+#ifdef ENABLE_SSLTRANSPORT
+void SSLTransport::setSession(std::shared_ptr<SSL_SESSION> session)
+{
+    d_session = session;
+}
+
+std::shared_ptr<SSL_SESSION> SSLTransport::getSession()
+{
+    return d_readSession;
+}
+
+bool SSLTransport::isSessionReused()
+{
+    return SSL_session_reused(d_socket.native_handle()) == 1;
+}
+#endif /* ENABLE_SSLTRANSPORT */
+
 std::string SSLTransport::getName() const
 {
     return d_ipAddress;
@@ -197,6 +253,14 @@ std::vector<uint8_t> SSLTransport::receive(long int timeout)
     }
 
     LOG(LogLevel::COMS) << "TCP Data read: " << BufferHelper::getHex(recv);
+
+    // The session tickets of TLS 1.3 came in before the first response.
+    if (!d_readSession)
+    {
+        SSL_SESSION *session = SSL_get1_session(d_socket.native_handle());
+        if (session)
+            d_readSession.reset(session, SSL_SESSION_free);
+    }
 #endif /* ENABLE_SSLTRANSPORT */
     return recv;
 }
@@ -233,6 +297,8 @@ bool SSLTransport::handshake(long timeout)
     {
         timeout *= 3;
         LOG(INFOS) << "Timeout value: " << timeout;
+        if (d_session && SSL_set_session(d_socket.native_handle(), d_session.get()) != 1)
+            LOG(LogLevel::WARNINGS) << "Cannot set the TLS session to resume.";
         d_ios.reset();
         d_timer.expires_from_now(boost::posix_time::milliseconds(timeout));
         d_timer.async_wait(boost::bind(&SSLTransport::time_out, this,
@@ -254,7 +320,8 @@ bool SSLTransport::handshake(long timeout)
         else
             LOG(LogLevel::INFOS) << "SSL Handshake to " << getIpAddress()
                                  << " on port " << getPort() << ""
-                                                                "completed.";
+                                                                "completed"
+                                 << (isSessionReused() ? " (resumed)." : ".");
     }
     catch (boost::system::system_error &ex)
     {
@@ -5,9 +5,13 @@
  */
 
 #include "logicalaccess/logs.hpp"
+#include "logicalaccess/logwriter.hpp"
 #include "logicalaccess/settings.hpp"
 #include "logicalaccess/colorize.hpp"
 #include <boost/date_time.hpp>
+#include <atomic>
+#include <iostream>
+#include <mutex>
 
 #ifdef WIN32
 // For now the additional context for the logger wont be thread safe,
@@ -22,20 +26,52 @@ static thread_local std::vector<std::string> context_;
 
 namespace logicalaccess
 {
+    std::map<LogLevel, std::string> Logs::logLevelMsg;
     bool Logs::logToStderr = false;
     std::ofstream Logs::logfile;
-    std::map<LogLevel, std::string> Logs::logLevelMsg;
+
+    namespace
+    {
+        /**
+         * Guard the legacy log file, written from the calling thread.
+         */
+        std::mutex& logfile_mutex()
+        {
+            static std::mutex* mutex = new std::mutex();
+            return *mutex;
+        }
+
+        /**
+         * The number of LogDisabler alive, logs are disabled while not zero.
+         */
+        std::atomic<int> disablers(0);
+    }
+
+    bool Logs::isEnabled(LogLevel level)
+    {
+        if (level == NONE)
+            return false;
+
+        if (disablers.load(std::memory_order_relaxed) > 0)
+            return false;
+
+        // Settings initialization opens the log file, query it first.
+        std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+        if (!(LogWriter::getInstance().isOpen() || logfile.is_open() || logToStderr) || !settings->IsLogEnabled)
+            return false;
+
+        if (level == LogLevel::COMS)
+            return settings->SeeCommunicationLog;
+        if (level == LogLevel::PLUGINS || level == LogLevel::PLUGINS_ERROR)
+            return settings->SeePluginLog;
+        return true;
+    }
 
     Logs::Logs(const char *file, const char *func, int line,
                enum LogLevel level)
         : d_level(level)
     {
-        if (!Settings::getInstance()->IsLogEnabled ||
-            (d_level == LogLevel::COMS &&
-             !Settings::getInstance()->SeeCommunicationLog) ||
-            ((d_level == LogLevel::PLUGINS ||
-              d_level == LogLevel::PLUGINS_ERROR) &&
-             !Settings::getInstance()->SeePluginLog))
+        if (!isCompiledIn(d_level) || !isEnabled(d_level))
             d_level = NONE;
 
         if (logLevelMsg.empty())
@@ -52,11 +88,12 @@ namespace logicalaccess
             logLevelMsg[PLUGINS]    = "PLUGIN";
         }
 
-        if (logfile && d_level != NONE)
+        if (d_level != NONE)
         {
+            std::shared_ptr<const Settings> settings = Settings::getSnapshot();
             boost::posix_time::ptime now =
                 boost::posix_time::microsec_clock::local_time();
-            if (Settings::getInstance()->ColorizeLog)
+            if (settings->ColorizeLog)
             {
                 _stream << Colorize::underline(
                                boost::posix_time::to_simple_string(now))
@@ -70,7 +107,7 @@ namespace logicalaccess
                         << logLevelMsg[d_level] << ": \t{" << line << "}\t{"
                         << func << "}\t{" << file << "}:" << std::endl;
             }
-            if (Settings::getInstance()->ContextLog)
+            if (settings->ContextLog)
                 _stream << pretty_context_infos();
         }
     }
@@ -81,8 +118,9 @@ namespace logicalaccess
         if (context_.size() == 0)
             return "";
 
+        bool colorize = Settings::getSnapshot()->ColorizeLog;
         std::string ret;
-        if (Settings::getInstance()->ColorizeLog)
+        if (colorize)
             ret = green(underline("Context:")) + ' ';
         else
             ret   = "Context: ";
@@ -94,7 +132,7 @@ namespace logicalaccess
                 ret += std::string(9, ' ');
             std::stringstream ss;
             ss << count << ") ";
-            if (Settings::getInstance()->ColorizeLog)
+            if (colorize)
                 ret += yellow(ss.str()) + itr + '\n';
             else
                 ret += ss.str() + itr + '\n';
@@ -105,14 +143,27 @@ namespace logicalaccess
 
     Logs::~Logs()
     {
-        if (logfile && d_level != NONE)
+        if (d_level != NONE)
         {
+            // The line is written by the log writer thread, never blocks.
             _stream << std::endl;
-            logfile << _stream.rdbuf();
-            logfile.flush();
-
-            if (logToStderr)
-                std::cerr << _stream.str();
+            std::string line = _stream.str();
+            LogWriter& writer = LogWriter::getInstance();
+            if (writer.isOpen())
+            {
+                writer.push(line);
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(logfile_mutex());
+                if (logfile.is_open())
+                {
+                    logfile << line;
+                    logfile.flush();
+                }
+                if (logToStderr)
+                    std::cerr << line;
+            }
         }
     }
 
@@ -152,13 +203,12 @@ namespace logicalaccess
 
     LogDisabler::LogDisabler()
     {
-        old_ = Settings::getInstance()->IsLogEnabled;
-        Settings::getInstance()->IsLogEnabled = false;
+        ++disablers;
     }
 
     LogDisabler::~LogDisabler()
     {
-        Settings::getInstance()->IsLogEnabled = old_;
+        --disablers;
     }
     
     std::string get_nth_param_name(const char *param_names, int idx)
@@ -0,0 +1,287 @@
+/**
+ * \file logwriter.cpp
+ * \brief Background log writer.
+ */
+
+#include "logicalaccess/logwriter.hpp"
+#include "logicalaccess/logs.hpp"
+#include <boost/filesystem.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+namespace logicalaccess
+{
+    LogRingBuffer::LogRingBuffer(size_t capacity)
+        : d_enqueuePos(0), d_dequeuePos(0)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        d_slots.reset(new Slot[size]);
+        for (size_t i = 0; i < size; ++i)
+            d_slots[i].sequence.store(i, std::memory_order_relaxed);
+        d_mask = size - 1;
+    }
+
+    bool LogRingBuffer::push(std::string& line)
+    {
+        Slot* slot;
+        size_t pos = d_enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            slot = &d_slots[pos & d_mask];
+            intptr_t diff = static_cast<intptr_t>(slot->sequence.load(std::memory_order_acquire) - pos);
+            if (diff == 0)
+            {
+                // The slot is free for this position, try to reserve it.
+                if (d_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // The slot still holds the line of the previous lap.
+                return false;
+            }
+            else
+            {
+                pos = d_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->line.swap(line);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool LogRingBuffer::pop(std::string& line)
+    {
+        Slot& slot = d_slots[d_dequeuePos & d_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != d_dequeuePos + 1)
+            return false;
+
+        line.clear();
+        line.swap(slot.line);
+        slot.sequence.store(d_dequeuePos + d_mask + 1, std::memory_order_release);
+        ++d_dequeuePos;
+        return true;
+    }
+
+    LogWriter::LogWriter(size_t capacity)
+        : d_buffer(capacity), d_open(false), d_stop(false), d_sleeping(false), d_toStderr(false),
+        d_pushed(0), d_writtenCount(0), d_dropped(0), d_reportedDropped(0), d_fileSize(0),
+        d_maxFileSize(0), d_maxAge(0), d_maxFiles(5)
+    {
+    }
+
+    LogWriter::~LogWriter()
+    {
+        close();
+    }
+
+    namespace
+    {
+        LogWriter* writer_instance = NULL;
+
+        void close_writer_at_exit()
+        {
+            writer_instance->close();
+        }
+    }
+
+    LogWriter& LogWriter::getInstance()
+    {
+        // Never destroyed so that logging from static destructors stays safe,
+        // the pending lines are written at exit or by Settings::Uninitialize().
+        static LogWriter* instance = []()
+        {
+            writer_instance = new LogWriter();
+            std::atexit(&close_writer_at_exit);
+            return writer_instance;
+        }();
+        return *instance;
+    }
+
+    bool LogWriter::open(const std::string& filename)
+    {
+        close();
+
+        {
+            std::lock_guard<std::mutex> lock(d_fileMutex);
+            d_file.open(filename, std::ios::out | std::ios::app);
+            if (!d_file)
+                return false;
+
+            boost::system::error_code error;
+            d_fileSize = boost::filesystem::file_size(filename, error);
+            if (error)
+                d_fileSize = 0;
+            d_filename = filename;
+            d_fileOpened = std::chrono::steady_clock::now();
+        }
+
+        d_stop = false;
+        d_thread = std::thread(&LogWriter::run, this);
+        d_open = true;
+        return true;
+    }
+
+    void LogWriter::close()
+    {
+        d_open = false;
+        if (d_thread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(d_mutex);
+                d_stop = true;
+                d_wakeup.notify_one();
+            }
+            d_thread.join();
+        }
+
+        // The writer thread may have been terminated before writing everything, at exit.
+        if (d_file.is_open())
+        {
+            while (writeBatch())
+            {
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(d_fileMutex);
+        if (d_file.is_open())
+            d_file.close();
+    }
+
+    bool LogWriter::push(std::string& line)
+    {
+        if (!d_open)
+            return false;
+
+        if (!d_buffer.push(line))
+        {
+            ++d_dropped;
+            return false;
+        }
+
+        ++d_pushed;
+        if (d_sleeping)
+            d_wakeup.notify_one();
+        return true;
+    }
+
+    void LogWriter::flush()
+    {
+        if (!d_open)
+            return;
+
+        uint64_t target = d_pushed;
+        std::unique_lock<std::mutex> lock(d_mutex);
+        d_wakeup.notify_one();
+        d_written.wait(lock, [this, target]() { return d_writtenCount >= target || d_stop; });
+    }
+
+    void LogWriter::setRotation(uint64_t maxFileSize, unsigned int maxAge, unsigned int maxFiles)
+    {
+        d_maxFileSize = maxFileSize;
+        d_maxAge = maxAge;
+        d_maxFiles = maxFiles;
+    }
+
+    void LogWriter::run()
+    {
+        for (;;)
+        {
+            if (writeBatch())
+                continue;
+
+            std::unique_lock<std::mutex> lock(d_mutex);
+            if (d_stop)
+                break;
+
+            // The timeout bounds the latency of a wake-up missed by a producer.
+            d_sleeping = true;
+            d_wakeup.wait_for(lock, std::chrono::milliseconds(100));
+            d_sleeping = false;
+        }
+
+        // Lines pushed while stopping.
+        while (writeBatch())
+        {
+        }
+
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_written.notify_all();
+    }
+
+    bool LogWriter::writeBatch()
+    {
+        std::string line;
+        uint64_t count = 0;
+        {
+            std::lock_guard<std::mutex> lock(d_fileMutex);
+            while (count < d_buffer.getCapacity() && d_buffer.pop(line))
+            {
+                rotateIfNeeded();
+                d_file << line;
+                d_fileSize += line.size();
+                if (d_toStderr || Logs::logToStderr)
+                    std::cerr << line;
+                ++count;
+            }
+
+            uint64_t dropped = d_dropped;
+            if (dropped != d_reportedDropped)
+            {
+                std::ostringstream oss;
+                oss << (dropped - d_reportedDropped) << " log lines dropped, the log buffer was full." << std::endl;
+                d_file << oss.str();
+                d_fileSize += oss.str().size();
+                d_reportedDropped = dropped;
+            }
+
+            if (count == 0)
+                return false;
+            d_file.flush();
+        }
+
+        d_writtenCount += count;
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_written.notify_all();
+        return true;
+    }
+
+    void LogWriter::rotateIfNeeded()
+    {
+        uint64_t maxFileSize = d_maxFileSize;
+        unsigned int maxAge = d_maxAge;
+        if (!(maxFileSize > 0 && d_fileSize >= maxFileSize) &&
+            !(maxAge > 0 && std::chrono::steady_clock::now() - d_fileOpened >= std::chrono::seconds(maxAge)))
+            return;
+
+        d_file.close();
+
+        boost::system::error_code error;
+        unsigned int maxFiles = d_maxFiles;
+        if (maxFiles == 0)
+        {
+            boost::filesystem::remove(d_filename, error);
+        }
+        else
+        {
+            for (unsigned int i = maxFiles - 1; i > 0; --i)
+            {
+                std::ostringstream from, to;
+                from << d_filename << "." << i;
+                to << d_filename << "." << (i + 1);
+                if (boost::filesystem::exists(from.str(), error))
+                    boost::filesystem::rename(from.str(), to.str(), error);
+            }
+            boost::filesystem::rename(d_filename, d_filename + ".1", error);
+        }
+
+        d_file.open(d_filename, std::ios::out | std::ios::trunc);
+        d_fileSize = 0;
+        d_fileOpened = std::chrono::steady_clock::now();
+    }
+}
@@ -7,20 +7,128 @@
 #include "logicalaccess/readerproviders/datatransport.hpp"
 #include "logicalaccess/bufferhelper.hpp"
 #include "logicalaccess/logs.hpp"
+#include "logicalaccess/myexception.hpp"
 #include "logicalaccess/settings.hpp"
 
 namespace logicalaccess
 {
+    namespace
+    {
+        /**
+         * Keep the transport for a synchronous exchange.
+         */
+        class ExchangeLock
+        {
+        public:
+            ExchangeLock(std::function<void()> lock, std::function<void()> unlock) : d_unlock(unlock)
+            {
+                lock();
+            }
+
+            ~ExchangeLock()
+            {
+                try
+                {
+                    d_unlock();
+                }
+                catch (std::exception& ex)
+                {
+                    LOG(LogLevel::ERRORS) << "Cannot go on with the asynchronous commands: " << ex.what();
+                }
+            }
+
+        private:
+            std::function<void()> d_unlock;
+        };
+    }
+
+    DataTransport::DataTransport() : d_retainLastExchange(false), d_asyncQueue(new AsyncQueue())
+    {
+        d_asyncQueue->owner = this;
+    }
+
+    DataTransport::~DataTransport()
+    {
+        abandonAsyncCommands();
+    }
+
+    void DataTransport::abandonAsyncCommands()
+    {
+        std::deque<PendingCommand> pending;
+        {
+            std::unique_lock<std::mutex> lock(d_asyncQueue->mutex);
+            if (d_asyncQueue->owner == NULL)
+                return;
+
+            d_asyncQueue->owner = NULL;
+            pending.swap(d_asyncQueue->commands);
+            // Wait for a completion handler starting the next command, unless it is the one destroying the transport.
+            std::shared_ptr<AsyncQueue> queue = d_asyncQueue;
+            queue->cond.wait(lock, [queue]()
+            {
+                return queue->users == 0 || queue->handlerThread == std::this_thread::get_id();
+            });
+        }
+
+        for (std::deque<PendingCommand>::iterator it = pending.begin(); it != pending.end(); ++it)
+        {
+            try
+            {
+                it->handler(std::make_exception_ptr(LibLogicalAccessException("The data transport was destroyed.")), std::vector<unsigned char>());
+            }
+            catch (...)
+            {
+                LOG(LogLevel::ERRORS) << "Asynchronous command handler failed.";
+            }
+        }
+    }
+
+    void DataTransport::lockExchange()
+    {
+        std::unique_lock<std::mutex> lock(d_asyncQueue->mutex);
+        // A completion handler sending a command already has the transport.
+        if (d_asyncQueue->handlerThread == std::this_thread::get_id())
+            return;
+
+        std::shared_ptr<AsyncQueue> queue = d_asyncQueue;
+        queue->cond.wait(lock, [queue]() { return !queue->busy; });
+        queue->busy = true;
+    }
+
+    void DataTransport::unlockExchange()
+    {
+        {
+            std::lock_guard<std::mutex> lock(d_asyncQueue->mutex);
+            if (d_asyncQueue->handlerThread == std::this_thread::get_id())
+                return;
+
+            if (d_asyncQueue->commands.empty())
+            {
+                d_asyncQueue->busy = false;
+                d_asyncQueue->cond.notify_all();
+                return;
+            }
+        }
+
+        // Commands were queued meanwhile, the transport is still busy with them.
+        processAsyncQueue();
+    }
+
     std::vector<unsigned char> DataTransport::sendCommand(const std::vector<unsigned char>& command, long int timeout)
     {
         if (timeout == -1)
-            timeout = Settings::getInstance()->DataTransportTimeout;
+            timeout = Settings::getSnapshot()->DataTransportTimeout;
+
+        ExchangeLock exchange(std::bind(&DataTransport::lockExchange, this), std::bind(&DataTransport::unlockExchange, this));
 
         LOG(LogLevel::COMS) << "Sending command " << BufferHelper::getHex(command) << " command size {" << command.size() << "} timeout {" << timeout << "}...";
 
         std::vector<unsigned char> res;
-        d_lastCommand = command;
-        d_lastResult.clear();
+        if (d_retainLastExchange)
+        {
+            d_lastCommand = command;
+            d_lastResult.clear();
+        }
 
         if (command.size() > 0)
         {
@@ -30,9 +138,208 @@ namespace logicalaccess
         }
 
         res = receive(timeout);
-		d_lastResult = res;
+        if (d_retainLastExchange)
+            d_lastResult = res;
 
         LOG(LogLevel::COMS) << "Response received successfully ! Response: " << BufferHelper::getHex(res) << " size {" << res.size() << "}";
         return res;
     }
-}
\ No newline at end of file
+
+    void DataTransport::transmit(const unsigned char* command, size_t commandlen, std::vector<unsigned char>& result, long int timeout)
+    {
+        if (timeout == -1)
+            timeout = Settings::getSnapshot()->DataTransportTimeout;
+
+        ExchangeLock exchange(std::bind(&DataTransport::lockExchange, this), std::bind(&DataTransport::unlockExchange, this));
+
+        LOG(LogLevel::COMS) << "Sending command " << BufferHelper::getHex(command, commandlen) << " command size {" << commandlen << "} timeout {" << timeout << "}...";
+
+        if (d_retainLastExchange)
+        {
+            d_lastCommand.assign(command, command + commandlen);
+            d_lastResult.clear();
+        }
+
+        if (commandlen > 0)
+        {
+            connect();
+
+            sendBuffer(command, commandlen);
+        }
+
+        receiveInto(result, timeout);
+        if (d_retainLastExchange)
+            d_lastResult = result;
+
+        LOG(LogLevel::COMS) << "Response received successfully ! Response: " << BufferHelper::getHex(result) << " size {" << result.size() << "}";
+    }
+
+    void DataTransport::sendBuffer(const unsigned char* data, size_t datalen)
+    {
+        send(std::vector<unsigned char>(data, data + datalen));
+    }
+
+    void DataTransport::receiveInto(std::vector<unsigned char>& result, long int timeout)
+    {
+        result = receive(timeout);
+    }
+
+    void DataTransport::sendCommandAsync(const std::vector<unsigned char>& command, CommandHandler handler, long int timeout)
+    {
+        if (timeout == -1)
+            timeout = Settings::getSnapshot()->DataTransportTimeout;
+
+        PendingCommand pending;
+        pending.command = command;
+        pending.timeout = timeout;
+        pending.handler = handler;
+        {
+            std::lock_guard<std::mutex> lock(d_asyncQueue->mutex);
+            d_asyncQueue->commands.push_back(pending);
+            if (d_asyncQueue->busy)
+                return;
+            d_asyncQueue->busy = true;
+        }
+
+        processAsyncQueue();
+    }
+
+    std::future<std::vector<unsigned char> > DataTransport::sendCommandAsync(const std::vector<unsigned char>& command, long int timeout)
+    {
+        std::shared_ptr<std::promise<std::vector<unsigned char> > > promise(new std::promise<std::vector<unsigned char> >());
+        std::future<std::vector<unsigned char> > result = promise->get_future();
+
+        sendCommandAsync(command, [promise](std::exception_ptr error, const std::vector<unsigned char>& res)
+        {
+            if (error)
+                promise->set_exception(error);
+            else
+                promise->set_value(res);
+        }, timeout);
+
+        return result;
+    }
+
+    void DataTransport::processAsyncQueue()
+    {
+        std::shared_ptr<AsyncQueue> queue = d_asyncQueue;
+        for (;;)
+        {
+            PendingCommand pending;
+            {
+                std::lock_guard<std::mutex> lock(queue->mutex);
+                // A completion handler may have destroyed the transport.
+                if (queue->commands.empty() || queue->owner == NULL)
+                {
+                    queue->busy = false;
+                    queue->cond.notify_all();
+                    return;
+                }
+                pending = queue->commands.front();
+                queue->commands.pop_front();
+            }
+
+            LOG(LogLevel::COMS) << "Sending asynchronous command " << BufferHelper::getHex(pending.command) << " command size {" << pending.command.size() << "} timeout {" << pending.timeout << "}...";
+            if (d_retainLastExchange)
+            {
+                d_lastCommand = pending.command;
+                d_lastResult.clear();
+            }
+
+            std::shared_ptr<AsyncStep> step(new AsyncStep());
+            CommandHandler handler = pending.handler;
+            exchangeAsync(pending.command, pending.timeout, [queue, step, handler](std::exception_ptr error, const std::vector<unsigned char>& res)
+            {
+                completeAsync(queue, step, handler, error, res);
+            });
+
+            {
+                std::lock_guard<std::mutex> lock(queue->mutex);
+                step->returned = true;
+                // Loop on synchronous completions rather than recursing.
+                if (!step->completed)
+                    return;
+            }
+        }
+    }
+
+    void DataTransport::completeAsync(std::shared_ptr<AsyncQueue> queue, std::shared_ptr<AsyncStep> step, CommandHandler handler,
+                                      std::exception_ptr error, const std::vector<unsigned char>& res)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            if (!error && queue->owner != NULL && queue->owner->d_retainLastExchange)
+                queue->owner->d_lastResult = res;
+            queue->handlerThread = std::this_thread::get_id();
+        }
+
+        if (!error)
+        {
+            LOG(LogLevel::COMS) << "Asynchronous response received successfully ! Response: " << BufferHelper::getHex(res) << " size {" << res.size() << "}";
+        }
+
+        try
+        {
+            handler(error, res);
+        }
+        catch (std::exception& ex)
+        {
+            LOG(LogLevel::ERRORS) << "Asynchronous command handler failed: " << ex.what();
+        }
+        catch (...)
+        {
+            LOG(LogLevel::ERRORS) << "Asynchronous command handler failed.";
+        }
+
+        DataTransport* owner;
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            queue->handlerThread = std::thread::id();
+            if (!step->returned)
+            {
+                // Completed from exchangeAsync(), processAsyncQueue() goes on.
+                step->completed = true;
+                return;
+            }
+
+            if (queue->commands.empty() || queue->owner == NULL)
+            {
+                queue->busy = false;
+                queue->cond.notify_all();
+                return;
+            }
+
+            owner = queue->owner;
+            ++queue->users;
+        }
+
+        owner->processAsyncQueue();
+
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        --queue->users;
+        queue->cond.notify_all();
+    }
+
+    void DataTransport::exchangeAsync(const std::vector<unsigned char>& command, long int timeout, CommandHandler handler)
+    {
+        std::vector<unsigned char> res;
+        try
+        {
+            if (command.size() > 0)
+            {
+                connect();
+
+                send(command);
+            }
+
+            res = receive(timeout);
+        }
+        catch (...)
+        {
+            handler(std::current_exception(), std::vector<unsigned char>());
+            return;
+        }
+
+        handler(std::exception_ptr(), res);
+    }
+}
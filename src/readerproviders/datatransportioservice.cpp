@@ -0,0 +1,50 @@
+/**
+ * \file datatransportioservice.cpp
+ * \brief I/O service shared by the network data transports.
+ */
+
+#include "logicalaccess/readerproviders/datatransportioservice.hpp"
+#include "logicalaccess/logs.hpp"
+
+namespace logicalaccess
+{
+    DataTransportIOService::DataTransportIOService()
+        : work_(new boost::asio::io_service::work(ios_))
+    {
+        thread_ = std::thread([this]()
+        {
+            for (;;)
+            {
+                try
+                {
+                    ios_.run();
+                    break;
+                }
+                catch (std::exception& ex)
+                {
+                    // A completion handler leaked an exception, keep serving the others.
+                    LOG(LogLevel::ERRORS) << "Data transport completion handler failed: " << ex.what();
+                }
+            }
+        });
+    }
+
+    DataTransportIOService::~DataTransportIOService()
+    {
+        work_.reset();
+        ios_.stop();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    std::shared_ptr<DataTransportIOService> DataTransportIOService::getInstance()
+    {
+        static std::shared_ptr<DataTransportIOService> instance(new DataTransportIOService());
+        return instance;
+    }
+
+    bool DataTransportIOService::isIOThread() const
+    {
+        return std::this_thread::get_id() == thread_.get_id();
+    }
+}
@@ -20,7 +20,7 @@ namespace logicalaccess
 {
     ReaderConfiguration::ReaderConfiguration()
     {
-        Settings* config = Settings::getInstance();
+        std::shared_ptr<const Settings> config = Settings::getSnapshot();
 
 		try
 		{
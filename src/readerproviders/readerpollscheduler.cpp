@@ -0,0 +1,276 @@
+/**
+ * \file readerpollscheduler.cpp
+ * \brief Shared poll scheduler for reader units without insertion/removal notification.
+ */
+
+#include "logicalaccess/readerproviders/readerpollscheduler.hpp"
+#include "logicalaccess/logs.hpp"
+
+#include <algorithm>
+#include <exception>
+
+namespace logicalaccess
+{
+    ReaderPollScheduler::ReaderPollScheduler(unsigned int threads, unsigned int maxThreads)
+        : min_threads_(std::max(threads, 1u)), max_threads_(std::max(maxThreads, std::max(threads, 1u))),
+          next_id_(0), stopping_(false)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (unsigned int i = 0; i < min_threads_; ++i)
+        {
+            startThread();
+        }
+    }
+
+    ReaderPollScheduler::~ReaderPollScheduler()
+    {
+        std::map<int, std::shared_ptr<PollEntry>> pending;
+        std::map<std::thread::id, std::thread> threads;
+        std::vector<std::thread> exited;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            // The threads no longer exit on their own once stopping.
+            threads.swap(threads_);
+            exited.swap(exited_);
+        }
+        cond_.notify_all();
+
+        for (std::map<std::thread::id, std::thread>::iterator it = threads.begin(); it != threads.end(); ++it)
+        {
+            if (it->second.joinable())
+                it->second.join();
+        }
+        for (std::vector<std::thread>::iterator it = exited.begin(); it != exited.end(); ++it)
+        {
+            if (it->joinable())
+                it->join();
+        }
+
+        pending.swap(entries_);
+        queue_.clear();
+        for (std::map<int, std::shared_ptr<PollEntry>>::iterator it = pending.begin(); it != pending.end(); ++it)
+        {
+            if (it->second->completion)
+                it->second->completion(false);
+        }
+    }
+
+    std::shared_ptr<ReaderPollScheduler> ReaderPollScheduler::getInstance()
+    {
+        static std::shared_ptr<ReaderPollScheduler> instance(new ReaderPollScheduler());
+        return instance;
+    }
+
+    int ReaderPollScheduler::schedule(PollHook hook, CompletionHandler completion, unsigned int maxwait,
+                                      const ReaderPollProfile& profile)
+    {
+        std::shared_ptr<PollEntry> entry(new PollEntry());
+        entry->hook = hook;
+        entry->completion = completion;
+        entry->profile = profile;
+        entry->start = Clock::now();
+        entry->deadline = entry->start + std::chrono::milliseconds(maxwait);
+        entry->infinite = (maxwait == 0);
+        entry->interval = profile.minInterval;
+        entry->cancelled = false;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            entry->id = next_id_++;
+            entries_[entry->id] = entry;
+            queue_.insert(std::make_pair(entry->start + std::chrono::milliseconds(profile.firstDelay), entry));
+            grow();
+        }
+        cond_.notify_one();
+
+        return entry->id;
+    }
+
+    void ReaderPollScheduler::cancel(int id)
+    {
+        std::shared_ptr<PollEntry> entry;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::map<int, std::shared_ptr<PollEntry>>::iterator it = entries_.find(id);
+            if (it == entries_.end())
+                return;
+
+            it->second->cancelled = true;
+            for (std::multimap<Clock::time_point, std::shared_ptr<PollEntry>>::iterator qit = queue_.begin(); qit != queue_.end(); ++qit)
+            {
+                if (qit->second->id == id)
+                {
+                    // Not being polled, complete it now. Otherwise the polling thread will.
+                    entry = qit->second;
+                    queue_.erase(qit);
+                    entries_.erase(it);
+                    break;
+                }
+            }
+        }
+
+        // An idle thread may now be in excess.
+        cond_.notify_all();
+
+        if (entry && entry->completion)
+            entry->completion(false);
+    }
+
+    unsigned int ReaderPollScheduler::getThreadCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return static_cast<unsigned int>(threads_.size());
+    }
+
+    bool ReaderPollScheduler::waitFor(PollHook hook, unsigned int maxwait, const ReaderPollProfile& profile)
+    {
+        struct WaitState
+        {
+            std::mutex mutex;
+            std::condition_variable cond;
+            bool done;
+            bool result;
+            std::exception_ptr error;
+        };
+        std::shared_ptr<WaitState> state(new WaitState());
+        state->done = false;
+        state->result = false;
+
+        schedule([hook, state]()
+        {
+            try
+            {
+                return hook();
+            }
+            catch (...)
+            {
+                state->error = std::current_exception();
+                return true;
+            }
+        }, [state](bool result)
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->result = result;
+            state->done = true;
+            state->cond.notify_all();
+        }, maxwait, profile);
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        while (!state->done)
+        {
+            state->cond.wait(lock);
+        }
+
+        if (state->error)
+            std::rethrow_exception(state->error);
+
+        return state->result;
+    }
+
+    ReaderPollScheduler::Clock::time_point ReaderPollScheduler::next_poll(PollEntry& entry, Clock::time_point now)
+    {
+        if (now - entry.start >= std::chrono::milliseconds(entry.profile.fastPeriod))
+        {
+            entry.interval = std::min(entry.interval * 2, entry.profile.maxInterval);
+        }
+
+        Clock::time_point next = now + std::chrono::milliseconds(entry.interval);
+        if (!entry.infinite && next > entry.deadline)
+        {
+            // Give it a last chance right on the deadline.
+            next = entry.deadline;
+        }
+        return next;
+    }
+
+    void ReaderPollScheduler::grow()
+    {
+        // The exited threads are done with the mutex, they only have to return.
+        for (std::vector<std::thread>::iterator it = exited_.begin(); it != exited_.end(); ++it)
+        {
+            it->join();
+        }
+        exited_.clear();
+
+        if (!stopping_ && threads_.size() < entries_.size() && threads_.size() < max_threads_)
+        {
+            startThread();
+        }
+    }
+
+    void ReaderPollScheduler::startThread()
+    {
+        std::thread thread(&ReaderPollScheduler::run, this);
+        std::thread::id id = thread.get_id();
+        threads_[id] = std::move(thread);
+    }
+
+    bool ReaderPollScheduler::shrink()
+    {
+        if (threads_.size() <= std::max<size_t>(min_threads_, entries_.size()))
+            return false;
+
+        std::map<std::thread::id, std::thread>::iterator it = threads_.find(std::this_thread::get_id());
+        exited_.push_back(std::move(it->second));
+        threads_.erase(it);
+        return true;
+    }
+
+    void ReaderPollScheduler::run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_)
+        {
+            if (shrink())
+                break;
+
+            if (queue_.empty())
+            {
+                cond_.wait(lock);
+                continue;
+            }
+
+            std::multimap<Clock::time_point, std::shared_ptr<PollEntry>>::iterator it = queue_.begin();
+            if (it->first > Clock::now())
+            {
+                cond_.wait_until(lock, it->first);
+                continue;
+            }
+
+            std::shared_ptr<PollEntry> entry = it->second;
+            queue_.erase(it);
+
+            lock.unlock();
+            bool done = false, failed = false;
+            try
+            {
+                done = entry->hook();
+            }
+            catch (std::exception& ex)
+            {
+                LOG(LogLevel::ERRORS) << "Reader poll hook failed: " << ex.what();
+                failed = true;
+            }
+            catch (...)
+            {
+                LOG(LogLevel::ERRORS) << "Reader poll hook failed.";
+                failed = true;
+            }
+            lock.lock();
+
+            Clock::time_point now = Clock::now();
+            if (!done && !failed && !entry->cancelled && (entry->infinite || now < entry->deadline) && !stopping_)
+            {
+                queue_.insert(std::make_pair(next_poll(*entry, now), entry));
+                continue;
+            }
+
+            entries_.erase(entry->id);
+            lock.unlock();
+            if (entry->completion)
+                entry->completion(done);
+            lock.lock();
+        }
+    }
+}
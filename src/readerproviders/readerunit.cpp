@@ -9,6 +9,7 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <thread>
 
 #include <cstring>
 #include <boost/date_time.hpp>
@@ -88,6 +89,42 @@ namespace logicalaccess
         d_ledBuzzerDisplay = lbd;
     }
 
+    void ReaderUnit::waitInsertionAsync(unsigned int maxwait, WaitHandler handler)
+    {
+        std::shared_ptr<ReaderUnit> self = shared_from_this();
+        std::thread([self, maxwait, handler]()
+        {
+            bool inserted = false;
+            try
+            {
+                inserted = self->waitInsertion(maxwait);
+            }
+            catch (std::exception& ex)
+            {
+                LOG(LogLevel::ERRORS) << "Wait for insertion failed: " << ex.what();
+            }
+            handler(inserted);
+        }).detach();
+    }
+
+    void ReaderUnit::waitRemovalAsync(unsigned int maxwait, WaitHandler handler)
+    {
+        std::shared_ptr<ReaderUnit> self = shared_from_this();
+        std::thread([self, maxwait, handler]()
+        {
+            bool removed = false;
+            try
+            {
+                removed = self->waitRemoval(maxwait);
+            }
+            catch (std::exception& ex)
+            {
+                LOG(LogLevel::ERRORS) << "Wait for removal failed: " << ex.what();
+            }
+            handler(removed);
+        }).detach();
+    }
+
     bool ReaderUnit::waitInsertion(const std::vector<unsigned char>& identifier, unsigned int maxwait)
     {
         LOG(LogLevel::INFOS) << "Started for identifier " << BufferHelper::getHex(identifier) << " - maxwait " << maxwait;
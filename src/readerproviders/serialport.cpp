@@ -22,13 +22,13 @@ namespace logicalaccess
 #else
         m_dev("COM1"),
 #endif
-        m_serial_port(m_io), m_circular_read_buffer(256), m_read_buffer(128),
+        m_serial_port(m_io), m_wait_timer(m_io), m_circular_read_buffer(256), m_read_buffer(128),
         data_flag_(false)
     {
     }
 
     SerialPort::SerialPort(const std::string& dev)
-        : m_dev(dev), m_serial_port(m_io), m_circular_read_buffer(256), m_read_buffer(128),
+        : m_dev(dev), m_serial_port(m_io), m_wait_timer(m_io), m_circular_read_buffer(256), m_read_buffer(128),
           data_flag_(false)
     {
     }
@@ -81,6 +81,7 @@ namespace logicalaccess
         {
             m_serial_port.close();
         }
+        complete_wait(false);
     }
 
     void SerialPort::setBaudrate(unsigned int rate)
@@ -191,6 +192,7 @@ namespace logicalaccess
         data_flag_ = true;
         cond_var_mutex_.unlock();
         cond_var_.notify_all();
+        complete_wait(true);
 
         // start the next read
         m_serial_port.async_read_some(boost::asio::buffer(m_read_buffer), boost::bind(&SerialPort::do_read,
@@ -243,4 +245,50 @@ namespace logicalaccess
     {
         data_flag_ = false;
     }
-}
\ No newline at end of file
+
+    void SerialPort::asyncWaitMoreData(long int timeout, DataHandler handler)
+    {
+        EXCEPTION_ASSERT(isOpen(), LibLogicalAccessException, "Cannot read on a closed device");
+
+        // The timer and the handler are only touched from the serial port thread.
+        m_io.post([this, timeout, handler]()
+        {
+            {
+                std::unique_lock<std::mutex> ul(cond_var_mutex_);
+                if (!data_flag_)
+                {
+                    data_handler_ = handler;
+                    m_wait_timer.expires_from_now(boost::posix_time::milliseconds(timeout));
+                    m_wait_timer.async_wait(boost::bind(&SerialPort::do_wait_timeout, this, boost::asio::placeholders::error));
+                    return;
+                }
+            }
+            handler(true);
+        });
+    }
+
+    void SerialPort::do_wait_timeout(const boost::system::error_code& error)
+    {
+        // Ignore a stale expiration, the timer may have been rearmed for the next wait since.
+        if (error || m_wait_timer.expires_at() > boost::asio::deadline_timer::traits_type::now())
+            return;
+
+        complete_wait(false);
+    }
+
+    void SerialPort::complete_wait(bool available)
+    {
+        DataHandler handler;
+        {
+            std::unique_lock<std::mutex> ul(cond_var_mutex_);
+            handler.swap(data_handler_);
+        }
+
+        if (handler)
+        {
+            boost::system::error_code ignored;
+            m_wait_timer.cancel(ignored);
+            handler(available);
+        }
+    }
+}
@@ -11,6 +11,7 @@
 #include "logicalaccess/settings.hpp"
 #include "logicalaccess/logs.hpp"
 #include <boost/property_tree/ptree.hpp>
+#include <algorithm>
 
 namespace logicalaccess
 {
@@ -107,9 +108,73 @@ namespace logicalaccess
         return res;
     }
 
+    void SerialPortDataTransport::exchangeAsync(const std::vector<unsigned char>& command, long int timeout, CommandHandler handler)
+    {
+        try
+        {
+            if (command.size() > 0)
+            {
+                connect();
+
+                send(command);
+            }
+        }
+        catch (...)
+        {
+            handler(std::current_exception(), std::vector<unsigned char>());
+            return;
+        }
+
+        receiveAsync(std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout), handler);
+    }
+
+    void SerialPortDataTransport::receiveAsync(const std::chrono::steady_clock::time_point& until, CommandHandler handler)
+    {
+        std::shared_ptr<SerialPort> port = d_port->getSerialPort();
+        long int remaining = static_cast<long int>(std::chrono::duration_cast<std::chrono::milliseconds>(until - std::chrono::steady_clock::now()).count());
+
+        try
+        {
+            port->asyncWaitMoreData(std::max(remaining, 0L), [this, port, until, handler](bool available)
+            {
+                std::vector<unsigned char> res;
+                try
+                {
+                    if (available)
+                    {
+                        port->lockedExecute([&]()
+                        {
+                            auto ret = port->read(res);
+                            if (ret == 0)
+                                port->dataConsumed();
+                        });
+                    }
+                }
+                catch (...)
+                {
+                    handler(std::current_exception(), std::vector<unsigned char>());
+                    return;
+                }
+
+                if (res.size() == 0 && std::chrono::steady_clock::now() < until && port->isOpen())
+                {
+                    receiveAsync(until, handler);
+                    return;
+                }
+
+                LOG(LogLevel::COMS) << "Command response: " << BufferHelper::getHex(res);
+                handler(std::exception_ptr(), res);
+            });
+        }
+        catch (...)
+        {
+            handler(std::current_exception(), std::vector<unsigned char>());
+        }
+    }
+
     void SerialPortDataTransport::configure()
     {
-        configure(d_port, Settings::getInstance()->IsConfigurationRetryEnabled);
+        configure(d_port, Settings::getSnapshot()->IsConfigurationRetryEnabled);
     }
 
     void SerialPortDataTransport::configure(std::shared_ptr<SerialPortXml> port, bool retryConfiguring)
@@ -135,9 +200,9 @@ namespace logicalaccess
                 // Strange stuff is going here... by waiting and reopening the COM port (maybe for system cleanup), it's working !
                 std::string portn = port->getSerialPort()->deviceName();
                 LOG(LogLevel::WARNINGS) << "Exception received " << e.what() << " ! Sleeping "
-                    << Settings::getInstance()->ConfigurationRetryTimeout << " milliseconds -> Reopen serial port "
+                    << Settings::getSnapshot()->ConfigurationRetryTimeout << " milliseconds -> Reopen serial port "
                     << portn << " -> Finally retry  to configure...";
-                std::this_thread::sleep_for(std::chrono::milliseconds(Settings::getInstance()->ConfigurationRetryTimeout));
+                std::this_thread::sleep_for(std::chrono::milliseconds(Settings::getSnapshot()->ConfigurationRetryTimeout));
 
                 port->getSerialPort()->reopen();
                 configure(port, false);
@@ -149,7 +214,7 @@ namespace logicalaccess
     {
         if (d_port && d_port->getSerialPort()->deviceName() == "")
         {
-            if (!Settings::getInstance()->IsAutoDetectEnabled)
+            if (!Settings::getSnapshot()->IsAutoDetectEnabled)
             {
                 LOG(LogLevel::INFOS) << "Auto detection is disabled through settings !";
                 return;
@@ -174,7 +239,7 @@ namespace logicalaccess
                             configure((*i), false);
 
                             d_port = (*i);
-                            std::vector<unsigned char> r = sendCommand(wrappedcmd, Settings::getInstance()->AutoDetectionTimeout);
+                            std::vector<unsigned char> r = sendCommand(wrappedcmd, Settings::getSnapshot()->AutoDetectionTimeout);
                             if (r.size() > 0)
                             {
                                 LOG(LogLevel::INFOS) << "Reader found ! Using this COM port !";
@@ -16,14 +16,27 @@
 #include <boost/property_tree/ptree.hpp>
 #include "logicalaccess/settings.hpp"
 
+#include <future>
+
 namespace logicalaccess
 {
-	TcpDataTransport::TcpDataTransport() : d_socket(d_ios), d_timer(d_ios), d_read_error(true), d_bytes_transferred(0), d_ipAddress("127.0.0.1"), d_port(9559)
+	TcpDataTransport::TcpDataTransport() : d_service(DataTransportIOService::getInstance()), d_async(new AsyncSocket(d_service)), d_ipAddress("127.0.0.1"), d_port(9559)
     {
     }
 
     TcpDataTransport::~TcpDataTransport()
     {
+        abandonAsyncCommands();
+
+        // Pending operations complete as aborted, they keep the socket alive until then.
+        std::shared_ptr<AsyncSocket> async = d_async;
+        d_service->getIOService().post([async]()
+        {
+            boost::system::error_code ignored;
+            async->closed = true;
+            async->timer.cancel(ignored);
+            async->socket.close(ignored);
+        });
     }
 
     std::string TcpDataTransport::getIpAddress() const
@@ -48,50 +61,55 @@ namespace logicalaccess
 
 	bool TcpDataTransport::connect()
 	{
-		return connect(Settings::getInstance()->DataTransportTimeout);
+		return connect(Settings::getSnapshot()->DataTransportTimeout);
 	}
 
     bool TcpDataTransport::connect(long int timeout)
     {
-		if (d_socket.is_open())
-            d_socket.close();
+        check_not_io_thread();
 
-        try
+        std::shared_ptr<std::promise<boost::system::error_code> > promise(new std::promise<boost::system::error_code>());
+        std::future<boost::system::error_code> result = promise->get_future();
+        async_connect(d_async, getIpAddress(), getPort(), timeout, [promise](const boost::system::error_code& error)
         {
-			d_ios.reset();
-			d_timer.expires_from_now(boost::posix_time::milliseconds(timeout));
-			d_timer.async_wait(boost::bind(&TcpDataTransport::time_out,
-                                this, boost::asio::placeholders::error));
-
-			boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address::from_string(getIpAddress()), getPort());
-			d_socket.async_connect(endpoint, boost::bind(&TcpDataTransport::connect_complete,
-                                this, boost::asio::placeholders::error));
+            promise->set_value(error);
+        });
 
-			d_ios.run();
-
-			if (d_read_error)
-				d_socket.close();
-
-            LOG(LogLevel::INFOS) << "Connected to " << getIpAddress() << " on port " << getPort() << ".";
+        boost::system::error_code error = result.get();
+        if (error)
+        {
+            LOG(LogLevel::ERRORS) << "Cannot establish connection on " << getIpAddress() << ":" << getPort() << " : " << error.message();
+            disconnect();
         }
-        catch (boost::system::system_error& ex)
+        else
         {
-            LOG(LogLevel::ERRORS) << "Cannot establish connection on " << getIpAddress() << ":" << getPort() << " : " << ex.what();
-			disconnect();
+            LOG(LogLevel::INFOS) << "Connected to " << getIpAddress() << " on port " << getPort() << ".";
         }
 
-		return bool(d_socket.is_open());
+		return isConnected();
     }
 
     void TcpDataTransport::disconnect()
     {
 		LOG(LogLevel::INFOS) << getIpAddress() << ":" << getPort() << "Disconnected.";
-        d_socket.close();
+        std::shared_ptr<AsyncSocket> async = d_async;
+        run_on_io_thread([async]()
+        {
+            // Pending operations complete as aborted.
+            boost::system::error_code ignored;
+            async->socket.close(ignored);
+        });
     }
 
     bool TcpDataTransport::isConnected()
     {
-		return bool(d_socket.is_open());
+        bool connected = false;
+        std::shared_ptr<AsyncSocket> async = d_async;
+        run_on_io_thread([async, &connected]()
+        {
+            connected = async->socket.is_open();
+        });
+		return connected;
     }
 
     std::string TcpDataTransport::getName() const
@@ -103,70 +121,215 @@ namespace logicalaccess
     {
         if (data.size() > 0)
         {
-			try
-			{
-				LOG(LogLevel::COMS) << "TCP Send Data: " << BufferHelper::getHex(data);
-				d_socket.send(boost::asio::buffer(data));
-			}
-			catch (boost::system::system_error& ex)
-			{
-				std::exception_ptr eptr = std::current_exception();
-				LOG(LogLevel::ERRORS) << "Cannot send on " << getIpAddress() << ":" << getPort() << " : " << ex.what();
-				disconnect();
-				std::rethrow_exception(eptr);
-			}
+            check_not_io_thread();
+
+            LOG(LogLevel::COMS) << "TCP Send Data: " << BufferHelper::getHex(data);
+            std::shared_ptr<AsyncSocket> async = d_async;
+            std::shared_ptr<std::vector<unsigned char> > buffer(new std::vector<unsigned char>(data));
+            std::shared_ptr<std::promise<boost::system::error_code> > promise(new std::promise<boost::system::error_code>());
+            std::future<boost::system::error_code> result = promise->get_future();
+            d_service->getIOService().post([async, buffer, promise]()
+            {
+                boost::asio::async_write(async->socket, boost::asio::buffer(*buffer), [buffer, promise](const boost::system::error_code& error, size_t)
+                {
+                    promise->set_value(error);
+                });
+            });
+
+            boost::system::error_code error = result.get();
+            if (error)
+            {
+                LOG(LogLevel::ERRORS) << "Cannot send on " << getIpAddress() << ":" << getPort() << " : " << error.message();
+                disconnect();
+                throw boost::system::system_error(error);
+            }
         }
     }
 
-	void TcpDataTransport::connect_complete(const boost::system::error_code& error)
-	{
-		d_read_error = (error != 0);
-        d_timer.cancel();
+    void TcpDataTransport::run_on_io_thread(std::function<void()> operation)
+    {
+        if (d_service->isIOThread())
+        {
+            operation();
+            return;
+        }
+
+        std::shared_ptr<std::promise<void> > promise(new std::promise<void>());
+        std::future<void> done = promise->get_future();
+        d_service->getIOService().post([operation, promise]()
+        {
+            operation();
+            promise->set_value();
+        });
+        done.get();
     }
 
-    void TcpDataTransport::read_complete(const boost::system::error_code& error, size_t bytes_transferred)
-	{
-        d_read_error = (error || bytes_transferred == 0);
-		d_bytes_transferred = bytes_transferred;
-        d_timer.cancel();
+    void TcpDataTransport::check_not_io_thread()
+    {
+        EXCEPTION_ASSERT_WITH_LOG(!d_service->isIOThread(), LibLogicalAccessException,
+            "Synchronous TCP operations cannot be run from an asynchronous completion handler.");
     }
- 
-    void TcpDataTransport::time_out(const boost::system::error_code& error)
-	{
-        if (error) 
-            return;
-        d_socket.cancel();
+
+    void TcpDataTransport::arm_timer(std::shared_ptr<AsyncSocket> async, long int timeout)
+    {
+        async->timer.expires_from_now(boost::posix_time::milliseconds(timeout));
+        async->timer.async_wait([async](const boost::system::error_code& error)
+        {
+            // Ignore a stale expiration, the timer may have been rearmed for the next operation since.
+            if (error || async->timer.expires_at() > boost::asio::deadline_timer::traits_type::now())
+                return;
+
+            boost::system::error_code ignored;
+            async->socket.cancel(ignored);
+        });
+    }
+
+    void TcpDataTransport::async_connect(std::shared_ptr<AsyncSocket> async, const std::string& ipAddress, int port, long int timeout, ConnectHandler handler)
+    {
+        // Socket and timer operations all run on the I/O service thread.
+        async->service->getIOService().post([async, ipAddress, port, timeout, handler]()
+        {
+            boost::system::error_code error;
+            if (async->closed)
+            {
+                handler(boost::asio::error::operation_aborted);
+                return;
+            }
+
+            if (async->socket.is_open())
+                async->socket.close(error);
+
+            boost::asio::ip::address address = boost::asio::ip::make_address(ipAddress, error);
+            if (error)
+            {
+                handler(error);
+                return;
+            }
+
+            arm_timer(async, timeout);
+            async->socket.async_connect(boost::asio::ip::tcp::endpoint(address, port), [async, handler](const boost::system::error_code& error)
+            {
+                boost::system::error_code ignored;
+                async->timer.cancel(ignored);
+                if (error)
+                    async->socket.close(ignored);
+                handler(error);
+            });
+        });
+    }
+
+    void TcpDataTransport::async_receive(std::shared_ptr<AsyncSocket> async, long int timeout, ReceiveHandler handler)
+    {
+        async->service->getIOService().post([async, timeout, handler]()
+        {
+            std::shared_ptr<std::vector<unsigned char> > recv(new std::vector<unsigned char>(256));
+
+            arm_timer(async, timeout);
+            async->socket.async_receive(boost::asio::buffer(*recv), [async, recv, handler](const boost::system::error_code& error, size_t bytes_transferred)
+            {
+                boost::system::error_code ignored;
+                async->timer.cancel(ignored);
+                recv->resize(bytes_transferred);
+                handler(error, *recv);
+            });
+        });
     }
 
     std::vector<unsigned char> TcpDataTransport::receive(long int timeout)
     {
-		std::vector<unsigned char> recv(256);
-		d_ios.reset();
-		d_bytes_transferred = 0;
- 
-		d_ios.reset();
-		d_socket.async_receive(boost::asio::buffer(recv),
-                boost::bind(&TcpDataTransport::read_complete,
-                        this,
-                        boost::asio::placeholders::error,
-                        boost::asio::placeholders::bytes_transferred));
- 
-        d_timer.expires_from_now(boost::posix_time::milliseconds(timeout));
-        d_timer.async_wait(boost::bind(&TcpDataTransport::time_out,
-                                this, boost::asio::placeholders::error));
- 
-		d_ios.run();
-
-		recv.resize(d_bytes_transferred);
-		if (d_read_error || recv.size() == 0)
+        check_not_io_thread();
+
+        typedef std::pair<boost::system::error_code, std::vector<unsigned char> > ReceiveResult;
+        std::shared_ptr<std::promise<ReceiveResult> > promise(new std::promise<ReceiveResult>());
+        std::future<ReceiveResult> result = promise->get_future();
+        async_receive(d_async, timeout, [promise](const boost::system::error_code& error, const std::vector<unsigned char>& data)
+        {
+            promise->set_value(ReceiveResult(error, data));
+        });
+
+        ReceiveResult res = result.get();
+		if (res.first || res.second.size() == 0)
 		{
             char buf[64];
             sprintf(buf, "Socket receive timeout (> %ld milliseconds).", timeout);
             THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, buf);
         }
 
-        LOG(LogLevel::COMS) << "TCP Data read: " << BufferHelper::getHex(recv);
-		return recv;
+        LOG(LogLevel::COMS) << "TCP Data read: " << BufferHelper::getHex(res.second);
+		return res.second;
+    }
+
+    void TcpDataTransport::exchangeAsync(const std::vector<unsigned char>& command, long int timeout, CommandHandler handler)
+    {
+        ReceiveHandler on_receive = [timeout, handler](const boost::system::error_code& error, const std::vector<unsigned char>& data)
+        {
+            if (error || data.size() == 0)
+            {
+                char buf[64];
+                sprintf(buf, "Socket receive timeout (> %ld milliseconds).", timeout);
+                LOG(LogLevel::ERRORS) << buf;
+                handler(std::make_exception_ptr(LibLogicalAccessException(buf)), std::vector<unsigned char>());
+                return;
+            }
+
+            LOG(LogLevel::COMS) << "TCP Data read: " << BufferHelper::getHex(data);
+            handler(std::exception_ptr(), data);
+        };
+
+        std::shared_ptr<AsyncSocket> async = d_async;
+        if (command.size() == 0)
+        {
+            async_receive(async, timeout, on_receive);
+            return;
+        }
+
+        // The lambdas only hold the socket, not the transport.
+        std::string endpoint = getIpAddress() + ":" + std::to_string(getPort());
+        std::shared_ptr<std::vector<unsigned char> > data(new std::vector<unsigned char>(command));
+        std::function<void()> send_and_receive = [async, endpoint, data, timeout, handler, on_receive]()
+        {
+            LOG(LogLevel::COMS) << "TCP Send Data: " << BufferHelper::getHex(*data);
+            boost::asio::async_write(async->socket, boost::asio::buffer(*data), [async, endpoint, data, timeout, handler, on_receive](const boost::system::error_code& error, size_t)
+            {
+                if (error)
+                {
+                    std::string msg = "Cannot send on " + endpoint + " : " + error.message();
+                    LOG(LogLevel::ERRORS) << msg;
+                    boost::system::error_code ignored;
+                    async->socket.close(ignored);
+                    handler(std::make_exception_ptr(LibLogicalAccessException(msg)), std::vector<unsigned char>());
+                    return;
+                }
+
+                async_receive(async, timeout, on_receive);
+            });
+        };
+
+        std::string ipAddress = getIpAddress();
+        int port = getPort();
+        d_service->getIOService().post([async, ipAddress, port, endpoint, handler, send_and_receive]()
+        {
+            // Keep the connection open between commands, only connect the first time or after a failure.
+            if (async->socket.is_open())
+            {
+                send_and_receive();
+                return;
+            }
+
+            async_connect(async, ipAddress, port, Settings::getSnapshot()->DataTransportTimeout, [endpoint, handler, send_and_receive](const boost::system::error_code& error)
+            {
+                if (error)
+                {
+                    std::string msg = "Cannot establish connection on " + endpoint + " : " + error.message();
+                    LOG(LogLevel::ERRORS) << msg;
+                    handler(std::make_exception_ptr(LibLogicalAccessException(msg)), std::vector<unsigned char>());
+                    return;
+                }
+
+                LOG(LogLevel::INFOS) << "Connected to " << endpoint << ".";
+                send_and_receive();
+            });
+        });
     }
 
     void TcpDataTransport::serialize(boost::property_tree::ptree& parentNode)
@@ -6,6 +6,9 @@
 
 #include "logicalaccess/readerproviders/udpdatatransport.hpp"
 #include "logicalaccess/cards/readercardadapter.hpp"
+#include "logicalaccess/myexception.hpp"
+#include "logicalaccess/bufferhelper.hpp"
+#include "logicalaccess/logs.hpp"
 
 #include <boost/foreach.hpp>
 #include <boost/optional.hpp>
@@ -15,7 +18,7 @@
 
 namespace logicalaccess
 {
-    UdpDataTransport::UdpDataTransport() : d_ipAddress("127.0.0.1"), d_port(9559)
+    UdpDataTransport::UdpDataTransport() : d_service(DataTransportIOService::getInstance()), d_timer(d_service->getIOService()), d_ipAddress("127.0.0.1"), d_port(9559)
     {
     }
 
@@ -52,8 +55,8 @@ namespace logicalaccess
     {
         if (!d_socket)
         {
-            boost::asio::ip::udp::endpoint endpoint(boost::asio::ip::address::from_string(getIpAddress()), getPort());
-            d_socket.reset(new boost::asio::ip::udp::socket(ios));
+            boost::asio::ip::udp::endpoint endpoint(boost::asio::ip::make_address(getIpAddress()), getPort());
+            d_socket.reset(new boost::asio::ip::udp::socket(d_service->getIOService()));
 
             try
             {
@@ -123,6 +126,82 @@ namespace logicalaccess
         return res;
     }
 
+    void UdpDataTransport::async_receive(long int timeout, CommandHandler handler)
+    {
+        std::shared_ptr<boost::asio::ip::udp::socket> socket = getSocket();
+        std::shared_ptr<boost::array<unsigned char, 128> > recv_buf(new boost::array<unsigned char, 128>());
+
+        d_timer.expires_from_now(boost::posix_time::milliseconds(timeout));
+        d_timer.async_wait([this, socket](const boost::system::error_code& error)
+        {
+            // Ignore a stale expiration, the timer may have been rearmed for the next datagram since.
+            if (error || d_timer.expires_at() > boost::asio::deadline_timer::traits_type::now())
+                return;
+
+            boost::system::error_code ignored;
+            socket->cancel(ignored);
+        });
+
+        socket->async_receive(boost::asio::buffer(*recv_buf), [this, recv_buf, handler](const boost::system::error_code& error, size_t len)
+        {
+            boost::system::error_code ignored;
+            d_timer.cancel(ignored);
+
+            // As for the synchronous receive, a timeout is an empty answer.
+            if (error && error != boost::asio::error::operation_aborted)
+            {
+                std::string msg = "Cannot receive on " + getIpAddress() + ":" + std::to_string(getPort()) + " : " + error.message();
+                LOG(LogLevel::ERRORS) << msg;
+                handler(std::make_exception_ptr(LibLogicalAccessException(msg)), std::vector<unsigned char>());
+                return;
+            }
+
+            handler(std::exception_ptr(), std::vector<unsigned char>(recv_buf->begin(), recv_buf->begin() + (error ? 0 : len)));
+        });
+    }
+
+    void UdpDataTransport::exchangeAsync(const std::vector<unsigned char>& command, long int timeout, CommandHandler handler)
+    {
+        std::shared_ptr<std::vector<unsigned char> > data(new std::vector<unsigned char>(command));
+
+        // Socket and timer operations all run on the I/O service thread.
+        d_service->getIOService().post([this, data, timeout, handler]()
+        {
+            if (data->size() == 0)
+            {
+                if (!isConnected())
+                {
+                    handler(std::exception_ptr(), std::vector<unsigned char>());
+                    return;
+                }
+
+                async_receive(timeout, handler);
+                return;
+            }
+
+            if (!connect())
+            {
+                std::string msg = "Cannot establish connection on " + getIpAddress() + ":" + std::to_string(getPort()) + ".";
+                LOG(LogLevel::ERRORS) << msg;
+                handler(std::make_exception_ptr(LibLogicalAccessException(msg)), std::vector<unsigned char>());
+                return;
+            }
+
+            getSocket()->async_send(boost::asio::buffer(*data), [this, data, timeout, handler](const boost::system::error_code& error, size_t)
+            {
+                if (error)
+                {
+                    std::string msg = "Cannot send on " + getIpAddress() + ":" + std::to_string(getPort()) + " : " + error.message();
+                    LOG(LogLevel::ERRORS) << msg;
+                    handler(std::make_exception_ptr(LibLogicalAccessException(msg)), std::vector<unsigned char>());
+                    return;
+                }
+
+                async_receive(timeout, handler);
+            });
+        });
+    }
+
     void UdpDataTransport::serialize(boost::property_tree::ptree& parentNode)
     {
         boost::property_tree::ptree node;
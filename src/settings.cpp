@@ -9,12 +9,14 @@
 #endif
 #include "logicalaccess/settings.hpp"
 #include "logicalaccess/logs.hpp"
+#include "logicalaccess/logwriter.hpp"
 
 #include <boost/foreach.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 
+#include <atomic>
 #include <string>
 
 #ifdef __APPLE__
@@ -36,11 +38,10 @@ namespace logicalaccess
 
     void Settings::Initialize()
     {
-        static bool alreadyInit = false;
+        static std::atomic<bool> alreadyInit(false);
 
-        if (alreadyInit == true)
+        if (alreadyInit.exchange(true))
             return;
-        alreadyInit = true;
 
         try
         {
@@ -49,39 +50,123 @@ namespace logicalaccess
             LOG(LogLevel::INFOS) << "Log [enabled " << IsLogEnabled << " filename " << LogFileName << " seewaitinsertion " << SeeWaitInsertionLog << " seewaitremoval " << SeeWaitRemovalLog << "]";
             LOG(LogLevel::INFOS) << "Auto-detection [enabled " << IsAutoDetectEnabled << " timeout " << AutoDetectionTimeout << "]";
             LOG(LogLevel::INFOS) << "Retry serial port configuration [enabled " << IsConfigurationRetryEnabled << " timeout " << ConfigurationRetryTimeout << "]";
-
-            if (IsLogEnabled && !Logs::logfile.is_open())
-            {
-#ifdef _MSC_VER
-                Logs::logfile.open((getDllPath() + "/" + LogFileName), std::ios::out | std::ios::app);
-#else
-                Logs::logToStderr = LogToStderr;
-                Logs::logfile.open(LogFileName, std::ios::out | std::ios::app);
-#endif
-            }
         }
         catch (...) { reset(); }
+
+        publish();
+        applyLogSettings();
     }
 
     void Settings::Uninitialize()
     {
-        if (Logs::logfile)
-        {
-            Logs::logfile.close();
-        }
+        LogWriter::getInstance().close();
     }
 
     Settings* Settings::getInstance()
     {
+        static std::atomic<Settings*> ready(NULL);
+        Settings* settings = ready.load(std::memory_order_acquire);
+        if (settings != NULL)
+            return settings;
+
+        // Recursive, logging while loading comes back here and reads the defaults.
+        static std::recursive_mutex* mutex = new std::recursive_mutex();
+        std::lock_guard<std::recursive_mutex> lock(*mutex);
         if (instance == NULL)
         {
             instance = new Settings();
+            // Publish the defaults first, logging while loading reads them.
+            instance->publish();
+            instance->Initialize();
+            ready.store(instance, std::memory_order_release);
             LOG(LogLevel::INFOS) << "New settings instance created.";
         }
-        instance->Initialize();
         return instance;
     }
 
+    std::shared_ptr<const Settings>& Settings::snapshot()
+    {
+        // Never destroyed so that logging from static destructors stays safe.
+        static std::shared_ptr<const Settings>* current = new std::shared_ptr<const Settings>();
+        return *current;
+    }
+
+    std::shared_ptr<const Settings> Settings::getSnapshot()
+    {
+        std::shared_ptr<const Settings> current = std::atomic_load(&snapshot());
+        if (!current)
+        {
+            getInstance();
+            current = std::atomic_load(&snapshot());
+        }
+        return current;
+    }
+
+    void Settings::publish()
+    {
+        std::lock_guard<std::mutex> lock(updateMutex());
+        std::atomic_store(&snapshot(), std::shared_ptr<const Settings>(new Settings(*this)));
+    }
+
+    void Settings::update(const std::function<void(Settings&)>& modifier)
+    {
+        Settings* settings = getInstance();
+        std::lock_guard<std::mutex> lock(updateMutex());
+        modifier(*settings);
+        std::atomic_store(&snapshot(), std::shared_ptr<const Settings>(new Settings(*settings)));
+    }
+
+    void Settings::setLogEnabled(bool enabled)
+    {
+        update([enabled](Settings& settings) { settings.IsLogEnabled = enabled; });
+    }
+
+    void Settings::reload()
+    {
+        Settings* settings = getInstance();
+        // Load aside, the file is read out of the update lock.
+        std::shared_ptr<Settings> loaded(new Settings());
+        loaded->LoadSettings();
+        {
+            std::lock_guard<std::mutex> lock(updateMutex());
+            *settings = *loaded;
+            std::atomic_store(&snapshot(), std::shared_ptr<const Settings>(loaded));
+        }
+
+        settings->applyLogSettings();
+        LOG(LogLevel::INFOS) << "Settings reloaded.";
+    }
+
+    std::mutex& Settings::updateMutex()
+    {
+        static std::mutex* mutex = new std::mutex();
+        return *mutex;
+    }
+
+    void Settings::applyLogSettings()
+    {
+        std::shared_ptr<const Settings> settings = getSnapshot();
+        LogWriter& writer = LogWriter::getInstance();
+        writer.setRotation(settings->LogMaxFileSize, settings->LogRotationInterval, settings->LogMaxFiles);
+#ifdef _MSC_VER
+        std::string filename = getDllPath() + "/" + settings->LogFileName;
+#else
+        writer.setToStderr(settings->LogToStderr);
+        Logs::logToStderr = settings->LogToStderr;
+        std::string filename = settings->LogFileName;
+#endif
+
+        if (!settings->IsLogEnabled)
+        {
+            if (writer.isOpen())
+                writer.close();
+        }
+        else if (!writer.isOpen() || writer.getFilename() != filename)
+        {
+            writer.open(filename);
+        }
+    }
+
     // Loads log settings structure from the specified XML file
     void Settings::LoadSettings()
     {
@@ -126,6 +211,9 @@ namespace logicalaccess
             SeePluginLog = pt.get("config.log.seeplugin", false);
             ColorizeLog = pt.get("config.log.colorize", false);
             ContextLog = pt.get("config.log.context", false);
+            LogMaxFileSize = pt.get<long int>("config.log.maxfilesize", 0);
+            LogRotationInterval = pt.get<long int>("config.log.rotationinterval", 0);
+            LogMaxFiles = pt.get<int>("config.log.maxfiles", 5);
 
             IsAutoDetectEnabled = pt.get("config.autodetect.enabled", false);
             AutoDetectionTimeout = pt.get<long int>("config.autodetect.timeout", 400);
@@ -182,6 +270,9 @@ namespace logicalaccess
             pt.put("config.log.seeplugin", SeePluginLog);
             pt.put("config.log.colorize", ColorizeLog);
             pt.put("config.log.context", ContextLog);
+            pt.put("config.log.maxfilesize", LogMaxFileSize);
+            pt.put("config.log.rotationinterval", LogRotationInterval);
+            pt.put("config.log.maxfiles", LogMaxFiles);
 
             pt.put("config.autodetect.enabled", IsAutoDetectEnabled);
             pt.put("config.autodetect.timeout", AutoDetectionTimeout);
@@ -210,6 +301,9 @@ namespace logicalaccess
         SeePluginLog = false;
         ColorizeLog = false;
         ContextLog = false;
+        LogMaxFileSize = 0;
+        LogRotationInterval = 0;
+        LogMaxFiles = 5;
 
         IsAutoDetectEnabled = false;
         AutoDetectionTimeout = 400;
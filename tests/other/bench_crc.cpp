@@ -0,0 +1,79 @@
+/**
+ * Compare the table driven CRC functions with the previous implementations.
+ * Usage: bench_crc [buffer size] [iterations]
+ */
+
+#include "logicalaccess/crypto/crc.hpp"
+#include "logicalaccess/crypto/tomcrypt.h"
+#include <boost/crc.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    volatile uint32_t sink;
+
+    void run(const std::string& name, size_t size, size_t iterations, const std::function<uint32_t()>& f)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            sink = f();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << name << ": " << (size * iterations) / seconds / (1024 * 1024) << " MiB/s" << std::endl;
+    }
+}
+
+int main(int ac, char **av)
+{
+    using namespace logicalaccess;
+
+    size_t size = (ac > 1) ? std::strtoul(av[1], NULL, 10) : 256;
+    size_t iterations = (ac > 2) ? std::strtoul(av[2], NULL, 10) : 100000;
+
+    std::vector<unsigned char> data(size);
+    for (size_t i = 0; i < size; ++i)
+        data[i] = static_cast<unsigned char>(i * 31 + 7);
+    const unsigned char* p = &data[0];
+
+    std::cout << "Buffer of " << size << " bytes, " << iterations << " iterations" << std::endl;
+
+    run("CRC_A ComputeCrc", size, iterations, [&]()
+    {
+        unsigned char first, second;
+        ComputeCrc(CRC_A, p, size, &first, &second);
+        return static_cast<uint32_t>(first | (second << 8));
+    });
+    run("CRC_A crc::crc_a", size, iterations, [&]() { return static_cast<uint32_t>(crc::crc_a(p, size)); });
+
+    run("CCITT ComputeCrcCCITT", size, iterations, [&]()
+    {
+        unsigned char first, second;
+        ComputeCrcCCITT(0x1D0F, p, size, &first, &second);
+        return static_cast<uint32_t>(first | (second << 8));
+    });
+    run("CCITT crc::ccitt", size, iterations, [&]() { return static_cast<uint32_t>(crc::ccitt(0x1D0F, p, size)); });
+
+    run("Kermit ComputeCrcKermit", size, iterations, [&]()
+    {
+        unsigned char first, second;
+        ComputeCrcKermit(p, size, &first, &second);
+        return static_cast<uint32_t>(first | (second << 8));
+    });
+    run("Kermit crc::kermit", size, iterations, [&]() { return static_cast<uint32_t>(crc::kermit(p, size)); });
+
+    run("CRC32 boost::crc_32_type", size, iterations, [&]()
+    {
+        boost::crc_32_type result;
+        result.process_bytes(p, size);
+        return result.checksum();
+    });
+    run("CRC32 crc::crc32", size, iterations, [&]() { return crc::crc32(p, size); });
+
+    return 0;
+}
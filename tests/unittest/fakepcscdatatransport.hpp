@@ -0,0 +1,64 @@
+/**
+ * \file fakepcscdatatransport.hpp
+ * \brief A PC/SC data transport without reader, for the unit tests.
+ */
+
+#ifndef LOGICALACCESS_FAKEPCSCDATATRANSPORT_HPP
+#define LOGICALACCESS_FAKEPCSCDATATRANSPORT_HPP
+
+#include "pluginsreaderproviders/pcsc/pcscdatatransport.hpp"
+
+#include <vector>
+
+namespace logicalaccess
+{
+    /**
+     * \brief Record the APDUs sent, the tests emulating the chip in receiveInto().
+     */
+    class FakePCSCDataTransport : public PCSCDataTransport
+    {
+    public:
+
+        virtual void beginTransaction() override {}
+        virtual void endTransaction() override {}
+
+        virtual void send(const std::vector<unsigned char>& data) override { sendBuffer(data.data(), data.size()); }
+
+        virtual std::vector<unsigned char> receive(long int timeout) override
+        {
+            std::vector<unsigned char> result;
+            receiveInto(result, timeout);
+            return result;
+        }
+
+        /**
+         * \brief Count the APDUs sent with an instruction.
+         * \param ins The instruction.
+         * \return The number of APDUs.
+         */
+        size_t count(unsigned char ins) const
+        {
+            size_t n = 0;
+            for (size_t i = 0; i < apdus.size(); ++i)
+            {
+                if (apdus[i][1] == ins)
+                    ++n;
+            }
+            return n;
+        }
+
+        /**
+         * \brief The APDUs sent, in order.
+         */
+        std::vector<std::vector<unsigned char> > apdus;
+
+    protected:
+
+        virtual void sendBuffer(const unsigned char* data, size_t datalen) override
+        {
+            apdus.push_back(std::vector<unsigned char>(data, data + datalen));
+        }
+    };
+}
+
+#endif /* LOGICALACCESS_FAKEPCSCDATATRANSPORT_HPP */
@@ -1,10 +1,28 @@
 #include "logicalaccess/lla_fwd.hpp"
 #include "pluginsreaderproviders/pcsc/atrparser.hpp"
+#include "logicalaccess/bufferhelper.hpp"
+#include "logicalaccess/myexception.hpp"
+#include <boost/filesystem.hpp>
+#include <fstream>
 #include <gtest/gtest.h>
 #include <iostream>
 
 using namespace logicalaccess;
 
+namespace
+{
+    /**
+     * Forget the ATRs registered by a test.
+     */
+    struct RegisteredATRGuard
+    {
+        ~RegisteredATRGuard()
+        {
+            ATRParser::clearRegisteredATR();
+        }
+    };
+}
+
 TEST(test_atr_parser, test_1)
 {
     ASSERT_EQ("DESFire", ATRParser::guessCardType(
@@ -43,3 +61,100 @@ TEST(test_atr_parser, test_hardcoded)
               ATRParser::guessCardType("3B8F8001804F0CA000000306030001000000006A",
                                        PCSC_RUT_ACS_ACR_1222L));
 }
+
+TEST(test_atr_parser, test_wildcard)
+{
+    ASSERT_EQ("MifareUltralight",
+              ATRParser::guessCardType("3BF59100FF918171FE400041000000000005"));
+    ASSERT_EQ("MifareUltralight",
+              ATRParser::guessCardType("3BF59100FF918171FE4000410F0000000005"));
+    // An exact pattern wins over a wildcard one.
+    ASSERT_EQ("Mifare1K",
+              ATRParser::guessCardType("3BF59100FF918171FE400041080000000D"));
+}
+
+TEST(test_atr_parser, test_register)
+{
+    RegisteredATRGuard guard;
+    ASSERT_EQ("GENERIC_T_CL", ATRParser::guessCardType("3B0102030405"));
+
+    ATRParser::registerATR("3B0102030405", "DESFireEV1");
+    ATRParser::registerATR("3B01020304xx", "DESFire");
+    ASSERT_EQ("DESFireEV1", ATRParser::guessCardType("3B0102030405"));
+    ASSERT_EQ("DESFire", ATRParser::guessCardType("3B0102030406"));
+
+    // A reader specific ATR takes precedence for this reader only.
+    ATRParser::registerATR("3B0102030405", "Prox", PCSC_RUT_OMNIKEY_XX27);
+    ASSERT_EQ("Prox",
+              ATRParser::guessCardType("3B0102030405", PCSC_RUT_OMNIKEY_XX27));
+    ASSERT_EQ("DESFireEV1",
+              ATRParser::guessCardType("3B0102030405", PCSC_RUT_SPRINGCARD));
+
+    ASSERT_THROW(ATRParser::registerATR("3B01020", "DESFire"), LibLogicalAccessException);
+    ASSERT_THROW(ATRParser::registerATR("3B0102G3", "DESFire"), LibLogicalAccessException);
+
+    ATRParser::clearRegisteredATR();
+    ASSERT_EQ("GENERIC_T_CL", ATRParser::guessCardType("3B0102030405"));
+    ASSERT_EQ("DESFire", ATRParser::guessCardType("3B8180018080"));
+}
+
+TEST(test_atr_parser, test_load_file)
+{
+    RegisteredATRGuard guard;
+    boost::filesystem::path path =
+        boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    {
+        std::ofstream file(path.string());
+        file << "# Test ATRs" << std::endl;
+        file << "3B0A0B0C0D Mifare4K" << std::endl;
+        file << std::endl;
+        file << "3B0A0B0C0E MifarePlus_SL1_4K " << PCSC_RUT_SPRINGCARD
+             << " # Reader specific" << std::endl;
+    }
+
+    ASSERT_EQ(2u, ATRParser::loadATRFile(path.string()));
+    boost::filesystem::remove(path);
+
+    ASSERT_EQ("Mifare4K", ATRParser::guessCardType("3B0A0B0C0D"));
+    ASSERT_EQ("GENERIC_T_CL", ATRParser::guessCardType("3B0A0B0C0E"));
+    ASSERT_EQ("MifarePlus_SL1_4K",
+              ATRParser::guessCardType("3B0A0B0C0E", PCSC_RUT_SPRINGCARD));
+
+    ASSERT_THROW(ATRParser::loadATRFile(path.string()), LibLogicalAccessException);
+
+    // A bad reader type fails the whole file.
+    {
+        std::ofstream file(path.string());
+        file << "3B0A0B0C0F Mifare1K" << std::endl;
+        file << "3B0A0B0C10 Mifare4K springcard" << std::endl;
+    }
+    try
+    {
+        ATRParser::loadATRFile(path.string());
+        FAIL();
+    }
+    catch (const LibLogicalAccessException &e)
+    {
+        ASSERT_NE(std::string::npos, std::string(e.what()).find("line 2"));
+    }
+    boost::filesystem::remove(path);
+    ASSERT_EQ("GENERIC_T_CL", ATRParser::guessCardType("3B0A0B0C0F"));
+}
+
+TEST(test_atr_parser, test_extended_length)
+{
+    // Card capabilities without / with extended Lc and Le fields.
+    ASSERT_FALSE(ATRParser::supportsExtendedLength(
+        BufferHelper::fromHexString("3B8880010073C84013009000")));
+    ASSERT_TRUE(ATRParser::supportsExtendedLength(
+        BufferHelper::fromHexString("3B8880010073C840C0009000")));
+    ASSERT_TRUE(ATRParser::supportsExtendedLength(
+        BufferHelper::fromHexString("3B85800180730000C0")));
+
+    // No card capabilities.
+    ASSERT_FALSE(ATRParser::supportsExtendedLength(
+        BufferHelper::fromHexString("3B8180018080")));
+    ASSERT_FALSE(ATRParser::supportsExtendedLength(
+        BufferHelper::fromHexString("3B8F8001804F0CA0000003060300010000000069")));
+    ASSERT_FALSE(ATRParser::supportsExtendedLength(ByteVector{0x3B}));
+}
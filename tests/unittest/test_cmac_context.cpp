@@ -0,0 +1,81 @@
+#include "logicalaccess/crypto/cmac.hpp"
+#include "logicalaccess/crypto/aes_cipher.hpp"
+#include "logicalaccess/crypto/aes_initialization_vector.hpp"
+#include "logicalaccess/crypto/aes_symmetric_key.hpp"
+#include "logicalaccess/crypto/des_cipher.hpp"
+#include "logicalaccess/crypto/keyed_cipher_context.hpp"
+#include <gtest/gtest.h>
+
+using namespace logicalaccess;
+using namespace logicalaccess::openssl;
+
+namespace
+{
+    std::vector<unsigned char> sequence(size_t length, unsigned char start)
+    {
+        std::vector<unsigned char> data(length);
+        for (size_t i = 0; i < length; ++i)
+            data[i] = static_cast<unsigned char>(start + i);
+        return data;
+    }
+}
+
+TEST(test_cmac_context, aes_rfc4493)
+{
+    std::vector<unsigned char> key = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    std::vector<unsigned char> message = {0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a};
+    CMACContext context(std::make_shared<AESCipher>(), key);
+
+    ASSERT_EQ(std::vector<unsigned char>({0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46}),
+              context.cmac(std::vector<unsigned char>(), std::vector<unsigned char>(16, 0x00)));
+    ASSERT_EQ(std::vector<unsigned char>({0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c}),
+              context.cmac(message, std::vector<unsigned char>(16, 0x00)));
+}
+
+TEST(test_cmac_context, same_as_cmac_crypto)
+{
+    std::vector<std::pair<std::shared_ptr<OpenSSLSymmetricCipher>, std::vector<unsigned char> > > ciphers;
+    ciphers.push_back(std::make_pair(std::make_shared<AESCipher>(), sequence(16, 0x10)));
+    ciphers.push_back(std::make_pair(std::make_shared<DESCipher>(), sequence(16, 0x20)));
+    ciphers.push_back(std::make_pair(std::make_shared<DESCipher>(), sequence(24, 0x30)));
+
+    for (size_t c = 0; c < ciphers.size(); ++c)
+    {
+        CMACContext context(ciphers[c].first, ciphers[c].second);
+        std::vector<unsigned char> iv = sequence(context.blockSize(), 0x40);
+
+        // The context is reused for all the messages.
+        for (size_t length = 0; length <= 40; ++length)
+        {
+            std::vector<unsigned char> data = sequence(length, static_cast<unsigned char>(length));
+            std::vector<unsigned char> expected = CMACCrypto::cmac(ciphers[c].second, ciphers[c].first, static_cast<unsigned int>(context.blockSize()), data, iv, static_cast<unsigned int>(context.blockSize()));
+            expected.erase(expected.begin(), expected.end() - context.blockSize());
+            ASSERT_EQ(expected, context.cmac(data, iv));
+
+            expected = CMACCrypto::cmac(ciphers[c].second, ciphers[c].first, static_cast<unsigned int>(context.blockSize()), data, iv, 32, true);
+            expected.erase(expected.begin(), expected.end() - context.blockSize());
+            ASSERT_EQ(expected, context.cmac(data, iv, 32, true));
+        }
+    }
+}
+
+TEST(test_cmac_context, keyed_cipher)
+{
+    AESCipher cipher;
+    AESSymmetricKey key = AESSymmetricKey::createFromData(sequence(16, 0x01));
+    KeyedCipherContext context(cipher, key);
+    std::vector<unsigned char> data = sequence(48, 0x80), iv = sequence(16, 0x02), expected, enc, dec;
+
+    cipher.cipher(data, expected, key, AESInitializationVector::createFromData(iv), false);
+    context.cipher(data, enc, iv);
+    ASSERT_EQ(expected, enc);
+
+    context.decipher(enc, dec, iv);
+    ASSERT_EQ(data, dec);
+
+    // In place.
+    context.cipher(&dec[0], dec.size(), &dec[0], &iv[0]);
+    ASSERT_EQ(expected, dec);
+
+    ASSERT_THROW(context.cipher(sequence(15, 0x00), enc, iv), std::invalid_argument);
+}
@@ -0,0 +1,79 @@
+#include "logicalaccess/crypto/crc.hpp"
+#include "logicalaccess/crypto/tomcrypt.h"
+#include <boost/crc.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace logicalaccess;
+
+namespace
+{
+    uint16_t legacy_crc(int type, const std::vector<unsigned char>& data)
+    {
+        unsigned char first, second;
+        ComputeCrc(type, &data[0], data.size(), &first, &second);
+        return static_cast<uint16_t>((second << 8) | first);
+    }
+
+    uint16_t legacy_ccitt(unsigned short init, const std::vector<unsigned char>& data)
+    {
+        unsigned char first, second;
+        ComputeCrcCCITT(init, &data[0], data.size(), &first, &second);
+        return static_cast<uint16_t>((second << 8) | first);
+    }
+
+    uint16_t legacy_kermit(const std::vector<unsigned char>& data)
+    {
+        unsigned char first, second;
+        ComputeCrcKermit(&data[0], data.size(), &first, &second);
+        return static_cast<uint16_t>((second << 8) | first);
+    }
+}
+
+TEST(test_crc, check_values)
+{
+    std::string check("123456789");
+
+    ASSERT_EQ(0xBF05, crc::crc_a(check.data(), check.size()));
+    ASSERT_EQ(0x906E, crc::crc_b(check.data(), check.size()));
+    ASSERT_EQ(0x2189, crc::kermit(check.data(), check.size()));
+    ASSERT_EQ(0x29B1, crc::ccitt(0xFFFF, check.data(), check.size()));
+    ASSERT_EQ(0xE5CC, crc::ccitt(0x1D0F, check.data(), check.size()));
+    ASSERT_EQ(0xCBF43926u, crc::crc32(check.data(), check.size()));
+
+    ASSERT_EQ(0x6363, crc::crc_a(check.data(), 0));
+    ASSERT_EQ(0u, crc::crc32(check.data(), 0));
+}
+
+TEST(test_crc, same_as_legacy)
+{
+    std::vector<unsigned char> data;
+    for (size_t length = 1; length <= 100; ++length)
+    {
+        data.push_back(static_cast<unsigned char>(length * 37 + 11));
+
+        ASSERT_EQ(legacy_crc(CRC_A, data), crc::crc_a(&data[0], data.size()));
+        ASSERT_EQ(legacy_crc(CRC_B, data), crc::crc_b(&data[0], data.size()));
+        ASSERT_EQ(legacy_kermit(data), crc::kermit(&data[0], data.size()));
+        ASSERT_EQ(legacy_ccitt(0xFFFF, data), crc::ccitt(0xFFFF, &data[0], data.size()));
+        ASSERT_EQ(legacy_ccitt(0x1D0F, data), crc::ccitt(0x1D0F, &data[0], data.size()));
+
+        boost::crc_32_type crc32;
+        crc32.process_bytes(&data[0], data.size());
+        ASSERT_EQ(crc32.checksum(), crc::crc32(&data[0], data.size()));
+    }
+}
+
+TEST(test_crc, incremental)
+{
+    std::vector<unsigned char> data(50, 0x5A);
+    data[7] = 0x01;
+
+    uint32_t crc32 = crc::crc32_update(0xFFFFFFFF, &data[0], 13);
+    crc32 = crc::crc32_update(crc32, &data[13], data.size() - 13);
+    ASSERT_EQ(crc::crc32(&data[0], data.size()), ~crc32);
+
+    uint16_t ccitt = crc::ccitt(0x1D0F, &data[0], 21);
+    ASSERT_EQ(crc::ccitt(0x1D0F, &data[0], data.size()), crc::ccitt(ccitt, &data[21], data.size() - 21));
+}
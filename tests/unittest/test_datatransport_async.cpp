@@ -0,0 +1,275 @@
+#include "logicalaccess/readerproviders/tcpdatatransport.hpp"
+#include "logicalaccess/cards/readercardadapter.hpp"
+#include "logicalaccess/myexception.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+using namespace logicalaccess;
+
+namespace
+{
+    /**
+     * Answer each command with its bytes incremented by one.
+     */
+    class FakeDataTransport : public DataTransport
+    {
+    public:
+        FakeDataTransport() : overlap(false), connected(false), exchanging(false) {}
+
+        virtual std::string getTransportType() const { return "Fake"; }
+        virtual bool connect() { connected = true; return true; }
+        virtual void disconnect() { connected = false; }
+        virtual bool isConnected() { return connected; }
+        virtual std::string getName() const { return "Fake"; }
+        virtual void serialize(boost::property_tree::ptree&) {}
+        virtual void unSerialize(boost::property_tree::ptree&) {}
+        virtual std::string getDefaultXmlNodeName() const { return "FakeDataTransport"; }
+
+        std::atomic<bool> overlap;
+
+    protected:
+        virtual void send(const std::vector<unsigned char>& data)
+        {
+            if (data[0] == 0xff)
+                throw std::runtime_error("send");
+            if (exchanging.exchange(true))
+                overlap = true;
+            last = data;
+        }
+
+        virtual std::vector<unsigned char> receive(long int)
+        {
+            std::vector<unsigned char> res(last);
+            for (size_t i = 0; i < res.size(); ++i)
+                ++res[i];
+            exchanging = false;
+            return res;
+        }
+
+        bool connected;
+        std::atomic<bool> exchanging;
+        std::vector<unsigned char> last;
+    };
+
+    /**
+     * Keep the completion handler of the last exchange, to answer it later.
+     */
+    class DeferredDataTransport : public FakeDataTransport
+    {
+    public:
+        CommandHandler pending;
+
+    protected:
+        virtual void exchangeAsync(const std::vector<unsigned char>&, long int, CommandHandler handler)
+        {
+            pending = handler;
+        }
+    };
+
+    /**
+     * Blocking TCP server answering each received chunk with itself, serving connections one after the other.
+     */
+    void echo_server(boost::asio::io_service& ios, boost::asio::ip::tcp::acceptor& acceptor, int connections)
+    {
+        for (int i = 0; i < connections; ++i)
+        {
+            boost::asio::ip::tcp::socket socket(ios);
+            acceptor.accept(socket);
+
+            boost::system::error_code error;
+            unsigned char buf[256];
+            for (;;)
+            {
+                size_t len = socket.read_some(boost::asio::buffer(buf), error);
+                if (error)
+                    break;
+                boost::asio::write(socket, boost::asio::buffer(buf, len), error);
+            }
+        }
+    }
+}
+
+TEST(test_datatransport_async, default_inline)
+{
+    FakeDataTransport transport;
+    transport.setRetainLastExchange(true);
+
+    std::future<std::vector<unsigned char> > res = transport.sendCommandAsync(std::vector<unsigned char>(1, 0x01), 100);
+    ASSERT_EQ(std::vector<unsigned char>(1, 0x02), res.get());
+    ASSERT_EQ(std::vector<unsigned char>(1, 0x02), transport.getLastResult());
+}
+
+TEST(test_datatransport_async, default_exception)
+{
+    FakeDataTransport transport;
+
+    std::future<std::vector<unsigned char> > res = transport.sendCommandAsync(std::vector<unsigned char>(1, 0xff), 100);
+    ASSERT_THROW(res.get(), std::runtime_error);
+
+    // The queue goes on after a failure.
+    res = transport.sendCommandAsync(std::vector<unsigned char>(1, 0x10), 100);
+    ASSERT_EQ(std::vector<unsigned char>(1, 0x11), res.get());
+}
+
+TEST(test_datatransport_async, handler_order)
+{
+    FakeDataTransport transport;
+    std::vector<unsigned char> answers;
+
+    // A command sent from a completion handler is queued after the current one.
+    transport.sendCommandAsync(std::vector<unsigned char>(1, 0x01),
+        [&](std::exception_ptr, const std::vector<unsigned char>& res)
+    {
+        transport.sendCommandAsync(std::vector<unsigned char>(1, 0x03),
+            [&](std::exception_ptr, const std::vector<unsigned char>& res2) { answers.push_back(res2[0]); }, 100);
+        answers.push_back(res[0]);
+    }, 100);
+
+    ASSERT_EQ(2u, answers.size());
+    ASSERT_EQ(0x02, answers[0]);
+    ASSERT_EQ(0x04, answers[1]);
+}
+
+TEST(test_datatransport_async, long_queue)
+{
+    FakeDataTransport transport;
+    size_t answers = 0;
+
+    // Synchronous completions are looped over, not recursed into.
+    transport.sendCommandAsync(std::vector<unsigned char>(1, 0x01),
+        [&](std::exception_ptr, const std::vector<unsigned char>&)
+    {
+        for (int i = 0; i < 100000; ++i)
+        {
+            transport.sendCommandAsync(std::vector<unsigned char>(1, 0x01),
+                [&](std::exception_ptr, const std::vector<unsigned char>&) { ++answers; }, 100);
+        }
+    }, 100);
+
+    ASSERT_EQ(100000u, answers);
+}
+
+TEST(test_datatransport_async, handler_non_std_exception)
+{
+    FakeDataTransport transport;
+
+    transport.sendCommandAsync(std::vector<unsigned char>(1, 0x01),
+        [](std::exception_ptr, const std::vector<unsigned char>&) { throw 42; }, 100);
+
+    // The queue is not left busy.
+    std::future<std::vector<unsigned char> > res = transport.sendCommandAsync(std::vector<unsigned char>(1, 0x10), 100);
+    ASSERT_EQ(std::vector<unsigned char>(1, 0x11), res.get());
+}
+
+TEST(test_datatransport_async, sync_and_async)
+{
+    FakeDataTransport transport;
+    transport.setRetainLastExchange(true);
+
+    std::thread async_sender([&transport]()
+    {
+        for (unsigned char i = 0; i < 200; ++i)
+        {
+            transport.sendCommandAsync(std::vector<unsigned char>(1, i), 100);
+        }
+    });
+    for (unsigned char i = 0; i < 200; ++i)
+    {
+        ASSERT_EQ(std::vector<unsigned char>(1, i + 1), transport.sendCommand(std::vector<unsigned char>(1, i), 100));
+    }
+    async_sender.join();
+    ASSERT_FALSE(transport.overlap);
+
+    // A completion handler can send a synchronous command.
+    std::vector<unsigned char> answer;
+    transport.sendCommandAsync(std::vector<unsigned char>(1, 0x01),
+        [&](std::exception_ptr, const std::vector<unsigned char>&)
+    {
+        answer = transport.sendCommand(std::vector<unsigned char>(1, 0x20), 100);
+    }, 100);
+    ASSERT_EQ(std::vector<unsigned char>(1, 0x21), answer);
+}
+
+TEST(test_datatransport_async, adapter_released)
+{
+    std::shared_ptr<DeferredDataTransport> transport(new DeferredDataTransport());
+    std::shared_ptr<ReaderCardAdapter> adapter(new ReaderCardAdapter());
+    adapter->setDataTransport(transport);
+
+    std::future<std::vector<unsigned char> > res = adapter->sendCommandAsync(std::vector<unsigned char>(1, 0x01), 100);
+    ASSERT_TRUE(bool(transport->pending));
+
+    // The answer comes in after the adapter is gone.
+    adapter.reset();
+    transport->pending(std::exception_ptr(), std::vector<unsigned char>(1, 0x02));
+    ASSERT_THROW(res.get(), LibLogicalAccessException);
+}
+
+TEST(test_datatransport_async, tcp_pipeline)
+{
+    boost::asio::io_service ios;
+    boost::asio::ip::tcp::acceptor acceptor(ios, boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0));
+    // The synchronous API reconnects on each command, hence a second connection.
+    std::thread server(echo_server, std::ref(ios), std::ref(acceptor), 2);
+
+    TcpDataTransport transport;
+    transport.setIpAddress("127.0.0.1");
+    transport.setPort(acceptor.local_endpoint().port());
+
+    std::vector<std::future<std::vector<unsigned char> > > results;
+    for (unsigned char i = 1; i <= 5; ++i)
+    {
+        results.push_back(transport.sendCommandAsync(std::vector<unsigned char>(3, i), 1000));
+    }
+
+    for (unsigned char i = 1; i <= 5; ++i)
+    {
+        ASSERT_EQ(std::vector<unsigned char>(3, i), results[i - 1].get());
+    }
+
+    // The synchronous API still works along.
+    ASSERT_EQ(std::vector<unsigned char>(2, 0x42), transport.sendCommand(std::vector<unsigned char>(2, 0x42), 1000));
+
+    transport.disconnect();
+    ASSERT_FALSE(transport.isConnected());
+    server.join();
+}
+
+TEST(test_datatransport_async, tcp_connection_refused)
+{
+    boost::asio::io_service ios;
+    unsigned short port;
+    {
+        boost::asio::ip::tcp::acceptor acceptor(ios, boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0));
+        port = acceptor.local_endpoint().port();
+    }
+
+    TcpDataTransport transport;
+    transport.setIpAddress("127.0.0.1");
+    transport.setPort(port);
+
+    std::future<std::vector<unsigned char> > res = transport.sendCommandAsync(std::vector<unsigned char>(1, 0x01), 500);
+    ASSERT_THROW(res.get(), LibLogicalAccessException);
+}
+
+TEST(test_datatransport_async, tcp_destroyed_pending)
+{
+    boost::asio::io_service ios;
+    // Accept connections but never answer.
+    boost::asio::ip::tcp::acceptor acceptor(ios, boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0));
+
+    std::future<std::vector<unsigned char> > first, second;
+    {
+        TcpDataTransport transport;
+        transport.setIpAddress("127.0.0.1");
+        transport.setPort(acceptor.local_endpoint().port());
+
+        first = transport.sendCommandAsync(std::vector<unsigned char>(1, 0x01), 5000);
+        second = transport.sendCommandAsync(std::vector<unsigned char>(1, 0x02), 5000);
+    }
+
+    ASSERT_THROW(first.get(), LibLogicalAccessException);
+    ASSERT_THROW(second.get(), LibLogicalAccessException);
+}
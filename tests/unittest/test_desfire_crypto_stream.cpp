@@ -0,0 +1,107 @@
+#include "pluginscards/desfire/desfirecrypto.hpp"
+#include "logicalaccess/crypto/cmac.hpp"
+#include "logicalaccess/crypto/keyed_cipher_context.hpp"
+#include "logicalaccess/crypto/aes_symmetric_key.hpp"
+#include "logicalaccess/myexception.hpp"
+#include <gtest/gtest.h>
+
+using namespace logicalaccess;
+
+namespace
+{
+    /**
+     * Set an AES ISO session, as after authentication.
+     */
+    void iso_session(DESFireCrypto& crypto)
+    {
+        crypto.d_auth_method = CM_ISO;
+        crypto.d_cipher.reset(new openssl::AESCipher());
+        crypto.d_block_size = 16;
+        crypto.d_mac_size = 8;
+        crypto.d_sessionKey = std::vector<unsigned char>(16, 0x5A);
+        crypto.d_lastIV = std::vector<unsigned char>(16, 0x00);
+    }
+
+    std::vector<unsigned char> sequence(size_t length)
+    {
+        std::vector<unsigned char> data(length);
+        for (size_t i = 0; i < length; ++i)
+            data[i] = static_cast<unsigned char>(i * 7);
+        return data;
+    }
+
+    /**
+     * Feed a response by frames of the reader size, as the additional frames come.
+     */
+    bool verify_by_frames(DESFireCrypto& crypto, const std::vector<unsigned char>& response, size_t frame)
+    {
+        crypto.initBuf();
+        size_t i = 0;
+        for (; i + frame < response.size(); i += frame)
+        {
+            crypto.verifyMAC(false, std::vector<unsigned char>(response.begin() + i, response.begin() + i + frame));
+        }
+        return crypto.verifyMAC(true, std::vector<unsigned char>(response.begin() + i, response.end()));
+    }
+}
+
+TEST(test_desfire_crypto_stream, mac_by_frames)
+{
+    for (size_t length = 1; length <= 120; length += 17)
+    {
+        std::vector<unsigned char> data = sequence(length);
+        std::vector<unsigned char> macbuf = data;
+        macbuf.push_back(0x00);
+        std::vector<unsigned char> mac = openssl::CMACContext(std::make_shared<openssl::AESCipher>(), std::vector<unsigned char>(16, 0x5A)).cmac(macbuf, std::vector<unsigned char>(16, 0x00));
+        std::vector<unsigned char> response = data;
+        response.insert(response.end(), mac.begin(), mac.begin() + 8);
+
+        for (size_t frame = 1; frame <= 59; frame += 29)
+        {
+            DESFireCrypto crypto;
+            iso_session(crypto);
+            ASSERT_TRUE(verify_by_frames(crypto, response, frame));
+            // The IV goes on with the last CMAC.
+            ASSERT_EQ(mac, crypto.d_lastIV);
+
+            iso_session(crypto);
+            std::vector<unsigned char> altered = response;
+            altered[0] ^= 0x01;
+            ASSERT_FALSE(verify_by_frames(crypto, altered, frame));
+        }
+    }
+}
+
+TEST(test_desfire_crypto_stream, decipher_by_frames)
+{
+    std::vector<unsigned char> data = sequence(100);
+    std::vector<unsigned char> plain = data;
+    std::vector<unsigned char> crcbuf = data;
+    crcbuf.push_back(0x00);
+    uint32_t crc = DESFireCrypto::desfire_crc32(&crcbuf[0], crcbuf.size());
+    plain.push_back(static_cast<unsigned char>(crc & 0xff));
+    plain.push_back(static_cast<unsigned char>((crc >> 8) & 0xff));
+    plain.push_back(static_cast<unsigned char>((crc >> 16) & 0xff));
+    plain.push_back(static_cast<unsigned char>((crc >> 24) & 0xff));
+    plain.resize(112, 0x00);
+
+    std::vector<unsigned char> encrypted;
+    openssl::AESCipher cipher;
+    openssl::KeyedCipherContext(cipher, openssl::AESSymmetricKey::createFromData(std::vector<unsigned char>(16, 0x5A))).cipher(plain, encrypted, std::vector<unsigned char>(16, 0x00));
+
+    DESFireCrypto crypto;
+    iso_session(crypto);
+    crypto.initBuf();
+    for (size_t i = 0; i < encrypted.size(); i += 59)
+    {
+        crypto.appendDecipherData(std::vector<unsigned char>(encrypted.begin() + i, encrypted.begin() + std::min(i + 59, encrypted.size())));
+    }
+    ASSERT_EQ(data, crypto.desfireDecrypt(100));
+    ASSERT_EQ(std::vector<unsigned char>(encrypted.end() - 16, encrypted.end()), crypto.d_lastIV);
+
+    // A wrong CRC is detected.
+    iso_session(crypto);
+    crypto.initBuf();
+    crypto.appendDecipherData(encrypted);
+    ASSERT_THROW(crypto.desfireDecrypt(99), LibLogicalAccessException);
+}
@@ -0,0 +1,239 @@
+#include "pluginsreaderproviders/iso7816/commands/desfireev1iso7816commands.hpp"
+#include "pluginsreaderproviders/iso7816/commands/desfireiso7816resultchecker.hpp"
+#include "pluginsreaderproviders/pcsc/readercardadapters/pcscreadercardadapter.hpp"
+#include "pluginscards/desfire/desfireev1chip.hpp"
+#include "pluginscards/desfire/desfirestoragecardservice.hpp"
+#include "pluginscards/desfire/desfirecrypto.hpp"
+#include "logicalaccess/crypto/aes_cipher.hpp"
+#include "fakepcscdatatransport.hpp"
+#include <gtest/gtest.h>
+
+using namespace logicalaccess;
+
+namespace
+{
+    std::vector<unsigned char> file_content(unsigned char fileno, size_t size)
+    {
+        std::vector<unsigned char> data(size);
+        for (size_t i = 0; i < size; ++i)
+            data[i] = static_cast<unsigned char>(fileno * 0x10 + i);
+        return data;
+    }
+
+    /**
+     * Emulate the standard data files of a DESFire EV1 with free read access, answering by frames of 59 bytes.
+     * With a mirror of the session, the commands are MACed and the responses carry their CMAC, or their MAC in legacy mode.
+     */
+    class DESFireTransport : public FakePCSCDataTransport
+    {
+    public:
+        DESFireTransport() : fileSize(300), transactions(0) {}
+
+        virtual void beginTransaction() override { ++transactions; }
+
+        std::shared_ptr<DESFireCrypto> mirror;
+        size_t fileSize;
+        int transactions;
+
+    protected:
+
+        virtual void receiveInto(std::vector<unsigned char>& result, long int) override
+        {
+            const std::vector<unsigned char>& last = apdus.back();
+            result.clear();
+            bool legacy = mirror && mirror->d_auth_method == CM_LEGACY;
+            if (last[1] == DF_INS_READ_DATA)
+            {
+                // A new command aborts the pending frames.
+                EXPECT_TRUE(pending.empty());
+                if (mirror && !legacy)
+                {
+                    std::vector<unsigned char> command(1, DF_INS_READ_DATA);
+                    command.insert(command.end(), last.begin() + 5, last.begin() + 12);
+                    mirror->desfire_cmac(command);
+                }
+
+                size_t offset = last[6] | (last[7] << 8) | (last[8] << 16);
+                size_t length = last[9] | (last[10] << 8) | (last[11] << 16);
+                std::vector<unsigned char> content = file_content(last[5], fileSize);
+                pending.assign(content.begin() + offset, content.begin() + offset + length);
+                if (legacy)
+                {
+                    std::vector<unsigned char> mac = mirror->desfire_mac(mirror->d_sessionKey, pending);
+                    pending.insert(pending.end(), mac.begin(), mac.end());
+                }
+                else if (mirror)
+                {
+                    std::vector<unsigned char> macbuf = pending;
+                    macbuf.push_back(0x00);
+                    std::vector<unsigned char> mac = mirror->desfire_cmac(macbuf);
+                    pending.insert(pending.end(), mac.begin(), mac.end());
+                }
+            }
+            else if (last[1] == DF_INS_GET_FILE_SETTINGS)
+            {
+                // Standard data file, plain, free read and write access.
+                const unsigned char settings[] = { 0x00, 0x00, 0xEE, 0xEE,
+                    static_cast<unsigned char>(fileSize & 0xff), static_cast<unsigned char>((fileSize >> 8) & 0xff), 0x00 };
+                result.assign(settings, settings + sizeof(settings));
+            }
+
+            if (last[1] == DF_INS_READ_DATA || last[1] == DF_INS_ADDITIONAL_FRAME)
+            {
+                size_t frame = (pending.size() > 59) ? 59 : pending.size();
+                result.assign(pending.begin(), pending.begin() + frame);
+                pending.erase(pending.begin(), pending.begin() + frame);
+                result.push_back(0x91);
+                result.push_back(pending.empty() ? 0x00 : DF_INS_ADDITIONAL_FRAME);
+                return;
+            }
+
+            result.push_back(0x91);
+            result.push_back(0x00);
+        }
+
+        std::vector<unsigned char> pending;
+    };
+
+    /**
+     * Set an AES ISO session, as after authentication.
+     */
+    void iso_session(DESFireCrypto& crypto)
+    {
+        crypto.d_auth_method = CM_ISO;
+        crypto.d_cipher.reset(new openssl::AESCipher());
+        crypto.d_block_size = 16;
+        crypto.d_mac_size = 8;
+        crypto.d_sessionKey = std::vector<unsigned char>(16, 0x5A);
+        crypto.d_lastIV = std::vector<unsigned char>(16, 0x00);
+    }
+
+    /**
+     * Set a legacy DESFire session, as after authentication with a 3DES key.
+     */
+    void legacy_session(DESFireCrypto& crypto)
+    {
+        crypto.d_auth_method = CM_LEGACY;
+        crypto.d_block_size = 8;
+        crypto.d_mac_size = 4;
+        crypto.d_sessionKey = std::vector<unsigned char>(8, 0x11);
+        crypto.d_sessionKey.insert(crypto.d_sessionKey.end(), 8, 0x22);
+    }
+
+    struct Fixture
+    {
+        Fixture()
+        {
+            transport = std::make_shared<DESFireTransport>();
+            transport->setReaderUnit(std::make_shared<PCSCReaderUnit>("Fake"));
+            std::shared_ptr<PCSCReaderCardAdapter> rca = std::make_shared<PCSCReaderCardAdapter>();
+            rca->setDataTransport(transport);
+            rca->setResultChecker(std::make_shared<DESFireISO7816ResultChecker>());
+            commands = std::make_shared<DESFireEV1ISO7816Commands>();
+            commands->setReaderCardAdapter(rca);
+            chip = std::make_shared<DESFireEV1Chip>();
+            chip->setCommands(commands);
+            commands->setChip(chip);
+        }
+
+        std::vector<DESFireCommands::FileRead> files() const
+        {
+            DESFireCommands::FileRead file;
+            file.mode = CM_PLAIN;
+            std::vector<DESFireCommands::FileRead> files;
+            file.fileno = 1; file.offset = 0; file.length = 40;
+            files.push_back(file);
+            file.fileno = 2; file.offset = 10; file.length = 260;
+            files.push_back(file);
+            file.fileno = 3; file.offset = 0; file.length = 8;
+            files.push_back(file);
+            return files;
+        }
+
+        void expect_files(const std::vector<std::vector<unsigned char> >& result) const
+        {
+            std::vector<unsigned char> file2 = file_content(2, transport->fileSize);
+            ASSERT_EQ(3u, result.size());
+            ASSERT_EQ(file_content(1, 40), result[0]);
+            ASSERT_EQ(std::vector<unsigned char>(file2.begin() + 10, file2.begin() + 270), result[1]);
+            ASSERT_EQ(file_content(3, 8), result[2]);
+        }
+
+        std::shared_ptr<DESFireTransport> transport;
+        std::shared_ptr<DESFireEV1ISO7816Commands> commands;
+        std::shared_ptr<DESFireEV1Chip> chip;
+    };
+}
+
+TEST(test_desfire_read_files, legacy_batch)
+{
+    Fixture f;
+
+    f.expect_files(f.commands->readFiles(f.files()));
+
+    // The second file takes two commands, the frames are chained in the batch.
+    ASSERT_EQ(4u, f.transport->count(DF_INS_READ_DATA));
+    ASSERT_EQ(4u, f.transport->count(DF_INS_ADDITIONAL_FRAME));
+    ASSERT_EQ(1, f.transport->transactions);
+}
+
+TEST(test_desfire_read_files, cmac_sequence)
+{
+    Fixture f;
+    iso_session(*f.chip->getCrypto());
+    f.transport->mirror = std::make_shared<DESFireCrypto>();
+    iso_session(*f.transport->mirror);
+
+    // Each response MAC is checked against the IV chained by the previous commands.
+    f.expect_files(f.commands->readFiles(f.files()));
+    ASSERT_EQ(4u, f.transport->count(DF_INS_READ_DATA));
+    ASSERT_EQ(1, f.transport->transactions);
+    ASSERT_EQ(f.transport->mirror->d_lastIV, f.chip->getCrypto()->d_lastIV);
+
+    // A response MACed with another IV is rejected.
+    f.transport->mirror->d_lastIV = std::vector<unsigned char>(16, 0x01);
+    ASSERT_THROW(f.commands->readFiles(f.files()), LibLogicalAccessException);
+}
+
+TEST(test_desfire_read_files, storage)
+{
+    Fixture f;
+    DESFireStorageCardService storage(f.chip);
+    std::shared_ptr<DESFireLocation> location = std::make_shared<DESFireLocation>();
+    location->aid = 0x000001;
+
+    std::vector<DESFireCommands::FileRead> files = f.files();
+    f.expect_files(storage.readFiles(location, std::shared_ptr<AccessInfo>(), files));
+    ASSERT_EQ(1u, f.transport->count(DF_INS_SELECT_APPLICATION));
+    ASSERT_EQ(3u, f.transport->count(DF_INS_GET_FILE_SETTINGS));
+    ASSERT_EQ(4u, f.transport->count(DF_INS_READ_DATA));
+
+    // The application and the file settings are not asked again.
+    f.expect_files(storage.readFiles(location, std::shared_ptr<AccessInfo>(), files));
+    ASSERT_EQ(1u, f.transport->count(DF_INS_SELECT_APPLICATION));
+    ASSERT_EQ(3u, f.transport->count(DF_INS_GET_FILE_SETTINGS));
+    ASSERT_EQ(8u, f.transport->count(DF_INS_READ_DATA));
+}
+
+TEST(test_desfire_read_files, legacy_mac_read)
+{
+    std::shared_ptr<DESFireTransport> transport = std::make_shared<DESFireTransport>();
+    transport->setReaderUnit(std::make_shared<PCSCReaderUnit>("Fake"));
+    std::shared_ptr<PCSCReaderCardAdapter> rca = std::make_shared<PCSCReaderCardAdapter>();
+    rca->setDataTransport(transport);
+    rca->setResultChecker(std::make_shared<DESFireISO7816ResultChecker>());
+    std::shared_ptr<DESFireISO7816Commands> commands = std::make_shared<DESFireISO7816Commands>();
+    commands->setReaderCardAdapter(rca);
+    std::shared_ptr<DESFireChip> chip = std::make_shared<DESFireChip>();
+    chip->setCommands(commands);
+    commands->setChip(chip);
+    legacy_session(*chip->getCrypto());
+    transport->mirror = std::make_shared<DESFireCrypto>();
+    legacy_session(*transport->mirror);
+
+    // The frames of the first command are all fetched before the second one, each MAC covering its command.
+    ASSERT_EQ(file_content(1, 300), commands->readData(1, 0, 300, CM_MAC));
+    ASSERT_EQ(2u, transport->count(DF_INS_READ_DATA));
+    ASSERT_EQ(4u, transport->count(DF_INS_ADDITIONAL_FRAME));
+    ASSERT_EQ(1, transport->transactions);
+}
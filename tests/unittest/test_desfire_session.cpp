@@ -0,0 +1,63 @@
+#include "pluginscards/desfire/desfirecrypto.hpp"
+#include "pluginscards/desfire/desfirekey.hpp"
+#include <gtest/gtest.h>
+
+using namespace logicalaccess;
+
+namespace
+{
+    /**
+     * Simulate a completed authentication on the current application.
+     */
+    void authenticated(DESFireCrypto& crypto, unsigned char keyno, std::shared_ptr<DESFireKey> key, unsigned char sessionByte)
+    {
+        crypto.d_currentKeyNo = keyno;
+        crypto.d_sessionKey = std::vector<unsigned char>(8, sessionByte);
+        crypto.setAuthenticatedKey(key);
+    }
+}
+
+TEST(test_desfire_session, selection)
+{
+    DESFireCrypto crypto;
+    ASSERT_FALSE(crypto.isApplicationSelected(0));
+
+    crypto.selectApplication(0x123456);
+    ASSERT_TRUE(crypto.isApplicationSelected(0x123456));
+    ASSERT_FALSE(crypto.isApplicationSelected(0x654321));
+
+    crypto.invalidateSession();
+    ASSERT_FALSE(crypto.isApplicationSelected(0x123456));
+}
+
+TEST(test_desfire_session, authentication)
+{
+    DESFireCrypto crypto;
+    std::shared_ptr<DESFireKey> key(new DESFireKey(std::string("01 02 03 04 05 06 07 08 01 02 03 04 05 06 07 08")));
+    std::shared_ptr<DESFireKey> copy = std::make_shared<DESFireKey>(*key);
+    std::shared_ptr<DESFireKey> other(new DESFireKey(std::string("08 07 06 05 04 03 02 01 08 07 06 05 04 03 02 01")));
+
+    crypto.selectApplication(0x123456);
+    ASSERT_FALSE(crypto.isAuthenticated(0x123456, 1, key));
+
+    authenticated(crypto, 1, key, 0x42);
+    ASSERT_TRUE(crypto.isAuthenticated(0x123456, 1, key));
+    ASSERT_TRUE(crypto.isAuthenticated(0x123456, 1, copy));
+    ASSERT_FALSE(crypto.isAuthenticated(0x123456, 2, key));
+    ASSERT_FALSE(crypto.isAuthenticated(0x123456, 1, other));
+    ASSERT_FALSE(crypto.isAuthenticated(0x654321, 1, key));
+
+    // Another authentication took place without recording its key.
+    crypto.d_sessionKey = std::vector<unsigned char>(8, 0x43);
+    ASSERT_FALSE(crypto.isAuthenticated(0x123456, 1, key));
+
+    authenticated(crypto, 1, key, 0x44);
+    crypto.invalidateSession();
+    ASSERT_FALSE(crypto.isAuthenticated(0x123456, 1, key));
+
+    // Selecting an application drops the authentication.
+    crypto.selectApplication(0x123456);
+    authenticated(crypto, 1, key, 0x45);
+    crypto.selectApplication(0x123456);
+    ASSERT_FALSE(crypto.isAuthenticated(0x123456, 1, key));
+}
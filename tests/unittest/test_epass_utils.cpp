@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 #include <iostream>
 #include <logicalaccess/bufferhelper.hpp>
+#include <logicalaccess/crypto/des_helper.hpp>
 #include <logicalaccess/logs.hpp>
 #include <pluginscards/epass/epasscrypto.hpp>
 
@@ -148,6 +149,54 @@ TEST(test_epass_utils, test_secure_messaging_3)
         decrypted_response);
 }
 
+TEST(test_epass_utils, test_secure_messaging_extended)
+{
+    auto ks_enc = BufferHelper::fromHexString("979EC13B1CBFE9DCD01AB0FED307EAE5");
+    auto ks_mac = BufferHelper::fromHexString("F1CB1F1FB5ADF208806B89DC579DC1F8");
+    auto ssc    = BufferHelper::fromHexString("887022120C06C22C");
+
+    // Read Binary with an extended Le: both the DO'97' and the protected APDU are
+    // extended.
+    auto encrypted_apdu =
+        EPassUtils::encrypt_apdu(BufferHelper::fromHexString("00B00004001000"), ks_enc,
+                                 ks_mac, ssc);
+    ASSERT_EQ(23u, encrypted_apdu.size());
+    ASSERT_EQ(BufferHelper::fromHexString("0CB0000400000E97021000"),
+              ByteVector(encrypted_apdu.begin(), encrypted_apdu.begin() + 11));
+    ASSERT_EQ(BufferHelper::fromHexString("0000"),
+              ByteVector(encrypted_apdu.end() - 2, encrypted_apdu.end()));
+
+    // Response with more than 127 bytes of data, hence a long form DO'87' length.
+    ByteVector plain(600);
+    for (size_t i = 0; i < plain.size(); ++i)
+        plain[i] = static_cast<uint8_t>(i);
+
+    auto encrypted = DESHelper::DESEncrypt(EPassUtils::pad(plain), ks_enc, {});
+    ByteVector do_87 = {0x87, 0x82, static_cast<uint8_t>((encrypted.size() + 1) >> 8),
+                        static_cast<uint8_t>((encrypted.size() + 1) & 0xFF), 0x01};
+    do_87.insert(do_87.end(), encrypted.begin(), encrypted.end());
+    ByteVector do_99 = {0x99, 0x02, 0x90, 0x00};
+
+    auto rapdu_ssc = EPassUtils::increment_ssc(ssc);
+    ByteVector K   = EPassUtils::increment_ssc(rapdu_ssc);
+    K.insert(K.end(), do_87.begin(), do_87.end());
+    K.insert(K.end(), do_99.begin(), do_99.end());
+    auto CC = EPassUtils::compute_mac(EPassUtils::pad(K), ks_mac);
+
+    ByteVector rapdu(do_87);
+    rapdu.insert(rapdu.end(), do_99.begin(), do_99.end());
+    rapdu.push_back(0x8E);
+    rapdu.push_back(0x08);
+    rapdu.insert(rapdu.end(), CC.begin(), CC.end());
+    rapdu.push_back(0x90);
+    rapdu.push_back(0x00);
+
+    auto expected = plain;
+    expected.push_back(0x90);
+    expected.push_back(0x00);
+    ASSERT_EQ(expected, EPassUtils::decrypt_rapdu(rapdu, ks_enc, ks_mac, rapdu_ssc));
+}
+
 TEST(test_epass_utils, test_parse_ef_com)
 {
     auto raw = BufferHelper::fromHexString(
@@ -0,0 +1,201 @@
+#include "pluginsreaderproviders/pcsc/commands/felicascmcommands.hpp"
+#include "pluginsreaderproviders/pcsc/commands/felicaspringcardcommands.hpp"
+#include "pluginscards/felica/felicachip.hpp"
+#include "pluginscards/felica/felicastoragecardservice.hpp"
+#include "fakepcscdatatransport.hpp"
+#include <gtest/gtest.h>
+
+using namespace logicalaccess;
+
+namespace
+{
+    /**
+     * Emulate the blocks of a FeliCa chip, each byte being its block number, and record the APDUs.
+     */
+    class FeliCaTransport : public FakePCSCDataTransport
+    {
+    public:
+        FeliCaTransport() : maxLength(0xFF), chipError(false) {}
+
+        std::vector<unsigned char> written;
+        size_t maxLength;
+        bool chipError;
+
+    protected:
+
+        virtual void receiveInto(std::vector<unsigned char>& result, long int) override
+        {
+            const std::vector<unsigned char>& last = apdus.back();
+            result.clear();
+            if (last[1] == 0x46)
+            {
+                // SCM, no Lc: IDm, status flags, blocks count, then the blocks
+                result.assign(10, 0x00);
+                result.push_back(last[3]);
+                for (unsigned char i = 0; i < last[3]; ++i)
+                    result.insert(result.end(), 16, last[4 + last[2] * 2 + i * 2 + 1]);
+            }
+            else if (last[1] == 0x48)
+            {
+                result.assign(10, 0x00);
+                written.insert(written.end(), last.begin() + 4 + last[2] * 2 + last[3] * 2, last.end());
+            }
+            else if ((last[1] == 0xB0 || last[1] == 0xD6) && chipError)
+            {
+                throw CardException("Memory failure.", CardException::MEMORY_FAILURE);
+            }
+            else if (last[1] == 0xB0)
+            {
+                if (last[4] > maxLength)
+                {
+                    throw CardException("Wrong length.", CardException::WRONG_LENGTH);
+                }
+                for (size_t i = 0; i < last[4]; ++i)
+                    result.push_back(static_cast<unsigned char>(last[3] + i / 16));
+            }
+            else if (last[1] == 0xD6)
+            {
+                if (last[4] > maxLength)
+                {
+                    throw CardException("Wrong length.", CardException::WRONG_LENGTH);
+                }
+                written.insert(written.end(), last.begin() + 5, last.end());
+            }
+            result.push_back(0x90);
+            result.push_back(0x00);
+        }
+    };
+
+    template<typename T>
+    struct Fixture
+    {
+        Fixture()
+        {
+            transport = std::make_shared<FeliCaTransport>();
+            transport->setReaderUnit(std::make_shared<PCSCReaderUnit>("Fake"));
+            std::shared_ptr<PCSCReaderCardAdapter> rca = std::make_shared<PCSCReaderCardAdapter>();
+            rca->setDataTransport(transport);
+            commands = std::make_shared<T>();
+            commands->setReaderCardAdapter(rca);
+            chip = std::make_shared<FeliCaChip>();
+            chip->setCommands(commands);
+            commands->setChip(chip);
+            location = std::make_shared<FeliCaLocation>();
+            location->code = FELICA_CODE_NDEF_READ;
+            location->block = 1;
+        }
+
+        std::shared_ptr<FeliCaTransport> transport;
+        std::shared_ptr<T> commands;
+        std::shared_ptr<FeliCaChip> chip;
+        std::shared_ptr<FeliCaLocation> location;
+    };
+
+    std::vector<unsigned char> expected_blocks(int start_block, int count)
+    {
+        std::vector<unsigned char> data;
+        for (int i = 0; i < count; ++i)
+            data.insert(data.end(), 16, static_cast<unsigned char>(start_block + i));
+        return data;
+    }
+}
+
+TEST(test_felica_multiple_blocks, scm_read)
+{
+    Fixture<FeliCaSCMCommands> f;
+    FeliCaStorageCardService storage(f.chip);
+
+    ASSERT_EQ(expected_blocks(1, 13), storage.readData(f.location, std::shared_ptr<AccessInfo>(), 13 * 16, CB_AUTOSWITCHAREA));
+    ASSERT_EQ(4u, f.transport->count(0x46));
+
+    // A tag advertising more blocks per command.
+    f.commands->setMaxBlocks(13, 1);
+    ASSERT_EQ(expected_blocks(1, 13), storage.readData(f.location, std::shared_ptr<AccessInfo>(), 13 * 16, CB_AUTOSWITCHAREA));
+    ASSERT_EQ(5u, f.transport->count(0x46));
+}
+
+TEST(test_felica_multiple_blocks, scm_write)
+{
+    Fixture<FeliCaSCMCommands> f;
+    FeliCaStorageCardService storage(f.chip);
+    f.commands->setMaxBlocks(4, 2);
+
+    std::vector<unsigned char> data(40, 0x42);
+    storage.writeData(f.location, std::shared_ptr<AccessInfo>(), std::shared_ptr<AccessInfo>(), data, CB_AUTOSWITCHAREA);
+    ASSERT_EQ(2u, f.transport->count(0x48));
+    data.resize(48, 0x00);
+    ASSERT_EQ(data, f.transport->written);
+}
+
+TEST(test_felica_multiple_blocks, springcard)
+{
+    Fixture<FeliCaSpringCardCommands> f;
+    FeliCaStorageCardService storage(f.chip);
+    f.commands->setMaxBlocks(15, 15);
+
+    ASSERT_EQ(expected_blocks(1, 13), storage.readData(f.location, std::shared_ptr<AccessInfo>(), 13 * 16, CB_AUTOSWITCHAREA));
+    ASSERT_EQ(1u, f.transport->count(0xB0));
+
+    std::vector<unsigned char> data(48, 0x42);
+    storage.writeData(f.location, std::shared_ptr<AccessInfo>(), std::shared_ptr<AccessInfo>(), data, CB_AUTOSWITCHAREA);
+    ASSERT_EQ(1u, f.transport->count(0xD6));
+    ASSERT_EQ(data, f.transport->written);
+}
+
+TEST(test_felica_multiple_blocks, springcard_fallback)
+{
+    Fixture<FeliCaSpringCardCommands> f;
+    FeliCaStorageCardService storage(f.chip);
+    f.transport->maxLength = 16;
+
+    ASSERT_EQ(expected_blocks(1, 3), storage.readData(f.location, std::shared_ptr<AccessInfo>(), 3 * 16, CB_AUTOSWITCHAREA));
+    ASSERT_EQ(4u, f.transport->count(0xB0));
+
+    // The reader is not asked again.
+    ASSERT_EQ(expected_blocks(1, 2), storage.readData(f.location, std::shared_ptr<AccessInfo>(), 2 * 16, CB_AUTOSWITCHAREA));
+    ASSERT_EQ(6u, f.transport->count(0xB0));
+}
+
+TEST(test_felica_multiple_blocks, springcard_chip_error)
+{
+    Fixture<FeliCaSpringCardCommands> f;
+    FeliCaStorageCardService storage(f.chip);
+    f.transport->chipError = true;
+
+    // A chip failure is reported, not taken for a reader limitation.
+    ASSERT_THROW(storage.readData(f.location, std::shared_ptr<AccessInfo>(), 3 * 16, CB_AUTOSWITCHAREA), CardException);
+    ASSERT_EQ(1u, f.transport->count(0xB0));
+
+    f.transport->chipError = false;
+    ASSERT_EQ(expected_blocks(1, 3), storage.readData(f.location, std::shared_ptr<AccessInfo>(), 3 * 16, CB_AUTOSWITCHAREA));
+    ASSERT_EQ(2u, f.transport->count(0xB0));
+}
+
+TEST(test_felica_multiple_blocks, reader_limits)
+{
+    // A tag advertising more blocks per command than the readers pass.
+    Fixture<FeliCaSCMCommands> scm;
+    FeliCaStorageCardService scmStorage(scm.chip);
+    scm.commands->setMaxBlocks(0xFF, 0xFF);
+
+    ASSERT_EQ(expected_blocks(1, 20), scmStorage.readData(scm.location, std::shared_ptr<AccessInfo>(), 20 * 16, CB_AUTOSWITCHAREA));
+    ASSERT_EQ(2u, scm.transport->count(0x46));
+    ASSERT_EQ(15, scm.transport->apdus[0][3]);
+
+    std::vector<unsigned char> data(20 * 16, 0x42);
+    scmStorage.writeData(scm.location, std::shared_ptr<AccessInfo>(), std::shared_ptr<AccessInfo>(), data, CB_AUTOSWITCHAREA);
+    ASSERT_EQ(2u, scm.transport->count(0x48));
+    ASSERT_EQ(13, scm.transport->apdus[2][3]);
+    ASSERT_EQ(data, scm.transport->written);
+
+    Fixture<FeliCaSpringCardCommands> springcard;
+    FeliCaStorageCardService springcardStorage(springcard.chip);
+    springcard.commands->setMaxBlocks(0xFF, 0xFF);
+
+    ASSERT_EQ(expected_blocks(1, 20), springcardStorage.readData(springcard.location, std::shared_ptr<AccessInfo>(), 20 * 16, CB_AUTOSWITCHAREA));
+    ASSERT_EQ(2u, springcard.transport->count(0xB0));
+
+    springcardStorage.writeData(springcard.location, std::shared_ptr<AccessInfo>(), std::shared_ptr<AccessInfo>(), data, CB_AUTOSWITCHAREA);
+    ASSERT_EQ(2u, springcard.transport->count(0xD6));
+    ASSERT_EQ(data, springcard.transport->written);
+}
@@ -0,0 +1,186 @@
+#include "logicalaccess/iks/IKSConnectionPool.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace logicalaccess;
+using namespace logicalaccess::iks;
+
+namespace
+{
+#ifdef ENABLE_SSLTRANSPORT
+    boost::asio::ssl::context& ssl_context()
+    {
+        static boost::asio::ssl::context ctx(boost::asio::ssl::context::tls_client);
+        return ctx;
+    }
+#endif /* ENABLE_SSLTRANSPORT */
+
+    /**
+     * A connection up until the test breaks it.
+     */
+    class FakeSSLTransport : public SSLTransport
+    {
+    public:
+        explicit FakeSSLTransport(std::shared_ptr<std::atomic<bool> > up)
+#ifdef ENABLE_SSLTRANSPORT
+            : SSLTransport(ssl_context()), up_(up)
+#else
+            : up_(up)
+#endif /* ENABLE_SSLTRANSPORT */
+        {
+        }
+
+        virtual bool connect(long int) override
+        {
+            *up_ = true;
+            return true;
+        }
+
+        virtual void disconnect() override { *up_ = false; }
+
+        virtual bool isConnected() override { return *up_; }
+
+        virtual bool checkConnection() override { return *up_; }
+
+    private:
+        std::shared_ptr<std::atomic<bool> > up_;
+    };
+
+    /**
+     * The connections opened by a pool, in order.
+     */
+    struct FakeServer
+    {
+        IKSConnectionPool::ChannelFactory factory()
+        {
+            return [this]()
+            {
+                std::shared_ptr<std::atomic<bool> > up = std::make_shared<std::atomic<bool> >(false);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    links.push_back(up);
+                }
+                return std::make_shared<IKSChannel>(std::unique_ptr<SSLTransport>(new FakeSSLTransport(up)));
+            };
+        }
+
+        size_t opened()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return links.size();
+        }
+
+        void cut(size_t i)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            *links[i] = false;
+        }
+
+        bool up(size_t i)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return *links[i];
+        }
+
+        std::mutex mutex;
+        std::vector<std::shared_ptr<std::atomic<bool> > > links;
+    };
+}
+
+TEST(test_iks_connection_pool, acquire_release)
+{
+    FakeServer server;
+    std::shared_ptr<IKSConnectionPool> pool = std::make_shared<IKSConnectionPool>(server.factory(), 2, 0);
+    ASSERT_EQ(1u, pool->size());
+    ASSERT_EQ(1u, pool->idle_count());
+
+    {
+        IKSConnectionPool::Lease first = pool->acquire();
+        ASSERT_EQ(0u, pool->idle_count());
+        IKSConnectionPool::Lease second = pool->acquire();
+        ASSERT_EQ(2u, pool->size());
+        ASSERT_EQ(2u, server.opened());
+    }
+
+    // The channels are given back and reused.
+    ASSERT_EQ(2u, pool->idle_count());
+    {
+        IKSConnectionPool::Lease lease = pool->acquire();
+        IKSConnectionPool::Lease moved(std::move(lease));
+        ASSERT_EQ(1u, pool->idle_count());
+    }
+    ASSERT_EQ(2u, pool->idle_count());
+    ASSERT_EQ(2u, server.opened());
+}
+
+TEST(test_iks_connection_pool, wait_at_limit)
+{
+    FakeServer server;
+    std::shared_ptr<IKSConnectionPool> pool = std::make_shared<IKSConnectionPool>(server.factory(), 1, 0);
+    std::unique_ptr<IKSConnectionPool::Lease> lease(new IKSConnectionPool::Lease(pool->acquire()));
+
+    std::atomic<bool> acquired(false);
+    std::thread waiter([pool, &acquired]()
+    {
+        IKSConnectionPool::Lease other = pool->acquire();
+        acquired = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(acquired);
+
+    lease.reset();
+    waiter.join();
+    ASSERT_TRUE(acquired);
+    ASSERT_EQ(1u, server.opened());
+    ASSERT_EQ(1u, pool->idle_count());
+}
+
+TEST(test_iks_connection_pool, broken_channels)
+{
+    FakeServer server;
+    std::shared_ptr<IKSConnectionPool> pool = std::make_shared<IKSConnectionPool>(server.factory(), 1, 0);
+
+    // A broken idle channel is replaced on acquire.
+    server.cut(0);
+    {
+        IKSConnectionPool::Lease lease = pool->acquire();
+        ASSERT_EQ(2u, server.opened());
+        ASSERT_EQ(1u, pool->size());
+
+        // A channel broken while leased is not given back.
+        lease->disconnect();
+    }
+    ASSERT_EQ(0u, pool->size());
+    ASSERT_EQ(0u, pool->idle_count());
+}
+
+TEST(test_iks_connection_pool, health_eviction)
+{
+    FakeServer server;
+    std::shared_ptr<IKSConnectionPool> pool = std::make_shared<IKSConnectionPool>(server.factory(), 2, 10);
+    server.cut(0);
+
+    // The background thread replaces the broken idle channel.
+    for (int i = 0; i < 500 && server.opened() < 2; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(2u, server.opened());
+    ASSERT_TRUE(server.up(1));
+    ASSERT_EQ(1u, pool->size());
+}
+
+TEST(test_iks_connection_pool, lease_outlives_pool)
+{
+    FakeServer server;
+    std::shared_ptr<IKSConnectionPool> pool = std::make_shared<IKSConnectionPool>(server.factory(), 1, 0);
+    {
+        IKSConnectionPool::Lease lease = pool->acquire();
+        pool.reset();
+        ASSERT_TRUE(server.up(0));
+    }
+    ASSERT_FALSE(server.up(0));
+}
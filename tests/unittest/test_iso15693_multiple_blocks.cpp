@@ -0,0 +1,173 @@
+#include "pluginsreaderproviders/pcsc/commands/iso15693pcsccommands.hpp"
+#include "pluginscards/iso15693/iso15693chip.hpp"
+#include "pluginscards/iso15693/iso15693storagecardservice.hpp"
+#include "fakepcscdatatransport.hpp"
+#include <gtest/gtest.h>
+
+using namespace logicalaccess;
+
+namespace
+{
+    /**
+     * Emulate a 64 blocks of 4 bytes tag, each byte being its block number, and record the APDUs.
+     */
+    class ISO15693Transport : public FakePCSCDataTransport
+    {
+    public:
+        ISO15693Transport() : maxLength(0xFF), chipError(false) {}
+
+        using FakePCSCDataTransport::count;
+
+        size_t count(unsigned char ins, unsigned char p1) const
+        {
+            size_t n = 0;
+            for (size_t i = 0; i < apdus.size(); ++i)
+            {
+                if (apdus[i][1] == ins && apdus[i][2] == p1)
+                    ++n;
+            }
+            return n;
+        }
+
+        std::vector<unsigned char> written;
+        size_t maxLength;
+        bool chipError;
+
+    protected:
+
+        virtual void receiveInto(std::vector<unsigned char>& result, long int) override
+        {
+            const std::vector<unsigned char>& last = apdus.back();
+            result.clear();
+            if (last[1] == 0x30 && last[2] == 0x04)
+            {
+                result.push_back(63);
+                result.push_back(3);
+            }
+            else if ((last[1] == 0xB0 || last[1] == 0xD6) && chipError)
+            {
+                throw CardException("Memory failure.", CardException::MEMORY_FAILURE);
+            }
+            else if (last[1] == 0xB0)
+            {
+                size_t length = (last[4] == 0) ? 4 : last[4];
+                if (length > maxLength)
+                {
+                    throw CardException("Wrong length.", CardException::WRONG_LENGTH);
+                }
+                for (size_t i = 0; i < length; ++i)
+                    result.push_back(static_cast<unsigned char>(last[3] + i / 4));
+            }
+            else if (last[1] == 0xD6)
+            {
+                if (last[4] > maxLength)
+                {
+                    throw CardException("Wrong length.", CardException::WRONG_LENGTH);
+                }
+                written.insert(written.end(), last.begin() + 5, last.end());
+            }
+            result.push_back(0x90);
+            result.push_back(0x00);
+        }
+    };
+
+    struct Fixture
+    {
+        Fixture()
+        {
+            transport = std::make_shared<ISO15693Transport>();
+            transport->setReaderUnit(std::make_shared<PCSCReaderUnit>("Fake"));
+            std::shared_ptr<PCSCReaderCardAdapter> rca = std::make_shared<PCSCReaderCardAdapter>();
+            rca->setDataTransport(transport);
+            commands = std::make_shared<ISO15693PCSCCommands>();
+            commands->setReaderCardAdapter(rca);
+            chip = std::make_shared<ISO15693Chip>();
+            chip->setCommands(commands);
+            commands->setChip(chip);
+        }
+
+        std::shared_ptr<ISO15693Transport> transport;
+        std::shared_ptr<ISO15693PCSCCommands> commands;
+        std::shared_ptr<ISO15693Chip> chip;
+    };
+
+    std::vector<unsigned char> expected_blocks(int start_block, int count)
+    {
+        std::vector<unsigned char> data;
+        for (int i = 0; i < count; ++i)
+            data.insert(data.end(), 4, static_cast<unsigned char>(start_block + i));
+        return data;
+    }
+}
+
+TEST(test_iso15693_multiple_blocks, read_blocks)
+{
+    Fixture f;
+
+    ASSERT_EQ(expected_blocks(0, 64), f.commands->readBlocks(0, 64));
+    ASSERT_EQ(2u, f.transport->count(0xB0));
+
+    // The system information is only asked once.
+    ASSERT_EQ(expected_blocks(10, 3), f.commands->readBlocks(10, 3));
+    ASSERT_EQ(3u, f.transport->count(0xB0));
+    ASSERT_EQ(1u, f.transport->count(0x30, 0x04));
+}
+
+TEST(test_iso15693_multiple_blocks, fallback)
+{
+    Fixture f;
+    f.transport->maxLength = 4;
+
+    ASSERT_EQ(expected_blocks(2, 3), f.commands->readBlocks(2, 3));
+    ASSERT_EQ(4u, f.transport->count(0xB0));
+
+    // The reader is not asked again.
+    ASSERT_EQ(expected_blocks(8, 2), f.commands->readBlocks(8, 2));
+    ASSERT_EQ(6u, f.transport->count(0xB0));
+
+    std::vector<unsigned char> data(12, 0x42);
+    f.commands->writeBlocks(3, data);
+    ASSERT_EQ(3u, f.transport->count(0xD6));
+    ASSERT_EQ(data, f.transport->written);
+}
+
+TEST(test_iso15693_multiple_blocks, storage)
+{
+    Fixture f;
+    ISO15693StorageCardService storage(f.chip);
+    std::shared_ptr<ISO15693Location> location = std::make_shared<ISO15693Location>();
+    location->block = 4;
+
+    std::vector<unsigned char> expected = expected_blocks(4, 3);
+    expected.resize(10);
+    ASSERT_EQ(expected, storage.readData(location, std::shared_ptr<AccessInfo>(), 10, CB_DEFAULT));
+    ASSERT_EQ(1u, f.transport->count(0xB0));
+
+    // Less than a block is cut too.
+    ASSERT_EQ(std::vector<unsigned char>(2, 4), storage.readData(location, std::shared_ptr<AccessInfo>(), 2, CB_DEFAULT));
+    ASSERT_EQ(2u, f.transport->count(0xB0));
+
+    // The last block is completed with its current content.
+    std::vector<unsigned char> towrite(10, 0x42);
+    storage.writeData(location, std::shared_ptr<AccessInfo>(), std::shared_ptr<AccessInfo>(), towrite, CB_DEFAULT);
+    ASSERT_EQ(1u, f.transport->count(0xD6));
+    towrite.push_back(6);
+    towrite.push_back(6);
+    ASSERT_EQ(towrite, f.transport->written);
+}
+
+TEST(test_iso15693_multiple_blocks, chip_error)
+{
+    Fixture f;
+    f.transport->chipError = true;
+
+    // A chip failure is reported, not taken for a reader limitation.
+    ASSERT_THROW(f.commands->readBlocks(0, 8), CardException);
+    ASSERT_EQ(1u, f.transport->count(0xB0));
+    ASSERT_THROW(f.commands->writeBlocks(0, std::vector<unsigned char>(8, 0x42)), CardException);
+    ASSERT_EQ(1u, f.transport->count(0xD6));
+
+    f.transport->chipError = false;
+    ASSERT_EQ(expected_blocks(0, 8), f.commands->readBlocks(0, 8));
+    ASSERT_EQ(2u, f.transport->count(0xB0));
+}
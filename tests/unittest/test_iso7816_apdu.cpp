@@ -0,0 +1,221 @@
+#include "pluginsreaderproviders/iso7816/readercardadapters/iso7816readercardadapter.hpp"
+#include "logicalaccess/readerproviders/datatransport.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace logicalaccess;
+
+namespace
+{
+    /**
+     * Record the sent command and answer with 90 00.
+     */
+    class RecordDataTransport : public DataTransport
+    {
+    public:
+        virtual std::string getTransportType() const { return "Record"; }
+        virtual bool connect() { return true; }
+        virtual void disconnect() {}
+        virtual bool isConnected() { return true; }
+        virtual std::string getName() const { return "Record"; }
+        virtual void serialize(boost::property_tree::ptree&) {}
+        virtual void unSerialize(boost::property_tree::ptree&) {}
+        virtual std::string getDefaultXmlNodeName() const { return "RecordDataTransport"; }
+
+        std::vector<unsigned char> sent;
+
+    protected:
+        virtual void send(const std::vector<unsigned char>& data) { sent = data; }
+
+        virtual std::vector<unsigned char> receive(long int)
+        {
+            std::vector<unsigned char> res;
+            res.push_back(0x90);
+            res.push_back(0x00);
+            return res;
+        }
+    };
+
+    /**
+     * Record the sent commands and answer with the scripted responses, in order.
+     */
+    class ScriptedDataTransport : public RecordDataTransport
+    {
+    public:
+        ScriptedDataTransport() : transactions(0), inTransaction(false) {}
+
+        virtual void beginTransaction() { ++transactions; inTransaction = true; }
+        virtual void endTransaction() { inTransaction = false; }
+
+        std::vector<std::vector<unsigned char> > commands;
+        std::vector<std::vector<unsigned char> > responses;
+        int transactions;
+        bool inTransaction;
+
+    protected:
+        virtual void send(const std::vector<unsigned char>& data)
+        {
+            EXPECT_TRUE(inTransaction);
+            commands.push_back(data);
+        }
+
+        virtual std::vector<unsigned char> receive(long int)
+        {
+            if (responses.empty())
+                throw std::runtime_error("No more response.");
+
+            std::vector<unsigned char> res = responses.front();
+            responses.erase(responses.begin());
+            return res;
+        }
+    };
+}
+
+TEST(test_iso7816_apdu, inline_storage)
+{
+    ISO7816APDU apdu(0x00, 0xB0, 0x01, 0x02);
+    apdu.push_back(0x10);
+
+    ASSERT_EQ(5u, apdu.size());
+    ASSERT_EQ(std::vector<unsigned char>({0x00, 0xB0, 0x01, 0x02, 0x10}),
+              std::vector<unsigned char>(apdu.data(), apdu.data() + apdu.size()));
+}
+
+TEST(test_iso7816_apdu, heap_storage)
+{
+    std::vector<unsigned char> data(300, 0x42);
+    ISO7816APDU apdu(0x00, 0xD6, 0x00, 0x00);
+    apdu.push_back(0x00);
+    apdu.append(data);
+    apdu.push_back(0x01);
+
+    ASSERT_EQ(306u, apdu.size());
+    ASSERT_EQ(0xD6, apdu.data()[1]);
+    ASSERT_EQ(0x42, apdu.data()[5]);
+    ASSERT_EQ(0x42, apdu.data()[304]);
+    ASSERT_EQ(0x01, apdu.data()[305]);
+}
+
+TEST(test_iso7816_apdu, send_apdu_command)
+{
+    std::shared_ptr<RecordDataTransport> transport(new RecordDataTransport());
+    ISO7816ReaderCardAdapter adapter;
+    adapter.setDataTransport(transport);
+
+    std::vector<unsigned char> res = adapter.sendAPDUCommand(0x00, 0xA4, 0x04, 0x00, 0x02, std::vector<unsigned char>(2, 0x3F), 0x00);
+    ASSERT_EQ(std::vector<unsigned char>({0x00, 0xA4, 0x04, 0x00, 0x02, 0x3F, 0x3F, 0x00}), transport->sent);
+    ASSERT_EQ(std::vector<unsigned char>({0x90, 0x00}), res);
+
+    // The result buffer is reused.
+    std::vector<unsigned char> result(1, 0xFF);
+    adapter.sendAPDUCommand(ISO7816APDU(0x00, 0x84, 0x00, 0x00), result);
+    ASSERT_EQ(std::vector<unsigned char>({0x00, 0x84, 0x00, 0x00}), transport->sent);
+    ASSERT_EQ(std::vector<unsigned char>({0x90, 0x00}), result);
+}
+
+TEST(test_iso7816_apdu, extended_length)
+{
+    std::shared_ptr<RecordDataTransport> transport(new RecordDataTransport());
+    ISO7816ReaderCardAdapter adapter;
+    adapter.setDataTransport(transport);
+
+    // Short fields are used when enough.
+    adapter.sendExtendedAPDUCommand(0x00, 0xB0, 0x00, 0x00, std::vector<unsigned char>(), 256);
+    ASSERT_EQ(std::vector<unsigned char>({0x00, 0xB0, 0x00, 0x00, 0x00}), transport->sent);
+
+    ASSERT_THROW(adapter.sendExtendedAPDUCommand(0x00, 0xB0, 0x00, 0x00, std::vector<unsigned char>(), 0x1000),
+                 LibLogicalAccessException);
+
+    adapter.setExtendedLengthSupported(true);
+    adapter.sendExtendedAPDUCommand(0x00, 0xB0, 0x00, 0x00, std::vector<unsigned char>(), 0x1000);
+    ASSERT_EQ(std::vector<unsigned char>({0x00, 0xB0, 0x00, 0x00, 0x00, 0x10, 0x00}), transport->sent);
+
+    adapter.sendExtendedAPDUCommand(0x00, 0xD6, 0x00, 0x00, std::vector<unsigned char>(300, 0x42), 65536);
+    ASSERT_EQ(309u, transport->sent.size());
+    ASSERT_EQ(std::vector<unsigned char>({0x00, 0x01, 0x2C}), std::vector<unsigned char>(transport->sent.begin() + 4, transport->sent.begin() + 7));
+    ASSERT_EQ(std::vector<unsigned char>({0x00, 0x00}), std::vector<unsigned char>(transport->sent.end() - 2, transport->sent.end()));
+}
+
+TEST(test_iso7816_apdu, retain_last_exchange)
+{
+    RecordDataTransport transport;
+    std::vector<unsigned char> command(4, 0x01), result;
+
+    transport.transmit(command.data(), command.size(), result, 100);
+    ASSERT_EQ(command, transport.sent);
+    ASSERT_EQ(std::vector<unsigned char>({0x90, 0x00}), result);
+    ASSERT_TRUE(transport.getLastCommand().empty());
+    ASSERT_TRUE(transport.getLastResult().empty());
+
+    transport.setRetainLastExchange(true);
+    transport.transmit(command.data(), command.size(), result, 100);
+    ASSERT_EQ(command, transport.getLastCommand());
+    ASSERT_EQ(result, transport.getLastResult());
+}
+
+TEST(test_iso7816_apdu, send_apdu_commands_batch)
+{
+    std::shared_ptr<ScriptedDataTransport> transport(new ScriptedDataTransport());
+    ISO7816ReaderCardAdapter adapter;
+    adapter.setDataTransport(transport);
+    transport->responses.push_back(std::vector<unsigned char>({0x01, 0x90, 0x00}));
+    transport->responses.push_back(std::vector<unsigned char>({0x6A, 0x82}));
+    transport->responses.push_back(std::vector<unsigned char>({0x02, 0x03, 0x90, 0x00}));
+
+    std::vector<std::vector<unsigned char> > commands;
+    commands.push_back(std::vector<unsigned char>({0x00, 0xB0, 0x00, 0x00, 0x01}));
+    commands.push_back(std::vector<unsigned char>({0x00, 0xB0, 0x00, 0x01, 0x01}));
+    commands.push_back(std::vector<unsigned char>({0x00, 0xB0, 0x00, 0x02, 0x02}));
+
+    std::vector<std::vector<unsigned char> > res = adapter.sendAPDUCommands(commands);
+    ASSERT_EQ(commands, transport->commands);
+    ASSERT_EQ(3u, res.size());
+    ASSERT_EQ(std::vector<unsigned char>({0x01, 0x90, 0x00}), res[0]);
+    ASSERT_EQ(std::vector<unsigned char>({0x6A, 0x82}), res[1]);
+    ASSERT_EQ(std::vector<unsigned char>({0x02, 0x03, 0x90, 0x00}), res[2]);
+    ASSERT_EQ(1, transport->transactions);
+    ASSERT_FALSE(transport->inTransaction);
+}
+
+TEST(test_iso7816_apdu, send_apdu_commands_chaining)
+{
+    std::shared_ptr<ScriptedDataTransport> transport(new ScriptedDataTransport());
+    ISO7816ReaderCardAdapter adapter;
+    adapter.setDataTransport(transport);
+    transport->responses.push_back(std::vector<unsigned char>({0x01, 0x02, 0x91, 0xAF}));
+    transport->responses.push_back(std::vector<unsigned char>({0x03, 0x91, 0xAF}));
+    transport->responses.push_back(std::vector<unsigned char>({0x04, 0x91, 0x00}));
+    transport->responses.push_back(std::vector<unsigned char>({0x05, 0x91, 0x00}));
+
+    std::vector<unsigned char> continuation({0x90, 0xAF, 0x00, 0x00, 0x00});
+    std::vector<std::vector<unsigned char> > commands;
+    commands.push_back(std::vector<unsigned char>({0x90, 0xBD, 0x00, 0x00, 0x07, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}));
+    commands.push_back(std::vector<unsigned char>({0x90, 0xBD, 0x00, 0x00, 0x07, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}));
+
+    std::vector<std::vector<unsigned char> > res = adapter.sendAPDUCommands(commands, ISO7816APDUChaining(0x91, 0xAF, continuation));
+    ASSERT_EQ(2u, res.size());
+    ASSERT_EQ(std::vector<unsigned char>({0x01, 0x02, 0x03, 0x04, 0x91, 0x00}), res[0]);
+    ASSERT_EQ(std::vector<unsigned char>({0x05, 0x91, 0x00}), res[1]);
+
+    ASSERT_EQ(4u, transport->commands.size());
+    ASSERT_EQ(commands[0], transport->commands[0]);
+    ASSERT_EQ(continuation, transport->commands[1]);
+    ASSERT_EQ(continuation, transport->commands[2]);
+    ASSERT_EQ(commands[1], transport->commands[3]);
+    ASSERT_EQ(1, transport->transactions);
+}
+
+TEST(test_iso7816_apdu, send_apdu_commands_failure)
+{
+    std::shared_ptr<ScriptedDataTransport> transport(new ScriptedDataTransport());
+    ISO7816ReaderCardAdapter adapter;
+    adapter.setDataTransport(transport);
+    transport->responses.push_back(std::vector<unsigned char>({0x90, 0x00}));
+
+    std::vector<std::vector<unsigned char> > commands(2, std::vector<unsigned char>({0x00, 0x84, 0x00, 0x00, 0x08}));
+    ASSERT_THROW(adapter.sendAPDUCommands(commands), std::runtime_error);
+
+    // The transaction is released on failure.
+    ASSERT_EQ(1, transport->transactions);
+    ASSERT_FALSE(transport->inTransaction);
+}
@@ -0,0 +1,112 @@
+#include "pluginscards/desfire/desfirekey.hpp"
+#include "pluginscards/desfire/nxpav1keydiversification.hpp"
+#include "pluginscards/desfire/nxpav2keydiversification.hpp"
+#include "pluginscards/desfire/omnitechkeydiversification.hpp"
+#include "logicalaccess/myexception.hpp"
+#include <gtest/gtest.h>
+
+using namespace logicalaccess;
+
+namespace
+{
+    std::shared_ptr<DESFireKey> make_key(DESFireKeyType type, size_t length)
+    {
+        std::shared_ptr<DESFireKey> key = std::make_shared<DESFireKey>();
+        key->setKeyType(type);
+        std::vector<unsigned char> data(length);
+        for (size_t i = 0; i < length; ++i)
+            data[i] = static_cast<unsigned char>(i * 13 + 1);
+        key->setData(data);
+        return key;
+    }
+
+    std::vector<KeyDiversification::DiversificationInput> make_inputs(size_t count)
+    {
+        std::vector<KeyDiversification::DiversificationInput> inputs(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            inputs[i].identifier = std::vector<unsigned char>(7, static_cast<unsigned char>(i));
+            inputs[i].identifier[0] = 0x04;
+            inputs[i].aid = 0x123456 + static_cast<int>(i % 3);
+            inputs[i].keyno = static_cast<unsigned char>(i % 4);
+        }
+        return inputs;
+    }
+
+    /**
+     * The keys diversified one by one, as on authentication.
+     */
+    std::vector<std::vector<unsigned char> > serial(KeyDiversification& div, std::shared_ptr<Key> key, const std::vector<KeyDiversification::DiversificationInput>& inputs)
+    {
+        std::vector<std::vector<unsigned char> > keys;
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            std::vector<unsigned char> diversify;
+            div.initDiversification(inputs[i].identifier, inputs[i].aid, key, inputs[i].keyno, diversify);
+            keys.push_back(div.getDiversifiedKey(key, diversify));
+        }
+        return keys;
+    }
+}
+
+TEST(test_key_diversification_batch, same_as_serial)
+{
+    std::vector<KeyDiversification::DiversificationInput> inputs = make_inputs(37);
+    std::vector<std::shared_ptr<DESFireKey> > keys;
+    keys.push_back(make_key(DF_KEY_DES, 16));
+    keys.push_back(make_key(DF_KEY_3K3DES, 24));
+    keys.push_back(make_key(DF_KEY_AES, 16));
+
+    for (size_t k = 0; k < keys.size(); ++k)
+    {
+        NXPAV2KeyDiversification av2;
+        ASSERT_EQ(serial(av2, keys[k], inputs), av2.getDiversifiedKeys(keys[k], inputs, 4));
+        av2.setForceK2Use(true);
+        ASSERT_EQ(serial(av2, keys[k], inputs), av2.getDiversifiedKeys(keys[k], inputs, 3));
+
+        // Long inputs go through the serial path.
+        NXPAV2KeyDiversification longInput(std::vector<unsigned char>(20, 0x5A));
+        ASSERT_EQ(serial(longInput, keys[k], inputs), longInput.getDiversifiedKeys(keys[k], inputs, 2));
+
+        if (keys[k]->getKeyType() != DF_KEY_3K3DES)
+        {
+            NXPAV1KeyDiversification av1;
+            ASSERT_EQ(serial(av1, keys[k], inputs), av1.getDiversifiedKeys(keys[k], inputs));
+        }
+    }
+
+    // The algorithms without a batch context diversify one key at a time on each thread.
+    OmnitechKeyDiversification omnitech;
+    ASSERT_EQ(serial(omnitech, keys[0], inputs), omnitech.getDiversifiedKeys(keys[0], inputs, 4));
+}
+
+TEST(test_key_diversification_batch, async)
+{
+    std::vector<KeyDiversification::DiversificationInput> inputs = make_inputs(10);
+    std::shared_ptr<DESFireKey> key = make_key(DF_KEY_AES, 16);
+    std::shared_ptr<NXPAV2KeyDiversification> av2 = std::make_shared<NXPAV2KeyDiversification>();
+
+    std::future<std::vector<std::vector<unsigned char> > > next = av2->getDiversifiedKeysAsync(key, inputs, 2);
+    ASSERT_EQ(serial(*av2, key, inputs), next.get());
+
+    ASSERT_TRUE(av2->getDiversifiedKeys(key, std::vector<KeyDiversification::DiversificationInput>()).empty());
+
+    // The task keeps the algorithm, the inputs are built before the settings change.
+    std::vector<std::vector<unsigned char> > expected = serial(*av2, key, inputs);
+    std::weak_ptr<NXPAV2KeyDiversification> released = av2;
+    next = av2->getDiversifiedKeysAsync(key, inputs, 2);
+    av2->setDivInput(std::vector<unsigned char>(4, 0x42));
+    av2.reset();
+    ASSERT_EQ(expected, next.get());
+    ASSERT_TRUE(released.expired());
+}
+
+TEST(test_key_diversification_batch, error)
+{
+    std::vector<KeyDiversification::DiversificationInput> inputs = make_inputs(4);
+    inputs[2].identifier.clear();
+
+    // The inputs are checked before diversifying.
+    NXPAV2KeyDiversification av2;
+    ASSERT_THROW(av2.getDiversifiedKeys(make_key(DF_KEY_AES, 16), inputs), LibLogicalAccessException);
+}
@@ -0,0 +1,120 @@
+#include "logicalaccess/cards/keydiversificationcache.hpp"
+#include "pluginscards/desfire/desfirekey.hpp"
+#include "pluginscards/desfire/nxpav2keydiversification.hpp"
+#include "pluginscards/desfire/omnitechkeydiversification.hpp"
+#include <gtest/gtest.h>
+
+using namespace logicalaccess;
+
+namespace
+{
+    /**
+     * Count the actual diversifications.
+     */
+    class CountingDiversification : public NXPAV2KeyDiversification
+    {
+    public:
+        CountingDiversification() : count(0) {}
+
+        virtual std::vector<unsigned char> getDiversifiedKey(std::shared_ptr<Key> key, std::vector<unsigned char> diversify) override
+        {
+            ++count;
+            return NXPAV2KeyDiversification::getDiversifiedKey(key, diversify);
+        }
+
+        int count;
+    };
+
+    std::shared_ptr<DESFireKey> aes_key(unsigned char value)
+    {
+        std::shared_ptr<DESFireKey> key = std::make_shared<DESFireKey>();
+        key->setKeyType(DF_KEY_AES);
+        key->setData(std::vector<unsigned char>(16, value));
+        return key;
+    }
+}
+
+TEST(test_key_diversification_cache, lru)
+{
+    KeyDiversificationCache cache(2);
+    std::vector<unsigned char> card(7, 0x04), keydiv;
+
+    cache.put(std::vector<unsigned char>(1, 0x01), card, std::vector<unsigned char>(16, 0x11));
+    cache.put(std::vector<unsigned char>(1, 0x02), card, std::vector<unsigned char>(16, 0x22));
+    ASSERT_TRUE(cache.get(std::vector<unsigned char>(1, 0x01), keydiv));
+    ASSERT_EQ(std::vector<unsigned char>(16, 0x11), keydiv);
+
+    // 0x02 is the least recently used.
+    cache.put(std::vector<unsigned char>(1, 0x03), card, std::vector<unsigned char>(16, 0x33));
+    ASSERT_EQ(2u, cache.size());
+    ASSERT_FALSE(cache.get(std::vector<unsigned char>(1, 0x02), keydiv));
+    ASSERT_TRUE(cache.get(std::vector<unsigned char>(1, 0x01), keydiv));
+    ASSERT_TRUE(cache.get(std::vector<unsigned char>(1, 0x03), keydiv));
+
+    cache.put(std::vector<unsigned char>(1, 0x04), std::vector<unsigned char>(7, 0x05), std::vector<unsigned char>(16, 0x44));
+    cache.removeCard(std::vector<unsigned char>(7, 0x05));
+    ASSERT_EQ(1u, cache.size());
+    ASSERT_TRUE(cache.get(std::vector<unsigned char>(1, 0x03), keydiv));
+
+    cache.setCapacity(0);
+    ASSERT_EQ(0u, cache.size());
+    cache.put(std::vector<unsigned char>(1, 0x01), card, std::vector<unsigned char>(16, 0x11));
+    ASSERT_EQ(0u, cache.size());
+}
+
+TEST(test_key_diversification_cache, wipe)
+{
+    std::vector<unsigned char> buffer(16, 0xAA);
+    const unsigned char* data = buffer.data();
+    KeyDiversificationCache::wipe(buffer);
+    ASSERT_TRUE(buffer.empty());
+    // Clearing keeps the storage.
+    for (size_t i = 0; i < 16; ++i)
+        ASSERT_EQ(0x00, data[i]);
+}
+
+TEST(test_key_diversification_cache, diversification)
+{
+    KeyDiversificationCache& cache = KeyDiversificationCache::getInstance();
+    cache.clear();
+
+    std::vector<unsigned char> card(7, 0x04), diversify(10, 0x42);
+    std::shared_ptr<DESFireKey> key = aes_key(0x01);
+    std::shared_ptr<CountingDiversification> div = std::make_shared<CountingDiversification>();
+
+    std::vector<unsigned char> keydiv = div->getCachedDiversifiedKey(key, diversify, card);
+    ASSERT_EQ(1, div->count);
+    ASSERT_EQ(keydiv, div->getCachedDiversifiedKey(key, diversify, card));
+    ASSERT_EQ(1, div->count);
+    ASSERT_EQ(keydiv, NXPAV2KeyDiversification().getDiversifiedKey(key, diversify));
+
+    // Anything changing the result is a miss.
+    div->getCachedDiversifiedKey(key, std::vector<unsigned char>(10, 0x43), card);
+    ASSERT_EQ(2, div->count);
+    div->getCachedDiversifiedKey(aes_key(0x02), diversify, card);
+    ASSERT_EQ(3, div->count);
+    std::shared_ptr<DESFireKey> deskey = aes_key(0x01);
+    deskey->setKeyType(DF_KEY_DES);
+    deskey->setData(std::vector<unsigned char>(16, 0x01));
+    div->getCachedDiversifiedKey(deskey, diversify, card);
+    ASSERT_EQ(4, div->count);
+    div->setForceK2Use(true);
+    div->getCachedDiversifiedKey(key, diversify, card);
+    ASSERT_EQ(5, div->count);
+    div->setForceK2Use(false);
+
+    // Another algorithm never gets the NXP entry.
+    std::vector<unsigned char> omnitechDiv(16, 0x42);
+    std::shared_ptr<DESFireKey> omnitechKey = aes_key(0x01);
+    omnitechKey->setKeyType(DF_KEY_DES);
+    omnitechKey->setData(std::vector<unsigned char>(16, 0x01));
+    OmnitechKeyDiversification omnitech;
+    ASSERT_EQ(omnitech.getDiversifiedKey(omnitechKey, omnitechDiv), omnitech.getCachedDiversifiedKey(omnitechKey, omnitechDiv, card));
+
+    // The card removal wipes its entries.
+    cache.removeCard(card);
+    ASSERT_EQ(0u, cache.size());
+    div->getCachedDiversifiedKey(key, diversify, card);
+    ASSERT_EQ(6, div->count);
+    cache.clear();
+}
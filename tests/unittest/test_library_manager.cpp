@@ -0,0 +1,58 @@
+#include "logicalaccess/dynlibrary/librarymanager.hpp"
+#include "logicalaccess/settings.hpp"
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <dlfcn.h>
+#include <thread>
+#include <vector>
+
+using namespace logicalaccess;
+
+extern "C" void getEPassChip(std::shared_ptr<Chip> *chip);
+
+TEST(test_library_manager, symbol_index)
+{
+    // Scan the folder of the EPass plugin the test is linked with.
+    Dl_info info;
+    ASSERT_NE(0, dladdr(reinterpret_cast<void *>(&getEPassChip), &info));
+    std::string folder = boost::filesystem::path(info.dli_fname).parent_path().string();
+
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    Settings::update([folder](Settings &s) { s.PluginFolders.assign(1, folder); });
+    LibraryManager *manager = LibraryManager::getInstance();
+    manager->scanPlugins();
+
+    void *getter = reinterpret_cast<void *>(&getEPassChip);
+    ASSERT_EQ(getter, manager->getFctFromName("getEPassChip", LibraryManager::CARDS_TYPE));
+    ASSERT_TRUE(manager->getCard("EPass") != nullptr);
+
+    // Misses are answered again from the index.
+    ASSERT_TRUE(manager->getFctFromName("getUnknownCommands", LibraryManager::READERS_TYPE) == NULL);
+    ASSERT_TRUE(manager->getFctFromName("getUnknownCommands", LibraryManager::READERS_TYPE) == NULL);
+
+    std::atomic<int> wrong(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.push_back(std::thread([manager, getter, i, &wrong]()
+        {
+            for (int j = 0; j < 1000; ++j)
+            {
+                if (manager->getFctFromName("getEPassChip", LibraryManager::CARDS_TYPE) != getter)
+                    ++wrong;
+                if (manager->getFctFromName("getUnknown" + std::to_string(i) + "Commands", LibraryManager::READERS_TYPE) != NULL)
+                    ++wrong;
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+    ASSERT_EQ(0, wrong);
+
+    // A new scan keeps the loaded factories.
+    manager->scanPlugins();
+    ASSERT_EQ(getter, manager->getFctFromName("getEPassChip", LibraryManager::CARDS_TYPE));
+
+    Settings::update([settings](Settings &s) { s = *settings; });
+}
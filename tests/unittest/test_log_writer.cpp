@@ -0,0 +1,126 @@
+#include "logicalaccess/logwriter.hpp"
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace logicalaccess;
+
+namespace
+{
+    boost::filesystem::path temp_log()
+    {
+        return boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("lla-%%%%-%%%%.log");
+    }
+
+    std::vector<std::string> read_lines(const boost::filesystem::path& path)
+    {
+        std::ifstream file(path.string());
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(file, line))
+            lines.push_back(line);
+        return lines;
+    }
+}
+
+TEST(test_log_writer, ring_buffer)
+{
+    LogRingBuffer buffer(3);
+    ASSERT_EQ(4u, buffer.getCapacity());
+
+    std::string line;
+    ASSERT_FALSE(buffer.pop(line));
+    for (int i = 0; i < 4; ++i)
+    {
+        line = std::to_string(i);
+        ASSERT_TRUE(buffer.push(line));
+    }
+    line = "full";
+    ASSERT_FALSE(buffer.push(line));
+    ASSERT_EQ("full", line);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(buffer.pop(line));
+        ASSERT_EQ(std::to_string(i), line);
+    }
+    ASSERT_FALSE(buffer.pop(line));
+
+    // The slots are reused on the next lap.
+    line = "again";
+    ASSERT_TRUE(buffer.push(line));
+    ASSERT_TRUE(buffer.pop(line));
+    ASSERT_EQ("again", line);
+}
+
+TEST(test_log_writer, concurrent_lines)
+{
+    boost::filesystem::path path = temp_log();
+    LogWriter writer(1 << 16);
+    ASSERT_TRUE(writer.open(path.string()));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.push_back(std::thread([&writer, t]()
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                std::ostringstream oss;
+                oss << "thread " << t << " line " << i << " " << std::string(40, 'x') << std::endl;
+                std::string line = oss.str();
+                writer.push(line);
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t)
+        threads[t].join();
+    writer.flush();
+    ASSERT_EQ(0u, writer.getDroppedCount());
+    writer.close();
+
+    std::vector<std::string> lines = read_lines(path);
+    ASSERT_EQ(4000u, lines.size());
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        ASSERT_EQ(0u, lines[i].find("thread "));
+        ASSERT_EQ(std::string(40, 'x'), lines[i].substr(lines[i].size() - 40));
+    }
+    boost::filesystem::remove(path);
+}
+
+TEST(test_log_writer, rotation)
+{
+    boost::filesystem::path path = temp_log();
+    LogWriter writer;
+    writer.setRotation(100, 0, 2);
+    ASSERT_TRUE(writer.open(path.string()));
+
+    for (int i = 0; i < 10; ++i)
+    {
+        std::string line = std::string(49, 'a' + i) + "\n";
+        writer.push(line);
+    }
+    writer.close();
+
+    // Two lines per file, the two previous files are kept.
+    ASSERT_EQ(std::vector<std::string>({ std::string(49, 'i'), std::string(49, 'j') }), read_lines(path));
+    ASSERT_EQ(std::vector<std::string>({ std::string(49, 'g'), std::string(49, 'h') }), read_lines(path.string() + ".1"));
+    ASSERT_EQ(std::vector<std::string>({ std::string(49, 'e'), std::string(49, 'f') }), read_lines(path.string() + ".2"));
+    ASSERT_FALSE(boost::filesystem::exists(path.string() + ".3"));
+
+    for (int i = 0; i <= 2; ++i)
+        boost::filesystem::remove(i ? path.string() + "." + std::to_string(i) : path.string());
+}
+
+TEST(test_log_writer, closed)
+{
+    LogWriter writer;
+    std::string line = "line\n";
+    ASSERT_FALSE(writer.isOpen());
+    ASSERT_FALSE(writer.push(line));
+    ASSERT_EQ(0u, writer.getDroppedCount());
+}
@@ -0,0 +1,166 @@
+#include "logicalaccess/logs.hpp"
+#include "logicalaccess/logwriter.hpp"
+#include "logicalaccess/settings.hpp"
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace logicalaccess;
+
+namespace
+{
+    int evaluated = 0;
+
+    int evaluate()
+    {
+        return ++evaluated;
+    }
+}
+
+TEST(test_logs, severity)
+{
+    ASSERT_LT(logLevelSeverity(TRACE), logLevelSeverity(COMS));
+    ASSERT_LT(logLevelSeverity(DEBUGS), logLevelSeverity(WARNINGS));
+    ASSERT_EQ(logLevelSeverity(ERRORS), logLevelSeverity(PLUGINS_ERROR));
+    ASSERT_LT(logLevelSeverity(ERRORS), logLevelSeverity(EMERGENSYS));
+
+    static_assert(Logs::isCompiledIn(ERRORS), "Errors are always compiled in.");
+}
+
+TEST(test_logs, lazy_arguments)
+{
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    boost::filesystem::path filename = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    ASSERT_TRUE(LogWriter::getInstance().open(filename.string()));
+
+    Settings::update([](Settings& s) { s.IsLogEnabled = true; s.SeeCommunicationLog = false; });
+    evaluated = 0;
+
+    LOG(LogLevel::COMS) << evaluate();
+    ASSERT_EQ(0, evaluated);
+    ASSERT_FALSE(Logs::isEnabled(LogLevel::COMS));
+
+    LOG(LogLevel::ERRORS) << evaluate();
+    ASSERT_EQ(1, evaluated);
+
+    Settings::update([](Settings& s) { s.SeeCommunicationLog = true; });
+    LOG(LogLevel::COMS) << evaluate();
+    ASSERT_EQ(2, evaluated);
+
+    {
+        LogDisabler disabler;
+        LOG(LogLevel::ERRORS) << evaluate();
+        ASSERT_EQ(2, evaluated);
+    }
+
+    Settings::update([settings](Settings& s) { s = *settings; });
+    LogWriter::getInstance().close();
+    boost::filesystem::remove(filename);
+}
+
+TEST(test_logs, log_disablers)
+{
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    boost::filesystem::path filename = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    ASSERT_TRUE(LogWriter::getInstance().open(filename.string()));
+    Settings::update([](Settings& s) { s.IsLogEnabled = true; });
+
+    // Disablers destroyed out of order leave logging enabled.
+    std::unique_ptr<LogDisabler> first(new LogDisabler());
+    std::unique_ptr<LogDisabler> second(new LogDisabler());
+    first.reset();
+    ASSERT_FALSE(Logs::isEnabled(LogLevel::ERRORS));
+    second.reset();
+    ASSERT_TRUE(Logs::isEnabled(LogLevel::ERRORS));
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i)
+    {
+        threads.push_back(std::thread([]()
+        {
+            for (int j = 0; j < 1000; ++j)
+            {
+                LogDisabler disabler;
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+    ASSERT_TRUE(Logs::isEnabled(LogLevel::ERRORS));
+    ASSERT_TRUE(Settings::getInstance()->IsLogEnabled);
+
+    Settings::update([settings](Settings& s) { s = *settings; });
+    LogWriter::getInstance().close();
+    boost::filesystem::remove(filename);
+}
+
+TEST(test_logs, legacy_logfile)
+{
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    boost::filesystem::path filename = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    LogWriter::getInstance().close();
+    Settings::update([](Settings& s) { s.IsLogEnabled = true; });
+
+    // Lines go to the application log file when the log writer is closed.
+    Logs::logfile.open(filename.string());
+    LOG(LogLevel::ERRORS) << "legacy line";
+    Logs::logfile.close();
+
+    std::ifstream file(filename.string());
+    std::stringstream content;
+    content << file.rdbuf();
+    ASSERT_NE(std::string::npos, content.str().find("legacy line"));
+
+    Settings::update([settings](Settings& s) { s = *settings; });
+    boost::filesystem::remove(filename);
+}
+
+TEST(test_logs, stderr_only)
+{
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    LogWriter::getInstance().close();
+    Settings::update([](Settings& s) { s.IsLogEnabled = true; });
+
+    // Without log file, the lines still reach stderr when requested.
+    bool logToStderr = Logs::logToStderr;
+    Logs::logToStderr = true;
+    ASSERT_TRUE(Logs::isEnabled(LogLevel::ERRORS));
+    ::testing::internal::CaptureStderr();
+    LOG(LogLevel::ERRORS) << "stderr line";
+    std::string output = ::testing::internal::GetCapturedStderr();
+    ASSERT_NE(std::string::npos, output.find("stderr line"));
+
+    Logs::logToStderr = false;
+    ASSERT_FALSE(Logs::isEnabled(LogLevel::ERRORS));
+
+    Logs::logToStderr = logToStderr;
+    Settings::update([settings](Settings& s) { s = *settings; });
+}
+
+TEST(test_logs, written_at_exit)
+{
+    boost::filesystem::path filename = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+
+    EXPECT_EXIT(
+    {
+        LogWriter::getInstance().open(filename.string());
+        for (int i = 0; i < 1000; ++i)
+        {
+            std::string line = "pending line\n";
+            LogWriter::getInstance().push(line);
+        }
+        std::exit(0);
+    }, ::testing::ExitedWithCode(0), "");
+
+    std::ifstream file(filename.string());
+    int count = 0;
+    std::string line;
+    while (std::getline(file, line))
+        ++count;
+    ASSERT_EQ(1000, count);
+    boost::filesystem::remove(filename);
+}
@@ -0,0 +1,197 @@
+#include "pluginsreaderproviders/pcsc/commands/mifarepcsccommands.hpp"
+#include "pluginsreaderproviders/pcsc/commands/mifareomnikeyxx21commands.hpp"
+#include "pluginscards/mifare/mifare1kchip.hpp"
+#include "logicalaccess/cards/computermemorykeystorage.hpp"
+#include "fakepcscdatatransport.hpp"
+#include <gtest/gtest.h>
+
+using namespace logicalaccess;
+
+namespace
+{
+    /**
+     * Emulate the blocks of a Mifare 1K, each byte being its block number, and record the APDUs.
+     */
+    class Mifare1KTransport : public FakePCSCDataTransport
+    {
+    public:
+        Mifare1KTransport() : maxLength(0xFF), authenticated(false) {}
+
+        std::vector<unsigned char> written;
+        size_t maxLength;
+        bool authenticated;
+
+    protected:
+
+        virtual void receiveInto(std::vector<unsigned char>& result, long int) override
+        {
+            const std::vector<unsigned char>& last = apdus.back();
+            result.clear();
+            if (last[1] == 0x86)
+            {
+                authenticated = true;
+            }
+            else if ((last[1] == 0xB0 || last[1] == 0xD6) && !authenticated)
+            {
+                throw CardException("Security status not satisfied.", CardException::SECURITY_STATUS);
+            }
+            else if (last[1] == 0xB0)
+            {
+                if (last[4] > maxLength)
+                {
+                    // The card is halted by the refused command.
+                    authenticated = false;
+                    throw CardException("Wrong length.", CardException::WRONG_LENGTH);
+                }
+                for (size_t i = 0; i < last[4]; ++i)
+                    result.push_back(static_cast<unsigned char>(last[3] + i / 16));
+            }
+            else if (last[1] == 0xD6)
+            {
+                if (last[4] > maxLength)
+                {
+                    authenticated = false;
+                    throw CardException("Wrong length.", CardException::WRONG_LENGTH);
+                }
+                written.insert(written.end(), last.begin() + 5, last.end());
+            }
+            result.push_back(0x90);
+            result.push_back(0x00);
+        }
+    };
+
+    template<typename T>
+    struct Fixture
+    {
+        Fixture()
+        {
+            readerUnit = std::make_shared<PCSCReaderUnit>("Fake");
+            transport = std::make_shared<Mifare1KTransport>();
+            transport->setReaderUnit(readerUnit);
+            std::shared_ptr<PCSCReaderCardAdapter> rca = std::make_shared<PCSCReaderCardAdapter>();
+            rca->setDataTransport(transport);
+            commands = std::make_shared<T>();
+            commands->setReaderCardAdapter(rca);
+            chip = std::make_shared<Mifare1KChip>();
+            commands->setChip(chip);
+            key = std::make_shared<MifareKey>("ff ff ff ff ff ff");
+            key->setKeyStorage(std::make_shared<ComputerMemoryKeyStorage>());
+        }
+
+        std::shared_ptr<PCSCReaderUnit> readerUnit;
+        std::shared_ptr<Mifare1KTransport> transport;
+        std::shared_ptr<T> commands;
+        std::shared_ptr<Mifare1KChip> chip;
+        std::shared_ptr<MifareKey> key;
+    };
+
+    std::vector<unsigned char> expected_blocks(int start_block, int count)
+    {
+        std::vector<unsigned char> data;
+        for (int i = 0; i < count; ++i)
+            data.insert(data.end(), 16, static_cast<unsigned char>(start_block + i));
+        return data;
+    }
+}
+
+TEST(test_mifare_multi_block, single_block_reader)
+{
+    Fixture<MifarePCSCCommands> f;
+    MifareAccessInfo::SectorAccessBits sab;
+    sab.setTransportConfiguration();
+
+    ASSERT_EQ(expected_blocks(4, 3), f.commands->readSector(1, 0, f.key, f.key, sab));
+    ASSERT_EQ(3u, f.transport->count(0xB0));
+}
+
+TEST(test_mifare_multi_block, multi_block_reader)
+{
+    Fixture<MifareOmnikeyXX21Commands> f;
+    MifareAccessInfo::SectorAccessBits sab;
+    sab.setTransportConfiguration();
+
+    ASSERT_EQ(expected_blocks(4, 4), f.commands->readSector(1, 0, f.key, f.key, sab, true));
+    ASSERT_EQ(2u, f.transport->count(0xB0));
+    ASSERT_EQ(expected_blocks(9, 2), f.commands->readSector(2, 1, f.key, f.key, sab));
+    ASSERT_EQ(3u, f.transport->count(0xB0));
+
+    std::vector<unsigned char> data(48, 0x42);
+    f.commands->writeSector(3, 0, data, f.key, f.key, sab);
+    ASSERT_EQ(1u, f.transport->count(0xD6));
+    ASSERT_EQ(data, f.transport->written);
+}
+
+TEST(test_mifare_multi_block, fallback)
+{
+    Fixture<MifareOmnikeyXX21Commands> f;
+    f.transport->maxLength = 16;
+    MifareAccessInfo::SectorAccessBits sab;
+    sab.setTransportConfiguration();
+
+    // The sector is authenticated again after the refused command.
+    ASSERT_EQ(expected_blocks(4, 3), f.commands->readSector(1, 0, f.key, f.key, sab));
+    ASSERT_EQ(4u, f.transport->count(0xB0));
+    ASSERT_EQ(2u, f.transport->count(0x86));
+
+    // The reader is not asked again.
+    ASSERT_EQ(expected_blocks(8, 3), f.commands->readSector(2, 0, f.key, f.key, sab));
+    ASSERT_EQ(7u, f.transport->count(0xB0));
+    ASSERT_EQ(3u, f.transport->count(0x86));
+
+    std::vector<unsigned char> data(48, 0x42);
+    f.commands->writeSector(3, 0, data, f.key, f.key, sab);
+    ASSERT_EQ(3u, f.transport->count(0xD6));
+    ASSERT_EQ(data, f.transport->written);
+}
+
+TEST(test_mifare_multi_block, write_fallback)
+{
+    Fixture<MifareOmnikeyXX21Commands> f;
+    f.transport->maxLength = 16;
+    MifareAccessInfo::SectorAccessBits sab;
+    sab.setTransportConfiguration();
+
+    std::vector<unsigned char> data(48, 0x42);
+    f.commands->writeSector(3, 0, data, f.key, f.key, sab);
+    ASSERT_EQ(4u, f.transport->count(0xD6));
+    ASSERT_EQ(2u, f.transport->count(0x86));
+    ASSERT_EQ(data, f.transport->written);
+}
+
+TEST(test_mifare_multi_block, card_error)
+{
+    Fixture<MifareOmnikeyXX21Commands> f;
+
+    // A card error is reported, not taken for a reader limitation.
+    ASSERT_THROW(f.commands->readBlocks(4, 3), CardException);
+    ASSERT_EQ(1u, f.transport->count(0xB0));
+
+    f.transport->authenticated = true;
+    ASSERT_EQ(expected_blocks(4, 3), f.commands->readBlocks(4, 3));
+    ASSERT_EQ(2u, f.transport->count(0xB0));
+}
+
+TEST(test_mifare_multi_block, authentication_order)
+{
+    Fixture<MifareOmnikeyXX21Commands> f;
+    MifareAccessInfo::SectorAccessBits sab;
+    sab.setTransportConfiguration();
+    // Block 1 is read with key B, blocks 0 and 2 with key A.
+    sab.d_data_blocks_access_bits[1].c3 = true;
+
+    ASSERT_EQ(expected_blocks(4, 3), f.commands->readSector(1, 0, f.key, f.key, sab));
+    ASSERT_EQ(2u, f.transport->count(0x86));
+    ASSERT_EQ(3u, f.transport->count(0xB0));
+}
+
+TEST(test_mifare_multi_block, dump)
+{
+    Fixture<MifareOmnikeyXX21Commands> f;
+    MifareAccessInfo::SectorAccessBits sab;
+    sab.setTransportConfiguration();
+
+    ASSERT_EQ(expected_blocks(0, 64), f.commands->dumpCard(f.key, f.key, sab));
+    ASSERT_EQ(16u, f.transport->count(0x86));
+    ASSERT_EQ(32u, f.transport->count(0xB0));
+    ASSERT_EQ(1u, f.transport->count(0x82));
+}
@@ -0,0 +1,220 @@
+#include "pluginsreaderproviders/pcsc/commands/mifarepcsccommands.hpp"
+#include "pluginsreaderproviders/pcsc/commands/mifarepcsckeyslots.hpp"
+#include "pluginscards/mifare/mifarelocation.hpp"
+#include "logicalaccess/cards/computermemorykeystorage.hpp"
+#include "logicalaccess/cards/readermemorykeystorage.hpp"
+#include "fakepcscdatatransport.hpp"
+#include <gtest/gtest.h>
+
+using namespace logicalaccess;
+
+namespace
+{
+    /**
+     * Record the APDUs, answering 90 00, or 63 86 to non-volatile LOAD KEY if asked.
+     */
+    class KeySlotsTransport : public FakePCSCDataTransport
+    {
+    public:
+        KeySlotsTransport() : refuseNonVolatile(false), failAuthentication(false) {}
+
+        std::vector<unsigned char> last(unsigned char ins) const
+        {
+            for (size_t i = apdus.size(); i > 0; --i)
+            {
+                if (apdus[i - 1][1] == ins)
+                    return apdus[i - 1];
+            }
+            return std::vector<unsigned char>();
+        }
+
+        bool refuseNonVolatile;
+        bool failAuthentication;
+
+    protected:
+
+        virtual void receiveInto(std::vector<unsigned char>& result, long int) override
+        {
+            const std::vector<unsigned char>& last = apdus.back();
+            result.clear();
+            if (refuseNonVolatile && last[1] == 0x82 && last[2] == 0x20)
+            {
+                result.push_back(0x63);
+                result.push_back(0x86);
+            }
+            else if (failAuthentication && last[1] == 0x86)
+            {
+                throw CardException("Authentication failed.", CardException::SECURITY_STATUS);
+            }
+            else
+            {
+                result.push_back(0x90);
+                result.push_back(0x00);
+            }
+        }
+    };
+
+    /**
+     * Give access to the sector authentication steps.
+     */
+    class TestMifarePCSCCommands : public MifarePCSCCommands
+    {
+    public:
+        using MifarePCSCCommands::loadKey;
+
+        void authenticateSector(unsigned char blockno, std::shared_ptr<MifareKey> key)
+        {
+            std::shared_ptr<MifareLocation> location = std::make_shared<MifareLocation>();
+            location->sector = blockno / 4;
+            loadKey(location, KT_KEY_A, key);
+            authenticate(blockno, key->getKeyStorage(), KT_KEY_A);
+        }
+    };
+
+    struct Fixture
+    {
+        Fixture()
+        {
+            readerUnit = std::make_shared<PCSCReaderUnit>("Fake");
+            transport = std::make_shared<KeySlotsTransport>();
+            transport->setReaderUnit(readerUnit);
+            std::shared_ptr<PCSCReaderCardAdapter> rca = std::make_shared<PCSCReaderCardAdapter>();
+            rca->setDataTransport(transport);
+            commands = std::make_shared<TestMifarePCSCCommands>();
+            commands->setReaderCardAdapter(rca);
+        }
+
+        std::shared_ptr<PCSCReaderUnit> readerUnit;
+        std::shared_ptr<KeySlotsTransport> transport;
+        std::shared_ptr<TestMifarePCSCCommands> commands;
+    };
+}
+
+TEST(test_mifare_pcsc_key_slots, key_slots)
+{
+    MifarePCSCKeySlots slots;
+    std::vector<unsigned char> key(6, 0xFF);
+
+    ASSERT_FALSE(slots.isLoaded(0, false, key));
+    slots.setLoaded(0, false, key);
+    ASSERT_TRUE(slots.isLoaded(0, false, key));
+    ASSERT_FALSE(slots.isLoaded(0, true, key));
+    ASSERT_FALSE(slots.isLoaded(1, false, key));
+    ASSERT_FALSE(slots.isLoaded(0, false, std::vector<unsigned char>(6, 0xA0)));
+
+    slots.setLoaded(0, true, key);
+    slots.invalidate(0, true);
+    ASSERT_TRUE(slots.isLoaded(0, false, key));
+    ASSERT_FALSE(slots.isLoaded(0, true, key));
+
+    slots.setLoaded(0, true, key);
+    slots.invalidate(0);
+    ASSERT_FALSE(slots.isLoaded(0, false, key));
+    ASSERT_FALSE(slots.isLoaded(0, true, key));
+    slots.setLoaded(0, false, key);
+    slots.clear();
+    ASSERT_FALSE(slots.isLoaded(0, false, key));
+}
+
+TEST(test_mifare_pcsc_key_slots, resident_key)
+{
+    Fixture f;
+    std::shared_ptr<MifareKey> key = std::make_shared<MifareKey>("ff ff ff ff ff ff");
+    key->setKeyStorage(std::make_shared<ComputerMemoryKeyStorage>());
+
+    for (unsigned char sector = 0; sector < 16; ++sector)
+        f.commands->authenticateSector(sector * 4, key);
+    ASSERT_EQ(1u, f.transport->count(0x82));
+    ASSERT_EQ(16u, f.transport->count(0x86));
+
+    // Another key replaces the slot content.
+    std::shared_ptr<MifareKey> other = std::make_shared<MifareKey>("a0 a1 a2 a3 a4 a5");
+    other->setKeyStorage(std::make_shared<ComputerMemoryKeyStorage>());
+    f.commands->authenticateSector(4, other);
+    f.commands->authenticateSector(8, key);
+    ASSERT_EQ(3u, f.transport->count(0x82));
+
+    // Reader memory slots are tracked apart.
+    std::shared_ptr<ReaderMemoryKeyStorage> rmks = std::make_shared<ReaderMemoryKeyStorage>();
+    rmks->setKeySlot(1);
+    rmks->setVolatile(true);
+    std::shared_ptr<MifareKey> readerKey = std::make_shared<MifareKey>("a0 a1 a2 a3 a4 a5");
+    readerKey->setKeyStorage(rmks);
+    f.commands->authenticateSector(12, readerKey);
+    f.commands->authenticateSector(16, readerKey);
+    f.commands->authenticateSector(20, key);
+    ASSERT_EQ(4u, f.transport->count(0x82));
+
+    // A new card connection forgets the slots.
+    f.readerUnit->teardown_pcsc_connection();
+    f.commands->authenticateSector(0, key);
+    ASSERT_EQ(5u, f.transport->count(0x82));
+}
+
+TEST(test_mifare_pcsc_key_slots, direct_load_key)
+{
+    Fixture f;
+    std::shared_ptr<MifareKey> key = std::make_shared<MifareKey>("ff ff ff ff ff ff");
+    key->setKeyStorage(std::make_shared<ComputerMemoryKeyStorage>());
+    std::shared_ptr<MifareKey> other = std::make_shared<MifareKey>("a0 a1 a2 a3 a4 a5");
+
+    // A key loaded directly replaces the tracked one.
+    f.commands->authenticateSector(0, key);
+    ASSERT_TRUE(f.commands->loadKey(0, KT_KEY_A, other));
+    f.commands->authenticateSector(4, key);
+    ASSERT_EQ(3u, f.transport->count(0x82));
+
+    // And is tracked too.
+    ASSERT_TRUE(f.commands->loadKey(0, KT_KEY_A, other));
+    other->setKeyStorage(std::make_shared<ComputerMemoryKeyStorage>());
+    f.commands->authenticateSector(8, other);
+    ASSERT_EQ(4u, f.transport->count(0x82));
+
+    // The volatile memory is another slot.
+    std::shared_ptr<ReaderMemoryKeyStorage> rmks = std::make_shared<ReaderMemoryKeyStorage>();
+    rmks->setKeySlot(0);
+    rmks->setVolatile(true);
+    std::shared_ptr<MifareKey> readerKey = std::make_shared<MifareKey>("a0 a1 a2 a3 a4 a5");
+    readerKey->setKeyStorage(rmks);
+    f.commands->authenticateSector(12, readerKey);
+    ASSERT_EQ(5u, f.transport->count(0x82));
+    ASSERT_EQ(0x00, f.transport->last(0x82)[2]);
+    f.commands->authenticateSector(16, readerKey);
+    ASSERT_EQ(5u, f.transport->count(0x82));
+}
+
+TEST(test_mifare_pcsc_key_slots, failed_authentication)
+{
+    Fixture f;
+    std::shared_ptr<MifareKey> key = std::make_shared<MifareKey>("ff ff ff ff ff ff");
+    key->setKeyStorage(std::make_shared<ComputerMemoryKeyStorage>());
+
+    f.commands->authenticateSector(0, key);
+    f.transport->failAuthentication = true;
+    ASSERT_THROW(f.commands->authenticateSector(4, key), CardException);
+    f.transport->failAuthentication = false;
+
+    // The slot content is not trusted anymore.
+    f.commands->authenticateSector(8, key);
+    ASSERT_EQ(2u, f.transport->count(0x82));
+}
+
+TEST(test_mifare_pcsc_key_slots, volatile_only)
+{
+    ASSERT_FALSE(MifarePCSCKeySlots::isVolatileOnly(PCSC_RUT_DEFAULT));
+
+    Fixture f;
+    f.transport->refuseNonVolatile = true;
+    std::shared_ptr<MifareKey> key = std::make_shared<MifareKey>("ff ff ff ff ff ff");
+    key->setKeyStorage(std::make_shared<ComputerMemoryKeyStorage>());
+
+    f.commands->authenticateSector(0, key);
+    ASSERT_EQ(2u, f.transport->count(0x82));
+    ASSERT_TRUE(MifarePCSCKeySlots::isVolatileOnly(PCSC_RUT_DEFAULT));
+
+    // Next connections go straight to volatile memory.
+    f.readerUnit->teardown_pcsc_connection();
+    f.commands->authenticateSector(0, key);
+    ASSERT_EQ(3u, f.transport->count(0x82));
+    ASSERT_EQ(0x00, f.transport->last(0x82)[2]);
+}
@@ -0,0 +1,160 @@
+#include "pluginsreaderproviders/pcsc/commands/mifareultralightpcsccommands.hpp"
+#include "pluginsreaderproviders/pcsc/commands/mifareultralightacsacrcommands.hpp"
+#include "pluginsreaderproviders/pcsc/commands/mifareultralightcacsacrcommands.hpp"
+#include "pluginscards/mifareultralight/mifareultralightchip.hpp"
+#include "fakepcscdatatransport.hpp"
+#include <gtest/gtest.h>
+
+using namespace logicalaccess;
+
+namespace
+{
+    /**
+     * Emulate the pages of an NTAG216, each byte being its page number, and record the APDUs.
+     */
+    class NTAG216Transport : public FakePCSCDataTransport
+    {
+    public:
+        NTAG216Transport() : rejectFastRead(false) {}
+
+        size_t countNative(unsigned char cmd) const
+        {
+            size_t n = 0;
+            for (size_t i = 0; i < apdus.size(); ++i)
+            {
+                if (apdus[i][1] == 0x00 && apdus[i].size() > 5 && apdus[i][5] == cmd)
+                    ++n;
+            }
+            return n;
+        }
+
+        bool rejectFastRead;
+
+    protected:
+
+        virtual void receiveInto(std::vector<unsigned char>& result, long int) override
+        {
+            const std::vector<unsigned char>& last = apdus.back();
+            result.clear();
+            if (last[1] == 0xB0)
+            {
+                for (size_t i = 0; i < last[4]; ++i)
+                    result.push_back(static_cast<unsigned char>(last[3] + i / 4));
+            }
+            else if (last[1] == 0x00 && last[5] == 0x60)
+            {
+                // NTAG216 version
+                const unsigned char version[] = { 0x00, 0x04, 0x04, 0x02, 0x01, 0x00, 0x13, 0x03 };
+                result.assign(version, version + sizeof(version));
+            }
+            else if (last[1] == 0x00 && last[5] == 0x3A)
+            {
+                if (rejectFastRead)
+                {
+                    throw CardException("Function not supported.", CardException::FUNCTION_NOT_SUPPORTED);
+                }
+                for (unsigned char page = last[6]; page <= last[7]; ++page)
+                    result.insert(result.end(), 4, page);
+            }
+            result.push_back(0x90);
+            result.push_back(0x00);
+        }
+    };
+
+    template<typename T>
+    struct Fixture
+    {
+        Fixture()
+        {
+            transport = std::make_shared<NTAG216Transport>();
+            transport->setReaderUnit(std::make_shared<PCSCReaderUnit>("Fake"));
+            std::shared_ptr<PCSCReaderCardAdapter> rca = std::make_shared<PCSCReaderCardAdapter>();
+            rca->setDataTransport(transport);
+            commands = std::make_shared<T>();
+            commands->setReaderCardAdapter(rca);
+            chip = std::make_shared<MifareUltralightChip>();
+            commands->setChip(chip);
+        }
+
+        /**
+         * As detected by the reader unit.
+         */
+        void setNTAG216()
+        {
+            const unsigned char version[] = { 0x00, 0x04, 0x04, 0x02, 0x01, 0x00, 0x13, 0x03 };
+            chip->setVersion(std::vector<unsigned char>(version, version + sizeof(version)));
+        }
+
+        std::shared_ptr<NTAG216Transport> transport;
+        std::shared_ptr<T> commands;
+        std::shared_ptr<MifareUltralightChip> chip;
+    };
+
+    std::vector<unsigned char> expected_pages(int start_page, int stop_page)
+    {
+        std::vector<unsigned char> data;
+        for (int i = start_page; i <= stop_page; ++i)
+            data.insert(data.end(), 4, static_cast<unsigned char>(i));
+        return data;
+    }
+}
+
+TEST(test_mifare_ultralight_read_pages, native_read)
+{
+    Fixture<MifareUltralightPCSCCommands> f;
+
+    ASSERT_EQ(expected_pages(4, 13), f.commands->readPages(4, 13));
+    ASSERT_EQ(3u, f.transport->count(0xB0));
+    ASSERT_EQ(0u, f.transport->count(0x00));
+}
+
+TEST(test_mifare_ultralight_read_pages, fast_read)
+{
+    Fixture<MifareUltralightACSACRCommands> f;
+    f.setNTAG216();
+
+    ASSERT_EQ(expected_pages(4, 225), f.commands->readPages(4, 225));
+    ASSERT_EQ(4u, f.transport->countNative(0x3A));
+    ASSERT_EQ(0u, f.transport->count(0xB0));
+
+    ASSERT_EQ(expected_pages(10, 12), f.commands->readPages(10, 12));
+    ASSERT_EQ(5u, f.transport->countNative(0x3A));
+
+    // The version is read on detection only.
+    ASSERT_EQ(0u, f.transport->countNative(0x60));
+}
+
+TEST(test_mifare_ultralight_read_pages, unknown_version)
+{
+    Fixture<MifareUltralightACSACRCommands> f;
+
+    ASSERT_EQ(expected_pages(4, 9), f.commands->readPages(4, 9));
+    ASSERT_EQ(0u, f.transport->count(0x00));
+    ASSERT_EQ(2u, f.transport->count(0xB0));
+}
+
+TEST(test_mifare_ultralight_read_pages, fast_read_rejected)
+{
+    Fixture<MifareUltralightACSACRCommands> f;
+    f.setNTAG216();
+    f.transport->rejectFastRead = true;
+
+    ASSERT_EQ(expected_pages(4, 9), f.commands->readPages(4, 9));
+    ASSERT_EQ(1u, f.transport->countNative(0x3A));
+    ASSERT_EQ(2u, f.transport->count(0xB0));
+
+    // The reader is not asked again.
+    ASSERT_EQ(expected_pages(4, 9), f.commands->readPages(4, 9));
+    ASSERT_EQ(1u, f.transport->countNative(0x3A));
+    ASSERT_EQ(4u, f.transport->count(0xB0));
+}
+
+TEST(test_mifare_ultralight_read_pages, ultralight_c)
+{
+    Fixture<MifareUltralightCACSACRCommands> f;
+    f.setNTAG216();
+
+    ASSERT_EQ(expected_pages(4, 9), f.commands->readPages(4, 9));
+    ASSERT_EQ(0u, f.transport->count(0x00));
+    ASSERT_EQ(2u, f.transport->count(0xB0));
+}
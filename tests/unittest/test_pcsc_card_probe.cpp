@@ -0,0 +1,210 @@
+#include "pluginsreaderproviders/pcsc/readers/cardprobes/pcsccardprobe.hpp"
+#include "pluginsreaderproviders/pcsc/pcscreaderunit.hpp"
+#include "pluginsreaderproviders/pcsc/readercardadapters/pcscreadercardadapter.hpp"
+#include "pluginsreaderproviders/iso7816/commands/desfireev1iso7816commands.hpp"
+#include "pluginsreaderproviders/iso7816/commands/desfireiso7816resultchecker.hpp"
+#include "pluginsreaderproviders/pcsc/commands/mifareultralightacsacrcommands.hpp"
+#include "pluginscards/desfire/desfireev1chip.hpp"
+#include "pluginscards/mifareultralight/mifareultralightchip.hpp"
+#include "fakepcscdatatransport.hpp"
+#include <gtest/gtest.h>
+#include <map>
+
+using namespace logicalaccess;
+
+namespace
+{
+    /**
+     * Emulate the DESFire and the Ultralight EV1 GetVersion answers, and record the APDUs.
+     */
+    class GetVersionTransport : public FakePCSCDataTransport
+    {
+    public:
+        GetVersionTransport() : softwareMjVersion(1), randomUid(false), ultralightVersion(true), frame(0) {}
+
+        unsigned char softwareMjVersion;
+        bool randomUid;
+        bool ultralightVersion;
+
+    protected:
+
+        virtual void receiveInto(std::vector<unsigned char>& result, long int) override
+        {
+            const std::vector<unsigned char>& last = apdus.back();
+            result.clear();
+            if (last[1] == 0x00 && last[5] == 0x60)
+            {
+                // Ultralight GET_VERSION through the transparent exchange, a NAK otherwise.
+                if (!ultralightVersion)
+                {
+                    throw CardException("No answer from the card.", CardException::EXECUTION_ERROR);
+                }
+                const unsigned char version[] = { 0x00, 0x04, 0x03, 0x01, 0x01, 0x00, 0x0B, 0x03 };
+                result.assign(version, version + sizeof(version));
+            }
+            else if (last[1] == 0x60)
+            {
+                // Hardware version
+                frame = 1;
+                result.assign(7, 0x01);
+                result.push_back(0x91);
+                result.push_back(0xAF);
+                return;
+            }
+            if (last[1] == 0xAF && frame == 1)
+            {
+                // Software version
+                frame = 2;
+                const unsigned char version[] = { 0x04, 0x01, 0x01, softwareMjVersion, 0x00, 0x18, 0x05 };
+                result.assign(version, version + sizeof(version));
+                result.push_back(0x91);
+                result.push_back(0xAF);
+                return;
+            }
+            if (last[1] == 0xAF && frame == 2)
+            {
+                // UID, batch number and production date
+                frame = 0;
+                result.assign(7, randomUid ? 0x00 : 0x42);
+                result.insert(result.end(), 7, 0x00);
+            }
+            result.push_back(0x91);
+            result.push_back(0x00);
+        }
+
+        int frame;
+    };
+
+    /**
+     * A reader unit creating DESFire and Ultralight chips on the fake transport, other chips are not answering.
+     */
+    class FakePCSCReaderUnit : public PCSCReaderUnit
+    {
+    public:
+        using PCSCReaderUnit::adjustChip;
+
+        FakePCSCReaderUnit() : PCSCReaderUnit("Fake"), resets(0)
+        {
+            transport = std::make_shared<GetVersionTransport>();
+            transport->setReaderUnit(std::make_shared<PCSCReaderUnit>("Fake"));
+        }
+
+        virtual bool reconnect(int) override
+        {
+            ++resets;
+            return true;
+        }
+
+        virtual std::shared_ptr<Chip> createChip(std::string type) override
+        {
+            ++created[type];
+            std::shared_ptr<PCSCReaderCardAdapter> rca = std::make_shared<PCSCReaderCardAdapter>();
+            rca->setDataTransport(transport);
+            if (type == "MifareUltralight")
+            {
+                std::shared_ptr<MifareUltralightACSACRCommands> commands = std::make_shared<MifareUltralightACSACRCommands>();
+                commands->setReaderCardAdapter(rca);
+                std::shared_ptr<MifareUltralightChip> chip = std::make_shared<MifareUltralightChip>();
+                chip->setCommands(commands);
+                commands->setChip(chip);
+                return chip;
+            }
+            if (type != "DESFireEV1")
+            {
+                THROW_EXCEPTION_WITH_LOG(CardException, "No answer from the card.");
+            }
+
+            rca->setResultChecker(std::make_shared<DESFireISO7816ResultChecker>());
+            std::shared_ptr<DESFireEV1ISO7816Commands> commands = std::make_shared<DESFireEV1ISO7816Commands>();
+            commands->setReaderCardAdapter(rca);
+            std::shared_ptr<DESFireEV1Chip> chip = std::make_shared<DESFireEV1Chip>();
+            chip->setCommands(commands);
+            commands->setChip(chip);
+            return chip;
+        }
+
+        std::shared_ptr<GetVersionTransport> transport;
+        std::map<std::string, int> created;
+        int resets;
+    };
+}
+
+TEST(test_pcsc_card_probe, desfire_version_once)
+{
+    std::shared_ptr<FakePCSCReaderUnit> unit = std::make_shared<FakePCSCReaderUnit>();
+    PCSCCardProbe probe(unit.get());
+
+    std::vector<uint8_t> uid;
+    ASSERT_TRUE(probe.is_desfire(&uid));
+    ASSERT_EQ(std::vector<uint8_t>(7, 0x42), uid);
+    ASSERT_TRUE(probe.is_desfire_ev1());
+    ASSERT_FALSE(probe.is_desfire_ev2());
+    ASSERT_FALSE(probe.has_desfire_random_uid(&uid));
+
+    // One reset and one GetVersion for all the answers.
+    ASSERT_EQ(1u, unit->transport->count(0x60));
+    ASSERT_EQ(1, unit->created["DESFireEV1"]);
+    ASSERT_EQ(1, unit->resets);
+
+    // A new card is probed again.
+    unit->transport->softwareMjVersion = 2;
+    unit->transport->randomUid = true;
+    probe.clear_cache();
+    ASSERT_FALSE(probe.is_desfire_ev1());
+    ASSERT_TRUE(probe.is_desfire_ev2());
+    ASSERT_TRUE(probe.has_desfire_random_uid(&uid));
+    ASSERT_EQ(2u, unit->transport->count(0x60));
+    ASSERT_EQ(2, unit->resets);
+}
+
+TEST(test_pcsc_card_probe, failures_are_cached)
+{
+    std::shared_ptr<FakePCSCReaderUnit> unit = std::make_shared<FakePCSCReaderUnit>();
+    PCSCCardProbe probe(unit.get());
+
+    ASSERT_FALSE(probe.maybe_mifare_classic());
+    ASSERT_FALSE(probe.maybe_mifare_classic());
+    ASSERT_EQ(1, unit->created["Mifare1K"]);
+
+    ASSERT_FALSE(probe.is_mifare_ultralight_c());
+    ASSERT_FALSE(probe.is_mifare_ultralight_c());
+    ASSERT_EQ(1, unit->created["MifareUltralightC"]);
+    ASSERT_EQ(2, unit->resets);
+
+    probe.clear_cache();
+    ASSERT_FALSE(probe.maybe_mifare_classic());
+    ASSERT_EQ(2, unit->created["Mifare1K"]);
+}
+
+TEST(test_pcsc_card_probe, mifare_ultralight_version)
+{
+    std::shared_ptr<FakePCSCReaderUnit> unit = std::make_shared<FakePCSCReaderUnit>();
+    PCSCCardProbe probe(unit.get());
+
+    std::vector<uint8_t> version;
+    ASSERT_TRUE(probe.get_mifare_ultralight_version(&version));
+    ASSERT_EQ(8u, version.size());
+    ASSERT_TRUE(probe.get_mifare_ultralight_version(&version));
+    ASSERT_EQ(1u, unit->transport->count(0x00));
+    ASSERT_EQ(1, unit->resets);
+
+    // The chip halted by the NAK is woken up.
+    unit->transport->ultralightVersion = false;
+    probe.clear_cache();
+    ASSERT_FALSE(probe.get_mifare_ultralight_version(&version));
+    ASSERT_EQ(2u, unit->transport->count(0x00));
+    ASSERT_EQ(3, unit->resets);
+}
+
+TEST(test_pcsc_card_probe, mifare_ultralight_detection)
+{
+    std::shared_ptr<FakePCSCReaderUnit> unit = std::make_shared<FakePCSCReaderUnit>();
+    std::shared_ptr<MifareUltralightChip> chip = std::dynamic_pointer_cast<MifareUltralightChip>(unit->createChip("MifareUltralight"));
+    chip->setChipIdentifier(std::vector<unsigned char>(7, 0x04));
+
+    // Not an Ultralight C, the version is kept on the chip.
+    std::shared_ptr<Chip> adjusted = unit->adjustChip(chip);
+    ASSERT_EQ(chip, adjusted);
+    ASSERT_TRUE(chip->hasFastRead());
+    ASSERT_EQ(1, unit->created["MifareUltralightC"]);
+}
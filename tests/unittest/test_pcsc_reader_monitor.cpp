@@ -0,0 +1,266 @@
+#include "pluginsreaderproviders/pcsc/pcscreadermonitor.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace logicalaccess;
+
+/**
+ * PC/SC stub, these definitions take precedence over the PC/SC library ones.
+ */
+namespace
+{
+    struct FakePCSC
+    {
+        FakePCSC() : waiting(0), cancelled(false), lose_cancel(false), next_context(1) {}
+
+        void reset()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            readers.clear();
+            waiting = 0;
+            cancelled = false;
+            lose_cancel = false;
+        }
+
+        void setReader(const std::string& name, DWORD state, const std::vector<unsigned char>& atr = std::vector<unsigned char>())
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            readers[name] = state;
+            atrs[name] = atr;
+            cond.notify_all();
+        }
+
+        void removeReader(const std::string& name)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            readers.erase(name);
+            cond.notify_all();
+        }
+
+        /**
+         * Fill the event states, return true if one changed.
+         */
+        bool update(SCARD_READERSTATE* states, DWORD count)
+        {
+            bool changed = false;
+            for (DWORD i = 0; i < count; ++i)
+            {
+                SCARD_READERSTATE& state = states[i];
+                if (std::strcmp(state.szReader, "\\\\?PnP?\\Notification") == 0)
+                {
+                    state.dwEventState = static_cast<DWORD>(readers.size() << 16);
+                }
+                else if (readers.find(state.szReader) != readers.end())
+                {
+                    state.dwEventState = readers[state.szReader];
+                    const std::vector<unsigned char>& atr = atrs[state.szReader];
+                    state.cbAtr = static_cast<DWORD>(atr.size());
+                    if (!atr.empty())
+                        std::memcpy(state.rgbAtr, &atr[0], atr.size());
+                }
+                else
+                {
+                    // The reader is going away, some drivers keep the card state.
+                    state.dwEventState = SCARD_STATE_UNAVAILABLE | (state.dwCurrentState & SCARD_STATE_PRESENT);
+                }
+
+                if (state.dwEventState != (state.dwCurrentState & ~SCARD_STATE_CHANGED))
+                {
+                    state.dwEventState |= SCARD_STATE_CHANGED;
+                    changed = true;
+                }
+            }
+            return changed;
+        }
+
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::map<std::string, DWORD> readers;
+        std::map<std::string, std::vector<unsigned char> > atrs;
+        int waiting;
+        bool cancelled;
+        bool lose_cancel;
+        SCARDCONTEXT next_context;
+    };
+
+    FakePCSC fake;
+}
+
+LONG SCardEstablishContext(DWORD, LPCVOID, LPCVOID, LPSCARDCONTEXT phContext)
+{
+    std::lock_guard<std::mutex> lock(fake.mutex);
+    *phContext = fake.next_context++;
+    return SCARD_S_SUCCESS;
+}
+
+LONG SCardReleaseContext(SCARDCONTEXT)
+{
+    return SCARD_S_SUCCESS;
+}
+
+LONG SCardCancel(SCARDCONTEXT)
+{
+    std::lock_guard<std::mutex> lock(fake.mutex);
+    // Like the resource manager, only a pending wait is cancelled.
+    if (fake.waiting > 0 && !fake.lose_cancel)
+    {
+        fake.cancelled = true;
+        fake.cond.notify_all();
+    }
+    return SCARD_S_SUCCESS;
+}
+
+LONG SCardListReaders(SCARDCONTEXT, LPCSTR, LPSTR mszReaders, LPDWORD pcchReaders)
+{
+    std::lock_guard<std::mutex> lock(fake.mutex);
+    std::string names;
+    for (std::map<std::string, DWORD>::const_iterator it = fake.readers.begin(); it != fake.readers.end(); ++it)
+    {
+        names += it->first;
+        names.push_back('\0');
+    }
+    names.push_back('\0');
+
+    if (mszReaders != NULL)
+        std::memcpy(mszReaders, names.data(), names.size());
+    *pcchReaders = static_cast<DWORD>(names.size());
+    return SCARD_S_SUCCESS;
+}
+
+LONG SCardGetStatusChange(SCARDCONTEXT, DWORD dwTimeout, SCARD_READERSTATE* rgReaderStates, DWORD cReaders)
+{
+    std::unique_lock<std::mutex> lock(fake.mutex);
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(dwTimeout);
+    ++fake.waiting;
+    LONG r = SCARD_S_SUCCESS;
+    while (!fake.update(rgReaderStates, cReaders))
+    {
+        if (fake.cancelled)
+        {
+            fake.cancelled = false;
+            r = SCARD_E_CANCELLED;
+            break;
+        }
+        if (dwTimeout == INFINITE)
+        {
+            fake.cond.wait(lock);
+        }
+        else if (fake.cond.wait_until(lock, deadline) == std::cv_status::timeout)
+        {
+            r = SCARD_E_TIMEOUT;
+            break;
+        }
+    }
+    --fake.waiting;
+    return r;
+}
+
+namespace
+{
+    struct Recorder
+    {
+        void operator()(const PCSCReaderMonitorEvent& event)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.push_back(event);
+            cond.notify_all();
+        }
+
+        bool waitFor(size_t count)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            return cond.wait_for(lock, std::chrono::seconds(5), [this, count]() { return events.size() >= count; });
+        }
+
+        std::vector<PCSCReaderMonitorEventType> types()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::vector<PCSCReaderMonitorEventType> result;
+            for (size_t i = 0; i < events.size(); ++i)
+                result.push_back(events[i].type);
+            return result;
+        }
+
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::vector<PCSCReaderMonitorEvent> events;
+    };
+}
+
+TEST(test_pcsc_reader_monitor, events)
+{
+    fake.reset();
+    std::vector<unsigned char> atr(2, 0x3B);
+    fake.setReader("Reader A", SCARD_STATE_PRESENT, atr);
+
+    std::shared_ptr<Recorder> recorder = std::make_shared<Recorder>();
+    PCSCReaderMonitor monitor;
+    monitor.addEventHandler([recorder](const PCSCReaderMonitorEvent& event) { (*recorder)(event); });
+    monitor.start();
+
+    ASSERT_TRUE(recorder->waitFor(2));
+    fake.setReader("Reader A", SCARD_STATE_EMPTY);
+    ASSERT_TRUE(recorder->waitFor(3));
+    fake.setReader("Reader A", SCARD_STATE_PRESENT, atr);
+    ASSERT_TRUE(recorder->waitFor(4));
+
+    // A reader unplugged with a card reports a single removal.
+    fake.removeReader("Reader A");
+    ASSERT_TRUE(recorder->waitFor(6));
+    fake.setReader("Reader B", SCARD_STATE_EMPTY);
+    ASSERT_TRUE(recorder->waitFor(7));
+    monitor.stop();
+
+    std::vector<PCSCReaderMonitorEventType> expected;
+    expected.push_back(PCSC_RME_READER_ADDED);
+    expected.push_back(PCSC_RME_CARD_INSERTED);
+    expected.push_back(PCSC_RME_CARD_REMOVED);
+    expected.push_back(PCSC_RME_CARD_INSERTED);
+    expected.push_back(PCSC_RME_CARD_REMOVED);
+    expected.push_back(PCSC_RME_READER_REMOVED);
+    expected.push_back(PCSC_RME_READER_ADDED);
+    ASSERT_EQ(expected, recorder->types());
+    ASSERT_EQ(atr, recorder->events[1].atr);
+    ASSERT_EQ("Reader B", recorder->events[6].readerName);
+}
+
+TEST(test_pcsc_reader_monitor, lost_cancel)
+{
+    fake.reset();
+    fake.lose_cancel = true;
+
+    PCSCReaderMonitor monitor;
+    monitor.start();
+    monitor.stop();
+    ASSERT_FALSE(monitor.isRunning());
+}
+
+TEST(test_pcsc_reader_monitor, stop_from_handler)
+{
+    fake.reset();
+    fake.setReader("Reader A", SCARD_STATE_EMPTY);
+
+    std::shared_ptr<Recorder> recorder = std::make_shared<Recorder>();
+    PCSCReaderMonitor monitor;
+    monitor.addEventHandler([&monitor, recorder](const PCSCReaderMonitorEvent& event)
+    {
+        monitor.stop();
+        (*recorder)(event);
+    });
+    monitor.start();
+
+    ASSERT_TRUE(recorder->waitFor(1));
+    ASSERT_FALSE(monitor.isRunning());
+
+    // The stopped thread is joined on restart.
+    monitor.start();
+    ASSERT_TRUE(monitor.isRunning());
+    ASSERT_TRUE(recorder->waitFor(2));
+    monitor.stop();
+}
@@ -0,0 +1,151 @@
+#include "logicalaccess/readerproviders/readerpollscheduler.hpp"
+#include "logicalaccess/utils.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+using namespace logicalaccess;
+
+TEST(test_reader_poll_scheduler, success)
+{
+    ReaderPollScheduler scheduler(1);
+    int count = 0;
+
+    ASSERT_TRUE(scheduler.waitFor([&count]() { return ++count == 3; }, 1000));
+    ASSERT_EQ(3, count);
+}
+
+TEST(test_reader_poll_scheduler, timeout)
+{
+    ReaderPollScheduler scheduler(1);
+    ElapsedTimeCounter counter;
+    int count = 0;
+
+    ASSERT_FALSE(scheduler.waitFor([&count]() { ++count; return false; }, 300));
+    ASSERT_GE(counter.elapsed(), 300);
+    // Polled right away, then until the deadline.
+    ASSERT_GE(count, 2);
+}
+
+TEST(test_reader_poll_scheduler, first_delay)
+{
+    ReaderPollScheduler scheduler(1);
+    ElapsedTimeCounter counter;
+
+    ASSERT_TRUE(scheduler.waitFor([]() { return true; }, 1000, ReaderPollProfile(20, 20, 0, 100)));
+    ASSERT_GE(counter.elapsed(), 100);
+}
+
+TEST(test_reader_poll_scheduler, non_std_exception)
+{
+    ReaderPollScheduler scheduler(1);
+    std::atomic<int> result(-1);
+
+    scheduler.schedule([]() -> bool { throw 42; }, [&result](bool r) { result = r; }, 1000);
+    ASSERT_TRUE(scheduler.waitFor([&result]() { return result != -1; }, 1000));
+    ASSERT_EQ(0, result);
+}
+
+TEST(test_reader_poll_scheduler, blocking_hook)
+{
+    ReaderPollScheduler scheduler(1);
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool other_done = false, seen = false;
+
+    // The first hook blocks until the second registration completes.
+    scheduler.schedule([&]()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        seen = cond.wait_for(lock, std::chrono::seconds(5), [&other_done]() { return other_done; });
+        return true;
+    }, [](bool) {}, 0);
+
+    ASSERT_TRUE(scheduler.waitFor([]() { return true; }, 1000));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        other_done = true;
+    }
+    cond.notify_all();
+    ASSERT_TRUE(scheduler.waitFor([&]() { std::lock_guard<std::mutex> lock(mutex); return seen; }, 1000));
+}
+
+TEST(test_reader_poll_scheduler, exception)
+{
+    ReaderPollScheduler scheduler(1);
+
+    ASSERT_THROW(scheduler.waitFor([]() -> bool { throw std::runtime_error("poll"); }, 300),
+                 std::runtime_error);
+}
+
+TEST(test_reader_poll_scheduler, multiplex)
+{
+    ReaderPollScheduler scheduler(1);
+    std::atomic<int> completed(0);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        std::shared_ptr<int> count(new int(0));
+        scheduler.schedule([count]() { return ++(*count) == 5; },
+                           [&completed](bool result) { if (result) ++completed; }, 2000);
+    }
+
+    ASSERT_TRUE(scheduler.waitFor([&completed]() { return completed == 10; }, 2000));
+}
+
+TEST(test_reader_poll_scheduler, cancel)
+{
+    ReaderPollScheduler scheduler(1);
+    std::atomic<int> result(-1);
+
+    int id = scheduler.schedule([]() { return false; },
+                                [&result](bool r) { result = r; }, 0, ReaderPollProfile(50, 50, 0));
+    scheduler.cancel(id);
+    ASSERT_TRUE(scheduler.waitFor([&result]() { return result != -1; }, 1000));
+    ASSERT_EQ(0, result);
+}
+
+TEST(test_reader_poll_scheduler, pool_cap)
+{
+    ReaderPollScheduler scheduler(1, 3);
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool released = false;
+    int running = 0, max_running = 0;
+    std::atomic<int> completed(0);
+
+    // Blocking hooks only get as many threads as the cap.
+    for (int i = 0; i < 6; ++i)
+    {
+        scheduler.schedule([&]()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            max_running = std::max(max_running, ++running);
+            cond.wait_for(lock, std::chrono::seconds(5), [&released]() { return released; });
+            --running;
+            return true;
+        }, [&completed](bool result) { if (result) ++completed; }, 0);
+    }
+    ASSERT_EQ(3u, scheduler.getThreadCount());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(3, max_running);
+        released = true;
+    }
+    cond.notify_all();
+
+    ElapsedTimeCounter counter;
+    while (completed != 6 && counter.elapsed() < 2000)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(6, completed);
+
+    // The pool shrinks back once the registrations are done.
+    while (scheduler.getThreadCount() > 1 && counter.elapsed() < 2000)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(1u, scheduler.getThreadCount());
+}
@@ -0,0 +1,71 @@
+#include "logicalaccess/settings.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace logicalaccess;
+
+TEST(test_settings, snapshot)
+{
+    std::shared_ptr<const Settings> before = Settings::getSnapshot();
+    ASSERT_TRUE(before != nullptr);
+    ASSERT_EQ(before, Settings::getSnapshot());
+
+    Settings::update([](Settings& s) { s.DataTransportTimeout = 1234; });
+    ASSERT_EQ(1234, Settings::getInstance()->DataTransportTimeout);
+
+    // The previous snapshot is left untouched.
+    std::shared_ptr<const Settings> after = Settings::getSnapshot();
+    ASSERT_NE(before, after);
+    ASSERT_EQ(1234, after->DataTransportTimeout);
+    ASSERT_NE(1234, before->DataTransportTimeout);
+
+    // Direct modifications are visible once published.
+    Settings::getInstance()->DataTransportTimeout = 42;
+    ASSERT_EQ(1234, Settings::getSnapshot()->DataTransportTimeout);
+    Settings::getInstance()->publish();
+    ASSERT_EQ(42, Settings::getSnapshot()->DataTransportTimeout);
+
+    // A reload publishes the configuration file values, the defaults without file.
+    Settings::reload();
+    ASSERT_NE(42, Settings::getSnapshot()->DataTransportTimeout);
+    ASSERT_EQ(Settings::getSnapshot()->DataTransportTimeout, Settings::getInstance()->DataTransportTimeout);
+
+    Settings::update([before](Settings& s) { s = *before; });
+    ASSERT_EQ(before->DataTransportTimeout, Settings::getSnapshot()->DataTransportTimeout);
+}
+
+TEST(test_settings, concurrent_update)
+{
+    std::shared_ptr<const Settings> before = Settings::getSnapshot();
+    Settings::update([](Settings& s) { s.ConfigurationRetryTimeout = s.AutoDetectionTimeout; });
+
+    std::atomic<bool> stop(false);
+    std::atomic<int> inconsistent(0);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.push_back(std::thread([&stop, &inconsistent]()
+        {
+            while (!stop)
+            {
+                std::shared_ptr<const Settings> s = Settings::getSnapshot();
+                if (s->AutoDetectionTimeout != s->ConfigurationRetryTimeout)
+                    ++inconsistent;
+            }
+        }));
+    }
+
+    for (long int i = 0; i < 1000; ++i)
+    {
+        Settings::update([i](Settings& s) { s.AutoDetectionTimeout = i; s.ConfigurationRetryTimeout = i; });
+    }
+    stop = true;
+    for (size_t i = 0; i < readers.size(); ++i)
+        readers[i].join();
+
+    ASSERT_EQ(0, inconsistent);
+    Settings::update([before](Settings& s) { s = *before; });
+}